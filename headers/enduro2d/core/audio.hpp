@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_core.hpp"
+
+namespace e2d
+{
+    using sound_ptr = std::shared_ptr<sound>;
+
+    class bad_audio_operation final : public exception {
+    public:
+        const char* what() const noexcept final {
+            return "bad audio operation";
+        }
+    };
+
+    //
+    // audio
+    //
+    // All voice control methods are lock-free and may be called from any
+    // thread, they only enqueue commands and the mixer is the only consumer
+    // of the queue. The mixer works on its own thread (or on the caller
+    // thread by 'mix' when the mixer thread is disabled) and passes
+    // interleaved stereo f32 blocks to the sink. Commands over the queue
+    // capacity are rejected: 'play' returns 'invalid_voice' and other
+    // methods return false. A mixer thread which is not 'realtime' sleeps
+    // while there are no voices.
+    //
+
+    class audio final : public module<audio> {
+    public:
+        using voice_id = u32;
+        static const voice_id invalid_voice = 0u;
+    public:
+        class sink;
+        using sink_uptr = std::unique_ptr<sink>;
+        class parameters;
+        class statistics;
+    public:
+        audio(debug& d, sink_uptr sink, const parameters& params);
+        ~audio() noexcept final;
+
+        voice_id play(
+            const sound_ptr& sound,
+            f32 volume = 1.f,
+            f32 pitch = 1.f,
+            bool looped = false);
+
+        voice_id play(
+            sound_stream_uptr stream,
+            f32 volume = 1.f,
+            f32 pitch = 1.f,
+            bool looped = false);
+
+        bool stop(voice_id voice);
+        bool stop_all();
+
+        bool pause(voice_id voice, bool value);
+        bool volume(voice_id voice, f32 value);
+        bool pitch(voice_id voice, f32 value);
+        bool master_volume(f32 value);
+
+        void mix(std::size_t frames);
+
+        u32 sample_rate() const noexcept;
+        statistics stats() const noexcept;
+    private:
+        class internal_state;
+        std::unique_ptr<internal_state> state_;
+    };
+
+    //
+    // audio::sink
+    //
+
+    class audio::sink : private e2d::noncopyable {
+    public:
+        virtual ~sink() noexcept = default;
+        virtual bool on_mix(
+            const f32* samples,
+            std::size_t frames,
+            u32 sample_rate) noexcept = 0;
+    };
+
+    //
+    // audio::parameters
+    //
+
+    class audio::parameters {
+    public:
+        parameters& sample_rate(u32 value) noexcept;
+        parameters& block_frames(u32 value) noexcept;
+        parameters& max_voices(u32 value) noexcept;
+        parameters& mixer_thread(bool value) noexcept;
+        parameters& realtime(bool value) noexcept;
+
+        u32 sample_rate() const noexcept;
+        u32 block_frames() const noexcept;
+        u32 max_voices() const noexcept;
+        bool mixer_thread() const noexcept;
+        bool realtime() const noexcept;
+    private:
+        u32 sample_rate_{44100u};
+        u32 block_frames_{512u};
+        u32 max_voices_{256u};
+        bool mixer_thread_{true};
+        bool realtime_{true};
+    };
+
+    //
+    // audio::statistics
+    //
+
+    class audio::statistics {
+    public:
+        u32 active_voices{0u};
+        u64 mixed_frames{0u};
+        u64 mix_time_us{0u};
+        u32 stream_underruns{0u};
+        u32 dropped_voices{0u};
+        u32 dropped_commands{0u};
+    };
+
+    //
+    // audio sinks
+    //
+
+    class audio_null_sink final : public audio::sink {
+    public:
+        bool on_mix(
+            const f32* samples,
+            std::size_t frames,
+            u32 sample_rate) noexcept final;
+    };
+
+    class audio_wav_sink final : public audio::sink {
+    public:
+        audio_wav_sink(output_stream_uptr stream);
+        ~audio_wav_sink() noexcept final;
+
+        bool on_mix(
+            const f32* samples,
+            std::size_t frames,
+            u32 sample_rate) noexcept final;
+    private:
+        output_stream_uptr stream_;
+        vector<i16> pcm_;
+        std::size_t data_size_{0u};
+        bool header_written_{false};
+    };
+}
@@ -698,6 +698,9 @@ namespace e2d
             pass_state& states(const state_block& states) noexcept;
             pass_state& properties(const property_block& properties) noexcept;
 
+            // keyword mask of the shader variant, zero for the default one
+            pass_state& variant(u32 variant) noexcept;
+
             shader_ptr& shader() noexcept;
             state_block& states() noexcept;
             property_block& properties() noexcept;
@@ -705,10 +708,12 @@ namespace e2d
             const shader_ptr& shader() const noexcept;
             const state_block& states() const noexcept;
             const property_block& properties() const noexcept;
+            u32 variant() const noexcept;
         private:
             property_block properties_;
             shader_ptr shader_;
             state_block states_;
+            u32 variant_ = 0;
         };
 
         class material final {
@@ -28,6 +28,8 @@ namespace e2d
         vfs();
         ~vfs() noexcept final;
 
+        // file sources are called from many threads without
+        // any locking by the vfs, so they must be thread safe
         class file_source : private e2d::noncopyable {
         public:
             virtual ~file_source() noexcept = default;
@@ -36,6 +38,17 @@ namespace e2d
             virtual input_stream_uptr read(str_view path) const = 0;
             virtual output_stream_uptr write(str_view path, bool append) const = 0;
             virtual bool trace(str_view path, filesystem::trace_func func) const = 0;
+
+            // native asynchronous loading, 'vfs::load_async' falls back
+            // to blocking reads on the vfs worker when it returns false
+            virtual bool load_async(
+                str_view path,
+                stdex::promise<buffer>& dst,
+                bool zero_terminated) const;
+
+            // drops cached state of the path (or of the whole
+            // source for the empty path) after external changes
+            virtual void invalidate(str_view path) const;
         };
         using file_source_uptr = std::unique_ptr<file_source>;
 
@@ -52,8 +65,10 @@ namespace e2d
         input_stream_uptr read(const url& url) const;
         output_stream_uptr write(const url& url, bool append) const;
 
-        bool load(const url& url, buffer& dst) const;
-        stdex::promise<buffer> load_async(const url& url) const;
+        // 'zero_terminated' appends a zero byte to the loaded content,
+        // so it can be parsed in place without copying
+        bool load(const url& url, buffer& dst, bool zero_terminated = false) const;
+        stdex::promise<buffer> load_async(const url& url, bool zero_terminated = false) const;
 
         bool load_as_string(const url& url, str& dst) const;
         stdex::promise<str> load_as_string_async(const url& url) const;
@@ -61,6 +76,7 @@ namespace e2d
         template < typename Iter >
         bool extract(const url& url, Iter result_iter) const;
         bool trace(const url& url, filesystem::trace_func func) const;
+        void invalidate(const url& url) const;
 
         url resolve_scheme_aliases(const url& url) const;
     private:
@@ -68,9 +84,18 @@ namespace e2d
         std::unique_ptr<state> state_;
     };
 
+    //
+    // file sources wrap their streams to read-ahead buffers,
+    // zero 'read_ahead' size disables the buffering
+    //
+
     class archive_file_source final : public vfs::file_source {
     public:
-        archive_file_source(input_stream_uptr stream);
+        static constexpr std::size_t default_read_ahead = 16u * 1024u;
+    public:
+        archive_file_source(
+            input_stream_uptr stream,
+            std::size_t read_ahead = default_read_ahead);
         ~archive_file_source() noexcept final;
         bool valid() const noexcept final;
         bool exists(str_view path) const final;
@@ -82,15 +107,52 @@ namespace e2d
         std::unique_ptr<state> state_;
     };
 
+    //
+    // reads entries of e2d packs (see 'pack_writer') to memory streams,
+    // entries are located by the path hash without directory walking
+    //
+
+    class pack_file_source final : public vfs::file_source {
+    public:
+        pack_file_source(input_stream_uptr stream);
+        ~pack_file_source() noexcept final;
+        bool valid() const noexcept final;
+        bool exists(str_view path) const final;
+        input_stream_uptr read(str_view path) const final;
+        output_stream_uptr write(str_view path, bool append) const final;
+        bool trace(str_view path, filesystem::trace_func func) const final;
+    private:
+        class state;
+        std::unique_ptr<state> state_;
+    };
+
     class filesystem_file_source final : public vfs::file_source {
     public:
-        filesystem_file_source();
+        static constexpr std::size_t default_read_ahead = 16u * 1024u;
+        static constexpr std::size_t default_async_queue_depth = 64u;
+    public:
+        // zero 'async_queue_depth' disables the native asynchronous io,
+        // 'listing_cache' serves 'exists' from cached directory listings,
+        // files changed outside of the source require 'vfs::invalidate'
+        filesystem_file_source(
+            std::size_t read_ahead = default_read_ahead,
+            std::size_t async_queue_depth = default_async_queue_depth,
+            bool listing_cache = false);
         ~filesystem_file_source() noexcept final;
         bool valid() const noexcept final;
         bool exists(str_view path) const final;
         input_stream_uptr read(str_view path) const final;
         output_stream_uptr write(str_view path, bool append) const final;
         bool trace(str_view path, filesystem::trace_func func) const final;
+        bool load_async(
+            str_view path,
+            stdex::promise<buffer>& dst,
+            bool zero_terminated) const final;
+        void invalidate(str_view path) const final;
+        bool native_async() const noexcept;
+    private:
+        class state;
+        std::unique_ptr<state> state_;
     };
 }
 
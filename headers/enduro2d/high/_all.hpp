@@ -19,6 +19,8 @@
 #include "assets/prefab_asset.hpp"
 #include "assets/shader_asset.hpp"
 #include "assets/shape_asset.hpp"
+#include "assets/snapshot_asset.hpp"
+#include "assets/sound_asset.hpp"
 #include "assets/sprite_asset.hpp"
 #include "assets/text_asset.hpp"
 #include "assets/texture_asset.hpp"
@@ -26,13 +28,17 @@
 
 #include "components/actor.hpp"
 #include "components/camera.hpp"
+#include "components/collider.hpp"
 #include "components/flipbook_player.hpp"
 #include "components/flipbook_source.hpp"
 #include "components/model_renderer.hpp"
+#include "components/pending_instance.hpp"
 #include "components/renderer.hpp"
 #include "components/scene.hpp"
+#include "components/shape_renderer.hpp"
 #include "components/sprite_renderer.hpp"
 
+#include "systems/collision_system.hpp"
 #include "systems/flipbook_system.hpp"
 #include "systems/render_system.hpp"
 
@@ -40,6 +46,8 @@
 #include "asset.hpp"
 #include "asset.inl"
 #include "atlas.hpp"
+#include "collision.hpp"
+#include "dynamic_resolution.hpp"
 #include "factory.hpp"
 #include "factory.inl"
 #include "flipbook.hpp"
@@ -50,6 +58,10 @@
 #include "node.hpp"
 #include "node.inl"
 #include "prefab.hpp"
+#include "render_graph.hpp"
+#include "shader_variants.hpp"
+#include "shared_property_block.hpp"
+#include "snapshot.hpp"
 #include "sprite.hpp"
 #include "starter.hpp"
 #include "world.hpp"
@@ -31,6 +31,8 @@ namespace e2d
     class prefab_asset;
     class shader_asset;
     class shape_asset;
+    class snapshot_asset;
+    class sound_asset;
     class sprite_asset;
     class text_asset;
     class texture_asset;
@@ -38,13 +40,17 @@ namespace e2d
 
     class actor;
     class camera;
+    class collider;
     class flipbook_player;
     class flipbook_source;
     class model_renderer;
+    class pending_instance;
     class renderer;
     class scene;
+    class shape_renderer;
     class sprite_renderer;
 
+    class collision_system;
     class flipbook_system;
     class render_system;
 
@@ -59,11 +65,14 @@ namespace e2d
     class asset_dependencies;
 
     class atlas;
+    class collision;
     class flipbook;
     class gobject;
     class model;
     class node;
     class prefab;
+    class shader_variants;
+    class shared_property_block;
     class sprite;
     class starter;
     class world;
@@ -12,4 +12,7 @@ namespace e2d { namespace address
 {
     str parent(str_view address);
     str nested(str_view address);
+
+    str_view parent_view(str_view address) noexcept;
+    str_view nested_view(str_view address) noexcept;
 }}
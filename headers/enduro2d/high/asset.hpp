@@ -39,6 +39,16 @@ namespace e2d
         asset() = default;
         virtual ~asset() noexcept = default;
         virtual asset_ptr find_nested_asset(str_view nested_address) const noexcept = 0;
+
+        // unique for every asset and changed by every content fill,
+        // unlike addresses generations are never reused
+        u64 generation() const noexcept;
+    protected:
+        void next_generation() noexcept;
+    private:
+        static u64 make_generation() noexcept;
+    private:
+        u64 generation_{make_generation()};
     };
 
     //
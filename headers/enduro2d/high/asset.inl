@@ -13,6 +13,23 @@
 
 namespace e2d
 {
+    //
+    // asset
+    //
+
+    inline u64 asset::generation() const noexcept {
+        return generation_;
+    }
+
+    inline void asset::next_generation() noexcept {
+        generation_ = make_generation();
+    }
+
+    inline u64 asset::make_generation() noexcept {
+        static std::atomic<u64> last_generation{0u};
+        return last_generation.fetch_add(1u, std::memory_order_relaxed) + 1u;
+    }
+
     //
     // content_asset
     //
@@ -42,12 +59,14 @@ namespace e2d
     template < typename Asset, typename Content >
     void content_asset<Asset, Content>::fill(Content content) {
         content_ = std::move(content);
+        next_generation();
     }
 
     template < typename Asset, typename Content >
     void content_asset<Asset, Content>::fill(Content content, nested_content nested_content) {
         content_ = std::move(content);
         nested_content_ = std::move(nested_content);
+        next_generation();
     }
 
     template < typename Asset, typename Content >
@@ -63,11 +82,11 @@ namespace e2d
 
     template < typename Asset, typename Content >
     asset_ptr content_asset<Asset, Content>::find_nested_asset(str_view address) const noexcept {
-        const auto iter = nested_content_.find(make_hash(address::parent(address)));
+        const auto iter = nested_content_.find(make_hash(address::parent_view(address)));
         if ( iter == nested_content_.end() ) {
             return nullptr;
         }
-        const str nested_asset = address::nested(address);
+        const str_view nested_asset = address::nested_view(address);
         return nested_asset.empty()
             ? iter->second
             : iter->second->find_nested_asset(nested_asset);
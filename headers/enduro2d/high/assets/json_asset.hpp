@@ -12,7 +12,7 @@
 
 namespace e2d
 {
-    using json_uptr = std::unique_ptr<rapidjson::Document>;
+    using json_uptr = json_document_uptr;
     class json_asset final : public content_asset<json_asset, json_uptr> {
     public:
         static const char* type_name() noexcept { return "json_asset"; }
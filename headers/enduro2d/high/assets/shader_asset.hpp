@@ -9,10 +9,11 @@
 #include "../_high.hpp"
 
 #include "../library.hpp"
+#include "../shader_variants.hpp"
 
 namespace e2d
 {
-    class shader_asset final : public content_asset<shader_asset, shader_ptr> {
+    class shader_asset final : public content_asset<shader_asset, shader_variants> {
     public:
         static const char* type_name() noexcept { return "shader_asset"; }
         static load_async_result load_async(const library& library, str_view address);
@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_high.hpp"
+
+namespace e2d
+{
+    //
+    // collision
+    //
+    // Broadphase over entities with 'actor' and 'collider' components.
+    // Proxies live in a dynamic AABB tree which is synchronized with
+    // node transforms by 'update' (see 'collision_system'). All queries
+    // are const and may be issued from several threads at once, but not
+    // concurrently with 'update'. Two colliders can interact only when
+    // the layer of each one is accepted by the mask of the other.
+    //
+
+    class collision final : public module<collision> {
+    public:
+        class parameters;
+
+        struct contact final {
+            ecs::entity_id first{0u};
+            ecs::entity_id second{0u};
+        };
+
+        struct ray final {
+            v2f origin;
+            v2f direction;
+            f32 distance{0.f};
+            u32 mask{~0u};
+        };
+
+        struct raycast_hit final {
+            bool hit{false};
+            ecs::entity_id entity{0u};
+            v2f point;
+            v2f normal;
+            f32 distance{0.f};
+        };
+    public:
+        collision();
+        collision(const parameters& params);
+        ~collision() noexcept final;
+
+        void update(ecs::registry& owner);
+        void clear() noexcept;
+
+        std::size_t proxy_count() const noexcept;
+        std::size_t tree_height() const noexcept;
+
+        // all touching pairs (first < second)
+        void find_contacts(vector<contact>& result) const;
+
+        // entities touching the area
+        void overlap(
+            const b2f& area,
+            u32 mask,
+            vector<ecs::entity_id>& result) const;
+
+        // batched overlap, results[i] matches areas[i]
+        void overlap(
+            const vector<b2f>& areas,
+            u32 mask,
+            vector<vector<ecs::entity_id>>& results) const;
+
+        // closest hit along the ray
+        bool raycast(
+            const ray& r,
+            raycast_hit& result) const;
+
+        // batched raycast, results[i] matches rays[i]
+        void raycast(
+            const vector<ray>& rays,
+            vector<raycast_hit>& results) const;
+    private:
+        class internal_state;
+        std::unique_ptr<internal_state> state_;
+    };
+
+    //
+    // collision::parameters
+    //
+
+    class collision::parameters {
+    public:
+        parameters& fat_margin(f32 value) noexcept;
+        parameters& parallel_threshold(std::size_t value) noexcept;
+
+        f32 fat_margin() const noexcept;
+        std::size_t parallel_threshold() const noexcept;
+    private:
+        f32 fat_margin_{4.f};
+        std::size_t parallel_threshold_{1024u};
+    };
+}
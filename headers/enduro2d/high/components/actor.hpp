@@ -39,6 +39,22 @@ namespace e2d
             asset_dependencies& dependencies,
             const collect_context& ctx) const;
     };
+
+    template <>
+    class factory_serializer<actor> final : factory_serializer<> {
+    public:
+        bool operator()(
+            const actor& component,
+            const save_context& ctx) const;
+
+        bool operator()(
+            actor& component,
+            const load_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
 }
 
 namespace e2d
@@ -22,17 +22,23 @@ namespace e2d
         camera& target(const render_target_ptr& value) noexcept;
         camera& background(const color& value) noexcept;
 
+        // redraw only changed regions over the previous frame
+        // contents (see 'render_system')
+        camera& partial_redraw(bool value) noexcept;
+
         i32 depth() const noexcept;
         const b2u& viewport() const noexcept;
         const m4f& projection() const noexcept;
         const render_target_ptr& target() const noexcept;
         const color& background() const noexcept;
+        bool partial_redraw() const noexcept;
     private:
         i32 depth_ = 0;
         b2u viewport_ = b2u::zero();
         m4f projection_ = m4f::identity();
         render_target_ptr target_ = nullptr;
         color background_ = color::clear();
+        bool partial_redraw_ = false;
     };
 
     template <>
@@ -48,6 +54,22 @@ namespace e2d
             asset_dependencies& dependencies,
             const collect_context& ctx) const;
     };
+
+    template <>
+    class factory_serializer<camera> final : factory_serializer<> {
+    public:
+        bool operator()(
+            const camera& component,
+            const save_context& ctx) const;
+
+        bool operator()(
+            camera& component,
+            const load_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
 }
 
 namespace e2d
@@ -77,6 +99,11 @@ namespace e2d
         return *this;
     }
 
+    inline camera& camera::partial_redraw(bool value) noexcept {
+        partial_redraw_ = value;
+        return *this;
+    }
+
     inline i32 camera::depth() const noexcept {
         return depth_;
     }
@@ -96,4 +123,8 @@ namespace e2d
     inline const color& camera::background() const noexcept {
         return background_;
     }
+
+    inline bool camera::partial_redraw() const noexcept {
+        return partial_redraw_;
+    }
 }
@@ -0,0 +1,154 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "../_high.hpp"
+
+#include "../factory.hpp"
+#include "../assets/shape_asset.hpp"
+
+namespace e2d
+{
+    class collider final {
+    public:
+        enum class types : u8 {
+            circle,
+            rect,
+            polygon
+        };
+    public:
+        collider() = default;
+
+        // shapes (in the local space of the actor node)
+
+        collider& circle(const v2f& center, f32 radius) noexcept;
+        collider& rect(const b2f& rect) noexcept;
+
+        // vertices are reduced to their convex hull
+        collider& polygon(const vector<v2f>& vertices);
+        collider& polygon(const shape& shape);
+
+        types type() const noexcept;
+        const v2f& center() const noexcept;
+        f32 radius() const noexcept;
+        const b2f& rect() const noexcept;
+        const vector<v2f>& vertices() const noexcept;
+
+        // filtering
+
+        collider& layer(u32 value) noexcept;
+        u32 layer() const noexcept;
+
+        collider& mask(u32 value) noexcept;
+        u32 mask() const noexcept;
+
+        collider& enabled(bool value) noexcept;
+        bool enabled() const noexcept;
+    private:
+        types type_ = types::rect;
+        v2f center_;
+        f32 radius_ = 0.f;
+        b2f rect_;
+        vector<v2f> vertices_;
+        u32 layer_ = 1u;
+        u32 mask_ = ~0u;
+        bool enabled_ = true;
+    };
+
+    template <>
+    class factory_loader<collider> final : factory_loader<> {
+    public:
+        static const char* schema_source;
+
+        bool operator()(
+            collider& component,
+            const fill_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
+
+    template <>
+    class factory_serializer<collider> final : factory_serializer<> {
+    public:
+        bool operator()(
+            const collider& component,
+            const save_context& ctx) const;
+
+        bool operator()(
+            collider& component,
+            const load_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
+}
+
+namespace e2d
+{
+    inline collider& collider::circle(const v2f& center, f32 radius) noexcept {
+        type_ = types::circle;
+        center_ = center;
+        radius_ = radius;
+        return *this;
+    }
+
+    inline collider& collider::rect(const b2f& rect) noexcept {
+        type_ = types::rect;
+        rect_ = rect;
+        return *this;
+    }
+
+    inline collider::types collider::type() const noexcept {
+        return type_;
+    }
+
+    inline const v2f& collider::center() const noexcept {
+        return center_;
+    }
+
+    inline f32 collider::radius() const noexcept {
+        return radius_;
+    }
+
+    inline const b2f& collider::rect() const noexcept {
+        return rect_;
+    }
+
+    inline const vector<v2f>& collider::vertices() const noexcept {
+        return vertices_;
+    }
+
+    inline collider& collider::layer(u32 value) noexcept {
+        layer_ = value;
+        return *this;
+    }
+
+    inline u32 collider::layer() const noexcept {
+        return layer_;
+    }
+
+    inline collider& collider::mask(u32 value) noexcept {
+        mask_ = value;
+        return *this;
+    }
+
+    inline u32 collider::mask() const noexcept {
+        return mask_;
+    }
+
+    inline collider& collider::enabled(bool value) noexcept {
+        enabled_ = value;
+        return *this;
+    }
+
+    inline bool collider::enabled() const noexcept {
+        return enabled_;
+    }
+}
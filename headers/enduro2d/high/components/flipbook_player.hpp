@@ -14,6 +14,26 @@
 namespace e2d
 {
     class flipbook_player final {
+    public:
+        // resolved playback data, maintained by flipbook_system,
+        // copies are unresolved and resolved again by the system
+        struct playback_state {
+            playback_state() = default;
+            playback_state(playback_state&& other) noexcept = default;
+            playback_state& operator=(playback_state&& other) noexcept = default;
+
+            playback_state(const playback_state& other) noexcept;
+            playback_state& operator=(const playback_state& other) noexcept;
+
+            bool resolved{false};
+            flipbook_asset::ptr flipbook;
+            str_hash sequence_name;
+            const flipbook::sequence* sequence{nullptr};
+            const flipbook::frame* frame{nullptr};
+            std::size_t frame_index{0u};
+            f32 frame_begin{0.f};
+            f32 frame_end{0.f};
+        };
     public:
         flipbook_player() = default;
 
@@ -44,12 +64,18 @@ namespace e2d
 
         flipbook_player& play(f32 ntime) noexcept;
         flipbook_player& play(str_hash nsequence) noexcept;
+
+        // playback
+
+        playback_state& playback() noexcept;
+        const playback_state& playback() const noexcept;
     private:
         f32 time_{0.f};
         f32 speed_{1.f};
         bool looped_{false};
         bool playing_{false};
         str_hash sequence_;
+        playback_state playback_;
     };
 
     template <>
@@ -65,10 +91,46 @@ namespace e2d
             asset_dependencies& dependencies,
             const collect_context& ctx) const;
     };
+
+    template <>
+    class factory_serializer<flipbook_player> final : factory_serializer<> {
+    public:
+        bool operator()(
+            const flipbook_player& component,
+            const save_context& ctx) const;
+
+        bool operator()(
+            flipbook_player& component,
+            const load_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
 }
 
 namespace e2d
 {
+    inline flipbook_player::playback_state::playback_state(const playback_state& other) noexcept {
+        E2D_UNUSED(other);
+    }
+
+    inline flipbook_player::playback_state& flipbook_player::playback_state::operator=(
+        const playback_state& other) noexcept
+    {
+        if ( this != &other ) {
+            resolved = false;
+            flipbook.reset();
+            sequence_name = str_hash();
+            sequence = nullptr;
+            frame = nullptr;
+            frame_index = 0u;
+            frame_begin = 0.f;
+            frame_end = 0.f;
+        }
+        return *this;
+    }
+
     inline flipbook_player& flipbook_player::time(f32 value) noexcept {
         time_ = value;
         return *this;
@@ -138,4 +200,12 @@ namespace e2d
     inline flipbook_player& flipbook_player::play(str_hash nsequence) noexcept {
         return sequence(nsequence).play(0.f);
     }
+
+    inline flipbook_player::playback_state& flipbook_player::playback() noexcept {
+        return playback_;
+    }
+
+    inline const flipbook_player::playback_state& flipbook_player::playback() const noexcept {
+        return playback_;
+    }
 }
@@ -37,6 +37,22 @@ namespace e2d
             asset_dependencies& dependencies,
             const collect_context& ctx) const;
     };
+
+    template <>
+    class factory_serializer<flipbook_source> final : factory_serializer<> {
+    public:
+        bool operator()(
+            const flipbook_source& component,
+            const save_context& ctx) const;
+
+        bool operator()(
+            flipbook_source& component,
+            const load_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
 }
 
 namespace e2d
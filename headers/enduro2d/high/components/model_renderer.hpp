@@ -37,6 +37,22 @@ namespace e2d
             asset_dependencies& dependencies,
             const collect_context& ctx) const;
     };
+
+    template <>
+    class factory_serializer<model_renderer> final : factory_serializer<> {
+    public:
+        bool operator()(
+            const model_renderer& component,
+            const save_context& ctx) const;
+
+        bool operator()(
+            model_renderer& component,
+            const load_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
 }
 
 namespace e2d
@@ -0,0 +1,25 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "../_high.hpp"
+
+namespace e2d
+{
+    //
+    // pending_instance
+    //
+    // Marks gobjects of an unfinished 'world::instantiate_async' call.
+    // The world removes it when the instance is attached, until then
+    // systems iterating components must skip marked entities.
+    //
+
+    class pending_instance final {
+    public:
+        pending_instance() = default;
+    };
+}
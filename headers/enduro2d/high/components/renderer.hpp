@@ -9,6 +9,7 @@
 #include "../_high.hpp"
 
 #include "../factory.hpp"
+#include "../shared_property_block.hpp"
 #include "../assets/material_asset.hpp"
 
 namespace e2d
@@ -20,11 +21,15 @@ namespace e2d
         renderer& enabled(bool value) noexcept;
         bool enabled() const noexcept;
 
-        renderer& properties(render::property_block&& value) noexcept;
+        renderer& properties(render::property_block&& value);
         renderer& properties(const render::property_block& value);
+        renderer& properties(const shared_property_block& value) noexcept;
 
-        render::property_block& properties() noexcept;
-        const render::property_block& properties() const noexcept;
+        // 'f' changes a copy of the properties
+        template < typename F >
+        renderer& update_properties(F&& f);
+
+        const shared_property_block& properties() const noexcept;
 
         renderer& materials(vector<material_asset::ptr>&& value) noexcept;
         renderer& materials(const vector<material_asset::ptr>& value);
@@ -33,7 +38,7 @@ namespace e2d
         const vector<material_asset::ptr>& materials() const noexcept;
     private:
         bool enabled_ = true;
-        render::property_block properties_;
+        shared_property_block properties_;
         vector<material_asset::ptr> materials_;
     };
 
@@ -50,6 +55,22 @@ namespace e2d
             asset_dependencies& dependencies,
             const collect_context& ctx) const;
     };
+
+    template <>
+    class factory_serializer<renderer> final : factory_serializer<> {
+    public:
+        bool operator()(
+            const renderer& component,
+            const save_context& ctx) const;
+
+        bool operator()(
+            renderer& component,
+            const load_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
 }
 
 namespace e2d
@@ -63,21 +84,28 @@ namespace e2d
         return enabled_;
     }
 
-    inline renderer& renderer::properties(render::property_block&& value) noexcept {
-        properties_ = std::move(value);
+    inline renderer& renderer::properties(render::property_block&& value) {
+        properties_ = shared_property_block(std::move(value));
         return *this;
     }
 
     inline renderer& renderer::properties(const render::property_block& value) {
+        properties_ = shared_property_block(value);
+        return *this;
+    }
+
+    inline renderer& renderer::properties(const shared_property_block& value) noexcept {
         properties_ = value;
         return *this;
     }
 
-    inline render::property_block& renderer::properties() noexcept {
-        return properties_;
+    template < typename F >
+    renderer& renderer::update_properties(F&& f) {
+        properties_.update(std::forward<F>(f));
+        return *this;
     }
 
-    inline const render::property_block& renderer::properties() const noexcept {
+    inline const shared_property_block& renderer::properties() const noexcept {
         return properties_;
     }
 
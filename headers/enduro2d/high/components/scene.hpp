@@ -18,8 +18,13 @@ namespace e2d
 
         scene& depth(i32 value) noexcept;
         i32 depth() const noexcept;
+
+        // batch non-moving models with the same materials (see 'render_system')
+        scene& static_batching(bool value) noexcept;
+        bool static_batching() const noexcept;
     private:
         i32 depth_ = 0;
+        bool static_batching_ = false;
     };
 
     template <>
@@ -35,6 +40,22 @@ namespace e2d
             asset_dependencies& dependencies,
             const collect_context& ctx) const;
     };
+
+    template <>
+    class factory_serializer<scene> final : factory_serializer<> {
+    public:
+        bool operator()(
+            const scene& component,
+            const save_context& ctx) const;
+
+        bool operator()(
+            scene& component,
+            const load_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
 }
 
 namespace e2d
@@ -47,4 +68,13 @@ namespace e2d
     inline i32 scene::depth() const noexcept {
         return depth_;
     }
+
+    inline scene& scene::static_batching(bool value) noexcept {
+        static_batching_ = value;
+        return *this;
+    }
+
+    inline bool scene::static_batching() const noexcept {
+        return static_batching_;
+    }
 }
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "../_high.hpp"
+
+#include "../factory.hpp"
+#include "../assets/shape_asset.hpp"
+#include "../assets/texture_asset.hpp"
+
+namespace e2d
+{
+    //
+    // shape_renderer
+    //
+    // Draws all subshapes of the shape with the first material of the
+    // renderer through the sprite batcher. Vertex colors of the first
+    // channel are multiplied by the tint, texture coordinates are taken
+    // from the first channel.
+    //
+
+    class shape_renderer final {
+    public:
+        shape_renderer() = default;
+        shape_renderer(const shape_asset::ptr& shape);
+
+        shape_renderer& tint(const color32& value) noexcept;
+        const color32& tint() const noexcept;
+
+        shape_renderer& filtering(bool value) noexcept;
+        bool filtering() const noexcept;
+
+        shape_renderer& shape(const shape_asset::ptr& value) noexcept;
+        const shape_asset::ptr& shape() const noexcept;
+
+        // optional, the material's own texture is used without it
+        shape_renderer& texture(const texture_asset::ptr& value) noexcept;
+        const texture_asset::ptr& texture() const noexcept;
+    private:
+        color32 tint_ = color32::white();
+        bool filtering_ = true;
+        shape_asset::ptr shape_;
+        texture_asset::ptr texture_;
+    };
+
+    template <>
+    class factory_loader<shape_renderer> final : factory_loader<> {
+    public:
+        static const char* schema_source;
+
+        bool operator()(
+            shape_renderer& component,
+            const fill_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
+
+    template <>
+    class factory_serializer<shape_renderer> final : factory_serializer<> {
+    public:
+        bool operator()(
+            const shape_renderer& component,
+            const save_context& ctx) const;
+
+        bool operator()(
+            shape_renderer& component,
+            const load_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
+}
+
+namespace e2d
+{
+    inline shape_renderer::shape_renderer(const shape_asset::ptr& shape)
+    : shape_(shape) {}
+
+    inline shape_renderer& shape_renderer::tint(const color32& value) noexcept {
+        tint_ = value;
+        return *this;
+    }
+
+    inline const color32& shape_renderer::tint() const noexcept {
+        return tint_;
+    }
+
+    inline shape_renderer& shape_renderer::filtering(bool value) noexcept {
+        filtering_ = value;
+        return *this;
+    }
+
+    inline bool shape_renderer::filtering() const noexcept {
+        return filtering_;
+    }
+
+    inline shape_renderer& shape_renderer::shape(const shape_asset::ptr& value) noexcept {
+        shape_ = value;
+        return *this;
+    }
+
+    inline const shape_asset::ptr& shape_renderer::shape() const noexcept {
+        return shape_;
+    }
+
+    inline shape_renderer& shape_renderer::texture(const texture_asset::ptr& value) noexcept {
+        texture_ = value;
+        return *this;
+    }
+
+    inline const texture_asset::ptr& shape_renderer::texture() const noexcept {
+        return texture_;
+    }
+}
@@ -15,6 +15,16 @@
 namespace e2d
 {
     class sprite_renderer final {
+    public:
+        enum class modes : u8 {
+            simple,
+            sliced
+        };
+
+        struct sliced_geometry final {
+            std::array<v2f, 16> vertices;
+            std::array<v2f, 16> texcoords;
+        };
     public:
         sprite_renderer() = default;
         sprite_renderer(const sprite_asset::ptr& sprite);
@@ -22,15 +32,30 @@ namespace e2d
         sprite_renderer& tint(const color32& value) noexcept;
         const color32& tint() const noexcept;
 
+        sprite_renderer& size(const v2f& value) noexcept;
+        const v2f& size() const noexcept;
+
+        sprite_renderer& mode(modes value) noexcept;
+        modes mode() const noexcept;
+
         sprite_renderer& filtering(bool value) noexcept;
         bool filtering() const noexcept;
 
         sprite_renderer& sprite(const sprite_asset::ptr& value) noexcept;
         const sprite_asset::ptr& sprite() const noexcept;
+
+        // local space 4x4 vertex grid of the nine-slice mesh,
+        // rebuilt only after the sprite, size or mode were changed
+        const sliced_geometry& sliced() const noexcept;
     private:
         color32 tint_ = color32::white();
+        v2f size_;
+        modes mode_ = modes::simple;
         bool filtering_ = true;
         sprite_asset::ptr sprite_;
+    private:
+        mutable bool sliced_dirty_ = true;
+        mutable sliced_geometry sliced_;
     };
 
     template <>
@@ -46,6 +71,22 @@ namespace e2d
             asset_dependencies& dependencies,
             const collect_context& ctx) const;
     };
+
+    template <>
+    class factory_serializer<sprite_renderer> final : factory_serializer<> {
+    public:
+        bool operator()(
+            const sprite_renderer& component,
+            const save_context& ctx) const;
+
+        bool operator()(
+            sprite_renderer& component,
+            const load_context& ctx) const;
+
+        bool operator()(
+            asset_dependencies& dependencies,
+            const collect_context& ctx) const;
+    };
 }
 
 namespace e2d
@@ -62,6 +103,26 @@ namespace e2d
         return tint_;
     }
 
+    inline sprite_renderer& sprite_renderer::size(const v2f& value) noexcept {
+        size_ = value;
+        sliced_dirty_ = true;
+        return *this;
+    }
+
+    inline const v2f& sprite_renderer::size() const noexcept {
+        return size_;
+    }
+
+    inline sprite_renderer& sprite_renderer::mode(modes value) noexcept {
+        mode_ = value;
+        sliced_dirty_ = true;
+        return *this;
+    }
+
+    inline sprite_renderer::modes sprite_renderer::mode() const noexcept {
+        return mode_;
+    }
+
     inline sprite_renderer& sprite_renderer::filtering(bool value) noexcept {
         filtering_ = value;
         return *this;
@@ -73,6 +134,7 @@ namespace e2d
 
     inline sprite_renderer& sprite_renderer::sprite(const sprite_asset::ptr& value) noexcept {
         sprite_ = value;
+        sliced_dirty_ = true;
         return *this;
     }
 
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_high.hpp"
+
+namespace e2d
+{
+    //
+    // dynamic_resolution
+    //
+    // Chooses the render scale from the average of the last frame times.
+    // The scale goes down by one step when frames are slower than the
+    // target by 'downscale_threshold' and up when they are faster than
+    // 'upscale_threshold'. After a change the history is restarted, and
+    // the scale which was too slow is not tried again for a period which
+    // doubles on every repeated failure.
+    //
+    // 'render_system' renders cameras without a target at the current
+    // scale and upscales them to the main framebuffer.
+    //
+
+    class dynamic_resolution final : public module<dynamic_resolution> {
+    public:
+        class parameters;
+    public:
+        dynamic_resolution();
+        dynamic_resolution(const parameters& params);
+        ~dynamic_resolution() noexcept final;
+
+        // returns true when the scale changed
+        bool update(f32 frame_time) noexcept;
+        void reset() noexcept;
+
+        bool enabled() const noexcept;
+        f32 scale() const noexcept;
+        f32 smoothed_frame_time() const noexcept;
+        const parameters& params() const noexcept;
+
+        // at least one pixel on each side
+        v2u scaled_size(const v2u& size) const noexcept;
+    private:
+        class internal_state;
+        std::unique_ptr<internal_state> state_;
+    };
+
+    //
+    // dynamic_resolution::parameters
+    //
+
+    class dynamic_resolution::parameters {
+    public:
+        parameters& enabled(bool value) noexcept;
+        parameters& min_scale(f32 value) noexcept;
+        parameters& max_scale(f32 value) noexcept;
+        parameters& scale_step(f32 value) noexcept;
+        parameters& target_frame_time(f32 value) noexcept;
+        parameters& downscale_threshold(f32 value) noexcept;
+        parameters& upscale_threshold(f32 value) noexcept;
+        parameters& history_size(std::size_t value) noexcept;
+
+        bool enabled() const noexcept;
+        f32 min_scale() const noexcept;
+        f32 max_scale() const noexcept;
+        f32 scale_step() const noexcept;
+        f32 target_frame_time() const noexcept;
+        f32 downscale_threshold() const noexcept;
+        f32 upscale_threshold() const noexcept;
+        std::size_t history_size() const noexcept;
+    private:
+        bool enabled_{false};
+        f32 min_scale_{0.5f};
+        f32 max_scale_{1.f};
+        f32 scale_step_{0.1f};
+        f32 target_frame_time_{1.f / 60.f};
+        f32 downscale_threshold_{1.15f};
+        f32 upscale_threshold_{1.05f};
+        std::size_t history_size_{30u};
+    };
+}
@@ -10,6 +10,8 @@
 
 #include "_high.hpp"
 
+#include "library.hpp"
+
 namespace e2d
 {
     //
@@ -59,6 +61,89 @@ namespace e2d
         };
     };
 
+    //
+    // factory_serializer
+    //
+
+    template < typename Component = void >
+    class factory_serializer;
+
+    template <>
+    class factory_serializer<> {
+    public:
+        // asset pointer to address mapping used by snapshot saving
+        using asset_addresses = hash_map<const asset*, str>;
+
+        struct save_context {
+            output_sequence& stream;
+            const asset_addresses& addresses;
+
+            save_context(
+                output_sequence& nstream,
+                const asset_addresses& naddresses)
+            : stream(nstream)
+            , addresses(naddresses) {}
+        };
+
+        struct load_context {
+            input_sequence& stream;
+            const asset_group& dependencies;
+
+            load_context(
+                input_sequence& nstream,
+                const asset_group& ndependencies)
+            : stream(nstream)
+            , dependencies(ndependencies) {}
+        };
+
+        struct collect_context {
+            input_sequence& stream;
+
+            collect_context(input_sequence& nstream)
+            : stream(nstream) {}
+        };
+    protected:
+        template < typename T >
+        static bool write_value(const save_context& ctx, const T& value);
+
+        template < typename T >
+        static bool read_value(const load_context& ctx, T& value);
+
+        template < typename T >
+        static bool read_value(const collect_context& ctx, T& value);
+
+        // booleans are stored as one byte, other values are rejected
+        static bool write_value(const save_context& ctx, bool value);
+        static bool read_value(const load_context& ctx, bool& value);
+
+        // enumerations are stored by the underlying type, values
+        // after 'last' are rejected
+        template < typename E >
+        static bool read_enum(const load_context& ctx, E& value, E last);
+
+        // samplers reference runtime textures, they are not saved
+        static bool write_properties(const save_context& ctx, const render::property_block& value);
+        static bool read_properties(const load_context& ctx, render::property_block& value);
+        static bool skip_properties(const collect_context& ctx);
+
+        static bool write_string(const save_context& ctx, str_view value);
+        static bool read_string(input_sequence& stream, str& value);
+        static bool skip_bytes(const collect_context& ctx, std::size_t size);
+
+        // writes the address of the asset or an empty string for null assets
+        static bool write_address(const save_context& ctx, const asset* value);
+
+        template < typename Asset, typename Nested = Asset >
+        static bool read_asset(
+            const load_context& ctx,
+            typename Nested::load_result& value);
+
+        template < typename Asset, typename Nested = Asset >
+        static bool collect_asset(
+            asset_dependencies& dependencies,
+            const collect_context& ctx);
+    };
+
     //
     // factory_creator
     //
@@ -106,6 +191,60 @@ namespace e2d
         std::unique_ptr<rapidjson::SchemaDocument> schema_;
     };
 
+    //
+    // factory_serializer_creator
+    //
+
+    class factory_serializer_creator;
+    using factory_serializer_creator_iptr = intrusive_ptr<factory_serializer_creator>;
+
+    class factory_serializer_creator
+        : private noncopyable
+        , public ref_counter<factory_serializer_creator> {
+    public:
+        factory_serializer_creator() = default;
+        virtual ~factory_serializer_creator() noexcept = default;
+
+        virtual bool has_component(
+            const ecs::const_entity& entity) const = 0;
+
+        virtual bool save_component(
+            const ecs::const_entity& entity,
+            const factory_serializer<>::save_context& ctx) const = 0;
+
+        virtual bool load_component(
+            ecs::prototype& prototype,
+            const factory_serializer<>::load_context& ctx) const = 0;
+
+        virtual bool collect_dependencies(
+            asset_dependencies& dependencies,
+            const factory_serializer<>::collect_context& ctx) const = 0;
+    };
+
+    template < typename Component >
+    class typed_factory_serializer_creator final : public factory_serializer_creator {
+    public:
+        typed_factory_serializer_creator() = default;
+        ~typed_factory_serializer_creator() noexcept final = default;
+
+        bool has_component(
+            const ecs::const_entity& entity) const final;
+
+        bool save_component(
+            const ecs::const_entity& entity,
+            const factory_serializer<>::save_context& ctx) const final;
+
+        bool load_component(
+            ecs::prototype& prototype,
+            const factory_serializer<>::load_context& ctx) const final;
+
+        bool collect_dependencies(
+            asset_dependencies& dependencies,
+            const factory_serializer<>::collect_context& ctx) const final;
+    private:
+        factory_serializer<Component> serializer_;
+    };
+
     //
     // factory
     //
@@ -118,6 +257,9 @@ namespace e2d
         template < typename Component >
         factory& register_component(str_hash type);
 
+        template < typename Component >
+        factory& register_serializer(str_hash type);
+
         bool validate_json(
             str_hash type,
             const rapidjson::Value& root) const;
@@ -131,11 +273,27 @@ namespace e2d
             str_hash type,
             asset_dependencies& dependencies,
             const factory_loader<>::collect_context& ctx) const;
+
+        // binary component records: count, then type hash and data of each one
+
+        bool save_components(
+            const ecs::const_entity& entity,
+            const factory_serializer<>::save_context& ctx) const;
+
+        bool load_components(
+            ecs::prototype& prototype,
+            const factory_serializer<>::load_context& ctx) const;
+
+        bool collect_dependencies(
+            asset_dependencies& dependencies,
+            const factory_serializer<>::collect_context& ctx) const;
     private:
         factory_creator_iptr find_creator(str_hash type) const;
+        factory_serializer_creator_iptr find_serializer(str_hash type) const;
     private:
         mutable std::mutex mutex_;
         hash_map<str_hash, factory_creator_iptr> creators_;
+        hash_map<str_hash, factory_serializer_creator_iptr> serializers_;
     };
 }
 
@@ -13,6 +13,90 @@
 
 namespace e2d
 {
+    //
+    // factory_serializer
+    //
+
+    template < typename T >
+    bool factory_serializer<>::write_value(const save_context& ctx, const T& value) {
+        static_assert(
+            std::is_trivially_copyable<T>::value,
+            "value type must be trivially copyable");
+        return ctx.stream.write(&value, sizeof(value)).success();
+    }
+
+    template < typename T >
+    bool factory_serializer<>::read_value(const load_context& ctx, T& value) {
+        static_assert(
+            std::is_trivially_copyable<T>::value,
+            "value type must be trivially copyable");
+        static_assert(
+            !std::is_enum<T>::value,
+            "enumerations must be read by 'read_enum'");
+        return ctx.stream.read(&value, sizeof(value)).success();
+    }
+
+    template < typename T >
+    bool factory_serializer<>::read_value(const collect_context& ctx, T& value) {
+        static_assert(
+            std::is_trivially_copyable<T>::value,
+            "value type must be trivially copyable");
+        return ctx.stream.read(&value, sizeof(value)).success();
+    }
+
+    template < typename E >
+    bool factory_serializer<>::read_enum(const load_context& ctx, E& value, E last) {
+        static_assert(std::is_enum<E>::value, "value type must be an enumeration");
+        using underlying_type = std::underlying_type_t<E>;
+        underlying_type raw = 0;
+        if ( !ctx.stream.read(&raw, sizeof(raw)).success() ) {
+            return false;
+        }
+        if ( raw < underlying_type(0) || raw > static_cast<underlying_type>(last) ) {
+            return false;
+        }
+        value = static_cast<E>(raw);
+        return true;
+    }
+
+    template < typename Asset, typename Nested >
+    bool factory_serializer<>::read_asset(
+        const load_context& ctx,
+        typename Nested::load_result& value)
+    {
+        str address;
+        if ( !read_string(ctx.stream, address) ) {
+            return false;
+        }
+        if ( address.empty() ) {
+            value = nullptr;
+            return true;
+        }
+        value = ctx.dependencies.find_asset<Asset, Nested>(address);
+        if ( !value ) {
+            the<debug>().error("FACTORY: Component dependency is not found:\n"
+                "--> Dependency address: %0",
+                address);
+            return false;
+        }
+        return true;
+    }
+
+    template < typename Asset, typename Nested >
+    bool factory_serializer<>::collect_asset(
+        asset_dependencies& dependencies,
+        const collect_context& ctx)
+    {
+        str address;
+        if ( !read_string(ctx.stream, address) ) {
+            return false;
+        }
+        if ( !address.empty() ) {
+            dependencies.add_dependency<Asset, Nested>(address);
+        }
+        return true;
+    }
+
     //
     // typed_factory_creator
     //
@@ -73,6 +157,49 @@ namespace e2d
         return loader_(dependencies, ctx);
     }
 
+    //
+    // typed_factory_serializer_creator
+    //
+
+    template < typename Component >
+    bool typed_factory_serializer_creator<Component>::has_component(
+        const ecs::const_entity& entity) const
+    {
+        return entity.exists_component<Component>();
+    }
+
+    template < typename Component >
+    bool typed_factory_serializer_creator<Component>::save_component(
+        const ecs::const_entity& entity,
+        const factory_serializer<>::save_context& ctx) const
+    {
+        return serializer_(entity.get_component<Component>(), ctx);
+    }
+
+    template < typename Component >
+    bool typed_factory_serializer_creator<Component>::load_component(
+        ecs::prototype& prototype,
+        const factory_serializer<>::load_context& ctx) const
+    {
+        Component component;
+        prototype.apply_to_component(component);
+
+        if ( !serializer_(component, ctx) ) {
+            return false;
+        }
+
+        prototype.component<Component>(std::move(component));
+        return true;
+    }
+
+    template < typename Component >
+    bool typed_factory_serializer_creator<Component>::collect_dependencies(
+        asset_dependencies& dependencies,
+        const factory_serializer<>::collect_context& ctx) const
+    {
+        return serializer_(dependencies, ctx);
+    }
+
     //
     // factory
     //
@@ -87,5 +214,16 @@ namespace e2d
         creators_.emplace(type, std::move(creator));
         return *this;
     }
+
+    template < typename Component >
+    factory& factory::register_serializer(str_hash type) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if ( serializers_.count(type) > 0 ) {
+            throw bad_factory_operation();
+        }
+        factory_serializer_creator_iptr creator(new typed_factory_serializer_creator<Component>());
+        serializers_.emplace(type, std::move(creator));
+        return *this;
+    }
 }
 #endif
@@ -48,6 +48,6 @@ namespace e2d
 
     template < typename T >
     ecs::const_component<T> gobject::get_component() const noexcept {
-        return ecs::const_component<T>(entity_);
+        return ecs::const_component<T>(ecs::const_entity(entity_));
     }
 }
@@ -88,6 +88,11 @@ namespace e2d
 
         template < typename Asset, typename Nested = Asset >
         typename Nested::load_async_result load_asset_async(str_view address) const;
+
+        // raw file content by the asset address, it isn't cached
+        stdex::promise<buffer> load_content_async(
+            str_view address,
+            bool zero_terminated = false) const;
     private:
         template < typename Asset >
         vector<loading_asset_iptr>::iterator
@@ -64,6 +64,16 @@ namespace e2d
         return cache_;
     }
 
+    inline stdex::promise<buffer> library::load_content_async(
+        str_view address,
+        bool zero_terminated) const
+    {
+        if ( cancelled_ ) {
+            return stdex::make_rejected_promise<buffer>(library_cancelled_exception());
+        }
+        return the<vfs>().load_async(root_ / address, zero_terminated);
+    }
+
     inline std::size_t library::unload_unused_assets() noexcept {
         return cache_.unload_unused_assets();
     }
@@ -82,7 +92,7 @@ namespace e2d
 
     template < typename Asset >
     typename Asset::load_async_result library::load_main_asset_async(str_view address) const {
-        const str main_address = address::parent(address);
+        const str_view main_address = address::parent_view(address);
         const str_hash main_address_hash = make_hash(main_address);
 
         std::lock_guard<std::recursive_mutex> guard(mutex_);
@@ -110,7 +120,7 @@ namespace e2d
             return new_asset;
         }).except([
             this,
-            main_address,
+            main_address = str(main_address),
             main_address_hash
         ](std::exception_ptr e) -> typename Asset::load_result {
             {
@@ -158,7 +168,7 @@ namespace e2d
         return load_main_asset_async<Asset>(address)
         .then([
             address = str(address),
-            nested_address = address::nested(address)
+            nested_address = str(address::nested_view(address))
         ](const typename Asset::load_result& main_asset){
             typename Nested::load_result nested_asset = nested_address.empty()
                 ? dynamic_pointer_cast<Nested>(main_asset)
@@ -247,12 +257,12 @@ namespace e2d
 
     template < typename Asset, typename Nested >
     typename Nested::load_result asset_group::find_asset(str_view address) const {
-        const str main_address = address::parent(address);
-        const str nested_address = address::nested(address);
+        const str_view main_address = address::parent_view(address);
+        const str_view nested_address = address::nested_view(address);
         auto iter = std::lower_bound(
             assets_.begin(), assets_.end(), main_address,
-            [](const auto& l, const str& r) noexcept {
-                return l.first < r;
+            [](const auto& l, str_view r) noexcept {
+                return str_view(l.first) < r;
             });
         for ( ; iter != assets_.end() && iter->first == main_address; ++iter ) {
             asset_ptr main_asset = iter->second;
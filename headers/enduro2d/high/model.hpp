@@ -32,12 +32,43 @@ namespace e2d
         model& set_mesh(const mesh_asset::ptr& mesh);
         const mesh_asset::ptr& mesh() const noexcept;
 
+        // Level 0 is 'mesh', coarser levels are used while the projected
+        // bounding sphere diameter is less than their 'screen_size'
+        // fraction of the viewport height
+        model& add_lod(const mesh_asset::ptr& mesh, f32 screen_size);
+        model& clear_lods() noexcept;
+
+        std::size_t lod_count() const noexcept;
+        const mesh_asset::ptr& lod_mesh(std::size_t level) const noexcept;
+        const render::geometry& lod_geometry(std::size_t level) const noexcept;
+        f32 lod_screen_size(std::size_t level) const noexcept;
+
+        // keeps the current level while the screen size stays within
+        // 'hysteresis' fraction of the switching size
+        std::size_t select_lod(
+            f32 screen_size,
+            std::size_t current,
+            f32 hysteresis) const noexcept;
+
+        // of the level 0 mesh in model space
+        const v3f& bounds_center() const noexcept;
+        f32 bounds_radius() const noexcept;
+
         // It can only be called from the main thread
         void regenerate_geometry(render& render);
         const render::geometry& geometry() const noexcept;
+    private:
+        struct lod final {
+            mesh_asset::ptr mesh;
+            render::geometry geometry;
+            f32 screen_size{0.f};
+        };
     private:
         mesh_asset::ptr mesh_;
         render::geometry geometry_;
+        vector<lod> lods_;
+        v3f bounds_center_;
+        f32 bounds_radius_{0.f};
     };
 
     void swap(model& l, model& r) noexcept;
@@ -57,6 +57,9 @@ namespace e2d
         const m4f& local_matrix() const noexcept;
         const m4f& world_matrix() const noexcept;
 
+        // changes every time the world matrix is recomputed
+        u32 world_matrix_version() const noexcept;
+
         node_iptr root() noexcept;
         const_node_iptr root() const noexcept;
 
@@ -153,6 +156,7 @@ namespace e2d
         mutable u32 flags_{0u};
         mutable m4f local_matrix_;
         mutable m4f world_matrix_;
+        mutable u32 world_matrix_version_{0u};
     };
 }
 
@@ -0,0 +1,194 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_high.hpp"
+
+namespace e2d
+{
+    class bad_render_graph_operation final : public exception {
+    public:
+        const char* what() const noexcept final {
+            return "bad render graph operation";
+        }
+    };
+
+    //
+    // render_graph
+    //
+    // Frame description as a list of passes executed in the order of
+    // addition. Every pass renders to one target and may sample others.
+    //
+    // 'compile' culls passes whose results are never used, computes
+    // lifetimes of transient targets and assigns transient targets with
+    // the same description and disjoint lifetimes to one pooled render
+    // target. Imported targets (cameras, the main framebuffer) are
+    // always used.
+    //
+    // 'execute' switches targets and viewports only when they change and
+    // skips clears of targets which already hold the same cleared contents.
+    // Passes must not switch targets or viewports by themselves.
+    //
+
+    class render_graph final : private noncopyable {
+    public:
+        class resource;
+        class target_desc;
+        class pass_builder;
+        class pass_context;
+        class statistics;
+
+        using execute_func = std::function<void(render&, const pass_context&)>;
+    public:
+        render_graph();
+        ~render_graph() noexcept;
+
+        // removes all passes and resources, pooled targets are kept
+        void clear() noexcept;
+
+        // nullptr is the main framebuffer, importing a target twice
+        // returns the same resource
+        resource import_target(str_view name, const render_target_ptr& target);
+        resource create_target(str_view name, const target_desc& desc);
+
+        pass_builder add_pass(str_view name);
+
+        void compile();
+        void execute(render& render);
+
+        // valid after 'compile'
+        bool is_culled(std::size_t pass) const noexcept;
+        std::size_t physical_target(const resource& target) const noexcept;
+
+        std::size_t pass_count() const noexcept;
+        std::size_t pooled_target_count() const noexcept;
+        const statistics& stats() const noexcept;
+
+        void release_pooled_targets() noexcept;
+    private:
+        class internal_state;
+        std::unique_ptr<internal_state> state_;
+    };
+
+    //
+    // render_graph::resource
+    //
+
+    class render_graph::resource final {
+    public:
+        static constexpr std::size_t invalid_index = std::size_t(-1);
+    public:
+        resource() = default;
+        explicit resource(std::size_t index) noexcept;
+
+        bool valid() const noexcept;
+        std::size_t index() const noexcept;
+    private:
+        std::size_t index_ = invalid_index;
+    };
+
+    bool operator==(const render_graph::resource& l, const render_graph::resource& r) noexcept;
+    bool operator!=(const render_graph::resource& l, const render_graph::resource& r) noexcept;
+
+    //
+    // render_graph::target_desc
+    //
+
+    class render_graph::target_desc final {
+    public:
+        target_desc() = default;
+        target_desc(const v2u& size) noexcept;
+
+        target_desc& size(const v2u& value) noexcept;
+        target_desc& color_decl(const pixel_declaration& value) noexcept;
+        target_desc& depth_decl(const pixel_declaration& value) noexcept;
+        target_desc& external_texture(render_target::external_texture value) noexcept;
+
+        const v2u& size() const noexcept;
+        const pixel_declaration& color_decl() const noexcept;
+        const pixel_declaration& depth_decl() const noexcept;
+        render_target::external_texture external_texture() const noexcept;
+    private:
+        v2u size_;
+        pixel_declaration color_decl_ = pixel_declaration::pixel_type::rgba8;
+        pixel_declaration depth_decl_ = pixel_declaration::pixel_type::depth16;
+        render_target::external_texture external_texture_ = render_target::external_texture::color;
+    };
+
+    bool operator==(const render_graph::target_desc& l, const render_graph::target_desc& r) noexcept;
+    bool operator!=(const render_graph::target_desc& l, const render_graph::target_desc& r) noexcept;
+
+    //
+    // render_graph::pass_builder
+    //
+
+    class render_graph::pass_builder final {
+    public:
+        pass_builder(render_graph& graph, std::size_t index) noexcept;
+
+        pass_builder& target(const resource& value);
+        pass_builder& read(const resource& value);
+
+        // the default is to keep the previous contents of the target
+        pass_builder& clear(const render::clear_command& value);
+        pass_builder& discard() noexcept;
+
+        // the default viewport is the whole target
+        pass_builder& viewport(const b2u& value) noexcept;
+        pass_builder& scissor(const b2u& value) noexcept;
+
+        // never culled
+        pass_builder& side_effect() noexcept;
+
+        pass_builder& execute(execute_func value);
+
+        std::size_t index() const noexcept;
+    private:
+        render_graph& graph_;
+        std::size_t index_ = 0u;
+    };
+
+    //
+    // render_graph::pass_context
+    //
+
+    class render_graph::pass_context final : private noncopyable {
+    public:
+        pass_context(
+            const render_graph& graph,
+            const render_target_ptr& target,
+            const render::viewport_command& viewport) noexcept;
+
+        // physical target of the pass, nullptr is the main framebuffer
+        const render_target_ptr& target() const noexcept;
+
+        // physical target of the resource
+        const render_target_ptr& target(const resource& value) const;
+
+        const render::viewport_command& viewport() const noexcept;
+    private:
+        const render_graph& graph_;
+        const render_target_ptr& target_;
+        const render::viewport_command& viewport_;
+    };
+
+    //
+    // render_graph::statistics
+    //
+
+    class render_graph::statistics final {
+    public:
+        u32 passes{0u};
+        u32 culled_passes{0u};
+        u32 transient_targets{0u};
+        u32 physical_targets{0u};
+        u32 target_switches{0u};
+        u32 viewport_switches{0u};
+        u32 clears{0u};
+        u32 skipped_clears{0u};
+    };
+}
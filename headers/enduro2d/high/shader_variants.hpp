@@ -0,0 +1,90 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_high.hpp"
+
+namespace e2d
+{
+    class bad_shader_variants_operation final : public exception {
+    public:
+        const char* what() const noexcept final {
+            return "bad shader variants operation";
+        }
+    };
+
+    //
+    // shader_variants
+    //
+    // Shader sources with declared keywords. A variant is compiled with
+    // '#define KEYWORD 1' for every enabled keyword, inserted after the
+    // '#version' line of both sources, comments before it are skipped. Variants are compiled on the first
+    // request and cached by the keyword mask, copies share the cache.
+    //
+
+    class shader_variants final {
+    public:
+        using keyword_mask = u32;
+        static constexpr std::size_t max_keyword_count = 32;
+
+        class variant_usage final {
+        public:
+            keyword_mask mask{0u};
+            u32 requests{0u};
+            bool compiled{false};
+        };
+    public:
+        shader_variants();
+        ~shader_variants() noexcept;
+
+        shader_variants(shader_variants&& other) noexcept;
+        shader_variants& operator=(shader_variants&& other) noexcept;
+
+        shader_variants(const shader_variants& other);
+        shader_variants& operator=(const shader_variants& other);
+
+        shader_variants(str vertex, str fragment, vector<str> keywords = {});
+
+        void clear() noexcept;
+        void swap(shader_variants& other) noexcept;
+
+        shader_variants& assign(shader_variants&& other) noexcept;
+        shader_variants& assign(const shader_variants& other);
+
+        const str& vertex_source() const noexcept;
+        const str& fragment_source() const noexcept;
+        const vector<str>& keywords() const noexcept;
+
+        // returns false if any of the keywords is not declared
+        bool try_make_mask(const vector<str>& keywords, keyword_mask& mask) const noexcept;
+        vector<str> mask_keywords(keyword_mask mask) const;
+
+        // sources of the variant with the keyword defines
+        str variant_vertex_source(keyword_mask mask) const;
+        str variant_fragment_source(keyword_mask mask) const;
+
+        // It can only be called from the main thread
+        shader_ptr variant(render& render, keyword_mask mask) const;
+        // compiles the variant without counting it as requested
+        shader_ptr prewarm(render& render, keyword_mask mask) const;
+
+        // requested and prewarmed variants ordered by the mask
+        vector<variant_usage> usage() const;
+    private:
+        struct cache_state;
+        shader_ptr compile_(render& render, keyword_mask mask, bool request) const;
+    private:
+        str vertex_;
+        str fragment_;
+        vector<str> keywords_;
+        std::shared_ptr<cache_state> cache_;
+    };
+
+    void swap(shader_variants& l, shader_variants& r) noexcept;
+    bool operator==(const shader_variants& l, const shader_variants& r) noexcept;
+    bool operator!=(const shader_variants& l, const shader_variants& r) noexcept;
+}
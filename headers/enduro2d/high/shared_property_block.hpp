@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_high.hpp"
+
+namespace e2d
+{
+    //
+    // shared_property_block
+    //
+    // Immutable reference counted property block. Blocks with bitwise
+    // identical contents are interned and share one instance, so handles
+    // are compared by pointer. Updates intern a changed copy of the block.
+    // Every interned instance has an unique id which is never reused.
+    //
+
+    class shared_property_block final {
+    public:
+        shared_property_block() = default;
+
+        explicit shared_property_block(render::property_block&& block);
+        explicit shared_property_block(const render::property_block& block);
+
+        // 'f' changes a copy of the block
+        template < typename F >
+        shared_property_block& update(F&& f);
+
+        bool empty() const noexcept;
+        bool equals(const shared_property_block& other) const noexcept;
+
+        // zero for the empty block
+        u64 id() const noexcept;
+
+        const render::property_block& get() const noexcept;
+        const render::property_block& operator*() const noexcept;
+        const render::property_block* operator->() const noexcept;
+
+        // number of interned blocks in use
+        static std::size_t instance_count();
+    private:
+        // initialized before the block, which sets it
+        u64 id_{0u};
+        std::shared_ptr<const render::property_block> block_;
+    };
+
+    bool operator==(const shared_property_block& l, const shared_property_block& r) noexcept;
+    bool operator!=(const shared_property_block& l, const shared_property_block& r) noexcept;
+}
+
+namespace e2d
+{
+    template < typename F >
+    shared_property_block& shared_property_block::update(F&& f) {
+        render::property_block block = get();
+        std::forward<F>(f)(block);
+        return *this = shared_property_block(std::move(block));
+    }
+}
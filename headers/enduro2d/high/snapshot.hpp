@@ -0,0 +1,44 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_high.hpp"
+
+#include "factory.hpp"
+#include "gobject.hpp"
+#include "library.hpp"
+#include "prefab.hpp"
+
+namespace e2d { namespace snapshots
+{
+    //
+    // Binary snapshot of a gobject subtree: components of every gobject
+    // written by serializers registered in the factory, followed by its
+    // node children. Assets are referenced by the addresses from the map.
+    // A loaded snapshot is a prefab, so the whole subtree is attached to
+    // the world by one 'world::instantiate' call.
+    //
+
+    bool try_save_snapshot(
+        const const_gobject_iptr& root,
+        const factory_serializer<>::asset_addresses& addresses,
+        buffer& dst) noexcept;
+
+    bool try_save_snapshot(
+        const const_gobject_iptr& root,
+        const factory_serializer<>::asset_addresses& addresses,
+        const output_stream_uptr& dst) noexcept;
+
+    bool try_collect_dependencies(
+        asset_dependencies& dst,
+        const buffer& src) noexcept;
+
+    bool try_load_snapshot(
+        prefab& dst,
+        const buffer& src,
+        const asset_group& dependencies) noexcept;
+}}
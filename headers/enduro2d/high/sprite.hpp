@@ -31,14 +31,17 @@ namespace e2d
 
         sprite& set_pivot(const v2f& pivot) noexcept;
         sprite& set_texrect(const b2f& texrect) noexcept;
+        sprite& set_borders(const v4f& borders) noexcept;
         sprite& set_texture(const texture_asset::ptr& texture) noexcept;
 
         const v2f& pivot() const noexcept;
         const b2f& texrect() const noexcept;
+        const v4f& borders() const noexcept;
         const texture_asset::ptr& texture() const noexcept;
     private:
         v2f pivot_;
         b2f texrect_;
+        v4f borders_;
         texture_asset::ptr texture_;
     };
 
@@ -8,6 +8,9 @@
 
 #include "_high.hpp"
 
+#include "dynamic_resolution.hpp"
+#include "systems/render_system.hpp"
+
 namespace e2d
 {
     //
@@ -27,6 +30,8 @@ namespace e2d
         template < typename HighApplication, typename... Args >
         bool start(Args&&... args);
         bool start(application_uptr app);
+    private:
+        render_system::parameters render_params_;
     };
 
     //
@@ -52,15 +57,23 @@ namespace e2d
 
         parameters& library_root(const url& value);
         parameters& engine_params(const engine::parameters& value);
+        parameters& render_params(const render_system::parameters& value);
+        parameters& dynamic_resolution_params(const dynamic_resolution::parameters& value);
 
         url& library_root() noexcept;
         engine::parameters& engine_params() noexcept;
+        render_system::parameters& render_params() noexcept;
+        dynamic_resolution::parameters& dynamic_resolution_params() noexcept;
 
         const url& library_root() const noexcept;
         const engine::parameters& engine_params() const noexcept;
+        const render_system::parameters& render_params() const noexcept;
+        const dynamic_resolution::parameters& dynamic_resolution_params() const noexcept;
     private:
         url library_root_{"resources://bin/library"};
         engine::parameters engine_params_;
+        render_system::parameters render_params_;
+        dynamic_resolution::parameters dynamic_resolution_params_;
     };
 }
 
@@ -10,13 +10,84 @@
 
 namespace e2d
 {
+    //
+    // render_system
+    //
+    // Cameras with 'partial_redraw' redraw only regions changed since
+    // the previous frame and skip frames without changes. Cameras
+    // without a target redraw a cached copy of their viewport which
+    // is copied to the main framebuffer.
+    //
+    // When 'dynamic_resolution' is enabled, other cameras without a target
+    // are rendered at its current scale and upscaled to the main framebuffer.
+    //
+    // Models of scenes with 'static_batching' are merged into pre-transformed
+    // batches per material when the scene is drawn for the first time. Batched
+    // nodes which move or change fall back to regular drawing.
+    //
+    // Models with levels of detail are drawn at the level selected by the
+    // projected size of their bounding sphere, separately for every camera.
+    //
+    // With 'pipelining', drawables are copied to a snapshot which is recorded
+    // on a render thread while the main thread simulates the next frame.
+    // Recordings are submitted by the main thread one frame later. It is
+    // off by default, the render thread pays only on machines with a free
+    // core for it, and sample_05 '--headless' measures both modes.
+    //
+
     class render_system final : public ecs::system {
+    public:
+        class parameters;
+        class statistics;
     public:
         render_system();
+        render_system(const parameters& params);
         ~render_system() noexcept final;
         void process(ecs::registry& owner) override;
+
+        // of the last processed frame
+        const statistics& stats() const noexcept;
     private:
         class internal_state;
         std::unique_ptr<internal_state> state_;
     };
+
+    //
+    // render_system::parameters
+    //
+
+    class render_system::parameters final {
+    public:
+        parameters& pipelining(bool value) noexcept;
+        bool pipelining() const noexcept;
+    private:
+        bool pipelining_ = false;
+    };
+
+    //
+    // render_system::statistics
+    //
+
+    class render_system::statistics final {
+    public:
+        u32 cameras{0u};
+        u32 partial_cameras{0u};
+        u32 skipped_cameras{0u};
+        u32 dirty_regions{0u};
+        u64 viewport_pixels{0u};
+        u64 redrawn_pixels{0u};
+        // share of viewport pixels not redrawn or rendered
+        // at the lower resolution
+        f32 saved_fill_rate{0.f};
+        f32 resolution_scale{1.f};
+        f32 smoothed_frame_time{0.f};
+        u32 static_batches{0u};
+        u32 static_batched_nodes{0u};
+        // model draw calls replaced by static batches
+        u32 static_draws_saved{0u};
+        // bytes of static batch geometry
+        u64 static_batch_memory{0u};
+        // submitted by all cameras, including repeated partial redraw regions
+        u64 triangles{0u};
+    };
 }
@@ -8,11 +8,19 @@
 
 #include "_high.hpp"
 
+#include "node.hpp"
 #include "prefab.hpp"
 #include "gobject.hpp"
 
 namespace e2d
 {
+    class bad_world_operation final : public exception {
+    public:
+        const char* what() const noexcept final {
+            return "bad world operation";
+        }
+    };
+
     class world final : public module<world> {
     public:
         enum priorities : ecs::priority_t {
@@ -29,7 +37,10 @@ namespace e2d
             priority_render_section_end = 4500
         };
     public:
-        world() = default;
+        class instantiation;
+        using instantiation_ptr = std::shared_ptr<instantiation>;
+    public:
+        world();
         ~world() noexcept final;
 
         ecs::registry& registry() noexcept;
@@ -39,10 +50,55 @@ namespace e2d
         gobject_iptr instantiate(const prefab& prefab);
         void destroy_instance(const gobject_iptr& inst) noexcept;
 
+        // The prefab is flattened in a worker thread and instantiated
+        // in 'process_instantiations' calls. The finished instance is
+        // attached to 'parent' at once when all its children are built.
+        // Built gobjects are marked by 'pending_instance' until then.
+        instantiation_ptr instantiate_async(prefab prefab, const node_iptr& parent = nullptr);
+
+        // builds pending instantiations until the budget is exhausted,
+        // at least one instance per call, the starter calls it once per frame
+        void process_instantiations();
+
+        world& instantiation_budget(microseconds<u64> value) noexcept;
+        microseconds<u64> instantiation_budget() const noexcept;
+
         gobject_iptr resolve(ecs::entity_id ent) const noexcept;
         gobject_iptr resolve(const ecs::const_entity& ent) const noexcept;
+    private:
+        gobject_iptr instantiate_single_(const prefab& prefab);
+        bool process_instantiation_(instantiation& inst, u64 deadline_us);
     private:
         ecs::registry registry_;
         hash_map<ecs::entity_id, gobject_iptr> gobjects_;
+        vector<instantiation_ptr> instantiations_;
+        microseconds<u64> instantiation_budget_;
+    };
+
+    //
+    // world::instantiation
+    //
+
+    class world::instantiation final : private e2d::noncopyable {
+    public:
+        instantiation(prefab&& prefab, const node_iptr& parent);
+        ~instantiation() noexcept;
+
+        // the total is zero until the prefab is flattened
+        std::size_t created() const noexcept;
+        std::size_t total() const noexcept;
+        f32 progress() const noexcept;
+        bool done() const noexcept;
+
+        // resolved with the root instance when it is attached, rejected
+        // when the instantiation fails or is cancelled
+        const stdex::promise<gobject_iptr>& result() const noexcept;
+
+        // built instances are destroyed by the next 'process_instantiations'
+        void cancel();
+    private:
+        friend class world;
+        class internal_state;
+        std::unique_ptr<internal_state> state_;
     };
 }
@@ -19,8 +19,10 @@
 #include "json_utils.hpp"
 #include "mesh.hpp"
 #include "module.hpp"
+#include "pack.hpp"
 #include "path.hpp"
 #include "shape.hpp"
+#include "sound.hpp"
 #include "streams.hpp"
 #include "strfmts.hpp"
 #include "strings.hpp"
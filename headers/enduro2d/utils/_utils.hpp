@@ -18,6 +18,7 @@ namespace e2d
     class image;
     class mesh;
     class shape;
+    class sound;
     class input_stream;
     class output_stream;
     class input_sequence;
@@ -11,6 +11,8 @@
 namespace e2d
 {
     class buffer final {
+    public:
+        using deleter_type = void(*)(void*);
     public:
         buffer() = default;
 
@@ -30,6 +32,10 @@ namespace e2d
         buffer& assign(const buffer& other);
         buffer& assign(const void* src, std::size_t nsize);
 
+        // takes the ownership of foreign memory without copying,
+        // the memory will be released by the deleter
+        buffer& adopt(void* src, std::size_t nsize, deleter_type deleter) noexcept;
+
         void swap(buffer& other) noexcept;
         void clear() noexcept;
         bool empty() const noexcept;
@@ -38,7 +44,11 @@ namespace e2d
         const u8* data() const noexcept;
         std::size_t size() const noexcept;
     private:
-        using data_t = std::unique_ptr<u8[]>;
+        struct data_deleter final {
+            deleter_type deleter;
+            void operator()(u8* data) const noexcept;
+        };
+        using data_t = std::unique_ptr<u8[], data_deleter>;
         data_t data_;
         std::size_t size_ = 0;
     };
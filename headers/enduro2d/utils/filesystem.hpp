@@ -59,6 +59,56 @@ namespace e2d { namespace filesystem
         str_view path,
         const trace_func& func);
 
+    //
+    // directory_scan
+    //
+    // batched result of the recursive scanning, all relative
+    // paths are packed to the one buffer in no particular order
+    //
+
+    class directory_scan final {
+    public:
+        struct entry final {
+            std::size_t offset{0u};
+            std::size_t size{0u};
+            bool directory{false};
+        };
+    public:
+        std::size_t size() const noexcept;
+        bool empty() const noexcept;
+
+        str_view path(std::size_t index) const noexcept;
+        bool directory(std::size_t index) const noexcept;
+
+        void clear() noexcept;
+        void reserve(std::size_t entries, std::size_t names);
+
+        void add(str_view parent, str_view name, bool directory);
+        void append(const directory_scan& other);
+    private:
+        str names_;
+        vector<entry> entries_;
+    };
+
+    // runs scanning tasks, usually on a worker pool
+    using scan_executor = std::function<void(std::function<void()>)>;
+
+    // subdirectories are scanned by 'executor' tasks in parallel,
+    // the calling thread scans too and never waits for not started tasks
+    bool scan_directory_recursive(
+        str_view path,
+        directory_scan& dst,
+        const scan_executor& executor = nullptr);
+
+    // the same parallel scanning, 'func' is called on the calling thread
+    // while it goes on, parents before their children. Returning false
+    // stops the scanning, entries found before a failed directory
+    // are traced anyway.
+    bool trace_directory_recursive(
+        str_view path,
+        const trace_func& func,
+        const scan_executor& executor);
+
     template < typename Iter >
     bool extract_directory(
         str_view path,
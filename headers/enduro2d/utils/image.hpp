@@ -103,6 +103,12 @@ namespace e2d { namespace images
         image& dst,
         const input_stream_uptr& src) noexcept;
 
+    // loads by the one named decoder only
+    bool try_load_image(
+        image& dst,
+        const buffer& src,
+        str_view decoder) noexcept;
+
     bool try_save_image(
         const image& src,
         image_file_format format,
@@ -113,3 +119,29 @@ namespace e2d { namespace images
         image_file_format format,
         const output_stream_uptr& dst) noexcept;
 }}
+
+namespace e2d { namespace images
+{
+    //
+    // decoders
+    //
+    // 'try_load_image' asks registered decoders from the highest priority
+    // to the lowest one, the first decoder accepting the data wins.
+    // Builtin decoders are 'dds', 'pvr', 'libpng' and 'libjpeg' (enabled by
+    // E2D_IMAGE_WITH_LIBPNG and E2D_IMAGE_WITH_LIBJPEG build options) and
+    // 'stb' as the fallback for everything. Decoders must not throw and
+    // should reject foreign data by signature as fast as possible.
+    //
+
+    using image_decoder = bool(*)(image& dst, const buffer& src);
+
+    bool register_decoder(
+        str_view name,
+        i32 priority,
+        image_decoder decoder);
+
+    bool unregister_decoder(str_view name) noexcept;
+
+    // from the highest priority to the lowest one
+    vector<str> decoder_names();
+}}
@@ -7,15 +7,100 @@
 #pragma once
 
 #include "_utils.hpp"
+#include "buffer.hpp"
+#include "streams.hpp"
 
 #include <3rdparty/rapidjson/schema.h>
+#include <3rdparty/rapidjson/reader.h>
 #include <3rdparty/rapidjson/document.h>
+#include <3rdparty/rapidjson/memorystream.h>
+
+namespace e2d { namespace impl
+{
+    class json_document_storage : private noncopyable {
+    protected:
+        json_document_storage(buffer text);
+        ~json_document_storage() noexcept = default;
+    protected:
+        buffer text_;
+        rapidjson::MemoryPoolAllocator<> pool_;
+    };
+}}
+
+namespace e2d
+{
+    //
+    // json_document
+    //
+    // Document parsed in place: strings of the document point into
+    // the owned text and all values are allocated from one memory pool
+    // sized from the text length, so parsing makes no string copies.
+    //
+
+    class json_document final
+        : private impl::json_document_storage
+        , public rapidjson::Document {
+    public:
+        explicit json_document(buffer text);
+        ~json_document() noexcept = default;
+
+        // the text is modified, a trailing zero byte is reused if present,
+        // otherwise the text is copied once to append it
+        bool parse() noexcept;
+    };
+    using json_document_uptr = std::unique_ptr<json_document>;
+}
 
 namespace e2d { namespace json_utils
 {
     void add_common_schema_definitions(rapidjson::Document& schema);
 }}
 
+namespace e2d { namespace json_utils
+{
+    //
+    // input_stream_wrapper
+    //
+    // Buffered rapidjson read stream over an input stream.
+    //
+
+    class input_stream_wrapper final : private noncopyable {
+    public:
+        using Ch = char;
+    public:
+        input_stream_wrapper(input_stream& stream, std::size_t buffer_size = 64u * 1024u);
+
+        Ch Peek() const noexcept;
+        Ch Take();
+        std::size_t Tell() const noexcept;
+
+        // in situ parsing is not supported
+        Ch* PutBegin();
+        void Put(Ch c);
+        void Flush();
+        std::size_t PutEnd(Ch* begin);
+    private:
+        void fill_if_empty_();
+    private:
+        input_stream& stream_;
+        vector<Ch> buffer_;
+        const Ch* cur_{nullptr};
+        const Ch* end_{nullptr};
+        std::size_t consumed_{0u};
+    };
+
+    //
+    // Streaming SAX parsing, Handler is a rapidjson::Reader handler.
+    // Nothing is materialized, so it suits huge data files.
+    //
+
+    template < typename Handler >
+    bool try_parse_sax(const buffer& src, Handler& handler) noexcept;
+
+    template < typename Handler >
+    bool try_parse_sax(const input_stream_uptr& src, Handler& handler) noexcept;
+}}
+
 namespace e2d { namespace json_utils
 {
     bool try_parse_value(const rapidjson::Value& root, v2i& v) noexcept;
@@ -141,3 +226,54 @@ namespace e2d { namespace json_utils
         return true;
     }
 }}
+
+namespace e2d { namespace json_utils
+{
+    inline input_stream_wrapper::Ch input_stream_wrapper::Peek() const noexcept {
+        return cur_ != end_ ? *cur_ : '\0';
+    }
+
+    inline input_stream_wrapper::Ch input_stream_wrapper::Take() {
+        if ( cur_ == end_ ) {
+            return '\0';
+        }
+        const Ch c = *cur_++;
+        if ( cur_ == end_ ) {
+            fill_if_empty_();
+        }
+        return c;
+    }
+
+    inline std::size_t input_stream_wrapper::Tell() const noexcept {
+        return consumed_ + math::numeric_cast<std::size_t>(cur_ - buffer_.data());
+    }
+
+    template < typename Handler >
+    bool try_parse_sax(const buffer& src, Handler& handler) noexcept {
+        try {
+            rapidjson::MemoryStream stream(
+                reinterpret_cast<const char*>(src.data()),
+                src.size());
+            rapidjson::Reader reader;
+            return !reader.Parse(stream, handler).IsError();
+        } catch (...) {
+            // nothing
+        }
+        return false;
+    }
+
+    template < typename Handler >
+    bool try_parse_sax(const input_stream_uptr& src, Handler& handler) noexcept {
+        try {
+            if ( !src ) {
+                return false;
+            }
+            input_stream_wrapper stream(*src);
+            rapidjson::Reader reader;
+            return !reader.Parse(stream, handler).IsError();
+        } catch (...) {
+            // nothing
+        }
+        return false;
+    }
+}}
@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_utils.hpp"
+
+#include "buffer.hpp"
+#include "streams.hpp"
+
+//
+// e2d pack format
+//
+// header:
+//   "e2d_pack", u32 version, u32 entry count, u64 index offset
+// entries:
+//   packed entry data in the order of addition, every entry
+//   starts at the 'pack_alignment' boundary (mmap and direct upload)
+// index:
+//   entry records sorted by the path hash, then the path names
+//
+
+namespace e2d
+{
+    enum class pack_codec : u8 {
+        store,
+        lz4
+    };
+
+    const std::size_t pack_alignment = 4096u;
+
+    //
+    // pack_writer
+    //
+
+    class pack_writer final : private noncopyable {
+    public:
+        pack_writer(output_stream_uptr stream);
+        ~pack_writer() noexcept;
+
+        bool valid() const noexcept;
+
+        // entries not compressible by the codec are stored as is
+        bool add(str_view path, buffer_view content, pack_codec codec);
+
+        // writes the index, the writer is not valid after that
+        bool finish();
+    private:
+        class internal_state;
+        std::unique_ptr<internal_state> state_;
+    };
+
+    //
+    // pack_reader
+    //
+
+    class pack_reader final : private noncopyable {
+    public:
+        struct entry final {
+            str path;
+            u64 hash{0u};
+            u64 offset{0u};
+            u64 packed_size{0u};
+            u64 size{0u};
+            pack_codec codec{pack_codec::store};
+        };
+    public:
+        pack_reader(input_stream_uptr stream);
+        ~pack_reader() noexcept;
+
+        bool valid() const noexcept;
+
+        // sorted by the path hash
+        const vector<entry>& entries() const noexcept;
+        const entry* find(str_view path) const noexcept;
+
+        // thread safe, entries share the one source stream
+        bool read(const entry& e, buffer& dst) const noexcept;
+    private:
+        class internal_state;
+        std::unique_ptr<internal_state> state_;
+    };
+}
+
+namespace e2d { namespace packs
+{
+    u64 path_hash(str_view path) noexcept;
+
+    bool try_compress(
+        pack_codec codec,
+        buffer_view src,
+        buffer& dst) noexcept;
+
+    bool try_decompress(
+        pack_codec codec,
+        buffer_view src,
+        std::size_t dst_size,
+        buffer& dst) noexcept;
+}}
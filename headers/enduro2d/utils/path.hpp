@@ -26,3 +26,82 @@ namespace e2d { namespace path
     bool is_absolute(str_view path) noexcept;
     bool is_relative(str_view path) noexcept;
 }}
+
+namespace e2d { namespace path
+{
+    //
+    // views into the source path, the same results
+    // as above without allocations
+    //
+
+    str_view remove_filename_view(str_view path) noexcept;
+    str_view remove_extension_view(str_view path) noexcept;
+
+    str_view stem_view(str_view path) noexcept;
+    str_view filename_view(str_view path) noexcept;
+    str_view extension_view(str_view path) noexcept;
+    str_view parent_path_view(str_view path) noexcept;
+
+    // writes the result to the caller storage, reuses its capacity
+    str& combine_to(str& dst, str_view lhs, str_view rhs);
+}}
+
+namespace e2d
+{
+    //
+    // path_buffer
+    //
+    // path builder with the inline storage for typical asset paths,
+    // longer paths are moved to the heap
+    //
+
+    class path_buffer final {
+    public:
+        static constexpr std::size_t inline_capacity = 240u;
+    public:
+        path_buffer() noexcept;
+        ~path_buffer() noexcept = default;
+
+        path_buffer(path_buffer&& other) noexcept;
+        path_buffer& operator=(path_buffer&& other) noexcept;
+
+        path_buffer(const path_buffer& other);
+        path_buffer& operator=(const path_buffer& other);
+
+        explicit path_buffer(str_view path);
+        path_buffer(str_view lhs, str_view rhs);
+
+        path_buffer& assign(path_buffer&& other) noexcept;
+        path_buffer& assign(const path_buffer& other);
+        path_buffer& assign(str_view path);
+
+        // 'path::combine' of the current path and 'path'
+        path_buffer& append(str_view path);
+        path_buffer& concat(str_view path);
+
+        path_buffer& replace_filename(str_view filename);
+        path_buffer& replace_extension(str_view extension);
+
+        void clear() noexcept;
+        bool empty() const noexcept;
+        std::size_t size() const noexcept;
+        bool on_heap() const noexcept;
+
+        // always null-terminated
+        const char* c_str() const noexcept;
+        str_view view() const noexcept;
+        operator str_view() const noexcept;
+    private:
+        char* reserve_(std::size_t nsize);
+        void commit_(std::size_t nsize) noexcept;
+        bool overlaps_(str_view path) const noexcept;
+    private:
+        std::array<char, inline_capacity> inline_;
+        str heap_;
+        std::size_t size_{0u};
+        bool on_heap_{false};
+    };
+
+    bool operator==(const path_buffer& l, str_view r) noexcept;
+    bool operator!=(const path_buffer& l, str_view r) noexcept;
+}
@@ -0,0 +1,97 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "_utils.hpp"
+
+#include "buffer.hpp"
+#include "streams.hpp"
+
+namespace e2d
+{
+    enum class sound_file_format : u8 {
+        wav
+    };
+
+    class sound final {
+    public:
+        sound() = default;
+
+        sound(sound&& other) noexcept;
+        sound& operator=(sound&& other) noexcept;
+
+        sound(const sound& other);
+        sound& operator=(const sound& other);
+
+        sound(u32 channels, u32 sample_rate, vector<f32>&& samples) noexcept;
+        sound(u32 channels, u32 sample_rate, const vector<f32>& samples);
+
+        sound& assign(sound&& other) noexcept;
+        sound& assign(const sound& other);
+
+        sound& assign(u32 channels, u32 sample_rate, vector<f32>&& samples) noexcept;
+        sound& assign(u32 channels, u32 sample_rate, const vector<f32>& samples);
+
+        void swap(sound& other) noexcept;
+        void clear() noexcept;
+        bool empty() const noexcept;
+
+        u32 channels() const noexcept;
+        u32 sample_rate() const noexcept;
+        std::size_t frame_count() const noexcept;
+        const vector<f32>& samples() const noexcept;
+    private:
+        vector<f32> samples_;
+        u32 channels_ = 0;
+        u32 sample_rate_ = 0;
+    };
+
+    void swap(sound& l, sound& r) noexcept;
+    bool operator==(const sound& l, const sound& r) noexcept;
+    bool operator!=(const sound& l, const sound& r) noexcept;
+
+    //
+    // sound_stream
+    //
+    // Incremental decoder of interleaved f32 frames,
+    // used to play long sounds without decoding them entirely.
+    //
+
+    class sound_stream : private noncopyable {
+    public:
+        virtual ~sound_stream() noexcept = default;
+        virtual u32 channels() const noexcept = 0;
+        virtual u32 sample_rate() const noexcept = 0;
+        virtual std::size_t read(f32* dst, std::size_t frames) = 0;
+        virtual bool rewind() = 0;
+    };
+    using sound_stream_uptr = std::unique_ptr<sound_stream>;
+}
+
+namespace e2d { namespace sounds
+{
+    bool try_load_sound(
+        sound& dst,
+        const buffer& src) noexcept;
+
+    bool try_load_sound(
+        sound& dst,
+        const input_stream_uptr& src) noexcept;
+
+    bool try_save_sound(
+        const sound& src,
+        sound_file_format format,
+        buffer& dst) noexcept;
+
+    bool try_save_sound(
+        const sound& src,
+        sound_file_format format,
+        const output_stream_uptr& dst) noexcept;
+
+    sound_stream_uptr try_open_sound_stream(
+        input_stream_uptr src) noexcept;
+}}
@@ -97,6 +97,14 @@ namespace e2d
 namespace e2d
 {
     input_stream_uptr make_memory_stream(buffer data) noexcept;
+
+    // small reads are served from the read-ahead buffer and seeks inside it
+    // never reach the underlying stream, reads larger than the buffer bypass it;
+    // the buffer is not larger than the rest of the stream, empty streams and
+    // streams which can't be buffered are returned as is
+    input_stream_uptr make_buffered_stream(
+        input_stream_uptr stream,
+        std::size_t buffer_size) noexcept;
 }
 
 namespace e2d { namespace streams
@@ -118,5 +126,28 @@ namespace e2d { namespace streams
         const output_stream_uptr& stream) noexcept;
 }}
 
+namespace e2d { namespace streams
+{
+    //
+    // io_statistics
+    //
+    // Process-wide counters of buffered streams, 'read_calls' and
+    // 'seek_calls' are requests to the underlying streams (syscalls
+    // for files, inflate calls for archives). 'buffered_reads' of a live
+    // stream are added on its next underlying read or its destruction.
+    //
+
+    class io_statistics {
+    public:
+        u64 read_calls{0u};
+        u64 seek_calls{0u};
+        u64 read_bytes{0u};
+        u64 buffered_reads{0u};
+    };
+
+    io_statistics statistics() noexcept;
+    void reset_statistics() noexcept;
+}}
+
 #include "streams.inl"
 #endif
@@ -27,6 +27,9 @@ namespace e2d
         basic_string_hash(const Char* str) noexcept;
         basic_string_hash(basic_string_view<Char> str) noexcept;
 
+        // restores a hash from the 'hash()' value
+        explicit basic_string_hash(u32 hash) noexcept;
+
         basic_string_hash& assign(basic_string_hash&& other) noexcept;
         basic_string_hash& assign(const basic_string_hash& other) noexcept;
         basic_string_hash& assign(const Char* str) noexcept;
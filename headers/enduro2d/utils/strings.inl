@@ -61,6 +61,10 @@ namespace e2d
         assign(str);
     }
 
+    template < typename Char >
+    basic_string_hash<Char>::basic_string_hash(u32 hash) noexcept
+    : hash_(hash) {}
+
     template < typename Char >
     basic_string_hash<Char>& basic_string_hash<Char>::assign(
         basic_string_hash&& other) noexcept
@@ -76,6 +76,9 @@ namespace e2d
 
     url operator+(const url& l, str_view r);
     url operator/(const url& l, str_view r);
+
+    // 'lhs / rhs' into the caller storage, reuses its capacity
+    url& combine_to(url& dst, const url& lhs, str_view rhs);
 }
 
 namespace std
@@ -0,0 +1,311 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "../common.hpp"
+using namespace e2d;
+
+#include <random>
+
+namespace
+{
+    //
+    // Stress test of the render system:
+    //   sample_05 [--pipelined] [--headless] [--sprites N] [--frames N]
+    //
+    // The headless run has no window and no graphics device, it draws
+    // untextured shapes with a fixed time step through the null render
+    // and reports the wall clock frame time of the whole frame.
+    //
+
+    struct options {
+        bool pipelined = false;
+        bool headless = false;
+        std::size_t sprites = 20000u;
+        std::size_t frames = 0u;
+    };
+
+    struct mover {
+        v2f velocity;
+    };
+
+    class game_system final : public ecs::system {
+    public:
+        void process(ecs::registry& owner) override {
+            E2D_UNUSED(owner);
+            const keyboard& k = the<input>().keyboard();
+
+            if ( k.is_key_just_released(keyboard_key::f12) ) {
+                the<dbgui>().toggle_visible(!the<dbgui>().visible());
+            }
+
+            if ( k.is_key_just_released(keyboard_key::escape) ) {
+                the<window>().set_should_close(true);
+            }
+        }
+    };
+
+    class camera_system final : public ecs::system {
+    public:
+        void process(ecs::registry& owner) override {
+            owner.for_joined_components<camera>(
+            [](const ecs::const_entity&, camera& cam){
+                if ( !cam.target() ) {
+                    cam.viewport(
+                        the<window>().real_size());
+                    cam.projection(math::make_orthogonal_lh_matrix4(
+                        the<window>().real_size().cast_to<f32>(), 0.f, 1000.f));
+                }
+            });
+        }
+    };
+
+    class mover_system final : public ecs::system {
+    public:
+        mover_system(f32 fixed_dt)
+        : fixed_dt_(fixed_dt) {}
+
+        void process(ecs::registry& owner) override {
+            const f32 dt = fixed_dt_ > 0.f
+                ? fixed_dt_
+                : the<engine>().delta_time();
+            const v2f half_size = the<window>().real_size().cast_to<f32>() * 0.5f;
+            owner.for_joined_components<mover, actor>(
+                [dt, &half_size](const ecs::const_entity&, mover& m, actor& act){
+                    const node_iptr node = act.node();
+                    if ( !node ) {
+                        return;
+                    }
+                    v3f t = node->translation();
+                    t.x += m.velocity.x * dt;
+                    t.y += m.velocity.y * dt;
+                    if ( math::abs(t.x) > half_size.x ) {
+                        m.velocity.x = -m.velocity.x;
+                    }
+                    if ( math::abs(t.y) > half_size.y ) {
+                        m.velocity.y = -m.velocity.y;
+                    }
+                    node->translation(t);
+                    node->rotation(math::make_quat_from_axis_angle(
+                        make_rad(t.x * 0.01f), v3f::unit_z()));
+                });
+        }
+    private:
+        f32 fixed_dt_ = 0.f;
+    };
+
+    class stats_system final : public ecs::system {
+    public:
+        stats_system(bool pipelined, std::size_t max_frames)
+        : pipelined_(pipelined)
+        , max_frames_(max_frames) {}
+
+        void process(ecs::registry& owner) override {
+            frame_time_ += the<engine>().delta_time();
+            ++frames_;
+            ++total_frames_;
+
+            if ( frame_time_ >= 2.f ) {
+                the<debug>().trace("SAMPLE: Average frame time:\n"
+                    "--> Sprites: %0\n"
+                    "--> Pipelined: %1\n"
+                    "--> Frame time: %2 ms",
+                    owner.component_count<mover>(),
+                    pipelined_,
+                    frame_time_ * 1000.f / math::numeric_cast<f32>(frames_));
+                frame_time_ = 0.f;
+                frames_ = 0u;
+            }
+
+            if ( max_frames_ && total_frames_ >= max_frames_ ) {
+                the<window>().set_should_close(true);
+            }
+        }
+    private:
+        bool pipelined_ = false;
+        std::size_t max_frames_ = 0u;
+        f32 frame_time_ = 0.f;
+        std::size_t frames_ = 0u;
+        std::size_t total_frames_ = 0u;
+    };
+
+    class game final : public starter::application {
+    public:
+        game(const options& opts)
+        : opts_(opts) {}
+
+        bool initialize() final {
+            return create_scene()
+                && create_camera()
+                && create_systems();
+        }
+    private:
+        bool create_scene() {
+            // the null render has no textures, so the headless run draws shapes
+            auto sprite_res = opts_.headless
+                ? nullptr
+                : the<library>().load_asset<sprite_asset>("ship_sprite.json");
+            auto sprite_mat = opts_.headless
+                ? material_asset::create(render::material()
+                    .add_pass(render::pass_state()))
+                : the<library>().load_asset<material_asset>("sprite_material.json");
+
+            if ( (!opts_.headless && !sprite_res) || !sprite_mat ) {
+                return false;
+            }
+
+            shape quad;
+            quad.set_vertices({
+                v2f(-32.f, -32.f), v2f(32.f, -32.f),
+                v2f(32.f, 32.f), v2f(-32.f, 32.f)});
+            quad.set_indices(0u, {0u, 1u, 2u, 2u, 3u, 0u});
+            const auto shape_res = shape_asset::create(std::move(quad));
+
+            auto scene_i = the<world>().instantiate();
+
+            scene_i->entity_filler()
+                .component<scene>()
+                .component<actor>(node::create(scene_i));
+
+            node_iptr scene_r = scene_i->get_component<actor>().get().node();
+
+            std::mt19937 rnd(42u);
+            std::uniform_real_distribution<f32> position(-300.f, 300.f);
+            std::uniform_real_distribution<f32> velocity(-150.f, 150.f);
+
+            for ( std::size_t i = 0; i < opts_.sprites; ++i ) {
+                auto sprite_i = the<world>().instantiate();
+
+                sprite_i->entity_filler()
+                    .component<mover>(mover{v2f(velocity(rnd), velocity(rnd))})
+                    .component<actor>(node::create(sprite_i, scene_r))
+                    .component<renderer>(renderer()
+                        .materials({sprite_mat}));
+
+                if ( opts_.headless ) {
+                    sprite_i->entity_filler()
+                        .component<shape_renderer>(shape_res);
+                } else {
+                    sprite_i->entity_filler()
+                        .component<sprite_renderer>(sprite_res);
+                }
+
+                node_iptr sprite_n = sprite_i->get_component<actor>().get().node();
+                sprite_n->scale(v3f(0.25f, 0.25f, 1.f));
+                sprite_n->translation(v3f(position(rnd), position(rnd), 0.f));
+            }
+
+            return true;
+        }
+
+        bool create_camera() {
+            auto camera_i = the<world>().instantiate();
+            camera_i->entity_filler()
+                .component<camera>(camera()
+                    .background({0.f, 0.2f, 0.4f, 1.f}))
+                .component<actor>(node::create(camera_i));
+            return true;
+        }
+
+        bool create_systems() {
+            const f32 fixed_dt = opts_.headless ? 1.f / 60.f : 0.f;
+            ecs::registry_filler(the<world>().registry())
+                .system<game_system>(world::priority_update)
+                .system<mover_system>(world::priority_update, fixed_dt)
+                .system<camera_system>(world::priority_pre_render);
+            if ( !opts_.headless ) {
+                ecs::registry_filler(the<world>().registry())
+                    .system<stats_system>(world::priority_update, opts_.pipelined, opts_.frames);
+            }
+            return true;
+        }
+    private:
+        options opts_;
+    };
+
+    //
+    // The headless frame loop repeats the starter one without
+    // the window, so systems of the starter are registered here.
+    //
+
+    bool run_headless(const options& opts) {
+        modules::initialize<window>(v2u(1024u, 768u), "sample_05", false, false);
+        modules::initialize<render>(the<debug>(), the<window>());
+
+        ecs::registry_filler(the<world>().registry())
+            .system<render_system>(world::priority_render, render_system::parameters()
+                .pipelining(opts.pipelined));
+
+        game app(opts);
+        if ( !app.initialize() ) {
+            the<debug>().error("SAMPLE: Failed to initialize headless application");
+            return false;
+        }
+
+        // the null render fails to create buffers every frame,
+        // these errors must not be formatted inside measured frames
+        const debug::level log_level = the<debug>().min_level();
+        the<debug>().set_min_level(debug::level::fatal);
+
+        const std::size_t frames = opts.frames ? opts.frames : 1000u;
+        const auto begin_time = time::now_us<f64>();
+
+        for ( std::size_t i = 0; i < frames; ++i ) {
+            the<deferrer>().scheduler().process_all_tasks();
+            the<world>().process_instantiations();
+            the<world>().registry().process_systems_in_range(
+                world::priority_update_section_begin,
+                world::priority_update_section_end);
+            the<world>().registry().process_systems_in_range(
+                world::priority_render_section_begin,
+                world::priority_render_section_end);
+        }
+
+        const auto total_time = time::now_us<f64>() - begin_time;
+        the<debug>().set_min_level(log_level);
+
+        the<debug>().trace("SAMPLE: Average headless frame time:\n"
+            "--> Sprites: %0\n"
+            "--> Pipelined: %1\n"
+            "--> Frames: %2\n"
+            "--> Frame time: %3 ms",
+            opts.sprites,
+            opts.pipelined,
+            frames,
+            total_time.value / 1000.0 / math::numeric_cast<f64>(frames));
+
+        app.shutdown();
+        return true;
+    }
+}
+
+int e2d_main(int argc, char *argv[]) {
+    options opts;
+    for ( int i = 1; i < argc; ++i ) {
+        const str_view arg = argv[i];
+        if ( arg == "--pipelined" ) {
+            opts.pipelined = true;
+        } else if ( arg == "--headless" ) {
+            opts.headless = true;
+        } else if ( arg == "--sprites" && i + 1 < argc ) {
+            opts.sprites = std::strtoul(argv[++i], nullptr, 10);
+        } else if ( arg == "--frames" && i + 1 < argc ) {
+            opts.frames = std::strtoul(argv[++i], nullptr, 10);
+        }
+    }
+
+    const auto starter_params = starter::parameters(
+        engine::parameters("sample_05", "enduro2d")
+            .without_graphics(opts.headless)
+            .without_audio(opts.headless))
+        .render_params(render_system::parameters()
+            .pipelining(opts.pipelined));
+    starter& s = modules::initialize<starter>(argc, argv, starter_params);
+    const bool success = opts.headless
+        ? run_headless(opts)
+        : s.start<game>(opts);
+    modules::shutdown<starter>();
+    return success ? 0 : 1;
+}
@@ -0,0 +1,1065 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/core/audio.hpp>
+
+#include <enduro2d/core/debug.hpp>
+#include <enduro2d/core/deferrer.hpp>
+
+#include <condition_variable>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define E2D_AUDIO_MIXER_SSE2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define E2D_AUDIO_MIXER_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace
+{
+    using namespace e2d;
+
+    const u32 output_channels = 2u;
+    const std::size_t command_queue_capacity = 1024u;
+    const std::size_t stream_ring_frames = 16384u;
+    const std::size_t stream_refill_frames = 2048u;
+
+    //
+    // command_queue
+    //
+    // Bounded lock-free multi-producer single-consumer queue.
+    // Inspired by:
+    // http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+    //
+
+    template < typename T >
+    class command_queue final : private noncopyable {
+    public:
+        explicit command_queue(std::size_t capacity)
+        : mask_(capacity - 1u)
+        , cells_(new cell[capacity])
+        {
+            E2D_ASSERT(capacity >= 2u && (capacity & (capacity - 1u)) == 0u);
+            for ( std::size_t i = 0; i < capacity; ++i ) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        // returns false and keeps the value if the queue is full
+        bool try_push(T&& value) noexcept {
+            cell* c = nullptr;
+            std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            while ( true ) {
+                c = &cells_[pos & mask_];
+                const std::size_t seq = c->sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t dif =
+                    static_cast<std::ptrdiff_t>(seq) -
+                    static_cast<std::ptrdiff_t>(pos);
+                if ( dif == 0 ) {
+                    if ( enqueue_pos_.compare_exchange_weak(pos, pos + 1u, std::memory_order_relaxed) ) {
+                        break;
+                    }
+                } else if ( dif < 0 ) {
+                    return false;
+                } else {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            c->value = std::move(value);
+            c->sequence.store(pos + 1u, std::memory_order_release);
+            return true;
+        }
+
+        // it can only be called from the consumer thread
+        bool try_pop(T& value) noexcept {
+            const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            cell& c = cells_[pos & mask_];
+            if ( c.sequence.load(std::memory_order_acquire) != pos + 1u ) {
+                return false;
+            }
+            value = std::move(c.value);
+            c.value = T();
+            dequeue_pos_.store(pos + 1u, std::memory_order_relaxed);
+            c.sequence.store(pos + mask_ + 1u, std::memory_order_release);
+            return true;
+        }
+
+        // it can only be called from the consumer thread
+        bool empty() const noexcept {
+            const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            return cells_[pos & mask_].sequence.load(std::memory_order_acquire) != pos + 1u;
+        }
+    private:
+        struct cell {
+            std::atomic<std::size_t> sequence{0u};
+            T value;
+        };
+    private:
+        const std::size_t mask_;
+        std::unique_ptr<cell[]> cells_;
+        u8 padding0_[64] = {0};
+        std::atomic<std::size_t> enqueue_pos_{0u};
+        u8 padding1_[64] = {0};
+        std::atomic<std::size_t> dequeue_pos_{0u};
+    };
+
+    //
+    // sample_ring
+    //
+    // Single-producer single-consumer ring of samples.
+    //
+
+    class sample_ring final : private noncopyable {
+    public:
+        explicit sample_ring(std::size_t capacity)
+        : samples_(capacity) {}
+
+        std::size_t size() const noexcept {
+            return tail_.load(std::memory_order_acquire)
+                - head_.load(std::memory_order_acquire);
+        }
+
+        std::size_t capacity() const noexcept {
+            return samples_.size();
+        }
+
+        std::size_t write(const f32* src, std::size_t count) noexcept {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            const std::size_t head = head_.load(std::memory_order_acquire);
+            count = math::min(count, samples_.size() - (tail - head));
+            for ( std::size_t i = 0; i < count; ++i ) {
+                samples_[(tail + i) % samples_.size()] = src[i];
+            }
+            tail_.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        std::size_t read(f32* dst, std::size_t count) noexcept {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            const std::size_t tail = tail_.load(std::memory_order_acquire);
+            count = math::min(count, tail - head);
+            for ( std::size_t i = 0; i < count; ++i ) {
+                dst[i] = samples_[(head + i) % samples_.size()];
+            }
+            head_.store(head + count, std::memory_order_release);
+            return count;
+        }
+    private:
+        vector<f32> samples_;
+        std::atomic<std::size_t> head_{0u};
+        std::atomic<std::size_t> tail_{0u};
+    };
+
+    //
+    // stream_state
+    //
+    // Shared between the mixer (consumer) and a refill job (producer).
+    // Only one refill job may work with the decoder at the same time.
+    //
+
+    class stream_state final : private noncopyable {
+    public:
+        stream_state(sound_stream_uptr decoder, bool looped)
+        : decoder_(std::move(decoder))
+        , ring_(stream_ring_frames * decoder_->channels())
+        , looped_(looped) {}
+
+        u32 channels() const noexcept {
+            return decoder_->channels();
+        }
+
+        u32 sample_rate() const noexcept {
+            return decoder_->sample_rate();
+        }
+
+        sample_ring& ring() noexcept {
+            return ring_;
+        }
+
+        bool finished() const noexcept {
+            return finished_.load(std::memory_order_acquire);
+        }
+
+        bool needs_refill() const noexcept {
+            return !finished()
+                && !cancelled_.load(std::memory_order_relaxed)
+                && ring_.size() < ring_.capacity() / 2u;
+        }
+
+        bool try_begin_refill() noexcept {
+            bool expected = false;
+            return refilling_.compare_exchange_strong(expected, true);
+        }
+
+        void end_refill() noexcept {
+            refilling_.store(false, std::memory_order_release);
+        }
+
+        void cancel() noexcept {
+            cancelled_.store(true, std::memory_order_relaxed);
+        }
+
+        void refill() noexcept {
+            try {
+                const std::size_t channels = decoder_->channels();
+                scratch_.resize(stream_refill_frames * channels);
+                bool empty_pass = true;
+                while ( !finished() && !cancelled_.load(std::memory_order_relaxed) ) {
+                    const std::size_t free_frames =
+                        (ring_.capacity() - ring_.size()) / channels;
+                    if ( !free_frames ) {
+                        break;
+                    }
+                    const std::size_t frames = decoder_->read(
+                        scratch_.data(),
+                        math::min(free_frames, stream_refill_frames));
+                    if ( frames ) {
+                        empty_pass = false;
+                        ring_.write(scratch_.data(), frames * channels);
+                    } else if ( looped_ && !empty_pass && decoder_->rewind() ) {
+                        empty_pass = true;
+                    } else {
+                        finished_.store(true, std::memory_order_release);
+                    }
+                }
+            } catch (...) {
+                finished_.store(true, std::memory_order_release);
+            }
+            end_refill();
+        }
+    private:
+        sound_stream_uptr decoder_;
+        sample_ring ring_;
+        vector<f32> scratch_;
+        const bool looped_;
+        std::atomic<bool> finished_{false};
+        std::atomic<bool> cancelled_{false};
+        std::atomic<bool> refilling_{false};
+    };
+    using stream_state_ptr = std::shared_ptr<stream_state>;
+
+    //
+    // simd helpers
+    //
+
+    void mix_add_samples(f32* dst, const f32* src, std::size_t count, f32 gain) noexcept {
+        std::size_t i = 0;
+    #if defined(E2D_AUDIO_MIXER_SSE2)
+        const __m128 g = _mm_set1_ps(gain);
+        for ( ; i + 4u <= count; i += 4u ) {
+            const __m128 d = _mm_loadu_ps(dst + i);
+            const __m128 s = _mm_loadu_ps(src + i);
+            _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g)));
+        }
+    #elif defined(E2D_AUDIO_MIXER_NEON)
+        const float32x4_t g = vdupq_n_f32(gain);
+        for ( ; i + 4u <= count; i += 4u ) {
+            const float32x4_t d = vld1q_f32(dst + i);
+            const float32x4_t s = vld1q_f32(src + i);
+            vst1q_f32(dst + i, vmlaq_f32(d, s, g));
+        }
+    #endif
+        for ( ; i < count; ++i ) {
+            dst[i] += src[i] * gain;
+        }
+    }
+
+    void apply_master_gain(f32* dst, std::size_t count, f32 gain) noexcept {
+        std::size_t i = 0;
+    #if defined(E2D_AUDIO_MIXER_SSE2)
+        const __m128 g = _mm_set1_ps(gain);
+        const __m128 lo = _mm_set1_ps(-1.f);
+        const __m128 hi = _mm_set1_ps(1.f);
+        for ( ; i + 4u <= count; i += 4u ) {
+            const __m128 d = _mm_mul_ps(_mm_loadu_ps(dst + i), g);
+            _mm_storeu_ps(dst + i, _mm_min_ps(_mm_max_ps(d, lo), hi));
+        }
+    #elif defined(E2D_AUDIO_MIXER_NEON)
+        const float32x4_t g = vdupq_n_f32(gain);
+        const float32x4_t lo = vdupq_n_f32(-1.f);
+        const float32x4_t hi = vdupq_n_f32(1.f);
+        for ( ; i + 4u <= count; i += 4u ) {
+            const float32x4_t d = vmulq_f32(vld1q_f32(dst + i), g);
+            vst1q_f32(dst + i, vminq_f32(vmaxq_f32(d, lo), hi));
+        }
+    #endif
+        for ( ; i < count; ++i ) {
+            dst[i] = math::clamp(dst[i] * gain, -1.f, 1.f);
+        }
+    }
+
+    // Resamples source frames to interleaved stereo by linear interpolation.
+    // Returns the number of produced frames, 'pos' is advanced by 'step'
+    // for each of them. Looped sources wrap around 'src_frames'.
+
+    std::size_t resample_to_stereo(
+        const f32* src, std::size_t src_frames, std::size_t src_channels,
+        f64& pos, f64 step, bool looped,
+        f32* dst, std::size_t dst_frames) noexcept
+    {
+        if ( !src_frames || !src_channels ) {
+            return 0u;
+        }
+
+        const std::size_t rch = src_channels > 1u ? 1u : 0u;
+        const f64 src_length = static_cast<f64>(src_frames);
+
+        std::size_t i = 0;
+        for ( ; i < dst_frames; ++i, pos += step ) {
+            if ( pos >= src_length ) {
+                if ( !looped ) {
+                    break;
+                }
+                pos = std::fmod(pos, src_length);
+            }
+
+            const std::size_t idx0 = static_cast<std::size_t>(pos);
+            const std::size_t idx1 = idx0 + 1u < src_frames
+                ? idx0 + 1u
+                : (looped ? 0u : idx0);
+            const f32 frac = static_cast<f32>(pos - static_cast<f64>(idx0));
+
+            const f32* f0 = src + idx0 * src_channels;
+            const f32* f1 = src + idx1 * src_channels;
+
+            dst[i * 2u + 0u] = f0[0] + (f1[0] - f0[0]) * frac;
+            dst[i * 2u + 1u] = f0[rch] + (f1[rch] - f0[rch]) * frac;
+        }
+        return i;
+    }
+
+    //
+    // command
+    //
+
+    struct command {
+        enum class types : u8 {
+            none,
+            play,
+            stop,
+            stop_all,
+            pause,
+            volume,
+            pitch,
+            master_volume
+        };
+
+        types type{types::none};
+        audio::voice_id voice{audio::invalid_voice};
+        f32 value{0.f};
+        f32 pitch{1.f};
+        bool flag{false};
+        sound_ptr sound;
+        stream_state_ptr stream;
+        vector<f32> window;
+    };
+
+    //
+    // voice
+    //
+
+    struct voice {
+        audio::voice_id id{audio::invalid_voice};
+        sound_ptr sound;
+        stream_state_ptr stream;
+        // preallocated by the producer, samples [begin, end) are not consumed
+        vector<f32> window;
+        std::size_t window_begin{0u};
+        std::size_t window_end{0u};
+        f64 position{0.0};
+        f32 volume{1.f};
+        f32 pitch{1.f};
+        bool looped{false};
+        bool paused{false};
+    };
+}
+
+namespace e2d
+{
+    const audio::voice_id audio::invalid_voice;
+
+    //
+    // audio::parameters
+    //
+
+    audio::parameters& audio::parameters::sample_rate(u32 value) noexcept {
+        sample_rate_ = value;
+        return *this;
+    }
+
+    audio::parameters& audio::parameters::block_frames(u32 value) noexcept {
+        block_frames_ = value;
+        return *this;
+    }
+
+    audio::parameters& audio::parameters::max_voices(u32 value) noexcept {
+        max_voices_ = value;
+        return *this;
+    }
+
+    audio::parameters& audio::parameters::mixer_thread(bool value) noexcept {
+        mixer_thread_ = value;
+        return *this;
+    }
+
+    audio::parameters& audio::parameters::realtime(bool value) noexcept {
+        realtime_ = value;
+        return *this;
+    }
+
+    u32 audio::parameters::sample_rate() const noexcept {
+        return sample_rate_;
+    }
+
+    u32 audio::parameters::block_frames() const noexcept {
+        return block_frames_;
+    }
+
+    u32 audio::parameters::max_voices() const noexcept {
+        return max_voices_;
+    }
+
+    bool audio::parameters::mixer_thread() const noexcept {
+        return mixer_thread_;
+    }
+
+    bool audio::parameters::realtime() const noexcept {
+        return realtime_;
+    }
+
+    //
+    // audio::internal_state
+    //
+
+    class audio::internal_state final : private e2d::noncopyable {
+    public:
+        internal_state(debug& d, sink_uptr sink, const parameters& params)
+        : debug_(d)
+        , sink_(std::move(sink))
+        , params_(params)
+        , commands_(command_queue_capacity)
+        {
+            if ( !sink_ || !params_.sample_rate() || !params_.block_frames() ) {
+                throw bad_audio_operation();
+            }
+
+            mix_bus_.resize(params_.block_frames() * output_channels);
+            voice_bus_.resize(params_.block_frames() * output_channels);
+            voices_.reserve(params_.max_voices());
+
+            if ( params_.mixer_thread() ) {
+                thread_ = std::thread([this](){
+                    mixer_thread_loop_();
+                });
+            }
+        }
+
+        ~internal_state() noexcept {
+            if ( thread_.joinable() ) {
+                exit_.store(true);
+                wake_mixer_();
+                thread_.join();
+            }
+            command cmd;
+            while ( commands_.try_pop(cmd) ) {
+                if ( cmd.stream ) {
+                    cmd.stream->cancel();
+                }
+            }
+            for ( voice& v : voices_ ) {
+                if ( v.stream ) {
+                    v.stream->cancel();
+                }
+            }
+        }
+    public:
+        voice_id next_voice_id() noexcept {
+            voice_id id = last_voice_id_.fetch_add(1u) + 1u;
+            while ( id == invalid_voice ) {
+                id = last_voice_id_.fetch_add(1u) + 1u;
+            }
+            return id;
+        }
+
+        // never blocks, a command is rejected when the queue is full
+        bool push_command(command&& cmd) noexcept {
+            if ( !commands_.try_push(std::move(cmd)) ) {
+                dropped_commands_.fetch_add(1u, std::memory_order_relaxed);
+                drop_command_(cmd);
+                return false;
+            }
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if ( mixer_idle_.load(std::memory_order_relaxed) ) {
+                wake_mixer_();
+            }
+            return true;
+        }
+
+        vector<f32> make_stream_window(const stream_state& stream, f32 pitch) const {
+            // twice the frames of a block at the start pitch,
+            // later pitch changes over it are clipped by the mixer
+            const f64 step = math::max(1.0, static_cast<f64>(pitch)
+                * stream.sample_rate()
+                / params_.sample_rate());
+            const std::size_t frames = static_cast<std::size_t>(
+                std::ceil(step * params_.block_frames() * 2.0)) + 4u;
+            return vector<f32>(frames * stream.channels());
+        }
+
+        // decodes the first frames before the voice reaches the mixer
+        void prefill_stream(const stream_state_ptr& stream) noexcept {
+            if ( !modules::is_initialized<deferrer>() || !stream->try_begin_refill() ) {
+                return;
+            }
+            try {
+                the<deferrer>().do_in_worker_thread([stream](){
+                    stream->refill();
+                });
+            } catch (...) {
+                // the mixer refills the stream
+                stream->end_refill();
+            }
+        }
+
+        void mix(std::size_t frames) {
+            if ( params_.mixer_thread() ) {
+                throw bad_audio_operation();
+            }
+            while ( frames > 0u ) {
+                const std::size_t block = math::min(
+                    frames,
+                    std::size_t(params_.block_frames()));
+                process_commands_();
+                mix_block_(block);
+                frames -= block;
+            }
+        }
+
+        u32 sample_rate() const noexcept {
+            return params_.sample_rate();
+        }
+
+        statistics stats() const noexcept {
+            statistics s;
+            s.active_voices = active_voices_.load(std::memory_order_relaxed);
+            s.mixed_frames = mixed_frames_.load(std::memory_order_relaxed);
+            s.mix_time_us = mix_time_us_.load(std::memory_order_relaxed);
+            s.stream_underruns = stream_underruns_.load(std::memory_order_relaxed);
+            s.dropped_voices = dropped_voices_.load(std::memory_order_relaxed);
+            s.dropped_commands = dropped_commands_.load(std::memory_order_relaxed);
+            return s;
+        }
+    private:
+        void mixer_thread_loop_() noexcept {
+            const auto block_duration = time::to_chrono(make_microseconds<u64>(
+                time::second_us<u64>().value * params_.block_frames() / params_.sample_rate()));
+            auto next_block_time = std::chrono::steady_clock::now();
+            while ( !exit_.load() ) {
+                if ( !params_.realtime() && voices_.empty() ) {
+                    // there is nothing to mix until the next command,
+                    // the realtime mixer never takes this lock
+                    std::unique_lock<std::mutex> lock(idle_mutex_);
+                    mixer_idle_.store(true, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    idle_cond_.wait_for(lock, block_duration, [this](){
+                        return exit_.load() || !commands_.empty();
+                    });
+                    mixer_idle_.store(false, std::memory_order_relaxed);
+                }
+                process_commands_();
+                if ( !params_.realtime() && voices_.empty() ) {
+                    continue;
+                }
+                mix_block_(params_.block_frames());
+                if ( params_.realtime() ) {
+                    const auto now = std::chrono::steady_clock::now();
+                    next_block_time += block_duration;
+                    if ( next_block_time + block_duration * 4 < now ) {
+                        next_block_time = now;
+                    }
+                    std::this_thread::sleep_until(next_block_time);
+                }
+            }
+        }
+
+        void wake_mixer_() noexcept {
+            std::lock_guard<std::mutex> guard(idle_mutex_);
+            idle_cond_.notify_one();
+        }
+
+        // only the mixer drains the queue
+        void process_commands_() noexcept {
+            command cmd;
+            while ( commands_.try_pop(cmd) ) {
+                process_command_(cmd);
+            }
+        }
+
+        void drop_command_(command& cmd) noexcept {
+            if ( cmd.type == command::types::play ) {
+                if ( cmd.stream ) {
+                    cmd.stream->cancel();
+                }
+                dropped_voices_.fetch_add(1u, std::memory_order_relaxed);
+            }
+        }
+
+        void process_command_(command& cmd) noexcept {
+            switch ( cmd.type ) {
+                case command::types::play:
+                    if ( voices_.size() < params_.max_voices() ) {
+                        voice v;
+                        v.id = cmd.voice;
+                        v.sound = std::move(cmd.sound);
+                        v.stream = std::move(cmd.stream);
+                        v.window = std::move(cmd.window);
+                        v.volume = cmd.value;
+                        v.pitch = cmd.pitch;
+                        v.looped = cmd.flag;
+                        voices_.push_back(std::move(v));
+                        if ( voices_.back().stream ) {
+                            schedule_refill_(voices_.back().stream);
+                        }
+                    } else {
+                        drop_command_(cmd);
+                    }
+                    break;
+                case command::types::stop:
+                    remove_voices_([&cmd](const voice& v){
+                        return v.id == cmd.voice;
+                    });
+                    break;
+                case command::types::stop_all:
+                    remove_voices_([](const voice&){
+                        return true;
+                    });
+                    break;
+                case command::types::pause:
+                    with_voice_(cmd.voice, [&cmd](voice& v){
+                        v.paused = cmd.flag;
+                    });
+                    break;
+                case command::types::volume:
+                    with_voice_(cmd.voice, [&cmd](voice& v){
+                        v.volume = cmd.value;
+                    });
+                    break;
+                case command::types::pitch:
+                    with_voice_(cmd.voice, [&cmd](voice& v){
+                        v.pitch = cmd.value;
+                    });
+                    break;
+                case command::types::master_volume:
+                    master_volume_ = cmd.value;
+                    break;
+                case command::types::none:
+                    break;
+                default:
+                    E2D_ASSERT_MSG(false, "unexpected audio command");
+                    break;
+            }
+            active_voices_.store(
+                math::numeric_cast<u32>(voices_.size()),
+                std::memory_order_relaxed);
+        }
+
+        template < typename F >
+        void with_voice_(voice_id id, F&& f) noexcept {
+            for ( voice& v : voices_ ) {
+                if ( v.id == id ) {
+                    f(v);
+                    return;
+                }
+            }
+        }
+
+        template < typename Pred >
+        void remove_voices_(Pred&& pred) noexcept {
+            const auto first = std::remove_if(
+                voices_.begin(), voices_.end(),
+                [&pred](const voice& v){
+                    if ( !pred(v) ) {
+                        return false;
+                    }
+                    if ( v.stream ) {
+                        v.stream->cancel();
+                    }
+                    return true;
+                });
+            voices_.erase(first, voices_.end());
+        }
+
+        void schedule_refill_(const stream_state_ptr& stream) noexcept {
+            if ( !stream->needs_refill() || !stream->try_begin_refill() ) {
+                return;
+            }
+            if ( thread_.joinable() && modules::is_initialized<deferrer>() ) {
+                try {
+                    the<deferrer>().do_in_worker_thread([stream](){
+                        stream->refill();
+                    });
+                    return;
+                } catch (...) {
+                    // fallback to the synchronous refill
+                }
+            }
+            stream->refill();
+        }
+
+        std::size_t render_sound_voice_(voice& v, std::size_t frames) noexcept {
+            const sound& snd = *v.sound;
+            const f64 step = static_cast<f64>(v.pitch)
+                * snd.sample_rate()
+                / params_.sample_rate();
+            const std::size_t produced = resample_to_stereo(
+                snd.samples().data(), snd.frame_count(), snd.channels(),
+                v.position, step, v.looped,
+                voice_bus_.data(), frames);
+            if ( produced < frames ) {
+                v.looped = false;
+                v.position = static_cast<f64>(snd.frame_count());
+            }
+            return produced;
+        }
+
+        std::size_t render_stream_voice_(voice& v, std::size_t frames, bool& finished) noexcept {
+            stream_state& stream = *v.stream;
+            const std::size_t channels = stream.channels();
+            const f64 step = static_cast<f64>(v.pitch)
+                * stream.sample_rate()
+                / params_.sample_rate();
+
+            const bool stream_finished = stream.finished();
+            const std::size_t capacity_frames = v.window.size() / channels;
+            const std::size_t required_frames = math::min(
+                capacity_frames,
+                static_cast<std::size_t>(v.position + step * frames) + 2u);
+            const std::size_t window_frames = (v.window_end - v.window_begin) / channels;
+
+            if ( window_frames < required_frames ) {
+                if ( v.window_begin + required_frames * channels > v.window.size() ) {
+                    // only a few frames are not consumed yet
+                    std::copy(
+                        v.window.begin() + math::numeric_cast<std::ptrdiff_t>(v.window_begin),
+                        v.window.begin() + math::numeric_cast<std::ptrdiff_t>(v.window_end),
+                        v.window.begin());
+                    v.window_end -= v.window_begin;
+                    v.window_begin = 0u;
+                }
+                v.window_end += stream.ring().read(
+                    v.window.data() + v.window_end,
+                    (required_frames - window_frames) * channels);
+            }
+
+            const f32* window = v.window.data() + v.window_begin;
+            const std::size_t available_frames = (v.window_end - v.window_begin) / channels;
+            const std::size_t usable_frames = stream_finished || !available_frames
+                ? available_frames
+                : available_frames - 1u;
+
+            std::size_t produced = 0u;
+            if ( usable_frames ) {
+                const std::size_t max_frames = v.position < usable_frames
+                    ? math::min(frames, static_cast<std::size_t>(
+                        std::ceil((usable_frames - v.position) / step)))
+                    : 0u;
+                produced = resample_to_stereo(
+                    window, available_frames, channels,
+                    v.position, step, false,
+                    voice_bus_.data(), max_frames);
+            }
+
+            const std::size_t consumed_frames = math::min(
+                static_cast<std::size_t>(v.position),
+                available_frames);
+            v.window_begin += consumed_frames * channels;
+            if ( v.window_begin == v.window_end ) {
+                v.window_begin = 0u;
+                v.window_end = 0u;
+            }
+            v.position -= static_cast<f64>(consumed_frames);
+
+            if ( produced < frames ) {
+                if ( stream_finished && stream.ring().size() == 0u ) {
+                    finished = true;
+                } else {
+                    stream_underruns_.fetch_add(1u, std::memory_order_relaxed);
+                }
+            }
+
+            schedule_refill_(v.stream);
+            return produced;
+        }
+
+        void mix_block_(std::size_t frames) noexcept {
+            E2D_ASSERT(frames <= params_.block_frames());
+            const auto begin_time = time::now_us<u64>();
+
+            std::fill(mix_bus_.begin(), mix_bus_.end(), 0.f);
+
+            for ( std::size_t i = 0; i < voices_.size(); ) {
+                voice& v = voices_[i];
+                bool finished = false;
+
+                if ( !v.paused && v.pitch > 0.f ) {
+                    std::size_t produced = 0u;
+                    if ( v.sound ) {
+                        produced = render_sound_voice_(v, frames);
+                        finished = produced < frames;
+                    } else if ( v.stream ) {
+                        produced = render_stream_voice_(v, frames, finished);
+                    } else {
+                        finished = true;
+                    }
+                    mix_add_samples(
+                        mix_bus_.data(),
+                        voice_bus_.data(),
+                        produced * output_channels,
+                        v.volume);
+                }
+
+                if ( finished ) {
+                    if ( v.stream ) {
+                        v.stream->cancel();
+                    }
+                    voices_[i] = std::move(voices_.back());
+                    voices_.pop_back();
+                } else {
+                    ++i;
+                }
+            }
+
+            apply_master_gain(
+                mix_bus_.data(),
+                frames * output_channels,
+                master_volume_);
+
+            if ( !sink_->on_mix(mix_bus_.data(), frames, params_.sample_rate()) && !sink_failed_ ) {
+                sink_failed_ = true;
+                debug_.error("AUDIO: Failed to pass mixed block to the sink");
+            }
+
+            active_voices_.store(
+                math::numeric_cast<u32>(voices_.size()),
+                std::memory_order_relaxed);
+            mixed_frames_.fetch_add(frames, std::memory_order_relaxed);
+            mix_time_us_.store(
+                (time::now_us<u64>() - begin_time).value,
+                std::memory_order_relaxed);
+        }
+    private:
+        debug& debug_;
+        sink_uptr sink_;
+        parameters params_;
+        command_queue<command> commands_;
+        std::mutex idle_mutex_;
+        std::condition_variable idle_cond_;
+        std::atomic<bool> mixer_idle_{false};
+        std::atomic<bool> exit_{false};
+        vector<voice> voices_;
+        vector<f32> mix_bus_;
+        vector<f32> voice_bus_;
+        f32 master_volume_{1.f};
+        bool sink_failed_{false};
+        std::thread thread_;
+        std::atomic<voice_id> last_voice_id_{0u};
+        std::atomic<u32> active_voices_{0u};
+        std::atomic<u64> mixed_frames_{0u};
+        std::atomic<u64> mix_time_us_{0u};
+        std::atomic<u32> stream_underruns_{0u};
+        std::atomic<u32> dropped_voices_{0u};
+        std::atomic<u32> dropped_commands_{0u};
+    };
+
+    //
+    // audio
+    //
+
+    audio::audio(debug& d, sink_uptr sink, const parameters& params)
+    : state_(new internal_state(d, std::move(sink), params)) {}
+    audio::~audio() noexcept = default;
+
+    audio::voice_id audio::play(
+        const sound_ptr& sound,
+        f32 volume,
+        f32 pitch,
+        bool looped)
+    {
+        if ( !sound || sound->empty() || !sound->sample_rate() ) {
+            return invalid_voice;
+        }
+        command cmd;
+        cmd.type = command::types::play;
+        cmd.voice = state_->next_voice_id();
+        cmd.value = volume;
+        cmd.pitch = pitch;
+        cmd.flag = looped;
+        cmd.sound = sound;
+        const voice_id id = cmd.voice;
+        return state_->push_command(std::move(cmd))
+            ? id
+            : invalid_voice;
+    }
+
+    audio::voice_id audio::play(
+        sound_stream_uptr stream,
+        f32 volume,
+        f32 pitch,
+        bool looped)
+    {
+        if ( !stream || !stream->channels() || !stream->sample_rate() ) {
+            return invalid_voice;
+        }
+        command cmd;
+        cmd.type = command::types::play;
+        cmd.voice = state_->next_voice_id();
+        cmd.value = volume;
+        cmd.pitch = pitch;
+        cmd.stream = std::make_shared<stream_state>(std::move(stream), looped);
+        cmd.window = state_->make_stream_window(*cmd.stream, pitch);
+        state_->prefill_stream(cmd.stream);
+        const voice_id id = cmd.voice;
+        return state_->push_command(std::move(cmd))
+            ? id
+            : invalid_voice;
+    }
+
+    bool audio::stop(voice_id voice) {
+        command cmd;
+        cmd.type = command::types::stop;
+        cmd.voice = voice;
+        return state_->push_command(std::move(cmd));
+    }
+
+    bool audio::stop_all() {
+        command cmd;
+        cmd.type = command::types::stop_all;
+        return state_->push_command(std::move(cmd));
+    }
+
+    bool audio::pause(voice_id voice, bool value) {
+        command cmd;
+        cmd.type = command::types::pause;
+        cmd.voice = voice;
+        cmd.flag = value;
+        return state_->push_command(std::move(cmd));
+    }
+
+    bool audio::volume(voice_id voice, f32 value) {
+        command cmd;
+        cmd.type = command::types::volume;
+        cmd.voice = voice;
+        cmd.value = value;
+        return state_->push_command(std::move(cmd));
+    }
+
+    bool audio::pitch(voice_id voice, f32 value) {
+        command cmd;
+        cmd.type = command::types::pitch;
+        cmd.voice = voice;
+        cmd.value = value;
+        return state_->push_command(std::move(cmd));
+    }
+
+    bool audio::master_volume(f32 value) {
+        command cmd;
+        cmd.type = command::types::master_volume;
+        cmd.value = value;
+        return state_->push_command(std::move(cmd));
+    }
+
+    void audio::mix(std::size_t frames) {
+        state_->mix(frames);
+    }
+
+    u32 audio::sample_rate() const noexcept {
+        return state_->sample_rate();
+    }
+
+    audio::statistics audio::stats() const noexcept {
+        return state_->stats();
+    }
+
+    //
+    // audio_null_sink
+    //
+
+    bool audio_null_sink::on_mix(
+        const f32* samples,
+        std::size_t frames,
+        u32 sample_rate) noexcept
+    {
+        E2D_UNUSED(samples, frames, sample_rate);
+        return true;
+    }
+
+    //
+    // audio_wav_sink
+    //
+
+    audio_wav_sink::audio_wav_sink(output_stream_uptr stream)
+    : stream_(std::move(stream)) {
+        if ( !stream_ ) {
+            throw bad_audio_operation();
+        }
+    }
+
+    audio_wav_sink::~audio_wav_sink() noexcept {
+        if ( !header_written_ ) {
+            return;
+        }
+        const u32 data_size = math::numeric_cast<u32>(
+            math::min(data_size_, std::size_t(std::numeric_limits<u32>::max() - 36u)));
+        output_sequence(*stream_)
+            .seek(4, false)
+            .write(data_size + 36u)
+            .seek(40, false)
+            .write(data_size)
+            .flush();
+    }
+
+    bool audio_wav_sink::on_mix(
+        const f32* samples,
+        std::size_t frames,
+        u32 sample_rate) noexcept
+    {
+        output_sequence oseq(*stream_);
+
+        if ( !header_written_ ) {
+            const u16 block_align = static_cast<u16>(output_channels * sizeof(i16));
+            oseq.write("RIFF", 4u)
+                .write(u32(36u))
+                .write("WAVEfmt ", 8u)
+                .write(u32(16u))
+                .write(u16(1u))
+                .write(u16(output_channels))
+                .write(sample_rate)
+                .write(u32(sample_rate * block_align))
+                .write(block_align)
+                .write(u16(16u))
+                .write("data", 4u)
+                .write(u32(0u));
+            header_written_ = oseq.success();
+        }
+
+        try {
+            pcm_.resize(frames * output_channels);
+        } catch (...) {
+            return false;
+        }
+
+        for ( std::size_t i = 0; i < pcm_.size(); ++i ) {
+            pcm_[i] = static_cast<i16>(math::clamp(samples[i], -1.f, 1.f) * 32767.f);
+        }
+
+        oseq.write(pcm_.data(), pcm_.size() * sizeof(i16));
+        if ( oseq.success() ) {
+            data_size_ += pcm_.size() * sizeof(i16);
+        }
+        return oseq.success();
+    }
+}
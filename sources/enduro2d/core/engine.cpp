@@ -6,6 +6,7 @@
 
 #include <enduro2d/core/engine.hpp>
 
+#include <enduro2d/core/audio.hpp>
 #include <enduro2d/core/dbgui.hpp>
 #include <enduro2d/core/debug.hpp>
 #include <enduro2d/core/deferrer.hpp>
@@ -174,6 +175,11 @@ namespace e2d
         return *this;
     }
 
+    engine::parameters& engine::parameters::without_audio(bool value) {
+        without_audio_ = value;
+        return *this;
+    }
+
     engine::parameters& engine::parameters::debug_params(const debug_parameters& value) {
         debug_params_ = value;
         return *this;
@@ -201,6 +207,10 @@ namespace e2d
         return without_graphics_;
     }
 
+    bool& engine::parameters::without_audio() noexcept {
+        return without_audio_;
+    }
+
     engine::debug_parameters& engine::parameters::debug_params() noexcept {
         return debug_params_;
     }
@@ -225,6 +235,10 @@ namespace e2d
         return without_graphics_;
     }
 
+    const bool& engine::parameters::without_audio() const noexcept {
+        return without_audio_;
+    }
+
     const engine::debug_parameters& engine::parameters::debug_params() const noexcept {
         return debug_params_;
     }
@@ -315,6 +329,26 @@ namespace e2d
                 frame_rate_.store(frame_rate_counter_.exchange(0));
             }
         }
+
+        // the null sink has no device clock, so the engine
+        // mixes as many frames as the last frame took
+        void mix_audio() {
+            if ( !mix_audio_ || !modules::is_initialized<audio>() ) {
+                return;
+            }
+            audio_time_us_ += delta_time_us_.load();
+            const u64 frames = audio_time_us_
+                * the<audio>().sample_rate()
+                / time::second_us<u64>().value;
+            if ( frames > audio_frames_ ) {
+                the<audio>().mix(math::numeric_cast<std::size_t>(frames - audio_frames_));
+                audio_frames_ = frames;
+            }
+        }
+
+        void set_mix_audio(bool value) noexcept {
+            mix_audio_ = value;
+        }
     private:
         timer_parameters timer_params_;
         microseconds<u64> init_time_{time::now_us<u64>()};
@@ -325,6 +359,9 @@ namespace e2d
         std::atomic<u32> frame_rate_{0};
         std::atomic<u32> frame_count_{0};
         std::atomic<u32> frame_rate_counter_{0};
+        bool mix_audio_{false};
+        u64 audio_time_us_{0u};
+        u64 audio_frames_{0u};
     };
 
     //
@@ -376,6 +413,18 @@ namespace e2d
 
         safe_module_initialize<input>();
 
+        // setup audio
+
+        // without an audio device the frame loop drives the mixer
+        if ( !params.without_audio() && !modules::is_initialized<audio>() ) {
+            modules::initialize<audio>(
+                the<debug>(),
+                std::make_unique<audio_null_sink>(),
+                audio::parameters()
+                    .mixer_thread(false));
+            state_->set_mix_audio(true);
+        }
+
         // setup graphics
 
         if ( !params.without_graphics() )
@@ -410,6 +459,7 @@ namespace e2d
         modules::shutdown<dbgui>();
         modules::shutdown<render>();
         modules::shutdown<window>();
+        modules::shutdown<audio>();
         modules::shutdown<input>();
         modules::shutdown<vfs>();
         modules::shutdown<debug>();
@@ -441,6 +491,7 @@ namespace e2d
                 }
 
                 state_->calculate_end_frame_timers();
+                state_->mix_audio();
             } catch ( ... ) {
                 app->shutdown();
                 throw;
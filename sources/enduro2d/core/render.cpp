@@ -786,6 +786,11 @@ namespace e2d
         return *this;
     }
 
+    render::pass_state& render::pass_state::variant(u32 variant) noexcept {
+        variant_ = variant;
+        return *this;
+    }
+
     shader_ptr& render::pass_state::shader() noexcept {
         return shader_;
     }
@@ -810,6 +815,10 @@ namespace e2d
         return properties_;
     }
 
+    u32 render::pass_state::variant() const noexcept {
+        return variant_;
+    }
+
     //
     // material
     //
@@ -1252,7 +1261,8 @@ namespace e2d
     bool operator==(const render::pass_state& l, const render::pass_state& r) noexcept {
         return l.shader() == r.shader()
             && l.states() == r.states()
-            && l.properties() == r.properties();
+            && l.properties() == r.properties()
+            && l.variant() == r.variant();
     }
 
     bool operator!=(const render::pass_state& l, const render::pass_state& r) noexcept {
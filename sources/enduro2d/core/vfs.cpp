@@ -4,7 +4,9 @@
  * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
  ******************************************************************************/
 
-#include <enduro2d/core/vfs.hpp>
+#include "vfs_impl/async_reader.hpp"
+
+#include <enduro2d/core/deferrer.hpp>
 
 #include <3rdparty/miniz/miniz_zip.h>
 
@@ -21,9 +23,9 @@ namespace
         OwnedState owned_state_;
         iter_state_uptr iter_state_;
     public:
-        archive_stream(const OwnedState& owned_state, mz_zip_archive* archive, const char* filename)
+        archive_stream(const OwnedState& owned_state, mz_zip_archive* archive, mz_uint32 file_index)
         : owned_state_(owned_state)
-        , iter_state_(open_iter_state_(archive, filename))
+        , iter_state_(open_iter_state_(archive, file_index))
         {
             if ( !iter_state_ ) {
                 throw bad_vfs_operation();
@@ -56,9 +58,9 @@ namespace
                 iter_state_->file_stat.m_uncomp_size);
         }
     private:
-        static iter_state_uptr open_iter_state_(mz_zip_archive* archive, const char* filename) noexcept {
-            mz_zip_reader_extract_iter_state* iter_state = mz_zip_reader_extract_file_iter_new(
-                archive, filename, MZ_ZIP_FLAG_CASE_SENSITIVE);
+        static iter_state_uptr open_iter_state_(mz_zip_archive* archive, mz_uint32 file_index) noexcept {
+            mz_zip_reader_extract_iter_state* iter_state = mz_zip_reader_extract_iter_new(
+                archive, file_index, 0);
             return iter_state_uptr(iter_state, state_deleter_);
         }
 
@@ -72,38 +74,146 @@ namespace
 
 namespace e2d
 {
+    //
+    // vfs::file_source
+    //
+
+    bool vfs::file_source::load_async(
+        str_view path,
+        stdex::promise<buffer>& dst,
+        bool zero_terminated) const
+    {
+        E2D_UNUSED(path, dst, zero_terminated);
+        return false;
+    }
+
+    void vfs::file_source::invalidate(str_view path) const {
+        E2D_UNUSED(path);
+    }
+
     //
     // vfs
     //
 
     class vfs::state final : private e2d::noncopyable {
+    public:
+        using file_source_sptr = std::shared_ptr<file_source>;
+
+        // scheme with flattened aliases, alias prefixes
+        // are stored in the order of resolving
+        struct route final {
+            str scheme;
+            str target_scheme;
+            vector<str> prefixes;
+            file_source_sptr source;
+            bool cyclic{false};
+        };
+
+        using routes_t = vector<route>;
+        using routes_cptr = std::shared_ptr<const routes_t>;
     public:
         std::mutex mutex;
         stdex::jobber worker{1};
         hash_map<str, url> aliases;
-        hash_map<str, file_source_uptr> schemes;
+        hash_map<str, file_source_sptr> schemes;
     public:
-        url resolve_url(const url& url, u8 level = 0) const {
-            if ( level > 32 ) {
+        state() {
+            rebuild_routes();
+        }
+
+        routes_cptr snapshot() const noexcept {
+            return std::atomic_load(&routes_);
+        }
+
+        // must be called under the mutex after any change
+        // of the aliases or the schemes, readers don't lock
+        void rebuild_routes() {
+            auto nroutes = std::make_shared<routes_t>();
+            nroutes->reserve(aliases.size() + schemes.size());
+            for ( const auto& alias : aliases ) {
+                nroutes->push_back(make_alias_route_(alias.first));
+            }
+            for ( const auto& scheme : schemes ) {
+                if ( aliases.find(scheme.first) == aliases.end() ) {
+                    nroutes->push_back(route{scheme.first, scheme.first, {}, scheme.second, false});
+                }
+            }
+            std::sort(nroutes->begin(), nroutes->end(),
+                [](const route& l, const route& r) noexcept {
+                    return l.scheme < r.scheme;
+                });
+            std::atomic_store(&routes_, routes_cptr(std::move(nroutes)));
+        }
+
+        static const route* find_route(const routes_t& routes, str_view scheme) noexcept {
+            const auto iter = std::lower_bound(
+                routes.begin(), routes.end(), scheme,
+                [](const route& r, str_view s) noexcept {
+                    return str_view(r.scheme) < s;
+                });
+            return iter != routes.end() && iter->scheme == scheme
+                ? &*iter
+                : nullptr;
+        }
+
+        url resolve_url(const url& url) const {
+            const routes_cptr routes = snapshot();
+            const route* r = find_route(*routes, url.scheme());
+            if ( !r ) {
+                return url;
+            }
+            if ( r->cyclic ) {
                 throw bad_vfs_operation();
             }
-            const auto alias_iter = aliases.find(url.scheme());
-            return alias_iter != aliases.cend()
-                ? resolve_url(alias_iter->second / url.path(), level + 1)
-                : url;
+            str path = url.path();
+            for ( const str& prefix : r->prefixes ) {
+                path = path::combine(prefix, path);
+            }
+            return e2d::url(r->target_scheme, std::move(path));
         }
 
         template < typename F, typename R >
         R with_file_source(const url& url, F&& f, R&& fallback_result) const {
-            const auto resolved_url = resolve_url(url);
-            const auto scheme_iter = schemes.find(resolved_url.scheme());
-            return (scheme_iter != schemes.cend() && scheme_iter->second)
-                ? stdex::invoke(
-                    std::forward<F>(f),
-                    scheme_iter->second,
-                    resolved_url.path())
-                : std::forward<R>(fallback_result);
+            const routes_cptr routes = snapshot();
+            const route* r = find_route(*routes, url.scheme());
+            if ( r && r->cyclic ) {
+                throw bad_vfs_operation();
+            }
+            if ( !r || !r->source ) {
+                return std::forward<R>(fallback_result);
+            }
+            if ( r->prefixes.empty() ) {
+                return stdex::invoke(std::forward<F>(f), *r->source, url.path());
+            }
+            str path = url.path();
+            for ( const str& prefix : r->prefixes ) {
+                path = path::combine(prefix, path);
+            }
+            return stdex::invoke(std::forward<F>(f), *r->source, path);
+        }
+    private:
+        route make_alias_route_(const str& scheme) const {
+            route r{scheme, scheme, {}, nullptr, false};
+            for ( u8 level = 0; ; ++level ) {
+                const auto alias_iter = aliases.find(r.target_scheme);
+                if ( alias_iter == aliases.end() ) {
+                    break;
+                }
+                if ( level > 32 ) {
+                    r.cyclic = true;
+                    return r;
+                }
+                r.prefixes.push_back(alias_iter->second.path());
+                r.target_scheme = alias_iter->second.scheme();
+            }
+            const auto scheme_iter = schemes.find(r.target_scheme);
+            if ( scheme_iter != schemes.end() ) {
+                r.source = scheme_iter->second;
+            }
+            return r;
         }
+    private:
+        routes_cptr routes_;
     };
 
     vfs::vfs()
@@ -113,65 +223,91 @@ namespace e2d
 
     bool vfs::register_scheme(str_view scheme, file_source_uptr source) {
         std::lock_guard<std::mutex> guard(state_->mutex);
-        return (source && source->valid())
-            ? state_->schemes.insert(
-                std::make_pair(scheme, std::move(source))).second
-            : false;
+        if ( !source || !source->valid() ) {
+            return false;
+        }
+        if ( !state_->schemes.insert(std::make_pair(scheme, std::move(source))).second ) {
+            return false;
+        }
+        state_->rebuild_routes();
+        return true;
     }
 
     bool vfs::unregister_scheme(str_view scheme) {
         std::lock_guard<std::mutex> guard(state_->mutex);
-        return state_->schemes.erase(scheme) > 0;
+        if ( !state_->schemes.erase(scheme) ) {
+            return false;
+        }
+        state_->rebuild_routes();
+        return true;
     }
 
     bool vfs::register_scheme_alias(str_view scheme, url alias) {
         std::lock_guard<std::mutex> guard(state_->mutex);
-        return state_->aliases.insert(
-            std::make_pair(scheme, alias)).second;
+        if ( !state_->aliases.insert(std::make_pair(scheme, alias)).second ) {
+            return false;
+        }
+        state_->rebuild_routes();
+        return true;
     }
 
     bool vfs::unregister_scheme_alias(str_view scheme) {
         std::lock_guard<std::mutex> guard(state_->mutex);
-        return state_->aliases.erase(scheme) > 0;
+        if ( !state_->aliases.erase(scheme) ) {
+            return false;
+        }
+        state_->rebuild_routes();
+        return true;
     }
 
     bool vfs::exists(const url& url) const {
-        std::lock_guard<std::mutex> guard(state_->mutex);
         return state_->with_file_source(url,
-            [](const file_source_uptr& source, const str& path) {
-                return source->exists(path);
+            [](const file_source& source, str_view path) {
+                return source.exists(path);
             }, false);
     }
 
     input_stream_uptr vfs::read(const url& url) const {
-        std::lock_guard<std::mutex> guard(state_->mutex);
         return state_->with_file_source(url,
-            [](const file_source_uptr& source, const str& path) {
-                return source->read(path);
+            [](const file_source& source, str_view path) {
+                return source.read(path);
             }, input_stream_uptr());
     }
 
     output_stream_uptr vfs::write(const url& url, bool append) const {
-        std::lock_guard<std::mutex> guard(state_->mutex);
         return state_->with_file_source(url,
-            [&append](const file_source_uptr& source, const str& path) {
-                return source->write(path, append);
+            [&append](const file_source& source, str_view path) {
+                return source.write(path, append);
             }, output_stream_uptr());
     }
 
-    bool vfs::load(const url& url, buffer& dst) const {
-        return load_async(url)
+    bool vfs::load(const url& url, buffer& dst, bool zero_terminated) const {
+        return load_async(url, zero_terminated)
             .then([&dst](auto&& src){
                 dst = std::forward<decltype(src)>(src);
                 return true;
             }).get_or_default(false);
     }
 
-    stdex::promise<buffer> vfs::load_async(const url& url) const {
-        return state_->worker.async([this, url](){
-            buffer content;
+    stdex::promise<buffer> vfs::load_async(const url& url, bool zero_terminated) const {
+        {
+            stdex::promise<buffer> result;
+            const bool native = state_->with_file_source(url,
+                [&result, zero_terminated](const file_source& source, str_view path) {
+                    return source.load_async(path, result, zero_terminated);
+                }, false);
+            if ( native ) {
+                return result;
+            }
+        }
+        return state_->worker.async([this, url, zero_terminated](){
             const input_stream_uptr stream = read(url);
-            if ( !stream || !streams::try_read_tail(content, stream) ) {
+            if ( !stream ) {
+                throw vfs_load_async_exception();
+            }
+            const std::size_t length = stream->length() - stream->tell();
+            buffer content(length + (zero_terminated ? 1u : 0u));
+            if ( !input_sequence(*stream).read(content.data(), length).success() ) {
                 throw vfs_load_async_exception();
             }
             return content;
@@ -198,15 +334,21 @@ namespace e2d
     }
 
     bool vfs::trace(const url& url, filesystem::trace_func func) const {
-        std::lock_guard<std::mutex> guard(state_->mutex);
         return state_->with_file_source(url,
-            [&func](const file_source_uptr& source, const str& path) {
-                return source->trace(path, func);
+            [&func](const file_source& source, str_view path) {
+                return source.trace(path, func);
+            }, false);
+    }
+
+    void vfs::invalidate(const url& url) const {
+        state_->with_file_source(url,
+            [](const file_source& source, str_view path) {
+                source.invalidate(path);
+                return true;
             }, false);
     }
 
     url vfs::resolve_scheme_aliases(const url& url) const {
-        std::lock_guard<std::mutex> guard(state_->mutex);
         return state_->resolve_url(url);
     }
 
@@ -214,26 +356,67 @@ namespace e2d
     // archive_file_source
     //
 
+    constexpr std::size_t archive_file_source::default_read_ahead;
+
     class archive_file_source::state final : private e2d::noncopyable {
     public:
+        // miniz reads the archive by callbacks from many
+        // streams at once, so the source stream is locked
+        struct archive_io final {
+            input_stream_uptr stream;
+            std::mutex mutex;
+        };
+
+        // miniz locates case sensitive names by the linear scan,
+        // so the sorted index of the central directory is cached
+        struct archive_entry final {
+            str filename;
+            mz_uint32 index{0u};
+            bool directory{false};
+        };
+
+        using io_ptr = std::shared_ptr<archive_io>;
         using archive_ptr = std::shared_ptr<mz_zip_archive>;
-        using stream_ptr = std::shared_ptr<input_stream>;
+        io_ptr io;
         archive_ptr archive;
-        stream_ptr stream;
+        vector<archive_entry> entries;
+        std::size_t read_ahead{0u};
     public:
-        state(input_stream_uptr nstream)
-        : archive(open_archive_(nstream))
-        , stream(std::move(nstream)) {}
+        state(input_stream_uptr nstream, std::size_t nread_ahead)
+        : io(open_io_(std::move(nstream), nread_ahead))
+        , archive(open_archive_(io))
+        , entries(make_entries_(archive))
+        , read_ahead(nread_ahead) {}
         ~state() noexcept = default;
+
+        const archive_entry* find_entry(str_view filename) const noexcept {
+            const auto iter = std::lower_bound(
+                entries.begin(), entries.end(), filename,
+                [](const archive_entry& e, str_view f) noexcept {
+                    return str_view(e.filename) < f;
+                });
+            return iter != entries.end() && iter->filename == filename
+                ? &*iter
+                : nullptr;
+        }
     private:
-        static archive_ptr open_archive_(const input_stream_uptr& stream) noexcept {
-            if ( stream ) {
+        static io_ptr open_io_(input_stream_uptr stream, std::size_t read_ahead) {
+            if ( !stream ) {
+                return nullptr;
+            }
+            io_ptr io = std::make_shared<archive_io>();
+            io->stream = make_buffered_stream(std::move(stream), read_ahead);
+            return io;
+        }
+
+        static archive_ptr open_archive_(const io_ptr& io) noexcept {
+            if ( io ) {
                 mz_zip_archive* archive = static_cast<mz_zip_archive*>(
                     std::calloc(1, sizeof(mz_zip_archive)));
                 if ( archive ) {
                     archive->m_pRead = archive_reader_;
-                    archive->m_pIO_opaque = stream.get();
-                    if ( mz_zip_reader_init(archive, stream->length(), 0) ) {
+                    archive->m_pIO_opaque = io.get();
+                    if ( mz_zip_reader_init(archive, io->stream->length(), 0) ) {
                         return archive_ptr(archive, archive_deleter_);
                     }
                     std::free(archive);
@@ -242,6 +425,28 @@ namespace e2d
             return archive_ptr();
         }
 
+        static vector<archive_entry> make_entries_(const archive_ptr& archive) {
+            vector<archive_entry> result;
+            if ( archive ) {
+                const mz_uint num_files = mz_zip_reader_get_num_files(archive.get());
+                result.reserve(num_files);
+                for ( mz_uint i = 0; i < num_files; ++i ) {
+                    mz_zip_archive_file_stat file_stat;
+                    if ( mz_zip_reader_file_stat(archive.get(), i, &file_stat) ) {
+                        result.push_back(archive_entry{
+                            file_stat.m_filename,
+                            i,
+                            !!file_stat.m_is_directory});
+                    }
+                }
+                std::sort(result.begin(), result.end(),
+                    [](const archive_entry& l, const archive_entry& r) noexcept {
+                        return l.filename < r.filename;
+                    });
+            }
+            return result;
+        }
+
         static void archive_deleter_(mz_zip_archive* archive) noexcept {
             if ( archive ) {
                 mz_zip_reader_end(archive);
@@ -250,16 +455,19 @@ namespace e2d
         }
 
         static size_t archive_reader_(void* opaque, mz_uint64 pos, void* dst, size_t size) noexcept {
-            input_stream* stream = static_cast<input_stream*>(opaque);
-            return input_sequence(*stream)
+            archive_io* io = static_cast<archive_io*>(opaque);
+            std::lock_guard<std::mutex> guard(io->mutex);
+            return input_sequence(*io->stream)
                 .seek(math::numeric_cast<std::ptrdiff_t>(pos), false)
                 .read(dst, size)
                 .success() ? size : 0;
         }
     };
 
-    archive_file_source::archive_file_source(input_stream_uptr stream)
-    : state_(new state(std::move(stream))) {}
+    archive_file_source::archive_file_source(
+        input_stream_uptr stream,
+        std::size_t read_ahead)
+    : state_(new state(std::move(stream), read_ahead)) {}
     archive_file_source::~archive_file_source() noexcept = default;
 
     bool archive_file_source::valid() const noexcept {
@@ -267,23 +475,25 @@ namespace e2d
     }
 
     bool archive_file_source::exists(str_view path) const {
-        return -1 != mz_zip_reader_locate_file(
-            state_->archive.get(),
-            make_utf8(path).c_str(),
-            nullptr,
-            MZ_ZIP_FLAG_CASE_SENSITIVE);
+        return !!state_->find_entry(path);
     }
 
     input_stream_uptr archive_file_source::read(str_view path) const {
         try {
+            const state::archive_entry* entry = state_->find_entry(path);
+            if ( !entry ) {
+                return nullptr;
+            }
             struct owned_state_t {
                 state::archive_ptr archive;
-                state::stream_ptr stream;
-            } owned_state{state_->archive, state_->stream};
-            return std::make_unique<archive_stream<owned_state_t>>(
-                std::move(owned_state),
-                state_->archive.get(),
-                make_utf8(path).c_str());
+                state::io_ptr io;
+            } owned_state{state_->archive, state_->io};
+            return make_buffered_stream(
+                std::make_unique<archive_stream<owned_state_t>>(
+                    std::move(owned_state),
+                    state_->archive.get(),
+                    entry->index),
+                state_->read_ahead);
         } catch (...) {
             return nullptr;
         }
@@ -300,24 +510,8 @@ namespace e2d
             if ( parent.back() != '/' ) {
                 parent += '/';
             }
-            mz_uint32 dir_index = 0;
-            if ( !mz_zip_reader_locate_file_v2(
-                state_->archive.get(),
-                parent.c_str(),
-                nullptr,
-                MZ_ZIP_FLAG_CASE_SENSITIVE,
-                &dir_index) )
-            {
-                return false;
-            }
-            mz_zip_archive_file_stat dir_stat;
-            if ( !mz_zip_reader_file_stat(
-                state_->archive.get(),
-                dir_index, &dir_stat) )
-            {
-                return false;
-            }
-            if ( !dir_stat.m_is_directory ) {
+            const state::archive_entry* dir_entry = state_->find_entry(parent);
+            if ( !dir_entry || !dir_entry->directory ) {
                 return false;
             }
         }
@@ -334,11 +528,167 @@ namespace e2d
         return true;
     }
 
+    //
+    // pack_file_source
+    //
+
+    class pack_file_source::state final : private e2d::noncopyable {
+    public:
+        pack_reader reader;
+    public:
+        state(input_stream_uptr stream)
+        : reader(std::move(stream)) {}
+        ~state() noexcept = default;
+    };
+
+    pack_file_source::pack_file_source(input_stream_uptr stream)
+    : state_(new state(std::move(stream))) {}
+    pack_file_source::~pack_file_source() noexcept = default;
+
+    bool pack_file_source::valid() const noexcept {
+        return state_->reader.valid();
+    }
+
+    bool pack_file_source::exists(str_view path) const {
+        return !!state_->reader.find(path);
+    }
+
+    input_stream_uptr pack_file_source::read(str_view path) const {
+        const pack_reader::entry* entry = state_->reader.find(path);
+        if ( !entry ) {
+            return nullptr;
+        }
+        buffer content;
+        if ( !state_->reader.read(*entry, content) ) {
+            return nullptr;
+        }
+        return make_memory_stream(std::move(content));
+    }
+
+    output_stream_uptr pack_file_source::write(str_view path, bool append) const {
+        E2D_UNUSED(path, append);
+        return nullptr;
+    }
+
+    bool pack_file_source::trace(str_view path, filesystem::trace_func func) const {
+        if ( !valid() ) {
+            return false;
+        }
+        str parent = make_utf8(path);
+        if ( !parent.empty() && parent.back() != '/' ) {
+            parent += '/';
+        }
+        // packs have no directory entries, so they are
+        // synthesized from file paths like zip archives have them
+        bool parent_found = parent.empty();
+        hash_set<str> directories;
+        for ( const pack_reader::entry& entry : state_->reader.entries() ) {
+            const str_view filename{entry.path};
+            if ( filename.length() <= parent.length() || !filename.starts_with(parent) ) {
+                continue;
+            }
+            parent_found = true;
+            for ( auto sep = std::find(filename.begin() + parent.length(), filename.end(), '/');
+                sep != filename.end();
+                sep = std::find(sep + 1, filename.end(), '/') )
+            {
+                str directory(filename.begin(), sep + 1);
+                if ( directories.insert(directory).second ) {
+                    func(directory, true);
+                }
+            }
+            func(entry.path, false);
+        }
+        return parent_found;
+    }
+
     //
     // filesystem_file_source
     //
 
-    filesystem_file_source::filesystem_file_source() = default;
+    constexpr std::size_t filesystem_file_source::default_read_ahead;
+    constexpr std::size_t filesystem_file_source::default_async_queue_depth;
+
+    class filesystem_file_source::state final : private e2d::noncopyable {
+    public:
+        using listing = vector<str>;
+        using listing_cptr = std::shared_ptr<const listing>;
+    public:
+        std::size_t read_ahead{0u};
+        std::unique_ptr<vfs_impl::async_reader> async_reader;
+        bool listing_cache{false};
+    public:
+        state(std::size_t nread_ahead, std::size_t async_queue_depth, bool nlisting_cache)
+        : read_ahead(nread_ahead)
+        , async_reader(async_queue_depth
+            ? std::make_unique<vfs_impl::async_reader>(async_queue_depth)
+            : nullptr)
+        , listing_cache(nlisting_cache) {}
+        ~state() noexcept = default;
+
+        bool cached_file_exists(str_view path) {
+            const str_view directory = directory_of_(path);
+            const str_view filename = path.substr(directory.size());
+            const listing_cptr files = find_or_load_listing_(directory);
+            return std::binary_search(files->begin(), files->end(), filename,
+                [](const auto& l, const auto& r) noexcept {
+                    return str_view(l) < str_view(r);
+                });
+        }
+
+        // drops listings of the path directory and all its subdirectories
+        void invalidate(str_view path) {
+            const str_view directory = directory_of_(path);
+            std::lock_guard<std::mutex> guard(listings_mutex_);
+            for ( auto iter = listings_.lower_bound(directory); iter != listings_.end(); ) {
+                if ( !str_view(iter->first).starts_with(directory) ) {
+                    break;
+                }
+                iter = listings_.erase(iter);
+            }
+        }
+    private:
+        // the path prefix up to the last separator inclusive
+        static str_view directory_of_(str_view path) noexcept {
+            const auto sep = std::find_if(path.rbegin(), path.rend(), [](char c) noexcept {
+                return c == '/' || c == '\\';
+            });
+            return path.substr(0, static_cast<std::size_t>(path.rend() - sep));
+        }
+
+    private:
+        listing_cptr find_or_load_listing_(str_view directory) {
+            {
+                std::lock_guard<std::mutex> guard(listings_mutex_);
+                const auto iter = listings_.find(directory);
+                if ( iter != listings_.end() ) {
+                    return iter->second;
+                }
+            }
+            // missing directories are cached as empty ones
+            auto files = std::make_shared<listing>();
+            filesystem::trace_directory(
+                directory.empty() ? str_view(".") : directory,
+                [&files](str_view relative, bool is_directory){
+                    if ( !is_directory ) {
+                        files->emplace_back(relative);
+                    }
+                    return true;
+                });
+            std::sort(files->begin(), files->end());
+            std::lock_guard<std::mutex> guard(listings_mutex_);
+            return listings_.emplace(directory, std::move(files)).first->second;
+        }
+    private:
+        std::mutex listings_mutex_;
+        map<str, listing_cptr, std::less<>> listings_;
+    };
+
+    filesystem_file_source::filesystem_file_source(
+        std::size_t read_ahead,
+        std::size_t async_queue_depth,
+        bool listing_cache)
+    : state_(new state(read_ahead, async_queue_depth, listing_cache)) {}
     filesystem_file_source::~filesystem_file_source() noexcept = default;
 
     bool filesystem_file_source::valid() const noexcept {
@@ -346,21 +696,53 @@ namespace e2d
     }
 
     bool filesystem_file_source::exists(str_view path) const {
-        return filesystem::file_exists(path);
+        return state_->listing_cache
+            ? state_->cached_file_exists(path)
+            : filesystem::file_exists(path);
     }
 
     input_stream_uptr filesystem_file_source::read(str_view path) const {
-        return make_read_file(path);
+        return make_buffered_stream(make_read_file(path), state_->read_ahead);
     }
 
     output_stream_uptr filesystem_file_source::write(str_view path, bool append) const {
         if ( !filesystem::create_directory_recursive(path::parent_path(path)) ) {
             return nullptr;
         }
-        return make_write_file(path, append);
+        output_stream_uptr stream = make_write_file(path, append);
+        if ( state_->listing_cache ) {
+            state_->invalidate(path);
+        }
+        return stream;
     }
 
     bool filesystem_file_source::trace(str_view path, filesystem::trace_func func) const {
-        return filesystem::trace_directory_recursive(path, func);
+        filesystem::scan_executor executor;
+        if ( modules::is_initialized<deferrer>() ) {
+            executor = [](std::function<void()> task){
+                the<deferrer>().worker().async(std::move(task));
+            };
+        }
+        return filesystem::trace_directory_recursive(path, func, executor);
+    }
+
+    bool filesystem_file_source::load_async(
+        str_view path,
+        stdex::promise<buffer>& dst,
+        bool zero_terminated) const
+    {
+        return native_async()
+            && state_->async_reader->load(path, dst, zero_terminated);
+    }
+
+    void filesystem_file_source::invalidate(str_view path) const {
+        if ( state_->listing_cache ) {
+            state_->invalidate(path);
+        }
+    }
+
+    bool filesystem_file_source::native_async() const noexcept {
+        return state_->async_reader
+            && state_->async_reader->valid();
     }
 }
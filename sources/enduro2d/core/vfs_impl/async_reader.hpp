@@ -0,0 +1,51 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <enduro2d/core/vfs.hpp>
+
+#define E2D_VFS_ASYNC_MODE_NONE 1
+#define E2D_VFS_ASYNC_MODE_URING 2
+
+#ifndef E2D_VFS_ASYNC_MODE
+#  if defined(E2D_PLATFORM) && E2D_PLATFORM == E2D_PLATFORM_LINUX && defined(__has_include)
+#    if __has_include(<linux/io_uring.h>)
+#      define E2D_VFS_ASYNC_MODE E2D_VFS_ASYNC_MODE_URING
+#    else
+#      define E2D_VFS_ASYNC_MODE E2D_VFS_ASYNC_MODE_NONE
+#    endif
+#  else
+#    define E2D_VFS_ASYNC_MODE E2D_VFS_ASYNC_MODE_NONE
+#  endif
+#endif
+
+namespace e2d { namespace vfs_impl
+{
+    //
+    // async_reader
+    //
+    // Loads whole files by the native asynchronous io of the platform.
+    // Requests are gathered by the reader thread and submitted to the
+    // kernel as one batch, promises are resolved by the reader thread.
+    // 'valid' is false when the platform (or the kernel) has no support,
+    // callers should fall back to blocking reads in this case.
+    //
+
+    class async_reader final : private noncopyable {
+    public:
+        explicit async_reader(std::size_t queue_depth);
+        ~async_reader() noexcept;
+
+        bool valid() const noexcept;
+
+        // returns false when the request can't be served asynchronously
+        bool load(str_view path, stdex::promise<buffer>& dst, bool zero_terminated);
+    private:
+        class internal_state;
+        std::unique_ptr<internal_state> state_;
+    };
+}}
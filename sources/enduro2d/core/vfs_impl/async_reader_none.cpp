@@ -0,0 +1,32 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "async_reader.hpp"
+
+#if defined(E2D_VFS_ASYNC_MODE) && E2D_VFS_ASYNC_MODE == E2D_VFS_ASYNC_MODE_NONE
+
+namespace e2d { namespace vfs_impl
+{
+    class async_reader::internal_state final : private noncopyable {
+    };
+
+    async_reader::async_reader(std::size_t queue_depth) {
+        E2D_UNUSED(queue_depth);
+    }
+
+    async_reader::~async_reader() noexcept = default;
+
+    bool async_reader::valid() const noexcept {
+        return false;
+    }
+
+    bool async_reader::load(str_view path, stdex::promise<buffer>& dst, bool zero_terminated) {
+        E2D_UNUSED(path, dst, zero_terminated);
+        return false;
+    }
+}}
+
+#endif
@@ -0,0 +1,464 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "async_reader.hpp"
+
+#if defined(E2D_VFS_ASYNC_MODE) && E2D_VFS_ASYNC_MODE == E2D_VFS_ASYNC_MODE_URING
+
+#include <linux/io_uring.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+
+#include <deque>
+#include <condition_variable>
+
+namespace
+{
+    using namespace e2d;
+
+    //
+    // uring
+    //
+    // Minimal io_uring wrapper over raw syscalls, only vectored reads
+    // (available since 5.1) are used, so older kernels are fine too.
+    //
+
+    class uring final : private noncopyable {
+    public:
+        explicit uring(u32 entries) noexcept {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if ( fd_ < 0 ) {
+                return;
+            }
+            if ( !map_rings_(params) ) {
+                unmap_rings_();
+                ::close(fd_);
+                fd_ = -1;
+            }
+        }
+
+        ~uring() noexcept {
+            unmap_rings_();
+            if ( fd_ >= 0 ) {
+                ::close(fd_);
+            }
+        }
+
+        bool valid() const noexcept {
+            return fd_ >= 0;
+        }
+
+        u32 capacity() const noexcept {
+            return sq_entries_;
+        }
+
+        bool push_readv(int fd, const iovec* iov, u64 offset, u64 user_data) noexcept {
+            const u32 tail = *sq_tail_;
+            if ( tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_ ) {
+                return false;
+            }
+            const u32 index = tail & *sq_mask_;
+            io_uring_sqe& sqe = sqes_[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READV;
+            sqe.fd = fd;
+            sqe.addr = reinterpret_cast<u64>(iov);
+            sqe.len = 1u;
+            sqe.off = offset;
+            sqe.user_data = user_data;
+            sq_array_[index] = index;
+            __atomic_store_n(sq_tail_, tail + 1u, __ATOMIC_RELEASE);
+            ++to_submit_;
+            return true;
+        }
+
+        bool submit_and_wait(u32 min_complete) noexcept {
+            if ( !to_submit_ && !min_complete ) {
+                return true;
+            }
+            for (;;) {
+                const int r = static_cast<int>(::syscall(
+                    __NR_io_uring_enter,
+                    fd_,
+                    to_submit_,
+                    min_complete,
+                    min_complete ? IORING_ENTER_GETEVENTS : 0u,
+                    nullptr,
+                    0));
+                if ( r >= 0 ) {
+                    to_submit_ -= math::min(to_submit_, static_cast<u32>(r));
+                    return true;
+                }
+                if ( errno != EINTR && errno != EAGAIN && errno != EBUSY ) {
+                    return false;
+                }
+                if ( errno != EINTR && !min_complete ) {
+                    return true;
+                }
+            }
+        }
+
+        // f(u64 user_data, i32 result)
+        template < typename F >
+        std::size_t reap(F&& f) {
+            std::size_t count = 0;
+            u32 head = *cq_head_;
+            const u32 tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            for ( ; head != tail; ++head, ++count ) {
+                const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+                const u64 user_data = cqe.user_data;
+                const i32 result = cqe.res;
+                __atomic_store_n(cq_head_, head + 1u, __ATOMIC_RELEASE);
+                f(user_data, result);
+            }
+            return count;
+        }
+    private:
+        bool map_rings_(const io_uring_params& params) noexcept {
+            sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(u32);
+            cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool single_mmap = !!(params.features & IORING_FEAT_SINGLE_MMAP);
+            if ( single_mmap ) {
+                sq_ring_size_ = cq_ring_size_ = math::max(sq_ring_size_, cq_ring_size_);
+            }
+
+            sq_ring_ = ::mmap(nullptr, sq_ring_size_, PROT_READ|PROT_WRITE,
+                MAP_SHARED|MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+            if ( sq_ring_ == MAP_FAILED ) {
+                sq_ring_ = nullptr;
+                return false;
+            }
+
+            if ( single_mmap ) {
+                cq_ring_ = sq_ring_;
+            } else {
+                cq_ring_ = ::mmap(nullptr, cq_ring_size_, PROT_READ|PROT_WRITE,
+                    MAP_SHARED|MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+                if ( cq_ring_ == MAP_FAILED ) {
+                    cq_ring_ = nullptr;
+                    return false;
+                }
+            }
+
+            sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ|PROT_WRITE,
+                MAP_SHARED|MAP_POPULATE, fd_, IORING_OFF_SQES);
+            if ( sqes == MAP_FAILED ) {
+                return false;
+            }
+            sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+            u8* sq = static_cast<u8*>(sq_ring_);
+            sq_head_ = reinterpret_cast<u32*>(sq + params.sq_off.head);
+            sq_tail_ = reinterpret_cast<u32*>(sq + params.sq_off.tail);
+            sq_mask_ = reinterpret_cast<u32*>(sq + params.sq_off.ring_mask);
+            sq_array_ = reinterpret_cast<u32*>(sq + params.sq_off.array);
+            sq_entries_ = params.sq_entries;
+
+            u8* cq = static_cast<u8*>(cq_ring_);
+            cq_head_ = reinterpret_cast<u32*>(cq + params.cq_off.head);
+            cq_tail_ = reinterpret_cast<u32*>(cq + params.cq_off.tail);
+            cq_mask_ = reinterpret_cast<u32*>(cq + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        void unmap_rings_() noexcept {
+            if ( sqes_ ) {
+                ::munmap(sqes_, sqes_size_);
+                sqes_ = nullptr;
+            }
+            if ( cq_ring_ && cq_ring_ != sq_ring_ ) {
+                ::munmap(cq_ring_, cq_ring_size_);
+            }
+            cq_ring_ = nullptr;
+            if ( sq_ring_ ) {
+                ::munmap(sq_ring_, sq_ring_size_);
+                sq_ring_ = nullptr;
+            }
+        }
+    private:
+        int fd_{-1};
+        u32 to_submit_{0u};
+
+        void* sq_ring_{nullptr};
+        void* cq_ring_{nullptr};
+        std::size_t sq_ring_size_{0u};
+        std::size_t cq_ring_size_{0u};
+
+        io_uring_sqe* sqes_{nullptr};
+        std::size_t sqes_size_{0u};
+
+        u32* sq_head_{nullptr};
+        u32* sq_tail_{nullptr};
+        u32* sq_mask_{nullptr};
+        u32* sq_array_{nullptr};
+        u32 sq_entries_{0u};
+
+        u32* cq_head_{nullptr};
+        u32* cq_tail_{nullptr};
+        u32* cq_mask_{nullptr};
+        io_uring_cqe* cqes_{nullptr};
+    };
+}
+
+namespace e2d { namespace vfs_impl
+{
+    //
+    // async_reader::internal_state
+    //
+
+    class async_reader::internal_state final : private noncopyable {
+    public:
+        internal_state(std::size_t queue_depth)
+        : ring_(math::numeric_cast<u32>(math::clamp(queue_depth, std::size_t(1u), std::size_t(4096u))))
+        {
+            if ( ring_.valid() ) {
+                slots_.resize(ring_.capacity());
+                thread_ = std::thread([this](){ process_(); });
+            }
+        }
+
+        ~internal_state() noexcept {
+            if ( thread_.joinable() ) {
+                {
+                    std::lock_guard<std::mutex> guard(mutex_);
+                    exit_ = true;
+                }
+                cond_var_.notify_one();
+                thread_.join();
+            }
+        }
+
+        bool valid() const noexcept {
+            return ring_.valid();
+        }
+
+        bool load(str_view path, stdex::promise<buffer>& dst, bool zero_terminated) {
+            // the reader thread must not wait for itself
+            if ( !ring_.valid() || std::this_thread::get_id() == thread_.get_id() ) {
+                return false;
+            }
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                if ( broken_ ) {
+                    return false;
+                }
+                requests_.push_back(request{str(path), dst, zero_terminated});
+            }
+            cond_var_.notify_one();
+            return true;
+        }
+    private:
+        struct request {
+            str path;
+            stdex::promise<buffer> promise;
+            bool zero_terminated{false};
+        };
+
+        struct slot {
+            bool busy{false};
+            int fd{-1};
+            buffer data;
+            // the zero terminator is not read
+            std::size_t length{0u};
+            std::size_t offset{0u};
+            iovec iov{nullptr, 0u};
+            stdex::promise<buffer> promise;
+        };
+    private:
+        void process_() noexcept {
+            vector<request> batch;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    if ( !inflight_ ) {
+                        cond_var_.wait(lock, [this](){
+                            return exit_ || !requests_.empty();
+                        });
+                        if ( exit_ && requests_.empty() ) {
+                            break;
+                        }
+                    }
+                    while ( !requests_.empty() && batch.size() + inflight_ < slots_.size() ) {
+                        batch.push_back(std::move(requests_.front()));
+                        requests_.pop_front();
+                    }
+                }
+
+                for ( request& r : batch ) {
+                    start_request_(std::move(r));
+                }
+                batch.clear();
+
+                if ( !ring_.submit_and_wait(inflight_ ? 1u : 0u) ) {
+                    // the ring is unusable, new requests go to the fallback
+                    break_down_();
+                    break;
+                }
+
+                ring_.reap([this](u64 user_data, i32 result){
+                    complete_read_(math::numeric_cast<std::size_t>(user_data), result);
+                });
+            }
+        }
+
+        void start_request_(request&& r) noexcept {
+            const int fd = ::open(r.path.c_str(), O_RDONLY|O_CLOEXEC);
+            if ( fd < 0 ) {
+                reject_(r.promise);
+                return;
+            }
+
+            struct stat st;
+            if ( ::fstat(fd, &st) != 0 || st.st_size < 0 ) {
+                ::close(fd);
+                reject_(r.promise);
+                return;
+            }
+
+            const std::size_t length = math::numeric_cast<std::size_t>(st.st_size);
+            const std::size_t padding = r.zero_terminated ? 1u : 0u;
+
+            if ( length == 0 ) {
+                ::close(fd);
+                try {
+                    resolve_(r.promise, buffer(padding));
+                } catch (...) {
+                    reject_(r.promise);
+                }
+                return;
+            }
+
+            const auto iter = std::find_if(slots_.begin(), slots_.end(),
+                [](const slot& s) noexcept { return !s.busy; });
+            E2D_ASSERT(iter != slots_.end());
+
+            try {
+                iter->data.resize(length + padding);
+            } catch (...) {
+                ::close(fd);
+                reject_(r.promise);
+                return;
+            }
+
+            iter->busy = true;
+            iter->fd = fd;
+            iter->length = length;
+            iter->offset = 0u;
+            iter->promise = std::move(r.promise);
+            ++inflight_;
+
+            submit_read_(static_cast<std::size_t>(iter - slots_.begin()));
+        }
+
+        void submit_read_(std::size_t index) noexcept {
+            slot& s = slots_[index];
+            s.iov.iov_base = s.data.data() + s.offset;
+            s.iov.iov_len = s.length - s.offset;
+            if ( !ring_.push_readv(s.fd, &s.iov, s.offset, index) ) {
+                finish_slot_(index, false);
+            }
+        }
+
+        void complete_read_(std::size_t index, i32 result) noexcept {
+            E2D_ASSERT(index < slots_.size() && slots_[index].busy);
+            slot& s = slots_[index];
+            if ( result == -EINTR || result == -EAGAIN ) {
+                submit_read_(index);
+            } else if ( result <= 0 ) {
+                // errors and files truncated after 'fstat'
+                finish_slot_(index, false);
+            } else {
+                s.offset += static_cast<std::size_t>(result);
+                if ( s.offset < s.length ) {
+                    submit_read_(index);
+                } else {
+                    finish_slot_(index, true);
+                }
+            }
+        }
+
+        void finish_slot_(std::size_t index, bool success) noexcept {
+            slot& s = slots_[index];
+            ::close(s.fd);
+            stdex::promise<buffer> promise = std::move(s.promise);
+            buffer data = std::move(s.data);
+            s = slot();
+            --inflight_;
+            if ( success ) {
+                resolve_(promise, std::move(data));
+            } else {
+                reject_(promise);
+            }
+        }
+
+        void break_down_() noexcept {
+            std::deque<request> requests;
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                broken_ = true;
+                requests.swap(requests_);
+            }
+            for ( request& r : requests ) {
+                reject_(r.promise);
+            }
+            for ( std::size_t i = 0; i < slots_.size(); ++i ) {
+                if ( slots_[i].busy ) {
+                    finish_slot_(i, false);
+                }
+            }
+        }
+
+        static void resolve_(stdex::promise<buffer>& promise, buffer data) noexcept {
+            try {
+                promise.resolve(std::move(data));
+            } catch (...) {
+                promise.reject(std::current_exception());
+            }
+        }
+
+        static void reject_(stdex::promise<buffer>& promise) noexcept {
+            promise.reject(std::make_exception_ptr(vfs_load_async_exception()));
+        }
+    private:
+        uring ring_;
+        vector<slot> slots_;
+        std::size_t inflight_{0u};
+        std::thread thread_;
+        std::mutex mutex_;
+        std::condition_variable cond_var_;
+        std::deque<request> requests_;
+        bool exit_{false};
+        bool broken_{false};
+    };
+
+    //
+    // async_reader
+    //
+
+    async_reader::async_reader(std::size_t queue_depth)
+    : state_(new internal_state(queue_depth)) {}
+
+    async_reader::~async_reader() noexcept = default;
+
+    bool async_reader::valid() const noexcept {
+        return state_->valid();
+    }
+
+    bool async_reader::load(str_view path, stdex::promise<buffer>& dst, bool zero_terminated) {
+        return state_->load(path, dst, zero_terminated);
+    }
+}}
+
+#endif
@@ -20,20 +20,29 @@ namespace
 namespace e2d { namespace address
 {
     str parent(str_view address) {
+        return parent_view(address);
+    }
+
+    str nested(str_view address) {
+        return nested_view(address);
+    }
+
+    str_view parent_view(str_view address) noexcept {
         const auto sep_e = str_view_search(address, address_separator);
         if ( sep_e == address.end() ) {
             return address;
         }
         const auto sep_d = std::distance(address.begin(), sep_e);
-        return address.substr(0, static_cast<std::size_t>(sep_d));
+        return str_view(address.data(), static_cast<std::size_t>(sep_d));
     }
 
-    str nested(str_view address) {
+    str_view nested_view(str_view address) noexcept {
         const auto sep_e = str_view_search(address, address_separator);
         if ( sep_e == address.end() ) {
-            return str();
+            return str_view();
         }
-        const auto sep_d = std::distance(address.begin(), sep_e);
-        return address.substr(static_cast<std::size_t>(sep_d) + address_separator.size());
+        const auto sep_d = static_cast<std::size_t>(
+            std::distance(address.begin(), sep_e)) + address_separator.size();
+        return str_view(address.data() + sep_d, address.size() - sep_d);
     }
 }}
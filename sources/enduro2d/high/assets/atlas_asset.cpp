@@ -41,7 +41,8 @@ namespace
                 "properties" : {
                     "name" : { "$ref": "#/common_definitions/name" },
                     "pivot" : { "$ref": "#/common_definitions/v2" },
-                    "texrect" : { "$ref": "#/common_definitions/b2" }
+                    "texrect" : { "$ref": "#/common_definitions/b2" },
+                    "borders" : { "$ref": "#/common_definitions/v4" }
                 }
             }
         }
@@ -69,6 +70,7 @@ namespace
         str_hash name;
         v2f pivot;
         b2f texrect;
+        v4f borders;
     };
 
     bool parse_sprites(
@@ -99,6 +101,13 @@ namespace
                 the<debug>().error("ATLAS: Incorrect formatting of 'texrect' property");
                 return false;
             }
+
+            if ( sprite_json.HasMember("borders") ) {
+                if ( !json_utils::try_parse_value(sprite_json["borders"], tsprite_descs[i].borders) ) {
+                    the<debug>().error("ATLAS: Incorrect formatting of 'borders' property");
+                    return false;
+                }
+            }
         }
 
         sprite_descs = std::move(tsprite_descs);
@@ -113,7 +122,7 @@ namespace
     {
         E2D_ASSERT(root.HasMember("texture") && root["texture"].IsString());
         auto texture_p = library.load_asset_async<texture_asset>(
-            path::combine(parent_address, root["texture"].GetString()));
+            path_buffer(parent_address, root["texture"].GetString()));
 
         vector<sprite_desc> sprite_descs;
         if ( root.HasMember("sprites") ) {
@@ -135,6 +144,7 @@ namespace
                 sprite spr;
                 spr.set_pivot(desc.pivot);
                 spr.set_texrect(desc.texrect);
+                spr.set_borders(desc.borders);
                 spr.set_texture(texture);
                 ncontent.insert(std::make_pair(desc.name, sprite_asset::create(std::move(spr))));
             }
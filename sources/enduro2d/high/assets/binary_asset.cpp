@@ -22,8 +22,7 @@ namespace e2d
     binary_asset::load_async_result binary_asset::load_async(
         const library& library, str_view address)
     {
-        const auto asset_url = library.root() / address;
-        return the<vfs>().load_async(asset_url)
+        return library.load_content_async(address)
         .then([](auto&& content){
             return binary_asset::create(
                 std::forward<decltype(content)>(content));
@@ -95,7 +95,7 @@ namespace
         if ( root.HasMember("atlas") ) {
             E2D_ASSERT(root["atlas"].IsString());
             return library.load_asset_async<atlas_asset, sprite_asset>(
-                path::combine(parent_address, root["atlas"].GetString()))
+                path_buffer(parent_address, root["atlas"].GetString()))
             .then([](const sprite_asset::load_result& sprite){
                 flipbook::frame frame;
                 frame.sprite = sprite;
@@ -106,7 +106,7 @@ namespace
         if ( root.HasMember("sprite") ) {
             E2D_ASSERT(root["sprite"].IsString());
             return library.load_asset_async<sprite_asset>(
-                path::combine(parent_address, root["sprite"].GetString()))
+                path_buffer(parent_address, root["sprite"].GetString()))
             .then([](const sprite_asset::load_result& sprite){
                 flipbook::frame frame;
                 frame.sprite = sprite;
@@ -5,7 +5,6 @@
  ******************************************************************************/
 
 #include <enduro2d/high/assets/json_asset.hpp>
-#include <enduro2d/high/assets/text_asset.hpp>
 
 namespace
 {
@@ -23,11 +22,15 @@ namespace e2d
     json_asset::load_async_result json_asset::load_async(
         const library& library, str_view address)
     {
-        return library.load_asset_async<text_asset>(address)
-        .then([](const text_asset::load_result& json_data){
-            return the<deferrer>().do_in_worker_thread([json_data](){
-                auto json = std::make_unique<rapidjson::Document>();
-                if ( json->Parse(json_data->content().c_str()).HasParseError() ) {
+        // the text is owned by the document and parsed in place,
+        // so it is not kept in the library as a separate text asset
+        return library.load_content_async(address, true)
+        .then([](auto&& content){
+            return the<deferrer>().do_in_worker_thread([
+                json_data = buffer(std::forward<decltype(content)>(content))
+            ]() mutable {
+                auto json = std::make_unique<json_document>(std::move(json_data));
+                if ( !json->parse() ) {
                     throw json_asset_loading_exception();
                 }
                 return json_asset::create(std::move(json));
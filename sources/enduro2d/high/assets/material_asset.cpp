@@ -38,6 +38,10 @@ namespace
                     "additionalProperties" : false,
                     "properties" : {
                         "shader" : { "$ref": "#/common_definitions/address" },
+                        "keywords" : {
+                            "type" : "array",
+                            "items" : { "$ref": "#/common_definitions/name" }
+                        },
                         "state_block" : { "$ref": "#/definitions/state_block" },
                         "property_block" : { "$ref": "#/definitions/property_block" }
                     }
@@ -491,17 +495,38 @@ namespace
         return false;
     }
 
-    stdex::promise<shader_ptr> parse_shader_block(
+    stdex::promise<std::pair<shader_ptr,u32>> parse_shader_block(
         const library& library,
         str_view parent_address,
-        const rapidjson::Value& root)
+        const rapidjson::Value& root,
+        const rapidjson::Value* keywords_root)
     {
         E2D_ASSERT(root.IsString());
-        const auto shader_address =
-            path::combine(parent_address, root.GetString());
+        const path_buffer shader_address(parent_address, root.GetString());
+
+        vector<str> keywords;
+        if ( keywords_root ) {
+            E2D_ASSERT(keywords_root->IsArray());
+            for ( rapidjson::SizeType i = 0; i < keywords_root->Size(); ++i ) {
+                E2D_ASSERT((*keywords_root)[i].IsString());
+                keywords.emplace_back((*keywords_root)[i].GetString());
+            }
+        }
+
         return library.load_asset_async<shader_asset>(shader_address)
-            .then([](const shader_asset::load_result& shader){
-                return shader->content();
+            .then([keywords = std::move(keywords)](const shader_asset::load_result& shader){
+                shader_variants::keyword_mask mask = 0u;
+                if ( !shader->content().try_make_mask(keywords, mask) ) {
+                    the<debug>().error("ASSETS: Undeclared shader keywords in material pass");
+                    throw material_asset_loading_exception();
+                }
+                return the<deferrer>().do_in_main_thread([shader, mask](){
+                    const shader_ptr content = shader->content().variant(the<render>(), mask);
+                    if ( !content ) {
+                        throw material_asset_loading_exception();
+                    }
+                    return std::make_pair(content, mask);
+                });
             });
     }
 
@@ -511,8 +536,7 @@ namespace
         const rapidjson::Value& root)
     {
         E2D_ASSERT(root.IsString());
-        const auto texture_address =
-            path::combine(parent_address, root.GetString());
+        const path_buffer texture_address(parent_address, root.GetString());
         return library.load_asset_async<texture_asset>(texture_address)
             .then([](const texture_asset::load_result& texture){
                 return texture->content();
@@ -1097,8 +1121,9 @@ namespace
         const rapidjson::Value& root)
     {
         auto shader_p = root.HasMember("shader")
-            ? parse_shader_block(library, parent_address, root["shader"])
-            : stdex::make_resolved_promise<shader_ptr>(nullptr);
+            ? parse_shader_block(library, parent_address, root["shader"],
+                root.HasMember("keywords") ? &root["keywords"] : nullptr)
+            : stdex::make_resolved_promise(std::make_pair(shader_ptr(), u32(0u)));
 
         auto state_block_p = root.HasMember("state_block")
             ? parse_state_block(root["state_block"])
@@ -1113,12 +1138,13 @@ namespace
             std::move(state_block_p),
             std::move(property_block_p)
         )).then([](const std::tuple<
-            shader_ptr,
+            std::pair<shader_ptr,u32>,
             render::state_block,
             render::property_block
         >& result) {
             render::pass_state content;
-            content.shader(std::get<0>(result));
+            content.shader(std::get<0>(result).first);
+            content.variant(std::get<0>(result).second);
             content.states(std::get<1>(result));
             content.properties(std::get<2>(result));
             return content;
@@ -24,7 +24,22 @@ namespace
         "required" : [ "mesh" ],
         "additionalProperties" : false,
         "properties" : {
-            "mesh" : { "$ref": "#/common_definitions/address" }
+            "mesh" : { "$ref": "#/common_definitions/address" },
+            "lods" : {
+                "type" : "array",
+                "items" : { "$ref": "#/definitions/model_lod" }
+            }
+        },
+        "definitions" : {
+            "model_lod" : {
+                "type" : "object",
+                "required" : [ "mesh", "screen_size" ],
+                "additionalProperties" : false,
+                "properties" : {
+                    "mesh" : { "$ref": "#/common_definitions/address" },
+                    "screen_size" : { "type" : "number", "minimum" : 0 }
+                }
+            }
         }
     })json";
 
@@ -53,13 +68,47 @@ namespace
     {
         E2D_ASSERT(root.HasMember("mesh") && root["mesh"].IsString());
         auto mesh_p = library.load_asset_async<mesh_asset>(
-            path::combine(parent_address, root["mesh"].GetString()));
+            path_buffer(parent_address, root["mesh"].GetString()));
+
+        vector<stdex::promise<mesh_asset::load_result>> lod_meshes_p;
+        vector<f32> lod_screen_sizes;
 
-        return mesh_p.then([
-        ](const mesh_asset::load_result& mesh){
-            return the<deferrer>().do_in_main_thread([mesh](){
+        if ( root.HasMember("lods") ) {
+            const rapidjson::Value& lods_json = root["lods"];
+            E2D_ASSERT(lods_json.IsArray());
+
+            for ( rapidjson::SizeType i = 0; i < lods_json.Size(); ++i ) {
+                const rapidjson::Value& lod_json = lods_json[i];
+                E2D_ASSERT(lod_json.HasMember("mesh") && lod_json["mesh"].IsString());
+
+                f32 screen_size{0.f};
+                if ( !json_utils::try_parse_value(lod_json["screen_size"], screen_size) ) {
+                    the<debug>().error("MODEL: Incorrect formatting of 'screen_size' property");
+                    return stdex::make_rejected_promise<model>(
+                        model_asset_loading_exception());
+                }
+
+                lod_meshes_p.push_back(library.load_asset_async<mesh_asset>(
+                    path_buffer(parent_address, lod_json["mesh"].GetString())));
+                lod_screen_sizes.push_back(screen_size);
+            }
+        }
+
+        return stdex::make_tuple_promise(std::make_tuple(
+            std::move(mesh_p),
+            stdex::make_all_promise(lod_meshes_p)))
+        .then([
+            lod_screen_sizes = std::move(lod_screen_sizes)
+        ](const std::tuple<
+            mesh_asset::load_result,
+            vector<mesh_asset::load_result>
+        >& results){
+            return the<deferrer>().do_in_main_thread([results, lod_screen_sizes](){
                 model content;
-                content.set_mesh(mesh);
+                content.set_mesh(std::get<0>(results));
+                for ( std::size_t i = 0; i < std::get<1>(results).size(); ++i ) {
+                    content.add_lod(std::get<1>(results)[i], lod_screen_sizes[i]);
+                }
                 content.regenerate_geometry(the<render>());
                 return content;
             });
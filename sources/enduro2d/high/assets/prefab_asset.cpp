@@ -73,7 +73,7 @@ namespace
     {
         if ( root.HasMember("prototype") ) {
             dependencies.add_dependency<prefab_asset>(
-                path::combine(parent_address, root["prototype"].GetString()));
+                path_buffer(parent_address, root["prototype"].GetString()));
         }
 
         if ( root.HasMember("components") ) {
@@ -132,7 +132,7 @@ namespace
 
         if ( root.HasMember("prototype") ) {
             auto proto_res = dependencies.find_asset<prefab_asset>(
-                path::combine(parent_address, root["prototype"].GetString()));
+                path_buffer(parent_address, root["prototype"].GetString()));
             if ( !proto_res ) {
                 the<debug>().error("PREFAB: Dependency 'prototype' is not found:\n"
                     "--> Parent address: %0\n"
@@ -26,7 +26,19 @@ namespace
             "additionalProperties" : false,
             "properties" : {
                 "vertex" : { "$ref": "#/common_definitions/address" },
-                "fragment" : { "$ref": "#/common_definitions/address" }
+                "fragment" : { "$ref": "#/common_definitions/address" },
+                "keywords" : { "$ref": "#/definitions/keywords" },
+                "variants" : {
+                    "type" : "array",
+                    "items" : { "$ref": "#/definitions/keywords" }
+                }
+            },
+            "definitions" : {
+                "keywords" : {
+                    "type" : "array",
+                    "uniqueItems" : true,
+                    "items" : { "$ref": "#/common_definitions/name" }
+                }
             }
         })json";
 
@@ -48,33 +60,85 @@ namespace
         return *schema;
     }
 
-    stdex::promise<shader_ptr> parse_shader(
+    vector<str> parse_keywords(const rapidjson::Value& root) {
+        E2D_ASSERT(root.IsArray());
+        vector<str> keywords;
+        keywords.reserve(root.Size());
+        for ( rapidjson::SizeType i = 0; i < root.Size(); ++i ) {
+            E2D_ASSERT(root[i].IsString());
+            keywords.emplace_back(root[i].GetString());
+        }
+        return keywords;
+    }
+
+    stdex::promise<shader_variants> parse_shader(
         const library& library,
         str_view parent_address,
         const rapidjson::Value& root)
     {
         E2D_ASSERT(root.HasMember("vertex") && root["vertex"].IsString());
         auto vertex_p = library.load_asset_async<text_asset>(
-            path::combine(parent_address, root["vertex"].GetString()));
+            path_buffer(parent_address, root["vertex"].GetString()));
 
         E2D_ASSERT(root.HasMember("fragment") && root["fragment"].IsString());
         auto fragment_p = library.load_asset_async<text_asset>(
-            path::combine(parent_address, root["fragment"].GetString()));
+            path_buffer(parent_address, root["fragment"].GetString()));
+
+        vector<str> keywords = root.HasMember("keywords")
+            ? parse_keywords(root["keywords"])
+            : vector<str>();
+
+        vector<vector<str>> variants;
+        if ( root.HasMember("variants") ) {
+            const rapidjson::Value& variants_json = root["variants"];
+            E2D_ASSERT(variants_json.IsArray());
+            for ( rapidjson::SizeType i = 0; i < variants_json.Size(); ++i ) {
+                variants.push_back(parse_keywords(variants_json[i]));
+            }
+        }
 
         return stdex::make_tuple_promise(std::make_tuple(
             std::move(vertex_p),
             std::move(fragment_p)))
-        .then([](const std::tuple<
+        .then([
+            keywords = std::move(keywords),
+            variants = std::move(variants)
+        ](const std::tuple<
             text_asset::load_result,
             text_asset::load_result
         >& results){
-            return the<deferrer>().do_in_main_thread([results](){
-                const shader_ptr content = the<render>().create_shader(
+            return the<deferrer>().do_in_main_thread([results, keywords, variants](){
+                if ( keywords.size() > shader_variants::max_keyword_count ) {
+                    the<debug>().error("ASSETS: Too many shader keywords:\n"
+                        "--> Count: %0\n"
+                        "--> Limit: %1",
+                        keywords.size(),
+                        shader_variants::max_keyword_count);
+                    throw shader_asset_loading_exception();
+                }
+
+                const shader_variants content(
                     std::get<0>(results)->content(),
-                    std::get<1>(results)->content());
-                if ( !content ) {
+                    std::get<1>(results)->content(),
+                    keywords);
+
+                // the default variant is always compiled to report
+                // source errors at loading
+                if ( !content.prewarm(the<render>(), 0u) ) {
                     throw shader_asset_loading_exception();
                 }
+
+                for ( const vector<str>& variant : variants ) {
+                    shader_variants::keyword_mask mask = 0u;
+                    if ( !content.try_make_mask(variant, mask) ) {
+                        the<debug>().error("ASSETS: Undeclared shader variant keywords");
+                        throw shader_asset_loading_exception();
+                    }
+                    if ( !content.prewarm(the<render>(), mask) ) {
+                        throw shader_asset_loading_exception();
+                    }
+                }
+
                 return content;
             });
         });
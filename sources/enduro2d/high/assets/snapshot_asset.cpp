@@ -0,0 +1,63 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/assets/snapshot_asset.hpp>
+
+#include <enduro2d/high/snapshot.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    class snapshot_asset_loading_exception final : public asset_loading_exception {
+        const char* what() const noexcept final {
+            return "snapshot asset loading exception";
+        }
+    };
+}
+
+namespace e2d
+{
+    snapshot_asset::load_async_result snapshot_asset::load_async(
+        const library& library, str_view address)
+    {
+        // the raw content isn't cached by the library,
+        // it's released with the last loading step
+        return library.load_content_async(address)
+        .then([
+            &library,
+            address = str(address)
+        ](auto&& content){
+            const auto snapshot_data = std::make_shared<const buffer>(
+                std::forward<decltype(content)>(content));
+            return the<deferrer>().do_in_worker_thread([address, snapshot_data](){
+                asset_dependencies dependencies;
+                if ( !snapshots::try_collect_dependencies(dependencies, *snapshot_data) ) {
+                    the<debug>().error("ASSETS: Failed to read snapshot dependencies:\n"
+                        "--> Address: %0",
+                        address);
+                    throw snapshot_asset_loading_exception();
+                }
+                return dependencies;
+            })
+            .then([&library](const asset_dependencies& dependencies){
+                return dependencies.load_async(library);
+            })
+            .then([address, snapshot_data](const asset_group& dependencies){
+                return the<deferrer>().do_in_worker_thread([address, snapshot_data, dependencies](){
+                    prefab content;
+                    if ( !snapshots::try_load_snapshot(content, *snapshot_data, dependencies) ) {
+                        the<debug>().error("ASSETS: Failed to load snapshot:\n"
+                            "--> Address: %0",
+                            address);
+                        throw snapshot_asset_loading_exception();
+                    }
+                    return snapshot_asset::create(std::move(content));
+                });
+            });
+        });
+    }
+}
@@ -0,0 +1,42 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/assets/sound_asset.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    class sound_asset_loading_exception final : public asset_loading_exception {
+        const char* what() const noexcept final {
+            return "sound asset loading exception";
+        }
+    };
+}
+
+namespace e2d
+{
+    sound_asset::load_async_result sound_asset::load_async(
+        const library& library, str_view address)
+    {
+        // the encoded data is not cached, it's released after decoding
+        return library.load_content_async(address)
+        .then([](auto&& data){
+            return the<deferrer>().do_in_worker_thread([
+                sound_data = buffer(std::forward<decltype(data)>(data))
+            ]() mutable {
+                sound content;
+                const bool success = sounds::try_load_sound(content, sound_data);
+                sound_data.clear();
+                if ( !success ) {
+                    throw sound_asset_loading_exception();
+                }
+                return sound_asset::create(
+                    std::make_shared<sound>(std::move(content)));
+            });
+        });
+    }
+}
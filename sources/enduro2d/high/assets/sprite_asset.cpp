@@ -27,7 +27,8 @@ namespace
         "properties" : {
             "texture" : { "$ref": "#/common_definitions/address" },
             "pivot" : { "$ref": "#/common_definitions/v2" },
-            "texrect" : { "$ref": "#/common_definitions/b2" }
+            "texrect" : { "$ref": "#/common_definitions/b2" },
+            "borders" : { "$ref": "#/common_definitions/v4" }
         }
     })json";
 
@@ -56,7 +57,7 @@ namespace
     {
         E2D_ASSERT(root.HasMember("texture") && root["texture"].IsString());
         auto texture_p = library.load_asset_async<texture_asset>(
-            path::combine(parent_address, root["texture"].GetString()));
+            path_buffer(parent_address, root["texture"].GetString()));
 
         v2f pivot;
         E2D_ASSERT(root.HasMember("pivot"));
@@ -72,13 +73,23 @@ namespace
             return stdex::make_rejected_promise<sprite>(sprite_asset_loading_exception());
         }
 
+        v4f borders;
+        if ( root.HasMember("borders") ) {
+            if ( !json_utils::try_parse_value(root["borders"], borders) ) {
+                the<debug>().error("SPRITE: Incorrect formatting of 'borders' property");
+                return stdex::make_rejected_promise<sprite>(sprite_asset_loading_exception());
+            }
+        }
+
         return texture_p.then([
             pivot,
-            texrect
+            texrect,
+            borders
         ](const texture_asset::load_result& texture){
             sprite content;
             content.set_pivot(pivot);
             content.set_texrect(texrect);
+            content.set_borders(borders);
             content.set_texture(texture);
             return content;
         });
@@ -0,0 +1,613 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/collision.hpp>
+
+#include <enduro2d/high/components/actor.hpp>
+#include <enduro2d/high/components/collider.hpp>
+#include <enduro2d/high/components/pending_instance.hpp>
+
+#include "collision_impl/collision_tree.hpp"
+
+namespace
+{
+    using namespace e2d;
+    using namespace e2d::collision_impl;
+
+    //
+    // proxy
+    //
+
+    struct proxy final {
+        ecs::entity_id entity{0u};
+        i32 tree_proxy{dynamic_tree::null_node};
+        u32 layer{0u};
+        u32 mask{0u};
+        u32 stamp{0u};
+        bool circle{false};
+        v2f center;
+        f32 radius{0.f};
+        vector<v2f> points; // counter-clockwise convex polygon in world space
+        bbox bounds;
+    };
+
+    bool accepts(u32 layer_a, u32 mask_a, u32 layer_b, u32 mask_b) noexcept {
+        return (layer_a & mask_b) && (layer_b & mask_a);
+    }
+
+    v2f transform_point(const v2f& p, const m4f& m) noexcept {
+        return v2f(v4f(p, 0.f, 1.f) * m);
+    }
+
+    f32 signed_area_x2(const vector<v2f>& points) noexcept {
+        f32 area = 0.f;
+        for ( std::size_t i = 0, j = points.size() - 1u; i < points.size(); j = i++ ) {
+            area += points[j].x * points[i].y - points[i].x * points[j].y;
+        }
+        return area;
+    }
+
+    bbox points_bounds(const vector<v2f>& points) noexcept {
+        E2D_ASSERT(!points.empty());
+        bbox b{points.front(), points.front()};
+        for ( const v2f& p : points ) {
+            b.min = math::minimized(b.min, p);
+            b.max = math::maximized(b.max, p);
+        }
+        return b;
+    }
+
+    // returns false if the collider has no area to collide with
+    bool build_world_shape(proxy& p, const collider& c, const m4f& m) {
+        switch ( c.type() ) {
+            case collider::types::circle: {
+                const f32 sx = math::length(v2f(m.rows[0]));
+                const f32 sy = math::length(v2f(m.rows[1]));
+                p.circle = true;
+                p.center = transform_point(c.center(), m);
+                p.radius = c.radius() * math::max(sx, sy);
+                p.points.clear();
+                p.bounds = bbox{
+                    p.center - v2f(p.radius),
+                    p.center + v2f(p.radius)};
+                return true;
+            }
+            case collider::types::rect: {
+                const v2f min = math::minimum(c.rect());
+                const v2f max = math::maximum(c.rect());
+                p.circle = false;
+                p.points.resize(4u);
+                p.points[0] = transform_point(min, m);
+                p.points[1] = transform_point(v2f(max.x, min.y), m);
+                p.points[2] = transform_point(max, m);
+                p.points[3] = transform_point(v2f(min.x, max.y), m);
+                break;
+            }
+            case collider::types::polygon: {
+                if ( c.vertices().empty() ) {
+                    return false;
+                }
+                p.circle = false;
+                p.points.resize(c.vertices().size());
+                for ( std::size_t i = 0; i < c.vertices().size(); ++i ) {
+                    p.points[i] = transform_point(c.vertices()[i], m);
+                }
+                break;
+            }
+            default:
+                E2D_ASSERT_MSG(false, "unexpected collider type");
+                return false;
+        }
+        if ( signed_area_x2(p.points) < 0.f ) {
+            // mirrored by the node transform
+            std::reverse(p.points.begin(), p.points.end());
+        }
+        p.bounds = points_bounds(p.points);
+        return true;
+    }
+
+    //
+    // narrowphase
+    //
+
+    void project(const vector<v2f>& points, const v2f& axis, f32& min, f32& max) noexcept {
+        min = max = math::dot(points.front(), axis);
+        for ( std::size_t i = 1; i < points.size(); ++i ) {
+            const f32 d = math::dot(points[i], axis);
+            min = math::min(min, d);
+            max = math::max(max, d);
+        }
+    }
+
+    bool has_separating_axis(const vector<v2f>& a, const vector<v2f>& b) noexcept {
+        for ( std::size_t i = 0, j = a.size() - 1u; i < a.size(); j = i++ ) {
+            const v2f edge = a[i] - a[j];
+            const v2f axis(edge.y, -edge.x);
+            f32 min_a = 0.f, max_a = 0.f, min_b = 0.f, max_b = 0.f;
+            project(a, axis, min_a, max_a);
+            project(b, axis, min_b, max_b);
+            if ( max_a < min_b || max_b < min_a ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool polygons_overlap(const vector<v2f>& a, const vector<v2f>& b) noexcept {
+        return !has_separating_axis(a, b)
+            && !has_separating_axis(b, a);
+    }
+
+    bool circle_polygon_overlap(const v2f& c, f32 r, const vector<v2f>& points) noexcept {
+        bool inside = true;
+        const f32 r2 = r * r;
+        for ( std::size_t i = 0, j = points.size() - 1u; i < points.size(); j = i++ ) {
+            const v2f& a = points[j];
+            const v2f& b = points[i];
+            const v2f ab = b - a;
+            const v2f ac = c - a;
+            if ( ab.x * ac.y - ab.y * ac.x < 0.f ) {
+                inside = false;
+            }
+            const f32 len2 = math::length_squared(ab);
+            const f32 t = len2 > 0.f
+                ? math::clamp(math::dot(ac, ab) / len2, 0.f, 1.f)
+                : 0.f;
+            if ( math::length_squared(ac - ab * t) <= r2 ) {
+                return true;
+            }
+        }
+        return inside;
+    }
+
+    bool proxies_overlap(const proxy& a, const proxy& b) noexcept {
+        if ( a.circle && b.circle ) {
+            const f32 r = a.radius + b.radius;
+            return math::length_squared(a.center - b.center) <= r * r;
+        }
+        if ( a.circle ) {
+            return circle_polygon_overlap(a.center, a.radius, b.points);
+        }
+        if ( b.circle ) {
+            return circle_polygon_overlap(b.center, b.radius, a.points);
+        }
+        return polygons_overlap(a.points, b.points);
+    }
+
+    bool area_overlaps(const vector<v2f>& area, const proxy& p) noexcept {
+        return p.circle
+            ? circle_polygon_overlap(p.center, p.radius, area)
+            : polygons_overlap(area, p.points);
+    }
+
+    // returns the fraction of the segment 'p1 + d * t' at the hit,
+    // or a negative value when there is no hit in [0, max_fraction]
+    f32 raycast_proxy(
+        const proxy& p,
+        const v2f& p1,
+        const v2f& d,
+        f32 max_fraction,
+        v2f& normal) noexcept
+    {
+        if ( p.circle ) {
+            const v2f s = p1 - p.center;
+            const f32 b = math::dot(s, s) - p.radius * p.radius;
+            const f32 c = math::dot(s, d);
+            const f32 dd = math::dot(d, d);
+            const f32 sigma = c * c - dd * b;
+            if ( sigma < 0.f || dd <= 0.f || b < 0.f ) {
+                return -1.f;
+            }
+            const f32 t = -(c + math::sqrt(sigma)) / dd;
+            if ( t < 0.f || t > max_fraction ) {
+                return -1.f;
+            }
+            normal = math::normalized(s + d * t);
+            return t;
+        }
+
+        f32 lower = 0.f;
+        f32 upper = max_fraction;
+        std::size_t index = p.points.size();
+        for ( std::size_t i = 0, j = p.points.size() - 1u; i < p.points.size(); j = i++ ) {
+            const v2f edge = p.points[i] - p.points[j];
+            const v2f n(edge.y, -edge.x);
+            const f32 numerator = math::dot(n, p.points[j] - p1);
+            const f32 denominator = math::dot(n, d);
+            if ( denominator == 0.f ) {
+                if ( numerator < 0.f ) {
+                    return -1.f;
+                }
+            } else if ( denominator < 0.f && numerator < lower * denominator ) {
+                lower = numerator / denominator;
+                index = j;
+            } else if ( denominator > 0.f && numerator < upper * denominator ) {
+                upper = numerator / denominator;
+            }
+            if ( upper < lower ) {
+                return -1.f;
+            }
+        }
+
+        if ( index >= p.points.size() ) {
+            // the origin is inside the polygon
+            return -1.f;
+        }
+
+        const v2f edge = p.points[(index + 1u) % p.points.size()] - p.points[index];
+        normal = math::normalized(v2f(edge.y, -edge.x));
+        return lower;
+    }
+
+    //
+    // parallel helpers
+    //
+
+    std::size_t parallel_chunk_count(std::size_t count, std::size_t threshold) noexcept {
+        if ( !threshold || count < threshold * 2u || !modules::is_initialized<deferrer>() ) {
+            return 1u;
+        }
+        const std::size_t threads = math::max(1u, std::thread::hardware_concurrency());
+        return math::clamp(count / threshold, std::size_t(1u), threads);
+    }
+
+    // f(std::size_t begin, std::size_t end, std::size_t chunk)
+    template < typename F >
+    void parallel_for_chunks(std::size_t count, std::size_t chunks, const F& f) {
+        if ( chunks <= 1u ) {
+            f(std::size_t(0u), count, std::size_t(0u));
+            return;
+        }
+
+        const std::size_t chunk_size = (count + chunks - 1u) / chunks;
+
+        vector<stdex::promise<void>> jobs;
+        jobs.reserve(chunks - 1u);
+
+        std::exception_ptr error;
+        try {
+            for ( std::size_t i = 1; i < chunks; ++i ) {
+                const std::size_t begin = math::min(count, i * chunk_size);
+                const std::size_t end = math::min(count, begin + chunk_size);
+                jobs.push_back(the<deferrer>().do_in_worker_thread([&f, begin, end, i](){
+                    f(begin, end, i);
+                }));
+            }
+            f(std::size_t(0u), math::min(count, chunk_size), std::size_t(0u));
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        for ( const stdex::promise<void>& job : jobs ) {
+            the<deferrer>().active_safe_wait_promise(job);
+            try {
+                job.get();
+            } catch (...) {
+                if ( !error ) {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        if ( error ) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+namespace e2d
+{
+    //
+    // collision::parameters
+    //
+
+    collision::parameters& collision::parameters::fat_margin(f32 value) noexcept {
+        fat_margin_ = value;
+        return *this;
+    }
+
+    collision::parameters& collision::parameters::parallel_threshold(std::size_t value) noexcept {
+        parallel_threshold_ = value;
+        return *this;
+    }
+
+    f32 collision::parameters::fat_margin() const noexcept {
+        return fat_margin_;
+    }
+
+    std::size_t collision::parameters::parallel_threshold() const noexcept {
+        return parallel_threshold_;
+    }
+
+    //
+    // collision::internal_state
+    //
+
+    class collision::internal_state final : private e2d::noncopyable {
+    public:
+        internal_state(const parameters& params)
+        : params_(params)
+        , tree_(params.fat_margin()) {}
+        ~internal_state() noexcept = default;
+    public:
+        void update(ecs::registry& owner) {
+            ++stamp_;
+
+            owner.for_joined_components<actor, collider>([this](
+                const ecs::const_entity& e,
+                const actor& a,
+                const collider& c)
+            {
+                if ( !e.exists_component<pending_instance>() ) {
+                    sync_proxy_(e.id(), a, c);
+                }
+            });
+
+            for ( std::size_t i = 0; i < proxies_.size(); ) {
+                if ( proxies_[i].stamp != stamp_ ) {
+                    remove_proxy_(i);
+                } else {
+                    ++i;
+                }
+            }
+        }
+
+        void clear() noexcept {
+            while ( !proxies_.empty() ) {
+                remove_proxy_(proxies_.size() - 1u);
+            }
+        }
+
+        std::size_t proxy_count() const noexcept {
+            return proxies_.size();
+        }
+
+        std::size_t tree_height() const noexcept {
+            return tree_.height();
+        }
+
+        void find_contacts(vector<contact>& result) const {
+            const std::size_t chunks = parallel_chunk_count(
+                proxies_.size(),
+                params_.parallel_threshold());
+
+            vector<vector<contact>> chunk_results(chunks);
+            parallel_for_chunks(proxies_.size(), chunks, [this, &chunk_results](
+                std::size_t begin, std::size_t end, std::size_t chunk)
+            {
+                vector<contact>& contacts = chunk_results[chunk];
+                for ( std::size_t i = begin; i < end; ++i ) {
+                    const proxy& a = proxies_[i];
+                    tree_.query(a.bounds, [this, i, &a, &contacts](u32 other){
+                        if ( other <= i ) {
+                            return true;
+                        }
+                        const proxy& b = proxies_[other];
+                        if ( accepts(a.layer, a.mask, b.layer, b.mask)
+                            && overlaps(a.bounds, b.bounds)
+                            && proxies_overlap(a, b) )
+                        {
+                            contacts.push_back(a.entity < b.entity
+                                ? contact{a.entity, b.entity}
+                                : contact{b.entity, a.entity});
+                        }
+                        return true;
+                    });
+                }
+            });
+
+            result.clear();
+            for ( const vector<contact>& contacts : chunk_results ) {
+                result.insert(result.end(), contacts.begin(), contacts.end());
+            }
+        }
+
+        void overlap(const b2f& area, u32 mask, vector<ecs::entity_id>& result) const {
+            result.clear();
+            overlap_(area, mask, result);
+        }
+
+        void overlap(
+            const vector<b2f>& areas,
+            u32 mask,
+            vector<vector<ecs::entity_id>>& results) const
+        {
+            results.resize(areas.size());
+            const std::size_t chunks = parallel_chunk_count(
+                areas.size(),
+                params_.parallel_threshold());
+            parallel_for_chunks(areas.size(), chunks, [this, &areas, mask, &results](
+                std::size_t begin, std::size_t end, std::size_t)
+            {
+                for ( std::size_t i = begin; i < end; ++i ) {
+                    results[i].clear();
+                    overlap_(areas[i], mask, results[i]);
+                }
+            });
+        }
+
+        bool raycast(const ray& r, raycast_hit& result) const {
+            result = raycast_hit();
+
+            const f32 dir_len = math::length(r.direction);
+            if ( r.distance <= 0.f || dir_len <= 0.f ) {
+                return false;
+            }
+
+            const v2f p1 = r.origin;
+            const v2f d = r.direction * (r.distance / dir_len);
+
+            tree_.raycast(p1, p1 + d, [this, &r, &p1, &d, &result](u32 index, f32 max_fraction){
+                const proxy& p = proxies_[index];
+                if ( !(p.layer & r.mask) ) {
+                    return max_fraction;
+                }
+                v2f normal;
+                const f32 fraction = raycast_proxy(p, p1, d, max_fraction, normal);
+                if ( fraction < 0.f ) {
+                    return max_fraction;
+                }
+                result.hit = true;
+                result.entity = p.entity;
+                result.point = p1 + d * fraction;
+                result.normal = normal;
+                result.distance = fraction * r.distance;
+                return fraction;
+            });
+
+            return result.hit;
+        }
+
+        void raycast(const vector<ray>& rays, vector<raycast_hit>& results) const {
+            results.resize(rays.size());
+            const std::size_t chunks = parallel_chunk_count(
+                rays.size(),
+                params_.parallel_threshold());
+            parallel_for_chunks(rays.size(), chunks, [this, &rays, &results](
+                std::size_t begin, std::size_t end, std::size_t)
+            {
+                for ( std::size_t i = begin; i < end; ++i ) {
+                    raycast(rays[i], results[i]);
+                }
+            });
+        }
+    private:
+        void sync_proxy_(ecs::entity_id entity, const actor& a, const collider& c) {
+            const const_node_iptr node = a.node();
+            if ( !node || !c.enabled() ) {
+                return;
+            }
+
+            const auto iter = proxy_indices_.find(entity);
+            if ( iter == proxy_indices_.end() ) {
+                proxy p;
+                if ( !build_world_shape(p, c, node->world_matrix()) ) {
+                    return;
+                }
+                p.entity = entity;
+                p.layer = c.layer();
+                p.mask = c.mask();
+                p.stamp = stamp_;
+
+                const u32 index = math::numeric_cast<u32>(proxies_.size());
+                p.tree_proxy = tree_.create_proxy(p.bounds, index);
+                proxies_.push_back(std::move(p));
+                proxy_indices_.emplace(entity, index);
+                return;
+            }
+
+            proxy& p = proxies_[iter->second];
+            if ( !build_world_shape(p, c, node->world_matrix()) ) {
+                return;
+            }
+            p.layer = c.layer();
+            p.mask = c.mask();
+            p.stamp = stamp_;
+            tree_.move_proxy(p.tree_proxy, p.bounds);
+        }
+
+        void remove_proxy_(std::size_t index) noexcept {
+            E2D_ASSERT(index < proxies_.size());
+            tree_.destroy_proxy(proxies_[index].tree_proxy);
+            proxy_indices_.erase(proxies_[index].entity);
+            if ( index + 1u != proxies_.size() ) {
+                proxies_[index] = std::move(proxies_.back());
+                proxy_indices_[proxies_[index].entity] = index;
+                tree_.user_data(
+                    proxies_[index].tree_proxy,
+                    math::numeric_cast<u32>(index));
+            }
+            proxies_.pop_back();
+        }
+
+        void overlap_(const b2f& area, u32 mask, vector<ecs::entity_id>& result) const {
+            const bbox area_bounds = make_bbox(area);
+            const vector<v2f> area_points{
+                area_bounds.min,
+                v2f(area_bounds.max.x, area_bounds.min.y),
+                area_bounds.max,
+                v2f(area_bounds.min.x, area_bounds.max.y)};
+            tree_.query(area_bounds, [this, mask, &area_bounds, &area_points, &result](u32 index){
+                const proxy& p = proxies_[index];
+                if ( (p.layer & mask)
+                    && overlaps(area_bounds, p.bounds)
+                    && area_overlaps(area_points, p) )
+                {
+                    result.push_back(p.entity);
+                }
+                return true;
+            });
+        }
+    private:
+        parameters params_;
+        dynamic_tree tree_;
+        vector<proxy> proxies_;
+        hash_map<ecs::entity_id, std::size_t> proxy_indices_;
+        u32 stamp_{0u};
+    };
+
+    //
+    // collision
+    //
+
+    collision::collision()
+    : collision(parameters()) {}
+
+    collision::collision(const parameters& params)
+    : state_(new internal_state(params)) {}
+
+    collision::~collision() noexcept = default;
+
+    void collision::update(ecs::registry& owner) {
+        state_->update(owner);
+    }
+
+    void collision::clear() noexcept {
+        state_->clear();
+    }
+
+    std::size_t collision::proxy_count() const noexcept {
+        return state_->proxy_count();
+    }
+
+    std::size_t collision::tree_height() const noexcept {
+        return state_->tree_height();
+    }
+
+    void collision::find_contacts(vector<contact>& result) const {
+        state_->find_contacts(result);
+    }
+
+    void collision::overlap(
+        const b2f& area,
+        u32 mask,
+        vector<ecs::entity_id>& result) const
+    {
+        state_->overlap(area, mask, result);
+    }
+
+    void collision::overlap(
+        const vector<b2f>& areas,
+        u32 mask,
+        vector<vector<ecs::entity_id>>& results) const
+    {
+        state_->overlap(areas, mask, results);
+    }
+
+    bool collision::raycast(
+        const ray& r,
+        raycast_hit& result) const
+    {
+        return state_->raycast(r, result);
+    }
+
+    void collision::raycast(
+        const vector<ray>& rays,
+        vector<raycast_hit>& results) const
+    {
+        state_->raycast(rays, results);
+    }
+}
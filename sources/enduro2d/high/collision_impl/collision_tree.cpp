@@ -0,0 +1,287 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "collision_tree.hpp"
+
+namespace e2d { namespace collision_impl
+{
+    const i32 dynamic_tree::null_node;
+
+    dynamic_tree::dynamic_tree(f32 margin)
+    : margin_(margin) {}
+
+    dynamic_tree::~dynamic_tree() noexcept = default;
+
+    i32 dynamic_tree::create_proxy(const bbox& bounds, u32 user_data) {
+        const i32 proxy = allocate_node_();
+        node& n = nodes_[static_cast<std::size_t>(proxy)];
+        n.bounds = expanded(bounds, margin_);
+        n.user_data = user_data;
+        n.height = 0;
+        insert_leaf_(proxy);
+        ++proxy_count_;
+        return proxy;
+    }
+
+    void dynamic_tree::destroy_proxy(i32 proxy) noexcept {
+        E2D_ASSERT(proxy >= 0 && static_cast<std::size_t>(proxy) < nodes_.size());
+        E2D_ASSERT(nodes_[static_cast<std::size_t>(proxy)].is_leaf());
+        remove_leaf_(proxy);
+        free_node_(proxy);
+        --proxy_count_;
+    }
+
+    bool dynamic_tree::move_proxy(i32 proxy, const bbox& bounds) noexcept {
+        E2D_ASSERT(proxy >= 0 && static_cast<std::size_t>(proxy) < nodes_.size());
+        node& n = nodes_[static_cast<std::size_t>(proxy)];
+        E2D_ASSERT(n.is_leaf());
+        if ( contains(n.bounds, bounds) ) {
+            return false;
+        }
+        remove_leaf_(proxy);
+        n.bounds = expanded(bounds, margin_);
+        insert_leaf_(proxy);
+        return true;
+    }
+
+    u32 dynamic_tree::user_data(i32 proxy) const noexcept {
+        E2D_ASSERT(proxy >= 0 && static_cast<std::size_t>(proxy) < nodes_.size());
+        return nodes_[static_cast<std::size_t>(proxy)].user_data;
+    }
+
+    void dynamic_tree::user_data(i32 proxy, u32 value) noexcept {
+        E2D_ASSERT(proxy >= 0 && static_cast<std::size_t>(proxy) < nodes_.size());
+        nodes_[static_cast<std::size_t>(proxy)].user_data = value;
+    }
+
+    const bbox& dynamic_tree::fat_bounds(i32 proxy) const noexcept {
+        E2D_ASSERT(proxy >= 0 && static_cast<std::size_t>(proxy) < nodes_.size());
+        return nodes_[static_cast<std::size_t>(proxy)].bounds;
+    }
+
+    std::size_t dynamic_tree::height() const noexcept {
+        return root_ == null_node
+            ? 0u
+            : static_cast<std::size_t>(nodes_[static_cast<std::size_t>(root_)].height);
+    }
+
+    std::size_t dynamic_tree::proxy_count() const noexcept {
+        return proxy_count_;
+    }
+
+    i32 dynamic_tree::allocate_node_() {
+        if ( free_list_ == null_node ) {
+            nodes_.emplace_back();
+            return math::numeric_cast<i32>(nodes_.size() - 1u);
+        }
+        const i32 index = free_list_;
+        node& n = nodes_[static_cast<std::size_t>(index)];
+        free_list_ = n.parent_or_next;
+        n = node();
+        return index;
+    }
+
+    void dynamic_tree::free_node_(i32 index) noexcept {
+        node& n = nodes_[static_cast<std::size_t>(index)];
+        n.parent_or_next = free_list_;
+        n.height = -1;
+        free_list_ = index;
+    }
+
+    void dynamic_tree::insert_leaf_(i32 leaf) noexcept {
+        if ( root_ == null_node ) {
+            root_ = leaf;
+            nodes_[static_cast<std::size_t>(root_)].parent_or_next = null_node;
+            return;
+        }
+
+        // find the best sibling by the surface area heuristic
+
+        const bbox leaf_bounds = nodes_[static_cast<std::size_t>(leaf)].bounds;
+        i32 index = root_;
+        while ( !nodes_[static_cast<std::size_t>(index)].is_leaf() ) {
+            const node& n = nodes_[static_cast<std::size_t>(index)];
+            const node& c1 = nodes_[static_cast<std::size_t>(n.child1)];
+            const node& c2 = nodes_[static_cast<std::size_t>(n.child2)];
+
+            const f32 area = perimeter(n.bounds);
+            const f32 combined_area = perimeter(merged(n.bounds, leaf_bounds));
+
+            const f32 cost = 2.f * combined_area;
+            const f32 inheritance_cost = 2.f * (combined_area - area);
+
+            const f32 cost1 = c1.is_leaf()
+                ? perimeter(merged(leaf_bounds, c1.bounds)) + inheritance_cost
+                : perimeter(merged(leaf_bounds, c1.bounds)) - perimeter(c1.bounds) + inheritance_cost;
+
+            const f32 cost2 = c2.is_leaf()
+                ? perimeter(merged(leaf_bounds, c2.bounds)) + inheritance_cost
+                : perimeter(merged(leaf_bounds, c2.bounds)) - perimeter(c2.bounds) + inheritance_cost;
+
+            if ( cost < cost1 && cost < cost2 ) {
+                break;
+            }
+
+            index = cost1 < cost2 ? n.child1 : n.child2;
+        }
+
+        // create a new parent for the sibling and the leaf
+        // (nodes may be reallocated here, so only indices are kept)
+
+        const i32 sibling = index;
+        const i32 old_parent = nodes_[static_cast<std::size_t>(sibling)].parent_or_next;
+        const i32 new_parent = allocate_node_();
+        {
+            node& np = nodes_[static_cast<std::size_t>(new_parent)];
+            np.parent_or_next = old_parent;
+            np.bounds = merged(leaf_bounds, nodes_[static_cast<std::size_t>(sibling)].bounds);
+            np.height = nodes_[static_cast<std::size_t>(sibling)].height + 1;
+            np.child1 = sibling;
+            np.child2 = leaf;
+        }
+
+        if ( old_parent != null_node ) {
+            node& op = nodes_[static_cast<std::size_t>(old_parent)];
+            if ( op.child1 == sibling ) {
+                op.child1 = new_parent;
+            } else {
+                op.child2 = new_parent;
+            }
+        } else {
+            root_ = new_parent;
+        }
+
+        nodes_[static_cast<std::size_t>(sibling)].parent_or_next = new_parent;
+        nodes_[static_cast<std::size_t>(leaf)].parent_or_next = new_parent;
+
+        // walk back up the tree fixing heights and bounds
+
+        index = nodes_[static_cast<std::size_t>(leaf)].parent_or_next;
+        while ( index != null_node ) {
+            index = balance_(index);
+            node& n = nodes_[static_cast<std::size_t>(index)];
+            const node& c1 = nodes_[static_cast<std::size_t>(n.child1)];
+            const node& c2 = nodes_[static_cast<std::size_t>(n.child2)];
+            n.height = 1 + math::max(c1.height, c2.height);
+            n.bounds = merged(c1.bounds, c2.bounds);
+            index = n.parent_or_next;
+        }
+    }
+
+    void dynamic_tree::remove_leaf_(i32 leaf) noexcept {
+        if ( leaf == root_ ) {
+            root_ = null_node;
+            return;
+        }
+
+        const i32 parent = nodes_[static_cast<std::size_t>(leaf)].parent_or_next;
+        const i32 grand_parent = nodes_[static_cast<std::size_t>(parent)].parent_or_next;
+        const i32 sibling = nodes_[static_cast<std::size_t>(parent)].child1 == leaf
+            ? nodes_[static_cast<std::size_t>(parent)].child2
+            : nodes_[static_cast<std::size_t>(parent)].child1;
+
+        if ( grand_parent != null_node ) {
+            node& gp = nodes_[static_cast<std::size_t>(grand_parent)];
+            if ( gp.child1 == parent ) {
+                gp.child1 = sibling;
+            } else {
+                gp.child2 = sibling;
+            }
+            nodes_[static_cast<std::size_t>(sibling)].parent_or_next = grand_parent;
+            free_node_(parent);
+
+            i32 index = grand_parent;
+            while ( index != null_node ) {
+                index = balance_(index);
+                node& n = nodes_[static_cast<std::size_t>(index)];
+                const node& c1 = nodes_[static_cast<std::size_t>(n.child1)];
+                const node& c2 = nodes_[static_cast<std::size_t>(n.child2)];
+                n.bounds = merged(c1.bounds, c2.bounds);
+                n.height = 1 + math::max(c1.height, c2.height);
+                index = n.parent_or_next;
+            }
+        } else {
+            root_ = sibling;
+            nodes_[static_cast<std::size_t>(sibling)].parent_or_next = null_node;
+            free_node_(parent);
+        }
+    }
+
+    // performs a left or right rotation if the node 'a' is imbalanced,
+    // returns the new root of the subtree
+    i32 dynamic_tree::balance_(i32 ia) noexcept {
+        const node& top = nodes_[static_cast<std::size_t>(ia)];
+        if ( top.is_leaf() || top.height < 2 ) {
+            return ia;
+        }
+
+        const i32 ib = top.child1;
+        const i32 ic = top.child2;
+        const i32 balance =
+            nodes_[static_cast<std::size_t>(ic)].height -
+            nodes_[static_cast<std::size_t>(ib)].height;
+
+        const auto rotate = [this, ia](i32 iup, i32 iother, bool up_is_child2) -> i32 {
+            node& a = nodes_[static_cast<std::size_t>(ia)];
+            node& up = nodes_[static_cast<std::size_t>(iup)];
+            node& other = nodes_[static_cast<std::size_t>(iother)];
+
+            const i32 if_ = up.child1;
+            const i32 ig = up.child2;
+            node& f = nodes_[static_cast<std::size_t>(if_)];
+            node& g = nodes_[static_cast<std::size_t>(ig)];
+
+            // swap 'a' and 'up'
+            up.child1 = ia;
+            up.parent_or_next = a.parent_or_next;
+            a.parent_or_next = iup;
+
+            if ( up.parent_or_next != null_node ) {
+                node& p = nodes_[static_cast<std::size_t>(up.parent_or_next)];
+                if ( p.child1 == ia ) {
+                    p.child1 = iup;
+                } else {
+                    p.child2 = iup;
+                }
+            } else {
+                root_ = iup;
+            }
+
+            // keep the taller grandchild above
+            const bool f_taller = f.height > g.height;
+            const i32 ikeep = f_taller ? if_ : ig;
+            const i32 imove = f_taller ? ig : if_;
+            node& keep = nodes_[static_cast<std::size_t>(ikeep)];
+            node& move = nodes_[static_cast<std::size_t>(imove)];
+
+            up.child2 = ikeep;
+            if ( up_is_child2 ) {
+                a.child2 = imove;
+            } else {
+                a.child1 = imove;
+            }
+            move.parent_or_next = ia;
+
+            a.bounds = merged(other.bounds, move.bounds);
+            up.bounds = merged(a.bounds, keep.bounds);
+
+            a.height = 1 + math::max(other.height, move.height);
+            up.height = 1 + math::max(a.height, keep.height);
+
+            return iup;
+        };
+
+        if ( balance > 1 ) {
+            return rotate(ic, ib, true);
+        }
+
+        if ( balance < -1 ) {
+            return rotate(ib, ic, false);
+        }
+
+        return ia;
+    }
+}}
@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <enduro2d/high/_high.hpp>
+
+namespace e2d { namespace collision_impl
+{
+    //
+    // bbox
+    //
+
+    struct bbox final {
+        v2f min;
+        v2f max;
+    };
+
+    inline bbox make_bbox(const b2f& r) noexcept {
+        return bbox{math::minimum(r), math::maximum(r)};
+    }
+
+    inline bbox merged(const bbox& l, const bbox& r) noexcept {
+        return bbox{
+            math::minimized(l.min, r.min),
+            math::maximized(l.max, r.max)};
+    }
+
+    inline bbox expanded(const bbox& b, f32 margin) noexcept {
+        return bbox{
+            b.min - v2f(margin),
+            b.max + v2f(margin)};
+    }
+
+    inline f32 perimeter(const bbox& b) noexcept {
+        return 2.f * ((b.max.x - b.min.x) + (b.max.y - b.min.y));
+    }
+
+    inline bool contains(const bbox& outer, const bbox& inner) noexcept {
+        return outer.min.x <= inner.min.x
+            && outer.min.y <= inner.min.y
+            && inner.max.x <= outer.max.x
+            && inner.max.y <= outer.max.y;
+    }
+
+    inline bool overlaps(const bbox& l, const bbox& r) noexcept {
+        return l.min.x <= r.max.x
+            && l.min.y <= r.max.y
+            && r.min.x <= l.max.x
+            && r.min.y <= l.max.y;
+    }
+
+    //
+    // dynamic_tree
+    //
+    // Incremental bounding volume hierarchy of fattened boxes.
+    // Leaves are reinserted only when their tight box leaves the
+    // fat one, so slowly moving proxies cost nothing to the tree.
+    // Inspired by:
+    // https://github.com/erincatto/box2d (b2DynamicTree)
+    //
+
+    class dynamic_tree final : private noncopyable {
+    public:
+        static const i32 null_node = -1;
+    public:
+        explicit dynamic_tree(f32 margin);
+        ~dynamic_tree() noexcept;
+
+        i32 create_proxy(const bbox& bounds, u32 user_data);
+        void destroy_proxy(i32 proxy) noexcept;
+
+        // returns true when the proxy was reinserted
+        bool move_proxy(i32 proxy, const bbox& bounds) noexcept;
+
+        u32 user_data(i32 proxy) const noexcept;
+        void user_data(i32 proxy, u32 value) noexcept;
+
+        const bbox& fat_bounds(i32 proxy) const noexcept;
+
+        std::size_t height() const noexcept;
+        std::size_t proxy_count() const noexcept;
+
+        // f(u32 user_data) -> bool (false to stop the query)
+        template < typename F >
+        void query(const bbox& bounds, F&& f) const;
+
+        // f(u32 user_data, f32 max_fraction) -> f32 (new max fraction)
+        template < typename F >
+        void raycast(const v2f& p1, const v2f& p2, F&& f) const;
+    private:
+        struct node {
+            bbox bounds;
+            i32 parent_or_next{null_node};
+            i32 child1{null_node};
+            i32 child2{null_node};
+            i32 height{-1};
+            u32 user_data{0u};
+
+            bool is_leaf() const noexcept {
+                return child1 == null_node;
+            }
+        };
+
+        // depth-first traversal stack, heap is touched only by very deep trees
+        class traversal_stack final : private noncopyable {
+        public:
+            void push(i32 v) {
+                if ( size_ < inline_capacity ) {
+                    inline_[size_] = v;
+                } else {
+                    overflow_.push_back(v);
+                }
+                ++size_;
+            }
+
+            i32 pop() noexcept {
+                E2D_ASSERT(size_ > 0u);
+                --size_;
+                if ( size_ < inline_capacity ) {
+                    return inline_[size_];
+                }
+                const i32 v = overflow_.back();
+                overflow_.pop_back();
+                return v;
+            }
+
+            bool empty() const noexcept {
+                return size_ == 0u;
+            }
+        private:
+            static const std::size_t inline_capacity = 64u;
+            std::array<i32, inline_capacity> inline_;
+            vector<i32> overflow_;
+            std::size_t size_{0u};
+        };
+    private:
+        i32 allocate_node_();
+        void free_node_(i32 index) noexcept;
+        void insert_leaf_(i32 leaf) noexcept;
+        void remove_leaf_(i32 leaf) noexcept;
+        i32 balance_(i32 index) noexcept;
+    private:
+        vector<node> nodes_;
+        i32 root_{null_node};
+        i32 free_list_{null_node};
+        std::size_t proxy_count_{0u};
+        f32 margin_{0.f};
+    };
+}}
+
+namespace e2d { namespace collision_impl
+{
+    template < typename F >
+    void dynamic_tree::query(const bbox& bounds, F&& f) const {
+        if ( root_ == null_node ) {
+            return;
+        }
+        traversal_stack stack;
+        stack.push(root_);
+        while ( !stack.empty() ) {
+            const node& n = nodes_[static_cast<std::size_t>(stack.pop())];
+            if ( !overlaps(n.bounds, bounds) ) {
+                continue;
+            }
+            if ( n.is_leaf() ) {
+                if ( !f(n.user_data) ) {
+                    return;
+                }
+            } else {
+                stack.push(n.child1);
+                stack.push(n.child2);
+            }
+        }
+    }
+
+    template < typename F >
+    void dynamic_tree::raycast(const v2f& p1, const v2f& p2, F&& f) const {
+        if ( root_ == null_node ) {
+            return;
+        }
+
+        const v2f d = p2 - p1;
+        if ( math::is_near_zero(math::length_squared(d), 0.f) ) {
+            return;
+        }
+
+        // separating axis of the segment
+        const v2f v = v2f(-d.y, d.x);
+        const v2f abs_v = v2f(math::abs(v.x), math::abs(v.y));
+
+        f32 max_fraction = 1.f;
+        bbox segment_bounds{
+            math::minimized(p1, p2),
+            math::maximized(p1, p2)};
+
+        traversal_stack stack;
+        stack.push(root_);
+        while ( !stack.empty() ) {
+            const node& n = nodes_[static_cast<std::size_t>(stack.pop())];
+            if ( !overlaps(n.bounds, segment_bounds) ) {
+                continue;
+            }
+
+            const v2f c = (n.bounds.min + n.bounds.max) * 0.5f;
+            const v2f h = (n.bounds.max - n.bounds.min) * 0.5f;
+            const f32 separation =
+                math::abs(math::dot(v, p1 - c)) -
+                math::dot(abs_v, h);
+            if ( separation > 0.f ) {
+                continue;
+            }
+
+            if ( n.is_leaf() ) {
+                const f32 fraction = f(n.user_data, max_fraction);
+                if ( fraction <= 0.f ) {
+                    return;
+                }
+                if ( fraction < max_fraction ) {
+                    max_fraction = fraction;
+                    const v2f t = p1 + d * max_fraction;
+                    segment_bounds = bbox{
+                        math::minimized(p1, t),
+                        math::maximized(p1, t)};
+                }
+            } else {
+                stack.push(n.child1);
+                stack.push(n.child2);
+            }
+        }
+    }
+}}
@@ -64,4 +64,51 @@ namespace e2d
         E2D_UNUSED(dependencies, ctx);
         return true;
     }
+
+    bool factory_serializer<actor>::operator()(
+        const actor& component,
+        const save_context& ctx) const
+    {
+        const_node_iptr n = component.node();
+        const v3f translation = n ? n->translation() : v3f::zero();
+        const q4f rotation = n ? n->rotation() : q4f::identity();
+        const v3f scale = n ? n->scale() : v3f::unit();
+        return write_value(ctx, translation)
+            && write_value(ctx, rotation)
+            && write_value(ctx, scale);
+    }
+
+    bool factory_serializer<actor>::operator()(
+        actor& component,
+        const load_context& ctx) const
+    {
+        v3f translation;
+        q4f rotation;
+        v3f scale;
+
+        if ( !read_value(ctx, translation)
+            || !read_value(ctx, rotation)
+            || !read_value(ctx, scale) )
+        {
+            the<debug>().error("ACTOR: Failed to read component data");
+            return false;
+        }
+
+        if ( !component.node() ) {
+            component.node(node::create());
+        }
+
+        component.node()->translation(translation);
+        component.node()->rotation(rotation);
+        component.node()->scale(scale);
+        return true;
+    }
+
+    bool factory_serializer<actor>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        E2D_UNUSED(dependencies);
+        return skip_bytes(ctx, sizeof(v3f) * 2u + sizeof(q4f));
+    }
 }
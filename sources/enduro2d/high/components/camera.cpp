@@ -16,7 +16,8 @@ namespace e2d
             "depth" : { "type" : "number" },
             "viewport" : { "$ref": "#/common_definitions/b2" },
             "projection" : { "$ref": "#/common_definitions/m4" },
-            "background" : { "$ref": "#/common_definitions/color" }
+            "background" : { "$ref": "#/common_definitions/color" },
+            "partial_redraw" : { "type" : "boolean" }
         }
     })json";
 
@@ -64,6 +65,15 @@ namespace e2d
             component.background(background);
         }
 
+        if ( ctx.root.HasMember("partial_redraw") ) {
+            auto partial_redraw = component.partial_redraw();
+            if ( !json_utils::try_parse_value(ctx.root["partial_redraw"], partial_redraw) ) {
+                the<debug>().error("CAMERA: Incorrect formatting of 'partial_redraw' property");
+                return false;
+            }
+            component.partial_redraw(partial_redraw);
+        }
+
         return true;
     }
 
@@ -74,4 +84,52 @@ namespace e2d
         E2D_UNUSED(dependencies, ctx);
         return true;
     }
+
+    bool factory_serializer<camera>::operator()(
+        const camera& component,
+        const save_context& ctx) const
+    {
+        return write_value(ctx, component.depth())
+            && write_value(ctx, component.viewport())
+            && write_value(ctx, component.projection())
+            && write_value(ctx, component.background())
+            && write_value(ctx, component.partial_redraw());
+    }
+
+    bool factory_serializer<camera>::operator()(
+        camera& component,
+        const load_context& ctx) const
+    {
+        i32 depth = 0;
+        b2u viewport;
+        m4f projection;
+        color background;
+        bool partial_redraw = false;
+
+        if ( !read_value(ctx, depth)
+            || !read_value(ctx, viewport)
+            || !read_value(ctx, projection)
+            || !read_value(ctx, background)
+            || !read_value(ctx, partial_redraw) )
+        {
+            the<debug>().error("CAMERA: Failed to read component data");
+            return false;
+        }
+
+        component
+            .depth(depth)
+            .viewport(viewport)
+            .projection(projection)
+            .background(background)
+            .partial_redraw(partial_redraw);
+        return true;
+    }
+
+    bool factory_serializer<camera>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        E2D_UNUSED(dependencies);
+        return skip_bytes(ctx, sizeof(i32) + sizeof(b2u) + sizeof(m4f) + sizeof(color) + sizeof(u8));
+    }
 }
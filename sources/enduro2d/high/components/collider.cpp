@@ -0,0 +1,274 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/components/collider.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    f32 cross(const v2f& o, const v2f& a, const v2f& b) noexcept {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    }
+
+    // Andrew's monotone chain, returns the hull in counter-clockwise order
+    vector<v2f> make_convex_hull(vector<v2f> points) {
+        std::sort(points.begin(), points.end(), [](const v2f& l, const v2f& r){
+            return l.x < r.x || (l.x == r.x && l.y < r.y);
+        });
+        points.erase(std::unique(points.begin(), points.end()), points.end());
+
+        if ( points.size() < 3u ) {
+            return points;
+        }
+
+        vector<v2f> hull(points.size() * 2u);
+        std::size_t k = 0u;
+
+        for ( std::size_t i = 0; i < points.size(); ++i ) {
+            while ( k >= 2u && cross(hull[k - 2u], hull[k - 1u], points[i]) <= 0.f ) {
+                --k;
+            }
+            hull[k++] = points[i];
+        }
+
+        for ( std::size_t i = points.size() - 1u, t = k + 1u; i > 0u; --i ) {
+            while ( k >= t && cross(hull[k - 2u], hull[k - 1u], points[i - 1u]) <= 0.f ) {
+                --k;
+            }
+            hull[k++] = points[i - 1u];
+        }
+
+        hull.resize(k - 1u);
+        return hull;
+    }
+}
+
+namespace e2d
+{
+    collider& collider::polygon(const vector<v2f>& vertices) {
+        vertices_ = make_convex_hull(vertices);
+        type_ = types::polygon;
+        return *this;
+    }
+
+    collider& collider::polygon(const shape& shape) {
+        return polygon(shape.vertices());
+    }
+}
+
+namespace e2d
+{
+    const char* factory_loader<collider>::schema_source = R"json({
+        "type" : "object",
+        "required" : [],
+        "additionalProperties" : false,
+        "properties" : {
+            "circle" : {
+                "type" : "object",
+                "required" : [ "radius" ],
+                "additionalProperties" : false,
+                "properties" : {
+                    "center" : { "$ref": "#/common_definitions/v2" },
+                    "radius" : { "type" : "number", "minimum" : 0 }
+                }
+            },
+            "rect" : { "$ref": "#/common_definitions/b2" },
+            "polygon" : {
+                "type" : "array",
+                "minItems" : 3,
+                "items" : { "$ref": "#/common_definitions/v2" }
+            },
+            "shape" : { "$ref": "#/common_definitions/address" },
+            "layer" : { "type" : "integer", "minimum" : 0 },
+            "mask" : { "type" : "integer", "minimum" : 0 },
+            "enabled" : { "type" : "boolean" }
+        }
+    })json";
+
+    bool factory_loader<collider>::operator()(
+        collider& component,
+        const fill_context& ctx) const
+    {
+        if ( ctx.root.HasMember("circle") ) {
+            const rapidjson::Value& circle_root = ctx.root["circle"];
+
+            auto center = component.center();
+            if ( circle_root.HasMember("center") ) {
+                if ( !json_utils::try_parse_value(circle_root["center"], center) ) {
+                    the<debug>().error("COLLIDER: Incorrect formatting of 'circle.center' property");
+                    return false;
+                }
+            }
+
+            auto radius = component.radius();
+            if ( !json_utils::try_parse_value(circle_root["radius"], radius) ) {
+                the<debug>().error("COLLIDER: Incorrect formatting of 'circle.radius' property");
+                return false;
+            }
+
+            component.circle(center, radius);
+        }
+
+        if ( ctx.root.HasMember("rect") ) {
+            auto rect = component.rect();
+            if ( !json_utils::try_parse_value(ctx.root["rect"], rect) ) {
+                the<debug>().error("COLLIDER: Incorrect formatting of 'rect' property");
+                return false;
+            }
+            component.rect(rect);
+        }
+
+        if ( ctx.root.HasMember("polygon") ) {
+            vector<v2f> vertices;
+            if ( !json_utils::try_parse_value(ctx.root["polygon"], vertices) ) {
+                the<debug>().error("COLLIDER: Incorrect formatting of 'polygon' property");
+                return false;
+            }
+            component.polygon(vertices);
+        }
+
+        if ( ctx.root.HasMember("shape") ) {
+            auto shape = ctx.dependencies.find_asset<shape_asset>(
+                path_buffer(ctx.parent_address, ctx.root["shape"].GetString()));
+            if ( !shape ) {
+                the<debug>().error("COLLIDER: Dependency 'shape' is not found:\n"
+                    "--> Parent address: %0\n"
+                    "--> Dependency address: %1",
+                    ctx.parent_address,
+                    ctx.root["shape"].GetString());
+                return false;
+            }
+            component.polygon(shape->content());
+        }
+
+        if ( ctx.root.HasMember("layer") ) {
+            auto layer = component.layer();
+            if ( !json_utils::try_parse_value(ctx.root["layer"], layer) ) {
+                the<debug>().error("COLLIDER: Incorrect formatting of 'layer' property");
+                return false;
+            }
+            component.layer(layer);
+        }
+
+        if ( ctx.root.HasMember("mask") ) {
+            auto mask = component.mask();
+            if ( !json_utils::try_parse_value(ctx.root["mask"], mask) ) {
+                the<debug>().error("COLLIDER: Incorrect formatting of 'mask' property");
+                return false;
+            }
+            component.mask(mask);
+        }
+
+        if ( ctx.root.HasMember("enabled") ) {
+            auto enabled = component.enabled();
+            if ( !json_utils::try_parse_value(ctx.root["enabled"], enabled) ) {
+                the<debug>().error("COLLIDER: Incorrect formatting of 'enabled' property");
+                return false;
+            }
+            component.enabled(enabled);
+        }
+
+        return true;
+    }
+
+    bool factory_loader<collider>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        if ( ctx.root.HasMember("shape") ) {
+            dependencies.add_dependency<shape_asset>(
+                path_buffer(ctx.parent_address, ctx.root["shape"].GetString()));
+        }
+
+        return true;
+    }
+
+    bool factory_serializer<collider>::operator()(
+        const collider& component,
+        const save_context& ctx) const
+    {
+        if ( !write_value(ctx, component.type())
+            || !write_value(ctx, component.center())
+            || !write_value(ctx, component.radius())
+            || !write_value(ctx, component.rect())
+            || !write_value(ctx, math::numeric_cast<u32>(component.vertices().size()))
+            || !write_value(ctx, component.layer())
+            || !write_value(ctx, component.mask())
+            || !write_value(ctx, component.enabled()) )
+        {
+            return false;
+        }
+        return ctx.stream
+            .write(component.vertices().data(), component.vertices().size() * sizeof(v2f))
+            .success();
+    }
+
+    bool factory_serializer<collider>::operator()(
+        collider& component,
+        const load_context& ctx) const
+    {
+        collider::types type = collider::types::rect;
+        v2f center;
+        f32 radius = 0.f;
+        b2f rect;
+        u32 vertex_count = 0u;
+        u32 layer = 0u;
+        u32 mask = 0u;
+        bool enabled = false;
+
+        if ( !read_enum(ctx, type, collider::types::polygon)
+            || !read_value(ctx, center)
+            || !read_value(ctx, radius)
+            || !read_value(ctx, rect)
+            || !read_value(ctx, vertex_count)
+            || !read_value(ctx, layer)
+            || !read_value(ctx, mask)
+            || !read_value(ctx, enabled) )
+        {
+            the<debug>().error("COLLIDER: Failed to read component data");
+            return false;
+        }
+
+        vector<v2f> vertices(vertex_count);
+        if ( !ctx.stream.read(vertices.data(), vertices.size() * sizeof(v2f)).success() ) {
+            the<debug>().error("COLLIDER: Failed to read component data");
+            return false;
+        }
+
+        switch ( type ) {
+            case collider::types::circle:
+                component.circle(center, radius);
+                break;
+            case collider::types::rect:
+                component.rect(rect);
+                break;
+            case collider::types::polygon:
+                component.polygon(vertices);
+                break;
+            default:
+                the<debug>().error("COLLIDER: Incorrect collider type");
+                return false;
+        }
+
+        component
+            .layer(layer)
+            .mask(mask)
+            .enabled(enabled);
+        return true;
+    }
+
+    bool factory_serializer<collider>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        E2D_UNUSED(dependencies);
+        u32 vertex_count = 0u;
+        return skip_bytes(ctx, sizeof(collider::types) + sizeof(v2f) + sizeof(f32) + sizeof(b2f))
+            && read_value(ctx, vertex_count)
+            && skip_bytes(ctx, sizeof(u32) * 2u + sizeof(u8) + vertex_count * sizeof(v2f));
+    }
+}
@@ -90,4 +90,52 @@ namespace e2d
         E2D_UNUSED(dependencies, ctx);
         return true;
     }
+
+    bool factory_serializer<flipbook_player>::operator()(
+        const flipbook_player& component,
+        const save_context& ctx) const
+    {
+        return write_value(ctx, component.time())
+            && write_value(ctx, component.speed())
+            && write_value(ctx, component.looped())
+            && write_value(ctx, component.playing())
+            && write_value(ctx, component.sequence().hash());
+    }
+
+    bool factory_serializer<flipbook_player>::operator()(
+        flipbook_player& component,
+        const load_context& ctx) const
+    {
+        f32 time = 0.f;
+        f32 speed = 0.f;
+        bool looped = false;
+        bool playing = false;
+        u32 sequence = 0u;
+
+        if ( !read_value(ctx, time)
+            || !read_value(ctx, speed)
+            || !read_value(ctx, looped)
+            || !read_value(ctx, playing)
+            || !read_value(ctx, sequence) )
+        {
+            the<debug>().error("FLIPBOOK_PLAYER: Failed to read component data");
+            return false;
+        }
+
+        component
+            .time(time)
+            .speed(speed)
+            .looped(looped)
+            .playing(playing)
+            .sequence(str_hash(sequence));
+        return true;
+    }
+
+    bool factory_serializer<flipbook_player>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        E2D_UNUSED(dependencies);
+        return skip_bytes(ctx, sizeof(f32) * 2u + sizeof(u8) * 2u + sizeof(u32));
+    }
 }
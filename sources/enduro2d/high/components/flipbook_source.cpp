@@ -23,7 +23,7 @@ namespace e2d
     {
         if ( ctx.root.HasMember("flipbook") ) {
             auto flipbook = ctx.dependencies.find_asset<flipbook_asset>(
-                path::combine(ctx.parent_address, ctx.root["flipbook"].GetString()));
+                path_buffer(ctx.parent_address, ctx.root["flipbook"].GetString()));
             if ( !flipbook ) {
                 the<debug>().error("FLIPBOOK_SOURCE: Dependency 'flipbook' is not found:\n"
                     "--> Parent address: %0\n"
@@ -44,9 +44,36 @@ namespace e2d
     {
         if ( ctx.root.HasMember("flipbook") ) {
             dependencies.add_dependency<flipbook_asset>(
-                path::combine(ctx.parent_address, ctx.root["flipbook"].GetString()));
+                path_buffer(ctx.parent_address, ctx.root["flipbook"].GetString()));
         }
 
         return true;
     }
+
+    bool factory_serializer<flipbook_source>::operator()(
+        const flipbook_source& component,
+        const save_context& ctx) const
+    {
+        return write_address(ctx, component.flipbook().get());
+    }
+
+    bool factory_serializer<flipbook_source>::operator()(
+        flipbook_source& component,
+        const load_context& ctx) const
+    {
+        flipbook_asset::ptr flipbook;
+        if ( !read_asset<flipbook_asset>(ctx, flipbook) ) {
+            the<debug>().error("FLIPBOOK_SOURCE: Failed to read component data");
+            return false;
+        }
+        component.flipbook(flipbook);
+        return true;
+    }
+
+    bool factory_serializer<flipbook_source>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        return collect_asset<flipbook_asset>(dependencies, ctx);
+    }
 }
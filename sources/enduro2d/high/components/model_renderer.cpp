@@ -23,7 +23,7 @@ namespace e2d
     {
         if ( ctx.root.HasMember("model") ) {
             auto model = ctx.dependencies.find_asset<model_asset>(
-                path::combine(ctx.parent_address, ctx.root["model"].GetString()));
+                path_buffer(ctx.parent_address, ctx.root["model"].GetString()));
             if ( !model ) {
                 the<debug>().error("MODEL_RENDERER: Dependency 'model' is not found:\n"
                     "--> Parent address: %0\n"
@@ -44,9 +44,36 @@ namespace e2d
     {
         if ( ctx.root.HasMember("model") ) {
             dependencies.add_dependency<model_asset>(
-                path::combine(ctx.parent_address, ctx.root["model"].GetString()));
+                path_buffer(ctx.parent_address, ctx.root["model"].GetString()));
         }
 
         return true;
     }
+
+    bool factory_serializer<model_renderer>::operator()(
+        const model_renderer& component,
+        const save_context& ctx) const
+    {
+        return write_address(ctx, component.model().get());
+    }
+
+    bool factory_serializer<model_renderer>::operator()(
+        model_renderer& component,
+        const load_context& ctx) const
+    {
+        model_asset::ptr model;
+        if ( !read_asset<model_asset>(ctx, model) ) {
+            the<debug>().error("MODEL_RENDERER: Failed to read component data");
+            return false;
+        }
+        component.model(model);
+        return true;
+    }
+
+    bool factory_serializer<model_renderer>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        return collect_asset<model_asset>(dependencies, ctx);
+    }
 }
@@ -43,7 +43,7 @@ namespace e2d
             vector<material_asset::ptr> materials(materials_root.Size());
             for ( rapidjson::SizeType i = 0; i < materials_root.Size(); ++i ) {
                 auto material = ctx.dependencies.find_asset<material_asset>(
-                    path::combine(ctx.parent_address, materials_root[i].GetString()));
+                    path_buffer(ctx.parent_address, materials_root[i].GetString()));
                 if ( !material ) {
                     the<debug>().error("RENDERER: Dependency 'material' is not found:\n"
                         "--> Parent address: %0\n"
@@ -68,10 +68,76 @@ namespace e2d
             const rapidjson::Value& materials_root = ctx.root["materials"];
             for ( rapidjson::SizeType i = 0; i < materials_root.Size(); ++i ) {
                 dependencies.add_dependency<material_asset>(
-                    path::combine(ctx.parent_address, materials_root[i].GetString()));
+                    path_buffer(ctx.parent_address, materials_root[i].GetString()));
             }
         }
 
         return true;
     }
+
+    bool factory_serializer<renderer>::operator()(
+        const renderer& component,
+        const save_context& ctx) const
+    {
+        if ( !write_value(ctx, component.enabled())
+            || !write_value(ctx, math::numeric_cast<u32>(component.materials().size())) )
+        {
+            return false;
+        }
+        for ( const material_asset::ptr& material : component.materials() ) {
+            if ( !write_address(ctx, material.get()) ) {
+                return false;
+            }
+        }
+        return write_properties(ctx, *component.properties());
+    }
+
+    bool factory_serializer<renderer>::operator()(
+        renderer& component,
+        const load_context& ctx) const
+    {
+        bool enabled = false;
+        u32 material_count = 0u;
+
+        if ( !read_value(ctx, enabled) || !read_value(ctx, material_count) ) {
+            the<debug>().error("RENDERER: Failed to read component data");
+            return false;
+        }
+
+        vector<material_asset::ptr> materials(material_count);
+        for ( material_asset::ptr& material : materials ) {
+            if ( !read_asset<material_asset>(ctx, material) ) {
+                the<debug>().error("RENDERER: Failed to read component data");
+                return false;
+            }
+        }
+
+        render::property_block properties;
+        if ( !read_properties(ctx, properties) ) {
+            the<debug>().error("RENDERER: Failed to read component data");
+            return false;
+        }
+
+        component
+            .enabled(enabled)
+            .materials(std::move(materials))
+            .properties(std::move(properties));
+        return true;
+    }
+
+    bool factory_serializer<renderer>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        u32 material_count = 0u;
+        if ( !skip_bytes(ctx, sizeof(u8)) || !read_value(ctx, material_count) ) {
+            return false;
+        }
+        for ( u32 i = 0; i < material_count; ++i ) {
+            if ( !collect_asset<material_asset>(dependencies, ctx) ) {
+                return false;
+            }
+        }
+        return skip_properties(ctx);
+    }
 }
@@ -13,7 +13,8 @@ namespace e2d
         "required" : [],
         "additionalProperties" : false,
         "properties" : {
-            "depth" : { "type" : "number" }
+            "depth" : { "type" : "number" },
+            "static_batching" : { "type" : "boolean" }
         }
     })json";
 
@@ -30,6 +31,15 @@ namespace e2d
             component.depth(depth);
         }
 
+        if ( ctx.root.HasMember("static_batching") ) {
+            auto static_batching = component.static_batching();
+            if ( !json_utils::try_parse_value(ctx.root["static_batching"], static_batching) ) {
+                the<debug>().error("SCENE: Incorrect formatting of 'static_batching' property");
+                return false;
+            }
+            component.static_batching(static_batching);
+        }
+
         return true;
     }
 
@@ -40,4 +50,40 @@ namespace e2d
         E2D_UNUSED(dependencies, ctx);
         return true;
     }
+
+    bool factory_serializer<scene>::operator()(
+        const scene& component,
+        const save_context& ctx) const
+    {
+        return write_value(ctx, component.depth())
+            && write_value(ctx, component.static_batching());
+    }
+
+    bool factory_serializer<scene>::operator()(
+        scene& component,
+        const load_context& ctx) const
+    {
+        i32 depth = 0;
+        bool static_batching = false;
+
+        if ( !read_value(ctx, depth)
+            || !read_value(ctx, static_batching) )
+        {
+            the<debug>().error("SCENE: Failed to read component data");
+            return false;
+        }
+
+        component
+            .depth(depth)
+            .static_batching(static_batching);
+        return true;
+    }
+
+    bool factory_serializer<scene>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        E2D_UNUSED(dependencies);
+        return skip_bytes(ctx, sizeof(i32) + sizeof(u8));
+    }
 }
@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/components/shape_renderer.hpp>
+
+namespace e2d
+{
+    const char* factory_loader<shape_renderer>::schema_source = R"json({
+        "type" : "object",
+        "required" : [],
+        "additionalProperties" : false,
+        "properties" : {
+            "tint" : { "$ref": "#/common_definitions/color" },
+            "filtering" : { "type" : "boolean" },
+            "shape" : { "$ref": "#/common_definitions/address" },
+            "texture" : { "$ref": "#/common_definitions/address" }
+        }
+    })json";
+
+    bool factory_loader<shape_renderer>::operator()(
+        shape_renderer& component,
+        const fill_context& ctx) const
+    {
+        if ( ctx.root.HasMember("tint") ) {
+            auto tint = component.tint();
+            if ( !json_utils::try_parse_value(ctx.root["tint"], tint) ) {
+                the<debug>().error("SHAPE_RENDERER: Incorrect formatting of 'tint' property");
+                return false;
+            }
+            component.tint(tint);
+        }
+
+        if ( ctx.root.HasMember("filtering") ) {
+            auto filtering = component.filtering();
+            if ( !json_utils::try_parse_value(ctx.root["filtering"], filtering) ) {
+                the<debug>().error("SHAPE_RENDERER: Incorrect formatting of 'filtering' property");
+                return false;
+            }
+            component.filtering(filtering);
+        }
+
+        if ( ctx.root.HasMember("shape") ) {
+            auto shape = ctx.dependencies.find_asset<shape_asset>(
+                path_buffer(ctx.parent_address, ctx.root["shape"].GetString()));
+            if ( !shape ) {
+                the<debug>().error("SHAPE_RENDERER: Dependency 'shape' is not found:\n"
+                    "--> Parent address: %0\n"
+                    "--> Dependency address: %1",
+                    ctx.parent_address,
+                    ctx.root["shape"].GetString());
+                return false;
+            }
+            component.shape(shape);
+        }
+
+        if ( ctx.root.HasMember("texture") ) {
+            auto texture = ctx.dependencies.find_asset<texture_asset>(
+                path_buffer(ctx.parent_address, ctx.root["texture"].GetString()));
+            if ( !texture ) {
+                the<debug>().error("SHAPE_RENDERER: Dependency 'texture' is not found:\n"
+                    "--> Parent address: %0\n"
+                    "--> Dependency address: %1",
+                    ctx.parent_address,
+                    ctx.root["texture"].GetString());
+                return false;
+            }
+            component.texture(texture);
+        }
+
+        return true;
+    }
+
+    bool factory_loader<shape_renderer>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        if ( ctx.root.HasMember("shape") ) {
+            dependencies.add_dependency<shape_asset>(
+                path_buffer(ctx.parent_address, ctx.root["shape"].GetString()));
+        }
+
+        if ( ctx.root.HasMember("texture") ) {
+            dependencies.add_dependency<texture_asset>(
+                path_buffer(ctx.parent_address, ctx.root["texture"].GetString()));
+        }
+
+        return true;
+    }
+
+    bool factory_serializer<shape_renderer>::operator()(
+        const shape_renderer& component,
+        const save_context& ctx) const
+    {
+        return write_value(ctx, component.tint())
+            && write_value(ctx, component.filtering())
+            && write_address(ctx, component.shape().get())
+            && write_address(ctx, component.texture().get());
+    }
+
+    bool factory_serializer<shape_renderer>::operator()(
+        shape_renderer& component,
+        const load_context& ctx) const
+    {
+        color32 tint;
+        bool filtering = false;
+        shape_asset::ptr shape;
+        texture_asset::ptr texture;
+
+        if ( !read_value(ctx, tint)
+            || !read_value(ctx, filtering)
+            || !read_asset<shape_asset>(ctx, shape)
+            || !read_asset<texture_asset>(ctx, texture) )
+        {
+            the<debug>().error("SHAPE_RENDERER: Failed to read component data");
+            return false;
+        }
+
+        component
+            .tint(tint)
+            .filtering(filtering)
+            .shape(shape)
+            .texture(texture);
+        return true;
+    }
+
+    bool factory_serializer<shape_renderer>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        return skip_bytes(ctx, sizeof(color32) + sizeof(u8))
+            && collect_asset<shape_asset>(dependencies, ctx)
+            && collect_asset<texture_asset>(dependencies, ctx);
+    }
+}
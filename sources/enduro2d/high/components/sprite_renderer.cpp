@@ -6,6 +6,113 @@
 
 #include <enduro2d/high/components/sprite_renderer.hpp>
 
+namespace
+{
+    using namespace e2d;
+
+    bool parse_sprite_renderer_mode(str_view str, sprite_renderer::modes& mode) noexcept {
+    #define DEFINE_IF(x) if ( str == #x ) { mode = sprite_renderer::modes::x; return true; }
+        DEFINE_IF(simple);
+        DEFINE_IF(sliced);
+    #undef DEFINE_IF
+        return false;
+    }
+
+    f32 fit_borders_factor(f32 first, f32 second, f32 length) noexcept {
+        const f32 borders = first + second;
+        return borders > length && borders > 0.f
+            ? math::max(length, 0.f) / borders
+            : 1.f;
+    }
+}
+
+namespace e2d
+{
+    const sprite_renderer::sliced_geometry& sprite_renderer::sliced() const noexcept {
+        if ( !sliced_dirty_ ) {
+            return sliced_;
+        }
+
+        sliced_ = sliced_geometry();
+        sliced_dirty_ = false;
+
+        if ( !sprite_ ) {
+            return sliced_;
+        }
+
+        const e2d::sprite& spr = sprite_->content();
+        const b2f& tex_r = spr.texrect();
+        const v2f tex_s = spr.texture() && spr.texture()->content()
+            ? spr.texture()->content()->size().cast_to<f32>()
+            : v2f::zero();
+
+        const v2f size = size_ == v2f::zero()
+            ? tex_r.size
+            : size_;
+
+        const v4f borders{
+            math::max(spr.borders().x, 0.f),
+            math::max(spr.borders().y, 0.f),
+            math::max(spr.borders().z, 0.f),
+            math::max(spr.borders().w, 0.f)};
+
+        const f32 tex_hk = fit_borders_factor(borders.x, borders.z, tex_r.size.x);
+        const f32 tex_vk = fit_borders_factor(borders.y, borders.w, tex_r.size.y);
+
+        const v4f tex_b{
+            borders.x * tex_hk,
+            borders.y * tex_vk,
+            borders.z * tex_hk,
+            borders.w * tex_vk};
+
+        const f32 hk = fit_borders_factor(tex_b.x, tex_b.z, size.x);
+        const f32 vk = fit_borders_factor(tex_b.y, tex_b.w, size.y);
+
+        const f32 px = tex_r.size.x > 0.f
+            ? (tex_r.position.x - spr.pivot().x) / tex_r.size.x * size.x
+            : 0.f;
+
+        const f32 py = tex_r.size.y > 0.f
+            ? (tex_r.position.y - spr.pivot().y) / tex_r.size.y * size.y
+            : 0.f;
+
+        const f32 xs[] = {
+            px,
+            px + tex_b.x * hk,
+            px + size.x - tex_b.z * hk,
+            px + size.x};
+
+        const f32 ys[] = {
+            py,
+            py + tex_b.y * vk,
+            py + size.y - tex_b.w * vk,
+            py + size.y};
+
+        const f32 us[] = {
+            tex_r.position.x,
+            tex_r.position.x + tex_b.x,
+            tex_r.position.x + tex_r.size.x - tex_b.z,
+            tex_r.position.x + tex_r.size.x};
+
+        const f32 vs[] = {
+            tex_r.position.y,
+            tex_r.position.y + tex_b.y,
+            tex_r.position.y + tex_r.size.y - tex_b.w,
+            tex_r.position.y + tex_r.size.y};
+
+        for ( std::size_t j = 0; j < 4; ++j ) {
+            for ( std::size_t i = 0; i < 4; ++i ) {
+                sliced_.vertices[j * 4 + i] = v2f(xs[i], ys[j]);
+                sliced_.texcoords[j * 4 + i] = v2f(
+                    tex_s.x > 0.f ? us[i] / tex_s.x : 0.f,
+                    tex_s.y > 0.f ? vs[j] / tex_s.y : 0.f);
+            }
+        }
+
+        return sliced_;
+    }
+}
+
 namespace e2d
 {
     const char* factory_loader<sprite_renderer>::schema_source = R"json({
@@ -14,6 +121,11 @@ namespace e2d
         "additionalProperties" : false,
         "properties" : {
             "tint" : { "$ref": "#/common_definitions/color" },
+            "size" : { "$ref": "#/common_definitions/v2" },
+            "mode" : {
+                "type" : "string",
+                "enum" : [ "simple", "sliced" ]
+            },
             "filtering" : { "type" : "boolean" },
             "atlas" : { "$ref": "#/common_definitions/address" },
             "sprite" : { "$ref": "#/common_definitions/address" }
@@ -33,6 +145,25 @@ namespace e2d
             component.tint(tint);
         }
 
+        if ( ctx.root.HasMember("size") ) {
+            auto size = component.size();
+            if ( !json_utils::try_parse_value(ctx.root["size"], size) ) {
+                the<debug>().error("SPRITE_RENDERER: Incorrect formatting of 'size' property");
+                return false;
+            }
+            component.size(size);
+        }
+
+        if ( ctx.root.HasMember("mode") ) {
+            auto mode = component.mode();
+            E2D_ASSERT(ctx.root["mode"].IsString());
+            if ( !parse_sprite_renderer_mode(ctx.root["mode"].GetString(), mode) ) {
+                the<debug>().error("SPRITE_RENDERER: Incorrect formatting of 'mode' property");
+                return false;
+            }
+            component.mode(mode);
+        }
+
         if ( ctx.root.HasMember("filtering") ) {
             auto filtering = component.filtering();
             if ( !json_utils::try_parse_value(ctx.root["filtering"], filtering) ) {
@@ -44,7 +175,7 @@ namespace e2d
 
         if ( ctx.root.HasMember("atlas") ) {
             auto sprite = ctx.dependencies.find_asset<atlas_asset, sprite_asset>(
-                path::combine(ctx.parent_address, ctx.root["atlas"].GetString()));
+                path_buffer(ctx.parent_address, ctx.root["atlas"].GetString()));
             if ( !sprite ) {
                 the<debug>().error("SPRITE_RENDERER: Dependency 'atlas' is not found:\n"
                     "--> Parent address: %0\n"
@@ -58,7 +189,7 @@ namespace e2d
 
         if ( ctx.root.HasMember("sprite") ) {
             auto sprite = ctx.dependencies.find_asset<sprite_asset>(
-                path::combine(ctx.parent_address, ctx.root["sprite"].GetString()));
+                path_buffer(ctx.parent_address, ctx.root["sprite"].GetString()));
             if ( !sprite ) {
                 the<debug>().error("SPRITE_RENDERER: Dependency 'sprite' is not found:\n"
                     "--> Parent address: %0\n"
@@ -79,14 +210,88 @@ namespace e2d
     {
         if ( ctx.root.HasMember("atlas") ) {
             dependencies.add_dependency<atlas_asset, sprite_asset>(
-                path::combine(ctx.parent_address, ctx.root["atlas"].GetString()));
+                path_buffer(ctx.parent_address, ctx.root["atlas"].GetString()));
         }
         
         if ( ctx.root.HasMember("sprite") ) {
             dependencies.add_dependency<sprite_asset>(
-                path::combine(ctx.parent_address, ctx.root["sprite"].GetString()));
+                path_buffer(ctx.parent_address, ctx.root["sprite"].GetString()));
         }
 
         return true;
     }
+
+    bool factory_serializer<sprite_renderer>::operator()(
+        const sprite_renderer& component,
+        const save_context& ctx) const
+    {
+        return write_value(ctx, component.tint())
+            && write_value(ctx, component.size())
+            && write_value(ctx, component.mode())
+            && write_value(ctx, component.filtering())
+            && write_address(ctx, component.sprite().get());
+    }
+
+    bool factory_serializer<sprite_renderer>::operator()(
+        sprite_renderer& component,
+        const load_context& ctx) const
+    {
+        color32 tint;
+        v2f size;
+        sprite_renderer::modes mode = sprite_renderer::modes::simple;
+        bool filtering = false;
+        str address;
+
+        if ( !read_value(ctx, tint)
+            || !read_value(ctx, size)
+            || !read_enum(ctx, mode, sprite_renderer::modes::sliced)
+            || !read_value(ctx, filtering)
+            || !read_string(ctx.stream, address) )
+        {
+            the<debug>().error("SPRITE_RENDERER: Failed to read component data");
+            return false;
+        }
+
+        sprite_asset::ptr sprite;
+        if ( !address.empty() ) {
+            // nested sprites are atlas regions
+            sprite = address::nested_view(address).empty()
+                ? ctx.dependencies.find_asset<sprite_asset>(address)
+                : ctx.dependencies.find_asset<atlas_asset, sprite_asset>(address);
+            if ( !sprite ) {
+                the<debug>().error("SPRITE_RENDERER: Dependency 'sprite' is not found:\n"
+                    "--> Dependency address: %0",
+                    address);
+                return false;
+            }
+        }
+
+        component
+            .tint(tint)
+            .size(size)
+            .mode(mode)
+            .filtering(filtering)
+            .sprite(sprite);
+        return true;
+    }
+
+    bool factory_serializer<sprite_renderer>::operator()(
+        asset_dependencies& dependencies,
+        const collect_context& ctx) const
+    {
+        str address;
+        if ( !skip_bytes(ctx, sizeof(color32) + sizeof(v2f) + sizeof(sprite_renderer::modes) + sizeof(u8))
+            || !read_string(ctx.stream, address) )
+        {
+            return false;
+        }
+        if ( !address.empty() ) {
+            if ( address::nested_view(address).empty() ) {
+                dependencies.add_dependency<sprite_asset>(address);
+            } else {
+                dependencies.add_dependency<atlas_asset, sprite_asset>(address);
+            }
+        }
+        return true;
+    }
 }
@@ -0,0 +1,244 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/dynamic_resolution.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    const u32 max_retry_backoff = 16u;
+}
+
+namespace e2d
+{
+    //
+    // dynamic_resolution::internal_state
+    //
+
+    class dynamic_resolution::internal_state final : private e2d::noncopyable {
+    public:
+        internal_state(const parameters& params)
+        : params_(params)
+        , history_(math::max(params.history_size(), std::size_t(1u)), 0.f) {
+            params_.min_scale(math::clamp(params_.min_scale(), 0.01f, 1.f));
+            params_.max_scale(math::clamp(params_.max_scale(), params_.min_scale(), 1.f));
+            params_.scale_step(math::max(params_.scale_step(), 0.01f));
+            reset();
+        }
+
+        bool update(f32 frame_time) noexcept {
+            if ( !params_.enabled() ) {
+                return false;
+            }
+
+            if ( retry_frames_ > 0u ) {
+                --retry_frames_;
+            }
+
+            history_sum_ += frame_time - history_[history_next_];
+            history_[history_next_] = frame_time;
+            history_next_ = (history_next_ + 1u) % history_.size();
+            history_count_ = math::min(history_count_ + 1u, history_.size());
+
+            if ( history_count_ < history_.size() ) {
+                return false;
+            }
+
+            const f32 avg = smoothed_frame_time();
+            const f32 target = params_.target_frame_time();
+            const f32 eps = params_.scale_step() * 0.01f;
+
+            if ( avg > target * params_.downscale_threshold() && scale_ > params_.min_scale() + eps ) {
+                retry_scale_ = scale_;
+                retry_frames_ = history_.size() * retry_backoff_;
+                retry_backoff_ = math::min(retry_backoff_ * 2u, max_retry_backoff);
+                set_scale_(scale_ - params_.scale_step());
+                return true;
+            }
+
+            if ( avg < target * params_.upscale_threshold() && scale_ < params_.max_scale() - eps ) {
+                const f32 next_scale = math::min(scale_ + params_.scale_step(), params_.max_scale());
+                const bool retry = next_scale + params_.scale_step() * 0.5f > retry_scale_;
+                if ( retry && retry_frames_ > 0u ) {
+                    return false;
+                }
+                set_scale_(next_scale);
+                return true;
+            }
+
+            // a stable scale for the whole retry period forgives failures
+            if ( retry_frames_ == 0u ) {
+                retry_backoff_ = 1u;
+            }
+
+            return false;
+        }
+
+        void reset() noexcept {
+            scale_ = params_.max_scale();
+            retry_scale_ = params_.max_scale();
+            retry_frames_ = 0u;
+            retry_backoff_ = 1u;
+            restart_history_();
+        }
+
+        f32 scale() const noexcept {
+            return scale_;
+        }
+
+        f32 smoothed_frame_time() const noexcept {
+            return history_count_ > 0u
+                ? history_sum_ / math::numeric_cast<f32>(history_count_)
+                : 0.f;
+        }
+
+        const parameters& params() const noexcept {
+            return params_;
+        }
+    private:
+        void set_scale_(f32 scale) noexcept {
+            scale_ = math::clamp(scale, params_.min_scale(), params_.max_scale());
+            restart_history_();
+        }
+
+        void restart_history_() noexcept {
+            std::fill(history_.begin(), history_.end(), 0.f);
+            history_sum_ = 0.f;
+            history_next_ = 0u;
+            history_count_ = 0u;
+        }
+    private:
+        parameters params_;
+        vector<f32> history_;
+        f32 history_sum_{0.f};
+        std::size_t history_next_{0u};
+        std::size_t history_count_{0u};
+        f32 scale_{1.f};
+        f32 retry_scale_{1.f};
+        std::size_t retry_frames_{0u};
+        u32 retry_backoff_{1u};
+    };
+
+    //
+    // dynamic_resolution::parameters
+    //
+
+    dynamic_resolution::parameters& dynamic_resolution::parameters::enabled(bool value) noexcept {
+        enabled_ = value;
+        return *this;
+    }
+
+    dynamic_resolution::parameters& dynamic_resolution::parameters::min_scale(f32 value) noexcept {
+        min_scale_ = value;
+        return *this;
+    }
+
+    dynamic_resolution::parameters& dynamic_resolution::parameters::max_scale(f32 value) noexcept {
+        max_scale_ = value;
+        return *this;
+    }
+
+    dynamic_resolution::parameters& dynamic_resolution::parameters::scale_step(f32 value) noexcept {
+        scale_step_ = value;
+        return *this;
+    }
+
+    dynamic_resolution::parameters& dynamic_resolution::parameters::target_frame_time(f32 value) noexcept {
+        target_frame_time_ = value;
+        return *this;
+    }
+
+    dynamic_resolution::parameters& dynamic_resolution::parameters::downscale_threshold(f32 value) noexcept {
+        downscale_threshold_ = value;
+        return *this;
+    }
+
+    dynamic_resolution::parameters& dynamic_resolution::parameters::upscale_threshold(f32 value) noexcept {
+        upscale_threshold_ = value;
+        return *this;
+    }
+
+    dynamic_resolution::parameters& dynamic_resolution::parameters::history_size(std::size_t value) noexcept {
+        history_size_ = value;
+        return *this;
+    }
+
+    bool dynamic_resolution::parameters::enabled() const noexcept {
+        return enabled_;
+    }
+
+    f32 dynamic_resolution::parameters::min_scale() const noexcept {
+        return min_scale_;
+    }
+
+    f32 dynamic_resolution::parameters::max_scale() const noexcept {
+        return max_scale_;
+    }
+
+    f32 dynamic_resolution::parameters::scale_step() const noexcept {
+        return scale_step_;
+    }
+
+    f32 dynamic_resolution::parameters::target_frame_time() const noexcept {
+        return target_frame_time_;
+    }
+
+    f32 dynamic_resolution::parameters::downscale_threshold() const noexcept {
+        return downscale_threshold_;
+    }
+
+    f32 dynamic_resolution::parameters::upscale_threshold() const noexcept {
+        return upscale_threshold_;
+    }
+
+    std::size_t dynamic_resolution::parameters::history_size() const noexcept {
+        return history_size_;
+    }
+
+    //
+    // dynamic_resolution
+    //
+
+    dynamic_resolution::dynamic_resolution()
+    : dynamic_resolution(parameters()) {}
+
+    dynamic_resolution::dynamic_resolution(const parameters& params)
+    : state_(new internal_state(params)) {}
+
+    dynamic_resolution::~dynamic_resolution() noexcept = default;
+
+    bool dynamic_resolution::update(f32 frame_time) noexcept {
+        return state_->update(frame_time);
+    }
+
+    void dynamic_resolution::reset() noexcept {
+        state_->reset();
+    }
+
+    bool dynamic_resolution::enabled() const noexcept {
+        return state_->params().enabled();
+    }
+
+    f32 dynamic_resolution::scale() const noexcept {
+        return state_->scale();
+    }
+
+    f32 dynamic_resolution::smoothed_frame_time() const noexcept {
+        return state_->smoothed_frame_time();
+    }
+
+    const dynamic_resolution::parameters& dynamic_resolution::params() const noexcept {
+        return state_->params();
+    }
+
+    v2u dynamic_resolution::scaled_size(const v2u& size) const noexcept {
+        const f32 s = scale();
+        return v2u(
+            math::max(1u, math::numeric_cast<u32>(math::numeric_cast<f32>(size.x) * s + 0.5f)),
+            math::max(1u, math::numeric_cast<u32>(math::numeric_cast<f32>(size.y) * s + 0.5f)));
+    }
+}
@@ -6,8 +6,187 @@
 
 #include <enduro2d/high/factory.hpp>
 
+namespace
+{
+    using namespace e2d;
+
+    using property_value = render::property_value;
+    constexpr std::size_t property_value_type_count = stdex::variant_size<property_value>::value;
+
+    template < std::size_t I = 0u >
+    std::enable_if_t<I == property_value_type_count, std::size_t>
+    property_value_size(std::size_t index) noexcept {
+        E2D_UNUSED(index);
+        return 0u;
+    }
+
+    template < std::size_t I = 0u >
+    std::enable_if_t<I < property_value_type_count, std::size_t>
+    property_value_size(std::size_t index) noexcept {
+        return index == I
+            ? sizeof(stdex::variant_alternative_t<I, property_value>)
+            : property_value_size<I + 1u>(index);
+    }
+
+    template < std::size_t I = 0u >
+    std::enable_if_t<I == property_value_type_count, bool>
+    read_property_value(input_sequence& stream, std::size_t index, property_value& value) {
+        E2D_UNUSED(stream, index, value);
+        return false;
+    }
+
+    template < std::size_t I = 0u >
+    std::enable_if_t<I < property_value_type_count, bool>
+    read_property_value(input_sequence& stream, std::size_t index, property_value& value) {
+        if ( index != I ) {
+            return read_property_value<I + 1u>(stream, index, value);
+        }
+        stdex::variant_alternative_t<I, property_value> v;
+        if ( !stream.read(&v, sizeof(v)).success() ) {
+            return false;
+        }
+        value = v;
+        return true;
+    }
+
+    class property_value_writer final {
+    public:
+        property_value_writer(output_sequence& stream) noexcept
+        : stream_(stream) {}
+
+        template < typename T >
+        bool operator()(const T& value) const {
+            return stream_.write(&value, sizeof(value)).success();
+        }
+    private:
+        output_sequence& stream_;
+    };
+}
+
 namespace e2d
 {
+    //
+    // factory_serializer
+    //
+
+    bool factory_serializer<>::write_value(const save_context& ctx, bool value) {
+        return ctx.stream
+            .write(value ? u8(1u) : u8(0u))
+            .success();
+    }
+
+    bool factory_serializer<>::read_value(const load_context& ctx, bool& value) {
+        u8 raw = 0u;
+        if ( !ctx.stream.read(raw).success() || raw > 1u ) {
+            return false;
+        }
+        value = raw != 0u;
+        return true;
+    }
+
+    bool factory_serializer<>::write_properties(
+        const save_context& ctx,
+        const render::property_block& value)
+    {
+        if ( value.sampler_count() ) {
+            the<debug>().warning("FACTORY: Samplers of a property block are not saved");
+        }
+        if ( !ctx.stream.write(math::numeric_cast<u32>(value.property_count())).success() ) {
+            return false;
+        }
+        bool success = true;
+        value.foreach_by_properties([&ctx, &success](str_hash name, const property_value& v){
+            success = success
+                && ctx.stream
+                    .write(name.hash())
+                    .write(math::numeric_cast<u8>(v.index()))
+                    .success()
+                && stdex::visit(property_value_writer(ctx.stream), v);
+        });
+        return success;
+    }
+
+    bool factory_serializer<>::read_properties(
+        const load_context& ctx,
+        render::property_block& value)
+    {
+        u32 count = 0u;
+        if ( !ctx.stream.read(count).success() ) {
+            return false;
+        }
+        render::property_block block;
+        for ( u32 i = 0; i < count; ++i ) {
+            u32 name = 0u;
+            u8 index = 0u;
+            property_value v;
+            if ( !ctx.stream.read(name).read(index).success()
+                || !read_property_value(ctx.stream, index, v) )
+            {
+                return false;
+            }
+            block.property(str_hash(name), v);
+        }
+        value = std::move(block);
+        return true;
+    }
+
+    bool factory_serializer<>::skip_properties(const collect_context& ctx) {
+        u32 count = 0u;
+        if ( !ctx.stream.read(count).success() ) {
+            return false;
+        }
+        for ( u32 i = 0; i < count; ++i ) {
+            u32 name = 0u;
+            u8 index = 0u;
+            if ( !ctx.stream.read(name).read(index).success() ) {
+                return false;
+            }
+            const std::size_t size = property_value_size(index);
+            if ( !size || !skip_bytes(ctx, size) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool factory_serializer<>::write_string(const save_context& ctx, str_view value) {
+        return ctx.stream
+            .write(math::numeric_cast<u32>(value.size()))
+            .write(value.data(), value.size())
+            .success();
+    }
+
+    bool factory_serializer<>::read_string(input_sequence& stream, str& value) {
+        u32 size = 0;
+        if ( !stream.read(size).success() ) {
+            return false;
+        }
+        value.resize(size);
+        return stream.read(&value[0], size).success();
+    }
+
+    bool factory_serializer<>::skip_bytes(const collect_context& ctx, std::size_t size) {
+        return ctx.stream
+            .seek(math::numeric_cast<std::ptrdiff_t>(size), true)
+            .success();
+    }
+
+    bool factory_serializer<>::write_address(const save_context& ctx, const asset* value) {
+        if ( !value ) {
+            return write_string(ctx, str_view());
+        }
+        const auto iter = ctx.addresses.find(value);
+        if ( iter == ctx.addresses.end() ) {
+            the<debug>().error("FACTORY: Failed to find the address of a component asset");
+            return false;
+        }
+        return write_string(ctx, iter->second);
+    }
+
+    //
+    // factory
+    //
+
     bool factory::validate_json(
         str_hash type,
         const rapidjson::Value& root) const
@@ -40,6 +219,99 @@ namespace e2d
             : false;
     }
 
+    bool factory::save_components(
+        const ecs::const_entity& entity,
+        const factory_serializer<>::save_context& ctx) const
+    {
+        vector<std::pair<str_hash, factory_serializer_creator_iptr>> serializers;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            for ( const auto& p : serializers_ ) {
+                if ( p.second->has_component(entity) ) {
+                    serializers.push_back(p);
+                }
+            }
+        }
+
+        // keeps snapshots of the same entities byte to byte identical
+        std::sort(serializers.begin(), serializers.end(), [](const auto& l, const auto& r) noexcept {
+            return l.first < r.first;
+        });
+
+        if ( !ctx.stream.write(math::numeric_cast<u32>(serializers.size())).success() ) {
+            return false;
+        }
+
+        for ( const auto& p : serializers ) {
+            if ( !ctx.stream.write(p.first.hash()).success() ) {
+                return false;
+            }
+            if ( !p.second->save_component(entity, ctx) ) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool factory::load_components(
+        ecs::prototype& prototype,
+        const factory_serializer<>::load_context& ctx) const
+    {
+        u32 count = 0;
+        if ( !ctx.stream.read(count).success() ) {
+            return false;
+        }
+
+        for ( u32 i = 0; i < count; ++i ) {
+            u32 type = 0;
+            if ( !ctx.stream.read(type).success() ) {
+                return false;
+            }
+            auto serializer = find_serializer(str_hash(type));
+            if ( !serializer ) {
+                the<debug>().error("FACTORY: Component serializer is not found:\n"
+                    "--> Type hash: %0",
+                    type);
+                return false;
+            }
+            if ( !serializer->load_component(prototype, ctx) ) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool factory::collect_dependencies(
+        asset_dependencies& dependencies,
+        const factory_serializer<>::collect_context& ctx) const
+    {
+        u32 count = 0;
+        if ( !ctx.stream.read(count).success() ) {
+            return false;
+        }
+
+        for ( u32 i = 0; i < count; ++i ) {
+            u32 type = 0;
+            if ( !ctx.stream.read(type).success() ) {
+                return false;
+            }
+            auto serializer = find_serializer(str_hash(type));
+            if ( !serializer ) {
+                the<debug>().error("FACTORY: Component serializer is not found:\n"
+                    "--> Type hash: %0",
+                    type);
+                return false;
+            }
+            if ( !serializer->collect_dependencies(dependencies, ctx) ) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     factory_creator_iptr factory::find_creator(str_hash type) const {
         std::lock_guard<std::mutex> guard(mutex_);
         const auto iter = creators_.find(type);
@@ -47,4 +319,12 @@ namespace e2d
             ? iter->second
             : nullptr;
     }
+
+    factory_serializer_creator_iptr factory::find_serializer(str_hash type) const {
+        std::lock_guard<std::mutex> guard(mutex_);
+        const auto iter = serializers_.find(type);
+        return iter != serializers_.end()
+            ? iter->second
+            : nullptr;
+    }
 }
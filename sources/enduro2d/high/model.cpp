@@ -140,6 +140,27 @@ namespace
 
         return geo;
     }
+
+    std::pair<v3f, f32> make_bounding_sphere(const mesh& mesh) noexcept {
+        const vector<v3f>& vertices = mesh.vertices();
+        if ( vertices.empty() ) {
+            return std::make_pair(v3f::zero(), 0.f);
+        }
+
+        v3f min = vertices.front();
+        v3f max = vertices.front();
+        for ( const v3f& v : vertices ) {
+            min = math::minimized(min, v);
+            max = math::maximized(max, v);
+        }
+
+        const v3f center = (min + max) * 0.5f;
+        f32 radius_sqr = 0.f;
+        for ( const v3f& v : vertices ) {
+            radius_sqr = math::max(radius_sqr, math::length_squared(v - center));
+        }
+        return std::make_pair(center, math::sqrt(radius_sqr));
+    }
 }
 
 namespace e2d
@@ -166,12 +187,18 @@ namespace e2d
     void model::clear() noexcept {
         mesh_.reset();
         geometry_.clear();
+        lods_.clear();
+        bounds_center_ = v3f::zero();
+        bounds_radius_ = 0.f;
     }
 
     void model::swap(model& other) noexcept {
         using std::swap;
         swap(mesh_, other.mesh_);
         swap(geometry_, other.geometry_);
+        swap(lods_, other.lods_);
+        swap(bounds_center_, other.bounds_center_);
+        swap(bounds_radius_, other.bounds_radius_);
     }
 
     model& model::assign(model&& other) noexcept {
@@ -187,14 +214,22 @@ namespace e2d
             model m;
             m.mesh_ = other.mesh_;
             m.geometry_ = other.geometry_;
+            m.lods_ = other.lods_;
+            m.bounds_center_ = other.bounds_center_;
+            m.bounds_radius_ = other.bounds_radius_;
             swap(m);
         }
         return *this;
     }
 
     model& model::set_mesh(const mesh_asset::ptr& mesh) {
+        const std::pair<v3f, f32> bounds = mesh
+            ? make_bounding_sphere(mesh->content())
+            : std::make_pair(v3f::zero(), 0.f);
         mesh_ = mesh;
         geometry_.clear();
+        bounds_center_ = bounds.first;
+        bounds_radius_ = bounds.second;
         return *this;
     }
 
@@ -202,12 +237,85 @@ namespace e2d
         return mesh_;
     }
 
+    model& model::add_lod(const mesh_asset::ptr& mesh, f32 screen_size) {
+        lod l;
+        l.mesh = mesh;
+        l.screen_size = screen_size;
+        const auto iter = std::upper_bound(
+            lods_.begin(), lods_.end(), screen_size,
+            [](f32 size, const lod& other) noexcept {
+                return size > other.screen_size;
+            });
+        lods_.insert(iter, std::move(l));
+        return *this;
+    }
+
+    model& model::clear_lods() noexcept {
+        lods_.clear();
+        return *this;
+    }
+
+    std::size_t model::lod_count() const noexcept {
+        return lods_.size() + 1u;
+    }
+
+    const mesh_asset::ptr& model::lod_mesh(std::size_t level) const noexcept {
+        E2D_ASSERT(level < lod_count());
+        return level > 0u
+            ? lods_[level - 1u].mesh
+            : mesh_;
+    }
+
+    const render::geometry& model::lod_geometry(std::size_t level) const noexcept {
+        E2D_ASSERT(level < lod_count());
+        return level > 0u
+            ? lods_[level - 1u].geometry
+            : geometry_;
+    }
+
+    f32 model::lod_screen_size(std::size_t level) const noexcept {
+        E2D_ASSERT(level < lod_count());
+        return level > 0u
+            ? lods_[level - 1u].screen_size
+            : std::numeric_limits<f32>::infinity();
+    }
+
+    std::size_t model::select_lod(
+        f32 screen_size,
+        std::size_t current,
+        f32 hysteresis) const noexcept
+    {
+        std::size_t level = math::min(current, lods_.size());
+        while ( level < lods_.size() && screen_size < lods_[level].screen_size * (1.f - hysteresis) ) {
+            ++level;
+        }
+        while ( level > 0u && screen_size > lods_[level - 1u].screen_size * (1.f + hysteresis) ) {
+            --level;
+        }
+        return level;
+    }
+
+    const v3f& model::bounds_center() const noexcept {
+        return bounds_center_;
+    }
+
+    f32 model::bounds_radius() const noexcept {
+        return bounds_radius_;
+    }
+
     void model::regenerate_geometry(render& render) {
         if ( mesh_ ) {
             geometry_ = make_geometry(render, mesh_->content());
         } else {
             geometry_.clear();
         }
+        for ( lod& l : lods_ ) {
+            if ( l.mesh ) {
+                l.geometry = make_geometry(render, l.mesh->content());
+            } else {
+                l.geometry.clear();
+            }
+        }
     }
 
     const render::geometry& model::geometry() const noexcept {
@@ -222,8 +330,22 @@ namespace e2d
     }
 
     bool operator==(const model& l, const model& r) noexcept {
-        return l.mesh() == r.mesh()
-            && l.geometry() == r.geometry();
+        if ( l.mesh() != r.mesh()
+            || l.geometry() != r.geometry()
+            || l.lod_count() != r.lod_count() )
+        {
+            return false;
+        }
+        for ( std::size_t i = 1; i < l.lod_count(); ++i ) {
+            const bool equal =
+                l.lod_mesh(i) == r.lod_mesh(i) &&
+                l.lod_geometry(i) == r.lod_geometry(i) &&
+                math::approximately(l.lod_screen_size(i), r.lod_screen_size(i));
+            if ( !equal ) {
+                return false;
+            }
+        }
+        return true;
     }
 
     bool operator!=(const model& l, const model& r) noexcept {
@@ -103,6 +103,11 @@ namespace e2d
         return world_matrix_;
     }
 
+    u32 node::world_matrix_version() const noexcept {
+        world_matrix();
+        return world_matrix_version_;
+    }
+
     node_iptr node::root() noexcept {
         node* n = this;
         while ( n->parent_ ) {
@@ -413,5 +418,6 @@ namespace e2d
         world_matrix_ = parent_
             ? local_matrix() * parent_->world_matrix()
             : local_matrix();
+        ++world_matrix_version_;
     }
 }
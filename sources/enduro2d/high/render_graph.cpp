@@ -0,0 +1,666 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/render_graph.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    const std::size_t no_pass = std::size_t(-1);
+    const u32 pooled_target_max_unused_frames = 3u;
+
+    bool has_buffer(
+        render::clear_command::buffer buffers,
+        render::clear_command::buffer buffer) noexcept
+    {
+        return !!(utils::enum_to_underlying(buffers) & utils::enum_to_underlying(buffer));
+    }
+
+    bool same_clear(
+        const render::clear_command& l,
+        const render::clear_command& r) noexcept
+    {
+        return l.clear_buffer() == r.clear_buffer()
+            && (!has_buffer(l.clear_buffer(), render::clear_command::buffer::color)
+                || l.color_value() == r.color_value())
+            && (!has_buffer(l.clear_buffer(), render::clear_command::buffer::depth)
+                || math::approximately(l.depth_value(), r.depth_value()))
+            && (!has_buffer(l.clear_buffer(), render::clear_command::buffer::stencil)
+                || l.stencil_value() == r.stencil_value());
+    }
+
+    // clears are limited by the scissor rect only
+    bool same_clear_area(
+        const render::viewport_command& l,
+        const render::viewport_command& r) noexcept
+    {
+        return l.scissoring() == r.scissoring()
+            && (!l.scissoring() || l.scissor_rect() == r.scissor_rect());
+    }
+
+    bool same_viewport(
+        const render::viewport_command& l,
+        const render::viewport_command& r) noexcept
+    {
+        return l.viewport_rect() == r.viewport_rect()
+            && same_clear_area(l, r);
+    }
+}
+
+namespace e2d
+{
+    //
+    // render_graph::internal_state
+    //
+
+    class render_graph::internal_state final : private noncopyable {
+    public:
+        struct resource_data final {
+            str name;
+            bool imported{false};
+            render_target_ptr target;
+            target_desc desc;
+            std::size_t first_use{no_pass};
+            std::size_t last_use{no_pass};
+            std::size_t physical{resource::invalid_index};
+        };
+
+        struct pass_data final {
+            str name;
+            resource target;
+            vector<resource> reads;
+            bool has_clear{false};
+            render::clear_command clear;
+            bool discard{false};
+            bool has_viewport{false};
+            b2u viewport;
+            bool has_scissor{false};
+            b2u scissor;
+            bool side_effect{false};
+            execute_func func;
+            bool culled{false};
+        };
+
+        struct physical_data final {
+            bool imported{false};
+            target_desc desc;
+            std::size_t last_use{no_pass};
+            render_target_ptr target;
+            bool failed{false};
+            // the target holds only the last clear
+            bool cleared{false};
+            render::clear_command clear;
+            b2u clear_scissor;
+            bool clear_scissoring{false};
+        };
+
+        struct pooled_target final {
+            target_desc desc;
+            render_target_ptr target;
+            u32 unused_frames{0u};
+            bool in_use{false};
+        };
+    public:
+        vector<resource_data> resources;
+        vector<pass_data> passes;
+        vector<physical_data> physicals;
+        vector<pooled_target> pool;
+        statistics stats;
+        bool compiled{false};
+    public:
+        pass_data& pass(std::size_t index) {
+            E2D_ASSERT(index < passes.size());
+            return passes[index];
+        }
+
+        void check_resource(const resource& r) const {
+            if ( !r.valid() || r.index() >= resources.size() ) {
+                throw bad_render_graph_operation();
+            }
+        }
+
+        void compile() {
+            stats = statistics();
+            stats.passes = math::numeric_cast<u32>(passes.size());
+
+            for ( const pass_data& p : passes ) {
+                check_resource(p.target);
+                for ( const resource& r : p.reads ) {
+                    check_resource(r);
+                }
+            }
+
+            // culling: contents of imported targets are always used,
+            // a pass which doesn't overwrite the whole target uses
+            // the previous contents
+
+            vector<bool> needed(resources.size(), false);
+            for ( std::size_t i = 0; i < resources.size(); ++i ) {
+                needed[i] = resources[i].imported;
+            }
+
+            for ( std::size_t i = passes.size(); i > 0; --i ) {
+                pass_data& p = passes[i - 1];
+                const std::size_t target = p.target.index();
+                p.culled = !p.side_effect && !needed[target];
+                if ( p.culled ) {
+                    ++stats.culled_passes;
+                    continue;
+                }
+                const bool reads_target = std::find(
+                    p.reads.begin(), p.reads.end(), p.target) != p.reads.end();
+                const bool overwrites =
+                    (p.discard || (p.has_clear && !p.has_scissor && has_buffer(
+                        p.clear.clear_buffer(),
+                        render::clear_command::buffer::color)));
+                if ( !resources[target].imported ) {
+                    needed[target] = !overwrites || reads_target;
+                }
+                for ( const resource& r : p.reads ) {
+                    needed[r.index()] = true;
+                }
+            }
+
+            // lifetimes
+
+            for ( resource_data& r : resources ) {
+                r.first_use = no_pass;
+                r.last_use = no_pass;
+                r.physical = resource::invalid_index;
+            }
+
+            const auto use = [this](const resource& r, std::size_t pass_index){
+                resource_data& rd = resources[r.index()];
+                if ( rd.first_use == no_pass ) {
+                    rd.first_use = pass_index;
+                }
+                rd.last_use = pass_index;
+            };
+
+            vector<bool> written(resources.size(), false);
+            for ( std::size_t i = 0; i < passes.size(); ++i ) {
+                const pass_data& p = passes[i];
+                if ( p.culled ) {
+                    continue;
+                }
+                for ( const resource& r : p.reads ) {
+                    if ( !resources[r.index()].imported && !written[r.index()] ) {
+                        throw bad_render_graph_operation();
+                    }
+                    use(r, i);
+                }
+                use(p.target, i);
+                written[p.target.index()] = true;
+            }
+
+            // physical targets: transient targets with equal descriptions
+            // and disjoint lifetimes share one physical target
+
+            physicals.clear();
+            vector<std::size_t> order;
+            order.reserve(resources.size());
+            for ( std::size_t i = 0; i < resources.size(); ++i ) {
+                if ( resources[i].first_use != no_pass ) {
+                    order.push_back(i);
+                }
+            }
+            std::stable_sort(order.begin(), order.end(), [this](std::size_t l, std::size_t r){
+                return resources[l].first_use < resources[r].first_use;
+            });
+
+            for ( std::size_t index : order ) {
+                resource_data& r = resources[index];
+                if ( r.imported ) {
+                    physical_data pd;
+                    pd.imported = true;
+                    pd.target = r.target;
+                    pd.last_use = r.last_use;
+                    r.physical = physicals.size();
+                    physicals.push_back(std::move(pd));
+                    continue;
+                }
+                ++stats.transient_targets;
+                const auto iter = std::find_if(
+                    physicals.begin(), physicals.end(),
+                    [&r](const physical_data& pd){
+                        return !pd.imported
+                            && pd.desc == r.desc
+                            && pd.last_use < r.first_use;
+                    });
+                if ( iter != physicals.end() ) {
+                    iter->last_use = r.last_use;
+                    r.physical = math::numeric_cast<std::size_t>(
+                        std::distance(physicals.begin(), iter));
+                } else {
+                    physical_data pd;
+                    pd.desc = r.desc;
+                    pd.last_use = r.last_use;
+                    r.physical = physicals.size();
+                    physicals.push_back(std::move(pd));
+                    ++stats.physical_targets;
+                }
+            }
+
+            compiled = true;
+        }
+
+        void acquire_targets(render& render) {
+            for ( pooled_target& pt : pool ) {
+                pt.in_use = false;
+            }
+            for ( physical_data& pd : physicals ) {
+                if ( pd.imported ) {
+                    continue;
+                }
+                const auto iter = std::find_if(
+                    pool.begin(), pool.end(),
+                    [&pd](const pooled_target& pt){
+                        return !pt.in_use && pt.desc == pd.desc;
+                    });
+                if ( iter != pool.end() ) {
+                    iter->in_use = true;
+                    iter->unused_frames = 0u;
+                    pd.target = iter->target;
+                    continue;
+                }
+                pd.target = render.create_render_target(
+                    pd.desc.size(),
+                    pd.desc.color_decl(),
+                    pd.desc.depth_decl(),
+                    pd.desc.external_texture());
+                if ( !pd.target ) {
+                    pd.failed = true;
+                    continue;
+                }
+                pooled_target pt;
+                pt.desc = pd.desc;
+                pt.target = pd.target;
+                pt.in_use = true;
+                pool.push_back(std::move(pt));
+            }
+        }
+
+        void release_targets() noexcept {
+            for ( physical_data& pd : physicals ) {
+                if ( !pd.imported ) {
+                    pd.target.reset();
+                }
+            }
+            pool.erase(std::remove_if(pool.begin(), pool.end(), [](pooled_target& pt){
+                return !pt.in_use && ++pt.unused_frames > pooled_target_max_unused_frames;
+            }), pool.end());
+        }
+
+        render::viewport_command make_viewport(
+            const pass_data& p,
+            const render_target_ptr& target) const
+        {
+            b2u viewport = p.viewport;
+            if ( !p.has_viewport ) {
+                if ( target ) {
+                    viewport = b2u(target->size());
+                } else if ( modules::is_initialized<window>() ) {
+                    viewport = b2u(the<window>().framebuffer_size());
+                }
+            }
+            render::viewport_command command(viewport);
+            if ( p.has_scissor ) {
+                command.scissor_rect(p.scissor).scissoring(true);
+            }
+            return command;
+        }
+
+        void execute(render_graph& graph, render& render) {
+            if ( !compiled ) {
+                compile();
+            }
+
+            stats.target_switches = 0u;
+            stats.viewport_switches = 0u;
+            stats.clears = 0u;
+            stats.skipped_clears = 0u;
+
+            for ( physical_data& pd : physicals ) {
+                pd.failed = false;
+                pd.cleared = false;
+            }
+
+            acquire_targets(render);
+
+            // the render state is unknown before the first pass
+            bool has_target = false;
+            const physical_data* current_target = nullptr;
+            bool has_viewport = false;
+            render::viewport_command current_viewport(b2u::zero());
+
+            try {
+                for ( pass_data& p : passes ) {
+                    if ( p.culled ) {
+                        continue;
+                    }
+
+                    physical_data& pd = physicals[resources[p.target.index()].physical];
+                    if ( pd.failed ) {
+                        the<debug>().error("RENDER_GRAPH: Skip pass without target:\n"
+                            "--> Pass: %0\n"
+                            "--> Target: %1",
+                            p.name,
+                            resources[p.target.index()].name);
+                        continue;
+                    }
+
+                    if ( !has_target || current_target != &pd ) {
+                        render.execute(render::target_command(pd.target));
+                        has_target = true;
+                        current_target = &pd;
+                        has_viewport = false;
+                        ++stats.target_switches;
+                    }
+
+                    const render::viewport_command viewport = make_viewport(p, pd.target);
+                    if ( !has_viewport || !same_viewport(current_viewport, viewport) ) {
+                        render.execute(viewport);
+                        has_viewport = true;
+                        current_viewport = viewport;
+                        ++stats.viewport_switches;
+                    }
+
+                    if ( p.has_clear ) {
+                        const bool redundant = pd.cleared
+                            && same_clear(pd.clear, p.clear)
+                            && pd.clear_scissoring == viewport.scissoring()
+                            && (!viewport.scissoring() || pd.clear_scissor == viewport.scissor_rect());
+                        if ( redundant ) {
+                            ++stats.skipped_clears;
+                        } else {
+                            render.execute(p.clear);
+                            pd.cleared = true;
+                            pd.clear = p.clear;
+                            pd.clear_scissoring = viewport.scissoring();
+                            pd.clear_scissor = viewport.scissor_rect();
+                            ++stats.clears;
+                        }
+                    }
+
+                    if ( p.func ) {
+                        pd.cleared = false;
+                        const pass_context ctx(graph, pd.target, viewport);
+                        p.func(render, ctx);
+                    }
+                }
+            } catch (...) {
+                release_targets();
+                throw;
+            }
+
+            release_targets();
+        }
+    };
+
+    //
+    // render_graph
+    //
+
+    render_graph::render_graph()
+    : state_(new internal_state()) {}
+    render_graph::~render_graph() noexcept = default;
+
+    void render_graph::clear() noexcept {
+        state_->resources.clear();
+        state_->passes.clear();
+        state_->physicals.clear();
+        state_->compiled = false;
+    }
+
+    render_graph::resource render_graph::import_target(
+        str_view name,
+        const render_target_ptr& target)
+    {
+        const auto iter = std::find_if(
+            state_->resources.begin(), state_->resources.end(),
+            [&target](const internal_state::resource_data& r){
+                return r.imported && r.target == target;
+            });
+        if ( iter != state_->resources.end() ) {
+            return resource(math::numeric_cast<std::size_t>(
+                std::distance(state_->resources.begin(), iter)));
+        }
+        internal_state::resource_data r;
+        r.name = name;
+        r.imported = true;
+        r.target = target;
+        state_->resources.push_back(std::move(r));
+        state_->compiled = false;
+        return resource(state_->resources.size() - 1u);
+    }
+
+    render_graph::resource render_graph::create_target(
+        str_view name,
+        const target_desc& desc)
+    {
+        if ( desc.size().x == 0u || desc.size().y == 0u ) {
+            throw bad_render_graph_operation();
+        }
+        internal_state::resource_data r;
+        r.name = name;
+        r.desc = desc;
+        state_->resources.push_back(std::move(r));
+        state_->compiled = false;
+        return resource(state_->resources.size() - 1u);
+    }
+
+    render_graph::pass_builder render_graph::add_pass(str_view name) {
+        internal_state::pass_data p;
+        p.name = name;
+        state_->passes.push_back(std::move(p));
+        state_->compiled = false;
+        return pass_builder(*this, state_->passes.size() - 1u);
+    }
+
+    void render_graph::compile() {
+        state_->compile();
+    }
+
+    void render_graph::execute(render& render) {
+        state_->execute(*this, render);
+    }
+
+    bool render_graph::is_culled(std::size_t pass) const noexcept {
+        return pass < state_->passes.size()
+            && state_->passes[pass].culled;
+    }
+
+    std::size_t render_graph::physical_target(const resource& target) const noexcept {
+        return target.valid() && target.index() < state_->resources.size()
+            ? state_->resources[target.index()].physical
+            : resource::invalid_index;
+    }
+
+    std::size_t render_graph::pass_count() const noexcept {
+        return state_->passes.size();
+    }
+
+    std::size_t render_graph::pooled_target_count() const noexcept {
+        return state_->pool.size();
+    }
+
+    const render_graph::statistics& render_graph::stats() const noexcept {
+        return state_->stats;
+    }
+
+    void render_graph::release_pooled_targets() noexcept {
+        state_->pool.clear();
+    }
+
+    //
+    // render_graph::resource
+    //
+
+    render_graph::resource::resource(std::size_t index) noexcept
+    : index_(index) {}
+
+    bool render_graph::resource::valid() const noexcept {
+        return index_ != invalid_index;
+    }
+
+    std::size_t render_graph::resource::index() const noexcept {
+        return index_;
+    }
+
+    bool operator==(const render_graph::resource& l, const render_graph::resource& r) noexcept {
+        return l.index() == r.index();
+    }
+
+    bool operator!=(const render_graph::resource& l, const render_graph::resource& r) noexcept {
+        return !(l == r);
+    }
+
+    //
+    // render_graph::target_desc
+    //
+
+    render_graph::target_desc::target_desc(const v2u& size) noexcept
+    : size_(size) {}
+
+    render_graph::target_desc& render_graph::target_desc::size(const v2u& value) noexcept {
+        size_ = value;
+        return *this;
+    }
+
+    render_graph::target_desc& render_graph::target_desc::color_decl(const pixel_declaration& value) noexcept {
+        color_decl_ = value;
+        return *this;
+    }
+
+    render_graph::target_desc& render_graph::target_desc::depth_decl(const pixel_declaration& value) noexcept {
+        depth_decl_ = value;
+        return *this;
+    }
+
+    render_graph::target_desc& render_graph::target_desc::external_texture(render_target::external_texture value) noexcept {
+        external_texture_ = value;
+        return *this;
+    }
+
+    const v2u& render_graph::target_desc::size() const noexcept {
+        return size_;
+    }
+
+    const pixel_declaration& render_graph::target_desc::color_decl() const noexcept {
+        return color_decl_;
+    }
+
+    const pixel_declaration& render_graph::target_desc::depth_decl() const noexcept {
+        return depth_decl_;
+    }
+
+    render_target::external_texture render_graph::target_desc::external_texture() const noexcept {
+        return external_texture_;
+    }
+
+    bool operator==(const render_graph::target_desc& l, const render_graph::target_desc& r) noexcept {
+        return l.size() == r.size()
+            && l.color_decl() == r.color_decl()
+            && l.depth_decl() == r.depth_decl()
+            && l.external_texture() == r.external_texture();
+    }
+
+    bool operator!=(const render_graph::target_desc& l, const render_graph::target_desc& r) noexcept {
+        return !(l == r);
+    }
+
+    //
+    // render_graph::pass_builder
+    //
+
+    render_graph::pass_builder::pass_builder(render_graph& graph, std::size_t index) noexcept
+    : graph_(graph)
+    , index_(index) {}
+
+    render_graph::pass_builder& render_graph::pass_builder::target(const resource& value) {
+        graph_.state_->check_resource(value);
+        graph_.state_->pass(index_).target = value;
+        return *this;
+    }
+
+    render_graph::pass_builder& render_graph::pass_builder::read(const resource& value) {
+        graph_.state_->check_resource(value);
+        graph_.state_->pass(index_).reads.push_back(value);
+        return *this;
+    }
+
+    render_graph::pass_builder& render_graph::pass_builder::clear(const render::clear_command& value) {
+        internal_state::pass_data& p = graph_.state_->pass(index_);
+        p.has_clear = true;
+        p.clear = value;
+        p.discard = false;
+        return *this;
+    }
+
+    render_graph::pass_builder& render_graph::pass_builder::discard() noexcept {
+        internal_state::pass_data& p = graph_.state_->pass(index_);
+        p.has_clear = false;
+        p.discard = true;
+        return *this;
+    }
+
+    render_graph::pass_builder& render_graph::pass_builder::viewport(const b2u& value) noexcept {
+        internal_state::pass_data& p = graph_.state_->pass(index_);
+        p.has_viewport = true;
+        p.viewport = value;
+        return *this;
+    }
+
+    render_graph::pass_builder& render_graph::pass_builder::scissor(const b2u& value) noexcept {
+        internal_state::pass_data& p = graph_.state_->pass(index_);
+        p.has_scissor = true;
+        p.scissor = value;
+        return *this;
+    }
+
+    render_graph::pass_builder& render_graph::pass_builder::side_effect() noexcept {
+        graph_.state_->pass(index_).side_effect = true;
+        return *this;
+    }
+
+    render_graph::pass_builder& render_graph::pass_builder::execute(execute_func value) {
+        graph_.state_->pass(index_).func = std::move(value);
+        return *this;
+    }
+
+    std::size_t render_graph::pass_builder::index() const noexcept {
+        return index_;
+    }
+
+    //
+    // render_graph::pass_context
+    //
+
+    render_graph::pass_context::pass_context(
+        const render_graph& graph,
+        const render_target_ptr& target,
+        const render::viewport_command& viewport) noexcept
+    : graph_(graph)
+    , target_(target)
+    , viewport_(viewport) {}
+
+    const render_target_ptr& render_graph::pass_context::target() const noexcept {
+        return target_;
+    }
+
+    const render_target_ptr& render_graph::pass_context::target(const resource& value) const {
+        const std::size_t physical = graph_.physical_target(value);
+        if ( physical >= graph_.state_->physicals.size() ) {
+            throw bad_render_graph_operation();
+        }
+        return graph_.state_->physicals[physical].target;
+    }
+
+    const render::viewport_command& render_graph::pass_context::viewport() const noexcept {
+        return viewport_;
+    }
+}
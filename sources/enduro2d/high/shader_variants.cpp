@@ -0,0 +1,276 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/shader_variants.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    // skips whitespaces and comments, which can precede '#version'
+    std::size_t find_first_directive(const str& source) noexcept {
+        std::size_t pos = 0u;
+        while ( pos < source.size() ) {
+            pos = source.find_first_not_of(" \t\r\n", pos);
+            if ( pos == str::npos ) {
+                return str::npos;
+            }
+            if ( source.compare(pos, 2, "//") == 0 ) {
+                pos = source.find('\n', pos);
+            } else if ( source.compare(pos, 2, "/*") == 0 ) {
+                pos = source.find("*/", pos + 2u);
+                pos = pos == str::npos ? pos : pos + 2u;
+            } else {
+                return pos;
+            }
+        }
+        return str::npos;
+    }
+
+    str add_keyword_defines(const str& source, const vector<str>& keywords) {
+        if ( keywords.empty() ) {
+            return source;
+        }
+
+        str defines;
+        for ( const str& keyword : keywords ) {
+            defines += "#define ";
+            defines += keyword;
+            defines += " 1\n";
+        }
+
+        // '#version' must be the first directive of the source
+        const std::size_t first = find_first_directive(source);
+        if ( first == str::npos || source.compare(first, 8, "#version") != 0 ) {
+            return defines + source;
+        }
+
+        const std::size_t eol = source.find('\n', first);
+        if ( eol == str::npos ) {
+            return source + "\n" + defines;
+        }
+
+        str result = source;
+        result.insert(eol + 1, defines);
+        return result;
+    }
+}
+
+namespace e2d
+{
+    struct shader_variants::cache_state final {
+        struct entry final {
+            shader_ptr shader;
+            u32 requests{0u};
+            bool attempted{false};
+        };
+        hash_map<keyword_mask, entry> entries;
+    };
+
+    shader_variants::shader_variants() = default;
+    shader_variants::~shader_variants() noexcept = default;
+
+    shader_variants::shader_variants(shader_variants&& other) noexcept {
+        assign(std::move(other));
+    }
+
+    shader_variants& shader_variants::operator=(shader_variants&& other) noexcept {
+        return assign(std::move(other));
+    }
+
+    shader_variants::shader_variants(const shader_variants& other) {
+        assign(other);
+    }
+
+    shader_variants& shader_variants::operator=(const shader_variants& other) {
+        return assign(other);
+    }
+
+    shader_variants::shader_variants(str vertex, str fragment, vector<str> keywords)
+    : vertex_(std::move(vertex))
+    , fragment_(std::move(fragment))
+    , keywords_(std::move(keywords))
+    , cache_(std::make_shared<cache_state>())
+    {
+        if ( keywords_.size() > max_keyword_count ) {
+            throw bad_shader_variants_operation();
+        }
+        for ( auto iter = keywords_.begin(); iter != keywords_.end(); ++iter ) {
+            if ( iter->empty() || std::find(iter + 1, keywords_.end(), *iter) != keywords_.end() ) {
+                throw bad_shader_variants_operation();
+            }
+        }
+    }
+
+    void shader_variants::clear() noexcept {
+        vertex_.clear();
+        fragment_.clear();
+        keywords_.clear();
+        cache_.reset();
+    }
+
+    void shader_variants::swap(shader_variants& other) noexcept {
+        using std::swap;
+        swap(vertex_, other.vertex_);
+        swap(fragment_, other.fragment_);
+        swap(keywords_, other.keywords_);
+        swap(cache_, other.cache_);
+    }
+
+    shader_variants& shader_variants::assign(shader_variants&& other) noexcept {
+        if ( this != &other ) {
+            swap(other);
+            other.clear();
+        }
+        return *this;
+    }
+
+    shader_variants& shader_variants::assign(const shader_variants& other) {
+        if ( this != &other ) {
+            shader_variants s;
+            s.vertex_ = other.vertex_;
+            s.fragment_ = other.fragment_;
+            s.keywords_ = other.keywords_;
+            s.cache_ = other.cache_;
+            swap(s);
+        }
+        return *this;
+    }
+
+    const str& shader_variants::vertex_source() const noexcept {
+        return vertex_;
+    }
+
+    const str& shader_variants::fragment_source() const noexcept {
+        return fragment_;
+    }
+
+    const vector<str>& shader_variants::keywords() const noexcept {
+        return keywords_;
+    }
+
+    bool shader_variants::try_make_mask(
+        const vector<str>& keywords,
+        keyword_mask& mask) const noexcept
+    {
+        keyword_mask result = 0u;
+        for ( const str& keyword : keywords ) {
+            const auto iter = std::find(keywords_.begin(), keywords_.end(), keyword);
+            if ( iter == keywords_.end() ) {
+                return false;
+            }
+            result |= keyword_mask(1u) << std::distance(keywords_.begin(), iter);
+        }
+        mask = result;
+        return true;
+    }
+
+    vector<str> shader_variants::mask_keywords(keyword_mask mask) const {
+        vector<str> result;
+        for ( std::size_t i = 0; i < keywords_.size(); ++i ) {
+            if ( mask & (keyword_mask(1u) << i) ) {
+                result.push_back(keywords_[i]);
+            }
+        }
+        return result;
+    }
+
+    str shader_variants::variant_vertex_source(keyword_mask mask) const {
+        return add_keyword_defines(vertex_, mask_keywords(mask));
+    }
+
+    str shader_variants::variant_fragment_source(keyword_mask mask) const {
+        return add_keyword_defines(fragment_, mask_keywords(mask));
+    }
+
+    shader_ptr shader_variants::variant(render& render, keyword_mask mask) const {
+        return compile_(render, mask, true);
+    }
+
+    shader_ptr shader_variants::prewarm(render& render, keyword_mask mask) const {
+        return compile_(render, mask, false);
+    }
+
+    vector<shader_variants::variant_usage> shader_variants::usage() const {
+        vector<variant_usage> result;
+        if ( cache_ ) {
+            result.reserve(cache_->entries.size());
+            for ( const auto& p : cache_->entries ) {
+                variant_usage u;
+                u.mask = p.first;
+                u.requests = p.second.requests;
+                u.compiled = !!p.second.shader;
+                result.push_back(u);
+            }
+        }
+        std::sort(result.begin(), result.end(),
+            [](const variant_usage& l, const variant_usage& r) noexcept {
+                return l.mask < r.mask;
+            });
+        return result;
+    }
+
+    shader_ptr shader_variants::compile_(render& render, keyword_mask mask, bool request) const {
+        if ( !cache_ ) {
+            throw bad_shader_variants_operation();
+        }
+
+        // bits of undeclared keywords are ignored
+        if ( keywords_.size() < max_keyword_count ) {
+            mask &= (keyword_mask(1u) << keywords_.size()) - 1u;
+        }
+
+        cache_state::entry& e = cache_->entries[mask];
+        if ( request ) {
+            ++e.requests;
+        }
+
+        // failed variants are not compiled again
+        if ( e.attempted ) {
+            return e.shader;
+        }
+        e.attempted = true;
+
+        const vector<str> defines = mask_keywords(mask);
+        e.shader = render.create_shader(
+            variant_vertex_source(mask),
+            variant_fragment_source(mask));
+
+        str names;
+        for ( const str& keyword : defines ) {
+            names += names.empty() ? keyword : " " + keyword;
+        }
+
+        if ( e.shader ) {
+            the<debug>().trace("SHADER_VARIANTS: Shader variant compiled:\n"
+                "--> Keywords: %0",
+                names);
+        } else {
+            the<debug>().error("SHADER_VARIANTS: Failed to compile shader variant:\n"
+                "--> Keywords: %0",
+                names);
+        }
+
+        return e.shader;
+    }
+}
+
+namespace e2d
+{
+    void swap(shader_variants& l, shader_variants& r) noexcept {
+        l.swap(r);
+    }
+
+    bool operator==(const shader_variants& l, const shader_variants& r) noexcept {
+        return l.vertex_source() == r.vertex_source()
+            && l.fragment_source() == r.fragment_source()
+            && l.keywords() == r.keywords();
+    }
+
+    bool operator!=(const shader_variants& l, const shader_variants& r) noexcept {
+        return !(l == r);
+    }
+}
@@ -0,0 +1,195 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/shared_property_block.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    template < typename T >
+    void append_bytes(vector<u8>& key, const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "unsupported key value type");
+        const u8* bytes = reinterpret_cast<const u8*>(&value);
+        key.insert(key.end(), bytes, bytes + sizeof(value));
+    }
+
+    class property_key_visitor final {
+    public:
+        property_key_visitor(vector<u8>& key) noexcept
+        : key_(key) {}
+
+        template < typename T >
+        void operator()(const T& value) const {
+            append_bytes(key_, value);
+        }
+    private:
+        vector<u8>& key_;
+    };
+
+    vector<u8> make_block_key(const render::property_block& block) {
+        vector<u8> key;
+        block.foreach_by_samplers([&key](str_hash name, const render::sampler_state& sampler){
+            append_bytes(key, name.hash());
+            append_bytes(key, sampler.texture().get());
+            append_bytes(key, sampler.s_wrap());
+            append_bytes(key, sampler.t_wrap());
+            append_bytes(key, sampler.r_wrap());
+            append_bytes(key, sampler.min_filter());
+            append_bytes(key, sampler.mag_filter());
+        });
+        block.foreach_by_properties([&key](str_hash name, const render::property_value& value){
+            append_bytes(key, name.hash());
+            append_bytes(key, value.index());
+            stdex::visit(property_key_visitor(key), value);
+        });
+        return key;
+    }
+
+    // FNV-1a
+    std::size_t make_key_hash(const vector<u8>& key) noexcept {
+        u32 hash = 2166136261u;
+        for ( u8 b : key ) {
+            hash = (hash ^ b) * 16777619u;
+        }
+        return hash;
+    }
+
+    struct instance final {
+        render::property_block block;
+        vector<u8> key;
+        std::size_t hash{0u};
+        u64 id{0u};
+    };
+
+    struct intern_table final {
+        using entry = std::pair<const instance*, std::weak_ptr<const instance>>;
+
+        std::mutex mutex;
+        hash_map<std::size_t, vector<entry>> buckets;
+        std::size_t count{0u};
+        u64 last_id{0u};
+    };
+
+    // instances keep the table alive, it can outlive the static pointer
+    const std::shared_ptr<intern_table>& get_intern_table() {
+        static const std::shared_ptr<intern_table> table =
+            std::make_shared<intern_table>();
+        return table;
+    }
+
+    std::shared_ptr<const instance> intern(render::property_block&& block) {
+        if ( !block.sampler_count() && !block.property_count() ) {
+            return nullptr;
+        }
+
+        vector<u8> key = make_block_key(block);
+        const std::size_t hash = make_key_hash(key);
+
+        const std::shared_ptr<intern_table>& table = get_intern_table();
+        std::lock_guard<std::mutex> guard(table->mutex);
+
+        vector<intern_table::entry>& bucket = table->buckets[hash];
+        for ( const intern_table::entry& e : bucket ) {
+            if ( e.first->key != key ) {
+                continue;
+            }
+            // the instance may be waiting for its deleter
+            std::shared_ptr<const instance> result = e.second.lock();
+            if ( result ) {
+                return result;
+            }
+        }
+
+        std::shared_ptr<const instance> result(
+            new instance{std::move(block), std::move(key), hash, ++table->last_id},
+            [table](const instance* inst) noexcept {
+                {
+                    std::lock_guard<std::mutex> guard(table->mutex);
+                    const auto bucket_iter = table->buckets.find(inst->hash);
+                    E2D_ASSERT(bucket_iter != table->buckets.end());
+                    vector<intern_table::entry>& entries = bucket_iter->second;
+                    entries.erase(std::remove_if(entries.begin(), entries.end(),
+                        [inst](const intern_table::entry& e) noexcept {
+                            return e.first == inst;
+                        }), entries.end());
+                    if ( entries.empty() ) {
+                        table->buckets.erase(bucket_iter);
+                    }
+                    --table->count;
+                }
+                delete inst;
+            });
+
+        bucket.emplace_back(result.get(), result);
+        ++table->count;
+        return result;
+    }
+
+    std::shared_ptr<const render::property_block> intern_block(
+        render::property_block&& block,
+        u64& id)
+    {
+        std::shared_ptr<const instance> inst = intern(std::move(block));
+        id = inst ? inst->id : 0u;
+        return inst
+            ? std::shared_ptr<const render::property_block>(inst, &inst->block)
+            : nullptr;
+    }
+}
+
+namespace e2d
+{
+    shared_property_block::shared_property_block(render::property_block&& block)
+    : block_(intern_block(std::move(block), id_)) {}
+
+    shared_property_block::shared_property_block(const render::property_block& block)
+    : block_(intern_block(render::property_block(block), id_)) {}
+
+    bool shared_property_block::empty() const noexcept {
+        return !block_;
+    }
+
+    bool shared_property_block::equals(const shared_property_block& other) const noexcept {
+        return block_ == other.block_;
+    }
+
+    u64 shared_property_block::id() const noexcept {
+        return id_;
+    }
+
+    const render::property_block& shared_property_block::get() const noexcept {
+        static const render::property_block empty_block;
+        return block_
+            ? *block_
+            : empty_block;
+    }
+
+    const render::property_block& shared_property_block::operator*() const noexcept {
+        return get();
+    }
+
+    const render::property_block* shared_property_block::operator->() const noexcept {
+        return &get();
+    }
+
+    std::size_t shared_property_block::instance_count() {
+        const std::shared_ptr<intern_table>& table = get_intern_table();
+        std::lock_guard<std::mutex> guard(table->mutex);
+        return table->count;
+    }
+}
+
+namespace e2d
+{
+    bool operator==(const shared_property_block& l, const shared_property_block& r) noexcept {
+        return l.equals(r);
+    }
+
+    bool operator!=(const shared_property_block& l, const shared_property_block& r) noexcept {
+        return !(l == r);
+    }
+}
@@ -0,0 +1,262 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/snapshot.hpp>
+
+#include <enduro2d/high/node.hpp>
+#include <enduro2d/high/components/actor.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    const u32 snapshot_file_version = 3u;
+    const str_view snapshot_file_signature = "e2d_snapshot";
+
+    class vector_output_stream final : public output_stream {
+    public:
+        vector_output_stream(vector<u8>& data) noexcept
+        : data_(data) {}
+
+        std::size_t write(const void* src, std::size_t size) final {
+            if ( size > 0 ) {
+                const u8* bytes = static_cast<const u8*>(src);
+                if ( pos_ == data_.size() ) {
+                    data_.insert(data_.end(), bytes, bytes + size);
+                } else {
+                    data_.resize(math::max(data_.size(), pos_ + size));
+                    std::memcpy(data_.data() + pos_, bytes, size);
+                }
+                pos_ += size;
+            }
+            return size;
+        }
+
+        std::size_t seek(std::ptrdiff_t offset, bool relative) final {
+            const std::ptrdiff_t npos = relative
+                ? math::numeric_cast<std::ptrdiff_t>(pos_) + offset
+                : offset;
+            if ( npos < 0 || math::abs_to_unsigned(npos) > data_.size() ) {
+                throw bad_stream_operation();
+            }
+            pos_ = math::abs_to_unsigned(npos);
+            return pos_;
+        }
+
+        std::size_t tell() const final {
+            return pos_;
+        }
+
+        void flush() const final {
+        }
+    private:
+        vector<u8>& data_;
+        std::size_t pos_{0u};
+    };
+
+    bool check_signature(input_sequence& iseq) {
+        u32 file_version = 0;
+        char* file_signature = static_cast<char*>(E2D_CLEAR_ALLOCA(
+            snapshot_file_signature.length() + 1));
+
+        iseq.read(file_signature, snapshot_file_signature.length())
+            .read(file_version);
+
+        return iseq.success()
+            && snapshot_file_signature == file_signature
+            && snapshot_file_version == file_version;
+    }
+
+    bool save_gobject(
+        const const_gobject_iptr& inst,
+        const factory_serializer<>::save_context& ctx)
+    {
+        if ( !the<factory>().save_components(inst->entity(), ctx) ) {
+            return false;
+        }
+
+        vector<const_gobject_iptr> children;
+        auto inst_a = inst->get_component<actor>();
+        if ( inst_a && inst_a->node() ) {
+            children.reserve(inst_a->node()->child_count());
+            inst_a->node()->for_each_child([&children](const const_node_iptr& child_n){
+                if ( child_n->owner() ) {
+                    children.push_back(child_n->owner());
+                }
+            });
+        }
+
+        if ( !ctx.stream.write(math::numeric_cast<u32>(children.size())).success() ) {
+            return false;
+        }
+
+        for ( const const_gobject_iptr& child : children ) {
+            if ( !save_gobject(child, ctx) ) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool collect_gobject(
+        asset_dependencies& dependencies,
+        const factory_serializer<>::collect_context& ctx)
+    {
+        if ( !the<factory>().collect_dependencies(dependencies, ctx) ) {
+            return false;
+        }
+
+        u32 child_count = 0;
+        if ( !ctx.stream.read(child_count).success() ) {
+            return false;
+        }
+
+        for ( u32 i = 0; i < child_count; ++i ) {
+            if ( !collect_gobject(dependencies, ctx) ) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool load_gobject(
+        prefab& dst,
+        const factory_serializer<>::load_context& ctx)
+    {
+        if ( !the<factory>().load_components(dst.prototype(), ctx) ) {
+            return false;
+        }
+
+        u32 child_count = 0;
+        if ( !ctx.stream.read(child_count).success() ) {
+            return false;
+        }
+
+        if ( child_count > 0 ) {
+            vector<prefab> children(child_count);
+            for ( prefab& child : children ) {
+                if ( !load_gobject(child, ctx) ) {
+                    return false;
+                }
+            }
+            dst.set_children(std::move(children));
+        }
+
+        return true;
+    }
+}
+
+namespace e2d { namespace snapshots
+{
+    bool try_save_snapshot(
+        const const_gobject_iptr& root,
+        const factory_serializer<>::asset_addresses& addresses,
+        buffer& dst) noexcept
+    {
+        try {
+            if ( !root ) {
+                return false;
+            }
+
+            vector<u8> data;
+            vector_output_stream stream(data);
+            output_sequence oseq(stream);
+
+            oseq.write(snapshot_file_signature.data(), snapshot_file_signature.length())
+                .write(snapshot_file_version);
+
+            factory_serializer<>::save_context ctx(oseq, addresses);
+            if ( !oseq.success() || !save_gobject(root, ctx) ) {
+                return false;
+            }
+
+            dst.assign(data.data(), data.size());
+            return true;
+        } catch (...) {
+            // nothing
+        }
+        return false;
+    }
+
+    bool try_save_snapshot(
+        const const_gobject_iptr& root,
+        const factory_serializer<>::asset_addresses& addresses,
+        const output_stream_uptr& dst) noexcept
+    {
+        buffer file_data;
+        return try_save_snapshot(root, addresses, file_data)
+            && streams::try_write_tail(file_data, dst);
+    }
+
+    bool try_collect_dependencies(
+        asset_dependencies& dst,
+        const buffer& src) noexcept
+    {
+        try {
+            auto stream = make_memory_stream(src);
+            if ( !stream ) {
+                return false;
+            }
+
+            input_sequence iseq(*stream);
+            if ( !check_signature(iseq) ) {
+                return false;
+            }
+
+            asset_dependencies dependencies;
+            factory_serializer<>::collect_context ctx(iseq);
+            if ( !collect_gobject(dependencies, ctx) ) {
+                return false;
+            }
+
+            if ( stream->tell() != stream->length() ) {
+                return false;
+            }
+
+            dst = std::move(dependencies);
+            return true;
+        } catch (...) {
+            // nothing
+        }
+        return false;
+    }
+
+    bool try_load_snapshot(
+        prefab& dst,
+        const buffer& src,
+        const asset_group& dependencies) noexcept
+    {
+        try {
+            auto stream = make_memory_stream(src);
+            if ( !stream ) {
+                return false;
+            }
+
+            input_sequence iseq(*stream);
+            if ( !check_signature(iseq) ) {
+                return false;
+            }
+
+            prefab content;
+            factory_serializer<>::load_context ctx(iseq, dependencies);
+            if ( !load_gobject(content, ctx) ) {
+                return false;
+            }
+
+            if ( stream->tell() != stream->length() ) {
+                return false;
+            }
+
+            dst = std::move(content);
+            return true;
+        } catch (...) {
+            // nothing
+        }
+        return false;
+    }
+}}
@@ -30,6 +30,7 @@ namespace e2d
     void sprite::clear() noexcept {
         pivot_ = v2f::zero();
         texrect_ = b2f::zero();
+        borders_ = v4f::zero();
         texture_.reset();
     }
 
@@ -37,6 +38,7 @@ namespace e2d
         using std::swap;
         swap(pivot_, other.pivot_);
         swap(texrect_, other.texrect_);
+        swap(borders_, other.borders_);
         swap(texture_, other.texture_);
     }
 
@@ -53,6 +55,7 @@ namespace e2d
             sprite s;
             s.pivot_ = other.pivot_;
             s.texrect_ = other.texrect_;
+            s.borders_ = other.borders_;
             s.texture_ = other.texture_;
             swap(s);
         }
@@ -69,6 +72,11 @@ namespace e2d
         return *this;
     }
 
+    sprite& sprite::set_borders(const v4f& borders) noexcept {
+        borders_ = borders;
+        return *this;
+    }
+
     sprite& sprite::set_texture(const texture_asset::ptr& texture) noexcept {
         texture_ = texture;
         return *this;
@@ -82,6 +90,10 @@ namespace e2d
         return texrect_;
     }
 
+    const v4f& sprite::borders() const noexcept {
+        return borders_;
+    }
+
     const texture_asset::ptr& sprite::texture() const noexcept {
         return texture_;
     }
@@ -96,6 +108,7 @@ namespace e2d
     bool operator==(const sprite& l, const sprite& r) noexcept {
         return l.pivot() == r.pivot()
             && l.texrect() == r.texrect()
+            && l.borders() == r.borders()
             && l.texture() == r.texture();
     }
 
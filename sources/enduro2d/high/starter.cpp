@@ -7,18 +7,23 @@
 #include <enduro2d/high/starter.hpp>
 
 #include <enduro2d/high/world.hpp>
+#include <enduro2d/high/collision.hpp>
+#include <enduro2d/high/dynamic_resolution.hpp>
 #include <enduro2d/high/factory.hpp>
 #include <enduro2d/high/library.hpp>
 
 #include <enduro2d/high/components/actor.hpp>
 #include <enduro2d/high/components/camera.hpp>
+#include <enduro2d/high/components/collider.hpp>
 #include <enduro2d/high/components/flipbook_player.hpp>
 #include <enduro2d/high/components/flipbook_source.hpp>
 #include <enduro2d/high/components/model_renderer.hpp>
 #include <enduro2d/high/components/renderer.hpp>
 #include <enduro2d/high/components/scene.hpp>
+#include <enduro2d/high/components/shape_renderer.hpp>
 #include <enduro2d/high/components/sprite_renderer.hpp>
 
+#include <enduro2d/high/systems/collision_system.hpp>
 #include <enduro2d/high/systems/flipbook_system.hpp>
 #include <enduro2d/high/systems/render_system.hpp>
 
@@ -35,13 +40,17 @@ namespace
 
     class engine_application final : public engine::application {
     public:
-        engine_application(starter::application_uptr application)
-        : application_(std::move(application)) {}
+        engine_application(
+            starter::application_uptr application,
+            const render_system::parameters& render_params)
+        : application_(std::move(application))
+        , render_params_(render_params) {}
 
         bool initialize() final {
             ecs::registry_filler(the<world>().registry())
                 .system<flipbook_system>(world::priority_update)
-                .system<render_system>(world::priority_render);
+                .system<collision_system>(world::priority_post_update)
+                .system<render_system>(world::priority_render, render_params_);
             return !application_ || application_->initialize();
         }
 
@@ -52,6 +61,7 @@ namespace
         }
 
         bool frame_tick() final {
+            the<world>().process_instantiations();
             the<world>().registry().process_systems_in_range(
                 world::priority_update_section_begin,
                 world::priority_update_section_end);
@@ -66,6 +76,7 @@ namespace
         }
     private:
         starter::application_uptr application_;
+        render_system::parameters render_params_;
     };
 }
 
@@ -103,6 +114,16 @@ namespace e2d
         return *this;
     }
 
+    starter::parameters& starter::parameters::render_params(const render_system::parameters& value) {
+        render_params_ = value;
+        return *this;
+    }
+
+    starter::parameters& starter::parameters::dynamic_resolution_params(const dynamic_resolution::parameters& value) {
+        dynamic_resolution_params_ = value;
+        return *this;
+    }
+
     url& starter::parameters::library_root() noexcept {
         return library_root_;
     }
@@ -111,6 +132,14 @@ namespace e2d
         return engine_params_;
     }
 
+    render_system::parameters& starter::parameters::render_params() noexcept {
+        return render_params_;
+    }
+
+    dynamic_resolution::parameters& starter::parameters::dynamic_resolution_params() noexcept {
+        return dynamic_resolution_params_;
+    }
+
     const url& starter::parameters::library_root() const noexcept {
         return library_root_;
     }
@@ -119,26 +148,51 @@ namespace e2d
         return engine_params_;
     }
 
+    const render_system::parameters& starter::parameters::render_params() const noexcept {
+        return render_params_;
+    }
+
+    const dynamic_resolution::parameters& starter::parameters::dynamic_resolution_params() const noexcept {
+        return dynamic_resolution_params_;
+    }
+
     //
     // starter
     //
 
-    starter::starter(int argc, char *argv[], const parameters& params) {
+    starter::starter(int argc, char *argv[], const parameters& params)
+    : render_params_(params.render_params()) {
         safe_module_initialize<engine>(argc, argv, params.engine_params());
         safe_module_initialize<factory>()
             .register_component<actor>("actor")
             .register_component<camera>("camera")
+            .register_component<collider>("collider")
             .register_component<flipbook_player>("flipbook_player")
             .register_component<flipbook_source>("flipbook_source")
             .register_component<model_renderer>("model_renderer")
             .register_component<renderer>("renderer")
             .register_component<scene>("scene")
-            .register_component<sprite_renderer>("sprite_renderer");
+            .register_component<shape_renderer>("shape_renderer")
+            .register_component<sprite_renderer>("sprite_renderer")
+            .register_serializer<actor>("actor")
+            .register_serializer<camera>("camera")
+            .register_serializer<collider>("collider")
+            .register_serializer<flipbook_player>("flipbook_player")
+            .register_serializer<flipbook_source>("flipbook_source")
+            .register_serializer<model_renderer>("model_renderer")
+            .register_serializer<renderer>("renderer")
+            .register_serializer<scene>("scene")
+            .register_serializer<shape_renderer>("shape_renderer")
+            .register_serializer<sprite_renderer>("sprite_renderer");
         safe_module_initialize<library>(params.library_root(), the<deferrer>());
         safe_module_initialize<world>();
+        safe_module_initialize<collision>();
+        safe_module_initialize<dynamic_resolution>(params.dynamic_resolution_params());
     }
 
     starter::~starter() noexcept {
+        modules::shutdown<dynamic_resolution>();
+        modules::shutdown<collision>();
         modules::shutdown<world>();
         modules::shutdown<library>();
         modules::shutdown<factory>();
@@ -148,6 +202,7 @@ namespace e2d
     bool starter::start(application_uptr app) {
         return the<engine>().start(
             std::make_unique<engine_application>(
-                std::move(app)));
+                std::move(app),
+                render_params_));
     }
 }
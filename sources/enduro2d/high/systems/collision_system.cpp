@@ -0,0 +1,40 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/high/systems/collision_system.hpp>
+
+#include <enduro2d/high/collision.hpp>
+
+namespace e2d
+{
+    //
+    // collision_system::internal_state
+    //
+
+    class collision_system::internal_state final : private noncopyable {
+    public:
+        internal_state() = default;
+        ~internal_state() noexcept = default;
+
+        void process(ecs::registry& owner) {
+            if ( modules::is_initialized<collision>() ) {
+                the<collision>().update(owner);
+            }
+        }
+    };
+
+    //
+    // collision_system
+    //
+
+    collision_system::collision_system()
+    : state_(new internal_state()) {}
+    collision_system::~collision_system() noexcept = default;
+
+    void collision_system::process(ecs::registry& owner) {
+        state_->process(owner);
+    }
+}
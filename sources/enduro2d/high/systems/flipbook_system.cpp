@@ -8,68 +8,118 @@
 
 #include <enduro2d/high/components/flipbook_player.hpp>
 #include <enduro2d/high/components/flipbook_source.hpp>
+#include <enduro2d/high/components/pending_instance.hpp>
 #include <enduro2d/high/components/sprite_renderer.hpp>
 
 namespace
 {
     using namespace e2d;
 
-    void update_flipbook_timers(f32 dt, ecs::registry& owner) {
+    void reset_playback(flipbook_player::playback_state& ps) noexcept {
+        ps.frame = nullptr;
+        ps.frame_index = std::numeric_limits<std::size_t>::max();
+        ps.frame_begin = std::numeric_limits<f32>::infinity();
+        ps.frame_end = -std::numeric_limits<f32>::infinity();
+    }
+
+    void update_playback_frame(f32 time, flipbook_player::playback_state& ps) noexcept {
+        if ( time >= ps.frame_begin && time < ps.frame_end ) {
+            return;
+        }
+
+        const flipbook& flipbook = ps.flipbook->content();
+        const flipbook::sequence& sequence = *ps.sequence;
+        const std::size_t last_index = sequence.frames.size() - 1u;
+
+        std::size_t frame_index = 0u;
+        if ( sequence.fps > 0.f ) {
+            frame_index = math::clamp<std::size_t>(
+                math::numeric_cast<std::size_t>(math::max(0.f, time * sequence.fps)),
+                0u,
+                last_index);
+        }
+
+        // the first and the last frames are open-ended, so clamped times
+        // before the start or after the end of a sequence never leave them
+        ps.frame_begin = frame_index > 0u
+            ? static_cast<f32>(frame_index) / sequence.fps
+            : -std::numeric_limits<f32>::infinity();
+        ps.frame_end = frame_index < last_index
+            ? static_cast<f32>(frame_index + 1u) / sequence.fps
+            : std::numeric_limits<f32>::infinity();
+
+        if ( ps.frame_index != frame_index ) {
+            ps.frame = flipbook.find_frame(sequence.frames[frame_index]);
+            ps.frame_index = frame_index;
+        }
+    }
+
+    void update_flipbooks(f32 dt, ecs::registry& owner) {
         owner.for_joined_components<flipbook_player, flipbook_source>([dt](
-            const ecs::const_entity&,
+            ecs::entity e,
             flipbook_player& fp,
             const flipbook_source& fs)
         {
-            if ( fp.speed() <= 0.f || fp.stopped() ) {
+            if ( e.exists_component<pending_instance>() ) {
                 return;
             }
-            const flipbook_asset::ptr& flipbook_res = fs.flipbook();
-            if ( !flipbook_res ) {
-                return;
+
+            flipbook_player::playback_state& ps = fp.playback();
+
+            // resolve the sequence only when the flipbook or the sequence name is changed
+            if ( !ps.resolved
+                || ps.flipbook != fs.flipbook()
+                || ps.sequence_name != fp.sequence() )
+            {
+                ps.resolved = true;
+                ps.flipbook = fs.flipbook();
+                ps.sequence_name = fp.sequence();
+                ps.sequence = ps.flipbook
+                    ? ps.flipbook->content().find_sequence(ps.sequence_name)
+                    : nullptr;
+                if ( ps.sequence && ps.sequence->frames.empty() ) {
+                    ps.sequence = nullptr;
+                }
+                reset_playback(ps);
+                if ( !ps.sequence ) {
+                    auto sr = e.find_component<sprite_renderer>();
+                    if ( sr ) {
+                        sr->sprite(nullptr);
+                    }
+                }
             }
-            const flipbook& flipbook = flipbook_res->content();
-            const flipbook::sequence* sequence = flipbook.find_sequence(fp.sequence());
-            if ( !sequence || sequence->frames.empty() ) {
+
+            if ( !ps.sequence ) {
                 return;
             }
-            fp.time(fp.time() + dt * fp.speed());
-            if ( sequence->fps > 0.f ) {
-                const f32 loop_time = sequence->frames.size() / sequence->fps;
-                if ( fp.time() >= loop_time ) {
-                    if ( fp.looped() ) {
-                        fp.time(math::mod(fp.time(), loop_time));
-                    } else {
-                        fp.stop(loop_time);
+
+            const flipbook::sequence& sequence = *ps.sequence;
+            if ( fp.speed() > 0.f && fp.playing() ) {
+                fp.time(fp.time() + dt * fp.speed());
+                if ( sequence.fps > 0.f ) {
+                    const f32 loop_time = sequence.frames.size() / sequence.fps;
+                    if ( fp.time() >= loop_time ) {
+                        if ( fp.looped() ) {
+                            fp.time(math::mod(fp.time(), loop_time));
+                        } else {
+                            fp.stop(loop_time);
+                        }
                     }
                 }
             }
-        });
-    }
 
-    void update_flipbook_sprites(ecs::registry& owner) {
-        owner.for_joined_components<flipbook_player, flipbook_source, sprite_renderer>([](
-            const ecs::const_entity&,
-            const flipbook_player& fp,
-            const flipbook_source& fs,
-            sprite_renderer& sr)
-        {
-            const flipbook_asset::ptr& flipbook_res = fs.flipbook();
-            if ( !flipbook_res ) {
-                sr.sprite(nullptr);
-                return;
-            }
-            const flipbook& flipbook = flipbook_res->content();
-            const flipbook::sequence* sequence = flipbook.find_sequence(fp.sequence());
-            if ( !sequence || sequence->frames.empty() ) {
-                sr.sprite(nullptr);
-                return;
+            // the sprite is replaced only when it differs from the current frame,
+            // so renderers added or changed between transitions get it too
+            update_playback_frame(fp.time(), ps);
+            auto sr = e.find_component<sprite_renderer>();
+            if ( sr ) {
+                const sprite_asset::ptr& frame_sprite = ps.frame
+                    ? ps.frame->sprite
+                    : sprite_asset::ptr();
+                if ( sr->sprite() != frame_sprite ) {
+                    sr->sprite(frame_sprite);
+                }
             }
-            const std::size_t frame_index = math::clamp<std::size_t>(
-                math::numeric_cast<std::size_t>(fp.time() * sequence->fps),
-                0u,
-                sequence->frames.size() - 1u);
-            const flipbook::frame* frame = flipbook.find_frame(sequence->frames[frame_index]);
-            sr.sprite(frame ? frame->sprite : nullptr);
         });
     }
 }
@@ -86,8 +136,7 @@ namespace e2d
         ~internal_state() noexcept = default;
 
         void process(ecs::registry& owner) {
-            update_flipbook_timers(the<engine>().delta_time(), owner);
-            update_flipbook_sprites(owner);
+            update_flipbooks(the<engine>().delta_time(), owner);
         }
     };
 
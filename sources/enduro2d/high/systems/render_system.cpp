@@ -6,13 +6,21 @@
 
 #include <enduro2d/high/systems/render_system.hpp>
 
+#include <enduro2d/high/dynamic_resolution.hpp>
+#include <enduro2d/high/render_graph.hpp>
+
 #include <enduro2d/high/components/actor.hpp>
 #include <enduro2d/high/components/camera.hpp>
+#include <enduro2d/high/components/pending_instance.hpp>
 #include <enduro2d/high/components/scene.hpp>
 
 #include "render_system_impl/render_system_base.hpp"
 #include "render_system_impl/render_system_batcher.hpp"
+#include "render_system_impl/render_system_blitter.hpp"
+#include "render_system_impl/render_system_dirty.hpp"
 #include "render_system_impl/render_system_drawer.hpp"
+#include "render_system_impl/render_system_pipeline.hpp"
+#include "render_system_impl/render_system_static.hpp"
 
 namespace
 {
@@ -42,7 +50,9 @@ namespace
         try {
             temp_components.reserve(owner.component_count<T>());
             owner.for_each_component<T>([](const ecs::const_entity& e, const T& t){
-                temp_components.emplace_back(e, t);
+                if ( !e.exists_component<pending_instance>() ) {
+                    temp_components.emplace_back(e, t);
+                }
             });
             std::sort(
                 temp_components.begin(),
@@ -60,33 +70,110 @@ namespace
         temp_components.clear();
     }
 
-    void for_all_scenes(drawer::context& ctx, ecs::registry& owner) {
+    void for_all_scenes(drawer::context& ctx, ecs::registry& owner, const static_batcher& sb) {
         const auto comp = [](const scene& l, const scene& r) noexcept {
             return l.depth() < r.depth();
         };
-        const auto func = [&ctx](const ecs::const_entity& scn_e, const scene&) {
+        const auto func = [&ctx, &sb](const ecs::const_entity& scn_e, const scene& scn) {
             const actor* scn_a = scn_e.find_component<actor>();
             if ( scn_a && scn_a->node() ) {
-                for_each_by_nodes(scn_a->node(), [&ctx](const const_node_iptr& node){
-                    ctx.draw(node);
+                if ( !scn.static_batching() ) {
+                    for_each_by_nodes(scn_a->node(), [&ctx](const const_node_iptr& node){
+                        ctx.draw(node);
+                    });
+                    return;
+                }
+                for ( const static_batcher::batch& b : sb.batches(scn_e.id()) ) {
+                    ctx.draw(m4f::identity(), b.node_r, b.mdl_r);
+                }
+                for_each_by_nodes(scn_a->node(), [&ctx, &sb, &scn_e](const const_node_iptr& node){
+                    if ( !sb.is_batched(scn_e.id(), node.get()) ) {
+                        ctx.draw(node);
+                    }
                 });
             }
         };
         for_each_by_sorted_components<scene>(owner, comp, func);
     }
 
-    void for_all_cameras(drawer& drawer, ecs::registry& owner) {
-        const auto comp = [](const camera& l, const camera& r) noexcept {
+    void snapshot_all_scenes(pipeline::frame& f, ecs::registry& owner, const static_batcher& sb) {
+        const auto comp = [](const scene& l, const scene& r) noexcept {
             return l.depth() < r.depth();
         };
-        const auto func = [&drawer, &owner](const ecs::const_entity& cam_e, const camera& cam) {
-            const actor* const cam_a = cam_e.find_component<actor>();
-            const const_node_iptr cam_n = cam_a ? cam_a->node() : nullptr;
-            drawer.with(cam, cam_n, [&owner](drawer::context& ctx){
-                for_all_scenes(ctx, owner);
-            });
+        const auto func = [&f, &sb](const ecs::const_entity& scn_e, const scene& scn) {
+            const actor* scn_a = scn_e.find_component<actor>();
+            if ( scn_a && scn_a->node() ) {
+                if ( scn.static_batching() ) {
+                    for ( const static_batcher::batch& b : sb.batches(scn_e.id()) ) {
+                        pipeline::draw_item& item = f.add_item();
+                        item.world = m4f::identity();
+                        item.key = nullptr;
+                        item.node_r = b.node_r;
+                        item.model = f.add_model(b.mdl_r);
+                        item.sprite = pipeline::no_index;
+                        item.shape = pipeline::no_index;
+                    }
+                }
+                const bool static_batching = scn.static_batching();
+                for_each_by_nodes(scn_a->node(), [&f, &sb, &scn_e, static_batching](const const_node_iptr& node){
+                    if ( !node->owner() ) {
+                        return;
+                    }
+                    if ( static_batching && sb.is_batched(scn_e.id(), node.get()) ) {
+                        return;
+                    }
+                    ecs::const_entity node_e = node->owner()->entity();
+                    const renderer* node_r = node_e.find_component<renderer>();
+                    if ( !node_r || !node_r->enabled() ) {
+                        return;
+                    }
+                    const model_renderer* mdl_r = node_e.find_component<model_renderer>();
+                    const sprite_renderer* spr_r = node_e.find_component<sprite_renderer>();
+                    const shape_renderer* shp_r = node_e.find_component<shape_renderer>();
+                    if ( !mdl_r && !spr_r && !shp_r ) {
+                        return;
+                    }
+                    pipeline::draw_item& item = f.add_item();
+                    item.world = node->world_matrix();
+                    item.key = node.get();
+                    item.node_r = *node_r;
+                    item.model = mdl_r ? f.add_model(*mdl_r) : pipeline::no_index;
+                    item.sprite = spr_r ? f.add_sprite(*spr_r) : pipeline::no_index;
+                    item.shape = shp_r ? f.add_shape(*shp_r) : pipeline::no_index;
+                });
+            }
+        };
+        for_each_by_sorted_components<scene>(owner, comp, func);
+    }
+
+    void update_static_batches(static_batcher& sb, ecs::registry& owner) {
+        owner.for_each_component<scene>([&sb](const ecs::const_entity& scn_e, const scene& scn){
+            const actor* scn_a = scn_e.find_component<actor>();
+            if ( scn.static_batching() && scn_a && scn_a->node()
+                && !scn_e.exists_component<pending_instance>() )
+            {
+                sb.update(scn_e.id(), scn_a->node());
+            }
+        });
+    }
+
+    void track_all_scenes(dirty_tracker& tracker, ecs::registry& owner) {
+        const auto comp = [](const scene& l, const scene& r) noexcept {
+            return l.depth() < r.depth();
+        };
+        const auto func = [&tracker](const ecs::const_entity& scn_e, const scene&) {
+            const actor* scn_a = scn_e.find_component<actor>();
+            if ( scn_a && scn_a->node() ) {
+                for_each_by_nodes(scn_a->node(), [&tracker](const const_node_iptr& node){
+                    tracker.track(node);
+                });
+            }
         };
-        for_each_by_sorted_components<camera>(owner, comp, func);
+        for_each_by_sorted_components<scene>(owner, comp, func);
+    }
+
+    u64 pixel_count(const b2u& r) noexcept {
+        return u64(r.size.x) * u64(r.size.y);
     }
 }
 
@@ -98,26 +185,324 @@ namespace e2d
 
     class render_system::internal_state final : private noncopyable {
     public:
-        internal_state()
-        : drawer_(the<engine>(), the<debug>(), the<render>()) {}
+        internal_state(const parameters& params)
+        : drawer_(the<engine>(), the<debug>(), the<render>())
+        , blitter_(the<debug>(), the<render>())
+        , static_batcher_(the<debug>(), the<render>()) {
+            if ( params.pipelining() ) {
+                pipeline_ = std::make_unique<pipeline>(
+                    the<engine>(), the<debug>(), the<render>());
+            }
+        }
         ~internal_state() noexcept = default;
 
         void process(ecs::registry& owner) {
-            for_all_cameras(drawer_, owner);
+            ++frame_;
+            stats_ = statistics();
+            graph_.clear();
+            drawer_.reset_triangles();
+
+            const f32 scale = update_resolution_scale();
+            stats_.resolution_scale = scale;
+
+            update_static_batches(static_batcher_, owner);
+            if ( static_batcher_.end_frame() ) {
+                for ( auto& p : partial_cameras_ ) {
+                    p.second.tracker.invalidate();
+                }
+            }
+            stats_.static_batches = static_batcher_.stats().batches;
+            stats_.static_batched_nodes = static_batcher_.stats().batched_nodes;
+            stats_.static_draws_saved = static_batcher_.stats().draws_saved;
+            stats_.static_batch_memory = static_batcher_.stats().memory;
+
+            if ( pipeline_ ) {
+                pipeline::frame& f = pipeline_->snapshot();
+                f.time = the<engine>().time();
+                plan_cameras(owner, f, scale);
+                snapshot_all_scenes(f, owner, static_batcher_);
+                pipeline::frame* const prev = pipeline_->submit();
+                if ( prev ) {
+                    for ( camera_job& job : prev->cameras ) {
+                        add_camera_passes(job, [this, &job](){
+                            drawer_.replay(job.rec);
+                        });
+                    }
+                }
+            } else {
+                immediate_.reset();
+                plan_cameras(owner, immediate_, scale);
+                immediate_.trim();
+                for ( const camera_job& job : immediate_.cameras ) {
+                    add_camera_passes(job, [this, &owner, &job](){
+                        drawer_.with(job.cam, job.cam_w, job.lods.get(), [this, &owner](drawer::context& ctx){
+                            for_all_scenes(ctx, owner, static_batcher_);
+                        });
+                    });
+                }
+            }
+
+            for ( auto iter = partial_cameras_.begin(); iter != partial_cameras_.end(); ) {
+                if ( iter->second.frame != frame_ ) {
+                    iter = partial_cameras_.erase(iter);
+                } else {
+                    ++iter;
+                }
+            }
+
+            for ( auto iter = camera_lods_.begin(); iter != camera_lods_.end(); ) {
+                if ( iter->second.frame != frame_ ) {
+                    iter = camera_lods_.erase(iter);
+                } else {
+                    ++iter;
+                }
+            }
+
+            stats_.saved_fill_rate = stats_.viewport_pixels > 0u
+                ? 1.f - math::numeric_cast<f32>(
+                    f64(stats_.redrawn_pixels) / f64(stats_.viewport_pixels))
+                : 0.f;
+
+            graph_.compile();
+            graph_.execute(the<render>());
+
+            if ( !pipeline_ ) {
+                for ( const camera_job& job : immediate_.cameras ) {
+                    job.lods->end_frame();
+                }
+            }
+            stats_.triangles = drawer_.triangles();
+        }
+
+        const statistics& stats() const noexcept {
+            return stats_;
+        }
+    private:
+        struct partial_camera final {
+            dirty_tracker tracker;
+            render_target_ptr cache;
+            u32 frame{0u};
+        };
+
+        struct camera_lods final {
+            std::shared_ptr<lod_selector> selector;
+            u32 frame{0u};
+        };
+    private:
+        void plan_cameras(ecs::registry& owner, pipeline::frame& f, f32 scale) {
+            const auto comp = [](const camera& l, const camera& r) noexcept {
+                return l.depth() < r.depth();
+            };
+            const auto func = [this, &owner, &f, scale](const ecs::const_entity& cam_e, const camera& cam) {
+                const actor* const cam_a = cam_e.find_component<actor>();
+                const const_node_iptr cam_n = cam_a ? cam_a->node() : nullptr;
+
+                camera_job& job = f.add_camera();
+                job.cam = cam;
+                job.cam_w = cam_n ? cam_n->world_matrix() : m4f::identity();
+                job.target = cam.target();
+                job.viewport = cam.viewport();
+                job.partial = false;
+                job.regions.clear();
+                job.cache.reset();
+                job.scaled_size = v2u::zero();
+
+                camera_lods& cl = camera_lods_[cam_e.id()];
+                if ( !cl.selector ) {
+                    cl.selector = std::make_shared<lod_selector>();
+                }
+                cl.frame = frame_;
+                job.lods = cl.selector;
+
+                ++stats_.cameras;
+                stats_.viewport_pixels += pixel_count(cam.viewport());
+                if ( cam.partial_redraw() && plan_partial_camera(owner, cam_e, cam_n, job) ) {
+                    return;
+                }
+                if ( !cam.target() && scale < 1.f ) {
+                    job.scaled_size = the<dynamic_resolution>().scaled_size(cam.viewport().size);
+                    stats_.redrawn_pixels += pixel_count(b2u(job.scaled_size));
+                } else {
+                    stats_.redrawn_pixels += pixel_count(cam.viewport());
+                }
+            };
+            for_each_by_sorted_components<camera>(owner, comp, func);
+        }
+
+        // cameras without a target redraw a cached copy of their
+        // viewport which is copied to the main framebuffer every frame
+        bool plan_partial_camera(
+            ecs::registry& owner,
+            const ecs::const_entity& cam_e,
+            const const_node_iptr& cam_n,
+            camera_job& job)
+        {
+            const camera& cam = job.cam;
+            partial_camera& pc = partial_cameras_[cam_e.id()];
+            pc.frame = frame_;
+
+            if ( !cam.target() ) {
+                if ( !pc.cache || pc.cache->size() != cam.viewport().size ) {
+                    pc.cache = the<render>().create_render_target(
+                        cam.viewport().size,
+                        pixel_declaration::pixel_type::rgba8,
+                        pixel_declaration::pixel_type::depth16,
+                        render_target::external_texture::color);
+                    pc.tracker.invalidate();
+                }
+                if ( !pc.cache ) {
+                    return false;
+                }
+                job.target = pc.cache;
+                job.viewport = b2u(cam.viewport().size);
+                job.cache = pc.cache;
+            } else {
+                pc.cache.reset();
+            }
+
+            pc.tracker.begin(cam, cam_n, job.viewport);
+            track_all_scenes(pc.tracker, owner);
+            job.regions = pc.tracker.end();
+            job.partial = true;
+
+            ++stats_.partial_cameras;
+            if ( job.regions.empty() ) {
+                ++stats_.skipped_cameras;
+            }
+            for ( const b2u& r : job.regions ) {
+                ++stats_.dirty_regions;
+                stats_.redrawn_pixels += pixel_count(r);
+            }
+            return true;
+        }
+
+        template < typename F >
+        void add_camera_passes(const camera_job& job, const F& draw) {
+            if ( job.partial ) {
+                const render_graph::resource target = graph_.import_target("camera_target", job.target);
+                for ( const b2u& r : job.regions ) {
+                    add_camera_pass(job, target, job.viewport, r == job.viewport ? nullptr : &r, draw);
+                }
+                if ( job.cache ) {
+                    graph_.add_pass("camera_present")
+                        .target(graph_.import_target("main", nullptr))
+                        .read(target)
+                        .viewport(job.cam.viewport())
+                        .execute([this, target](render&, const render_graph::pass_context& ctx){
+                            blitter_.blit(ctx.target(target)->color(), false);
+                        });
+                }
+            } else if ( job.scaled_size != v2u::zero() ) {
+                // cameras without a target are rendered to a pooled target
+                // of the scaled size and upscaled to the main framebuffer
+                const render_graph::resource scaled_target = graph_.create_target(
+                    "camera_scaled",
+                    render_graph::target_desc(job.scaled_size)
+                        .external_texture(render_target::external_texture::color));
+
+                add_camera_pass(job, scaled_target, b2u(job.scaled_size), nullptr, draw);
+
+                graph_.add_pass("camera_upscale")
+                    .target(graph_.import_target("main", nullptr))
+                    .read(scaled_target)
+                    .viewport(job.cam.viewport())
+                    .execute([this, scaled_target](render&, const render_graph::pass_context& ctx){
+                        const render_target_ptr& rt = ctx.target(scaled_target);
+                        if ( rt ) {
+                            blitter_.blit(rt->color(), true);
+                        }
+                    });
+            } else {
+                add_camera_pass(job,
+                    graph_.import_target("camera_target", job.target),
+                    job.viewport,
+                    nullptr,
+                    draw);
+            }
+        }
+
+        template < typename F >
+        void add_camera_pass(
+            const camera_job& job,
+            const render_graph::resource& target,
+            const b2u& viewport,
+            const b2u* scissor,
+            const F& draw)
+        {
+            render_graph::pass_builder pass = graph_.add_pass("camera")
+                .target(target)
+                .viewport(viewport)
+                .clear(render::clear_command()
+                    .color_value(job.cam.background()));
+            if ( scissor ) {
+                pass.scissor(*scissor);
+            }
+            pass.execute([draw](render&, const render_graph::pass_context&){
+                draw();
+            });
+        }
+
+        f32 update_resolution_scale() {
+            if ( !modules::is_initialized<dynamic_resolution>() ) {
+                return 1.f;
+            }
+            dynamic_resolution& dr = the<dynamic_resolution>();
+            if ( !dr.enabled() ) {
+                return 1.f;
+            }
+            const f32 frame_time = dr.smoothed_frame_time();
+            if ( dr.update(the<engine>().delta_time()) ) {
+                the<debug>().trace("RENDER: Resolution scale changed:\n"
+                    "--> Scale: %0\n"
+                    "--> Frame time: %1",
+                    dr.scale(),
+                    frame_time);
+            }
+            stats_.smoothed_frame_time = dr.smoothed_frame_time();
+            return dr.scale();
         }
     private:
         drawer drawer_;
+        blitter blitter_;
+        static_batcher static_batcher_;
+        render_graph graph_;
+        statistics stats_;
+        hash_map<ecs::entity_id, partial_camera> partial_cameras_;
+        hash_map<ecs::entity_id, camera_lods> camera_lods_;
+        pipeline::frame immediate_;
+        std::unique_ptr<pipeline> pipeline_;
+        u32 frame_{0u};
     };
 
+    //
+    // render_system::parameters
+    //
+
+    render_system::parameters& render_system::parameters::pipelining(bool value) noexcept {
+        pipelining_ = value;
+        return *this;
+    }
+
+    bool render_system::parameters::pipelining() const noexcept {
+        return pipelining_;
+    }
+
     //
     // render_system
     //
 
     render_system::render_system()
-    : state_(new internal_state()) {}
+    : render_system(parameters()) {}
+
+    render_system::render_system(const parameters& params)
+    : state_(new internal_state(params)) {}
     render_system::~render_system() noexcept = default;
 
     void render_system::process(ecs::registry& owner) {
         state_->process(owner);
     }
+
+    const render_system::statistics& render_system::stats() const noexcept {
+        return state_->stats();
+    }
 }
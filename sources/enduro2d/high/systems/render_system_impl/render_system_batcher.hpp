@@ -8,6 +8,7 @@
 
 #include <enduro2d/high/_high.hpp>
 
+#include <enduro2d/high/shared_property_block.hpp>
 #include <enduro2d/high/assets/material_asset.hpp>
 
 namespace e2d { namespace render_system_impl
@@ -25,36 +26,35 @@ namespace e2d { namespace render_system_impl
         using index_type = typename Index::type;
         using vertex_type = typename Vertex::type;
 
+        class batch_type;
+        class record;
+        class recording;
+
         batcher(debug& debug, render& render);
 
+        // batches are merged when they have the same material, sampler
+        // and interned properties, the properties override the sampler
         void batch(
             const material_asset::ptr& material,
-            const render::property_block& properties,
+            str_hash sampler_name,
+            const render::sampler_state& sampler,
+            const shared_property_block& properties,
             const index_type* indices, std::size_t index_count,
             const vertex_type* vertices, std::size_t vertex_count);
 
         render::property_block& flush();
         void clear(bool clear_internal_props) noexcept;
+
+        // while recording, flushes append records instead of rendering
+        // and the batcher can be used from any thread
+        void record_to(recording* value) noexcept;
+        void replay(record& value);
     private:
         void update_buffers_();
         void render_buffers_();
         void update_index_buffer_();
         void update_vertex_buffer_();
-    private:
-        struct batch_type {
-            std::size_t start{0u};
-            std::size_t count{0u};
-            material_asset::ptr material;
-            render::property_block properties;
-
-            batch_type(
-                std::size_t nstart,
-                const material_asset::ptr& nmaterial,
-                const render::property_block& nproperties)
-            : start(nstart)
-            , material(nmaterial)
-            , properties(nproperties) {}
-        };
+        void swap_with_(record& value) noexcept;
     private:
         debug& debug_;
         render& render_;
@@ -67,10 +67,58 @@ namespace e2d { namespace render_system_impl
         vertex_buffer_ptr vertex_buffer_;
         render::property_block property_cache_;
         render::property_block internal_properties_;
+        recording* recording_ = nullptr;
     private:
         static std::size_t calculate_new_buffer_size(
             std::size_t esize, std::size_t osize, std::size_t nsize);
     };
+
+    template < typename Index, typename Vertex >
+    class batcher<Index, Vertex>::batch_type final {
+    public:
+        std::size_t start{0u};
+        std::size_t count{0u};
+        material_asset::ptr material;
+        str_hash sampler_name;
+        render::sampler_state sampler;
+        shared_property_block properties;
+    public:
+        batch_type() = default;
+        batch_type(
+            std::size_t nstart,
+            const material_asset::ptr& nmaterial,
+            str_hash nsampler_name,
+            const render::sampler_state& nsampler,
+            const shared_property_block& nproperties)
+        : start(nstart)
+        , material(nmaterial)
+        , sampler_name(nsampler_name)
+        , sampler(nsampler)
+        , properties(nproperties) {}
+    };
+
+    template < typename Index, typename Vertex >
+    class batcher<Index, Vertex>::record final {
+    public:
+        vector<batch_type> batches;
+        vector<index_type> indices;
+        vector<vertex_type> vertices;
+        render::property_block internal_properties;
+    };
+
+    template < typename Index, typename Vertex >
+    class batcher<Index, Vertex>::recording final {
+    public:
+        // keeps geometry buffers for the next recording
+        void reset() noexcept;
+        record& add();
+
+        std::size_t size() const noexcept;
+        record& operator[](std::size_t index) noexcept;
+    private:
+        vector<record> records_;
+        std::size_t size_{0u};
+    };
 }}
 
 namespace e2d { namespace render_system_impl
@@ -88,7 +136,9 @@ namespace e2d { namespace render_system_impl
     template < typename Index, typename Vertex >
     void batcher<Index, Vertex>::batch(
         const material_asset::ptr& material,
-        const render::property_block& properties,
+        str_hash sampler_name,
+        const render::sampler_state& sampler,
+        const shared_property_block& properties,
         const index_type* indices, std::size_t index_count,
         const vertex_type* vertices, std::size_t vertex_count)
     {
@@ -110,13 +160,15 @@ namespace e2d { namespace render_system_impl
             const bool batching_available =
                 !batches_.empty() &&
                 (batches_.back().material == material || batches_.back().material->content() == material->content()) &&
-                batches_.back().properties == properties;
+                batches_.back().properties == properties &&
+                batches_.back().sampler_name == sampler_name &&
+                batches_.back().sampler == sampler;
 
             if ( !batching_available ) {
                 const std::size_t start = batches_.empty()
                     ? 0u
                     : batches_.back().start + batches_.back().count;
-                batches_.emplace_back(start, material, properties);
+                batches_.emplace_back(start, material, sampler_name, sampler, properties);
             }
 
             if ( indices && index_count ) {
@@ -144,6 +196,22 @@ namespace e2d { namespace render_system_impl
 
     template < typename Index, typename Vertex >
     render::property_block& batcher<Index, Vertex>::flush() {
+        if ( recording_ ) {
+            try {
+                if ( !batches_.empty() ) {
+                    record& r = recording_->add();
+                    r.batches.assign(batches_.begin(), batches_.end());
+                    r.indices.assign(indices_.begin(), indices_.end());
+                    r.vertices.assign(vertices_.begin(), vertices_.end());
+                    r.internal_properties = internal_properties_;
+                }
+            } catch (...) {
+                clear(false);
+                throw;
+            }
+            clear(false);
+            return internal_properties_;
+        }
         try {
             update_buffers_();
             render_buffers_();
@@ -165,6 +233,28 @@ namespace e2d { namespace render_system_impl
         }
     }
 
+    template < typename Index, typename Vertex >
+    void batcher<Index, Vertex>::record_to(recording* value) noexcept {
+        recording_ = value;
+    }
+
+    template < typename Index, typename Vertex >
+    void batcher<Index, Vertex>::replay(record& value) {
+        E2D_ASSERT(!recording_ && batches_.empty());
+        if ( value.batches.empty() ) {
+            return;
+        }
+        swap_with_(value);
+        try {
+            update_buffers_();
+            render_buffers_();
+        } catch (...) {
+            swap_with_(value);
+            throw;
+        }
+        swap_with_(value);
+    }
+
     template < typename Index, typename Vertex >
     void batcher<Index, Vertex>::update_buffers_() {
         update_index_buffer_();
@@ -184,12 +274,16 @@ namespace e2d { namespace render_system_impl
         try {
             for ( const batch_type& batch : batches_ ) {
                 const render::material& mat = batch.material->content();
+                // samplers of the previous batch must not leak into this one
+                property_cache_.clear();
+                property_cache_.merge(internal_properties_);
+                if ( !batch.sampler_name.empty() ) {
+                    property_cache_.sampler(batch.sampler_name, batch.sampler);
+                }
                 render_.execute(render::draw_command(
                     mat,
                     geo,
-                    property_cache_
-                        .merge(internal_properties_)
-                        .merge(batch.properties)
+                    property_cache_.merge(*batch.properties)
                 ).index_range(batch.start, batch.count));
             }
         } catch ( ... ) {
@@ -253,6 +347,15 @@ namespace e2d { namespace render_system_impl
         }
     }
 
+    template < typename Index, typename Vertex >
+    void batcher<Index, Vertex>::swap_with_(record& value) noexcept {
+        using std::swap;
+        swap(batches_, value.batches);
+        swap(indices_, value.indices);
+        swap(vertices_, value.vertices);
+        swap(internal_properties_, value.internal_properties);
+    }
+
     template < typename Index, typename Vertex >
     std::size_t batcher<Index, Vertex>::calculate_new_buffer_size(
         std::size_t esize, std::size_t osize, std::size_t nsize)
@@ -266,4 +369,36 @@ namespace e2d { namespace render_system_impl
         }
         return math::max(osize * 2u, nsize);
     }
+
+    //
+    // batcher::recording
+    //
+
+    template < typename Index, typename Vertex >
+    void batcher<Index, Vertex>::recording::reset() noexcept {
+        for ( record& r : records_ ) {
+            r.batches.clear();
+            r.internal_properties.clear();
+        }
+        size_ = 0u;
+    }
+
+    template < typename Index, typename Vertex >
+    typename batcher<Index, Vertex>::record& batcher<Index, Vertex>::recording::add() {
+        if ( size_ == records_.size() ) {
+            records_.emplace_back();
+        }
+        return records_[size_++];
+    }
+
+    template < typename Index, typename Vertex >
+    std::size_t batcher<Index, Vertex>::recording::size() const noexcept {
+        return size_;
+    }
+
+    template < typename Index, typename Vertex >
+    typename batcher<Index, Vertex>::record& batcher<Index, Vertex>::recording::operator[](std::size_t index) noexcept {
+        E2D_ASSERT(index < size_);
+        return records_[index];
+    }
 }}
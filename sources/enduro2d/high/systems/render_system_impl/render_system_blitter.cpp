@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "render_system_blitter.hpp"
+
+namespace
+{
+    using namespace e2d;
+
+    const char* vs_src_cstr = R"glsl(
+        #version 120
+
+        attribute vec2 a_position;
+
+        varying vec2 v_uv;
+
+        void main(){
+          v_uv = a_position;
+          gl_Position = vec4(a_position * 2.0 - 1.0, 0.0, 1.0);
+        }
+    )glsl";
+
+    const char* fs_src_cstr = R"glsl(
+        #version 120
+
+        uniform sampler2D u_texture;
+        varying vec2 v_uv;
+
+        void main(){
+          gl_FragColor = texture2D(u_texture, v_uv);
+        }
+    )glsl";
+
+    const str_hash texture_sampler_hash = "u_texture";
+}
+
+namespace e2d { namespace render_system_impl
+{
+    //
+    // blitter
+    //
+
+    blitter::blitter(debug& debug, render& render)
+    : debug_(debug)
+    , render_(render) {}
+
+    bool blitter::blit(const texture_ptr& texture, bool filtering) {
+        if ( !texture || !create_resources_() ) {
+            return false;
+        }
+
+        const render::sampler_min_filter min_filter = filtering
+            ? render::sampler_min_filter::linear
+            : render::sampler_min_filter::nearest;
+
+        const render::sampler_mag_filter mag_filter = filtering
+            ? render::sampler_mag_filter::linear
+            : render::sampler_mag_filter::nearest;
+
+        properties_.sampler(texture_sampler_hash, render::sampler_state()
+            .texture(texture)
+            .s_wrap(render::sampler_wrap::clamp)
+            .t_wrap(render::sampler_wrap::clamp)
+            .min_filter(min_filter)
+            .mag_filter(mag_filter));
+
+        render_.execute(render::draw_command(material_, geometry_, properties_)
+            .index_range(0u, 6u));
+        return true;
+    }
+
+    bool blitter::create_resources_() {
+        if ( failed_ || geometry_.indices() ) {
+            return !failed_;
+        }
+
+        const shader_ptr shader = render_.create_shader(vs_src_cstr, fs_src_cstr);
+
+        const u16 indices[] = {0u, 1u, 2u, 2u, 3u, 0u};
+        const index_buffer_ptr index_buffer = render_.create_index_buffer(
+            buffer_view(indices, sizeof(indices)),
+            index_declaration::index_type::unsigned_short,
+            index_buffer::usage::static_draw);
+
+        const v2f vertices[] = {{0.f, 0.f}, {1.f, 0.f}, {1.f, 1.f}, {0.f, 1.f}};
+        const vertex_buffer_ptr vertex_buffer = render_.create_vertex_buffer(
+            buffer_view(vertices, sizeof(vertices)),
+            vertex_declaration()
+                .add_attribute<v2f>("a_position"),
+            vertex_buffer::usage::static_draw);
+
+        if ( !shader || !index_buffer || !vertex_buffer ) {
+            debug_.error("RENDER: Failed to create blitter resources");
+            failed_ = true;
+            return false;
+        }
+
+        material_ = render::material()
+            .add_pass(render::pass_state()
+                .states(render::state_block()
+                    .capabilities(render::capabilities_state()
+                        .culling(false)
+                        .blending(false)
+                        .depth_test(false)))
+                .shader(shader));
+
+        geometry_ = render::geometry()
+            .indices(index_buffer)
+            .add_vertices(vertex_buffer);
+
+        return true;
+    }
+}}
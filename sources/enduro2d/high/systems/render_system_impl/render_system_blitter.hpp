@@ -0,0 +1,35 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "render_system_base.hpp"
+
+namespace e2d { namespace render_system_impl
+{
+    //
+    // blitter
+    //
+    // Copies a texture to the current viewport of the current target.
+    // Internal resources are created on the first use.
+    //
+
+    class blitter final : private noncopyable {
+    public:
+        blitter(debug& debug, render& render);
+
+        bool blit(const texture_ptr& texture, bool filtering);
+    private:
+        bool create_resources_();
+    private:
+        debug& debug_;
+        render& render_;
+        bool failed_{false};
+        render::material material_;
+        render::geometry geometry_;
+        render::property_block properties_;
+    };
+}}
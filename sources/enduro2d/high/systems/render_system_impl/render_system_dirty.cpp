@@ -0,0 +1,458 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "render_system_dirty.hpp"
+
+#include <enduro2d/high/components/renderer.hpp>
+#include <enduro2d/high/components/model_renderer.hpp>
+#include <enduro2d/high/components/shape_renderer.hpp>
+#include <enduro2d/high/components/sprite_renderer.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    // fnv-1a
+    const u64 signature_basis = 14695981039346656037ull;
+    const u64 signature_prime = 1099511628211ull;
+
+    u64 add_bytes(u64 sig, const void* data, std::size_t size) noexcept {
+        const u8* bytes = static_cast<const u8*>(data);
+        for ( std::size_t i = 0; i < size; ++i ) {
+            sig = (sig ^ bytes[i]) * signature_prime;
+        }
+        return sig;
+    }
+
+    template < typename T >
+    u64 add_value(u64 sig, const T& value) noexcept {
+        static_assert(std::is_trivially_copyable<T>::value, "unsupported signature value");
+        return add_bytes(sig, &value, sizeof(value));
+    }
+
+    using region = render_system_impl::dirty_region;
+
+    i64 area(const region& r) noexcept {
+        return (r.x2 - r.x1) * (r.y2 - r.y1);
+    }
+
+    region merged(const region& l, const region& r) noexcept {
+        return {
+            math::min(l.x1, r.x1), math::min(l.y1, r.y1),
+            math::max(l.x2, r.x2), math::max(l.y2, r.y2)};
+    }
+
+    bool touches(const region& l, const region& r) noexcept {
+        return l.x1 <= r.x2 && r.x1 <= l.x2
+            && l.y1 <= r.y2 && r.y1 <= l.y2;
+    }
+
+    // grows merged pairs only if the merge doesn't add
+    // more pixels than the separate pair has
+    i64 merge_cost(const region& l, const region& r) noexcept {
+        return area(merged(l, r)) - area(l) - area(r);
+    }
+
+    b2f intersection(const b2f& l, const b2f& r) noexcept {
+        return math::make_minmax_rect(
+            math::maximized(math::minimum(l), math::minimum(r)),
+            math::minimized(math::maximum(l), math::maximum(r)));
+    }
+
+    // marks 'in_lis' items of the longest increasing subsequence of 'ranks'
+    void mark_longest_increasing(
+        const vector<u32>& ranks,
+        vector<u32>& tails,
+        vector<u32>& links,
+        vector<u8>& in_lis)
+    {
+        tails.clear();
+        links.assign(ranks.size(), 0u);
+        in_lis.assign(ranks.size(), 0u);
+        for ( std::size_t i = 0; i < ranks.size(); ++i ) {
+            const auto iter = std::lower_bound(
+                tails.begin(), tails.end(), ranks[i],
+                [&ranks](u32 index, u32 rank) noexcept {
+                    return ranks[index] < rank;
+                });
+            links[i] = iter != tails.begin()
+                ? *(iter - 1)
+                : math::numeric_cast<u32>(i);
+            if ( iter == tails.end() ) {
+                tails.push_back(math::numeric_cast<u32>(i));
+            } else {
+                *iter = math::numeric_cast<u32>(i);
+            }
+        }
+        if ( tails.empty() ) {
+            return;
+        }
+        for ( u32 i = tails.back(); ; i = links[i] ) {
+            in_lis[i] = 1u;
+            if ( links[i] == i ) {
+                break;
+            }
+        }
+    }
+}
+
+namespace e2d { namespace render_system_impl
+{
+    //
+    // dirty_tracker
+    //
+
+    void dirty_tracker::begin(const camera& cam, const const_node_iptr& cam_n, const b2u& viewport) {
+        const m4f& cam_w = cam_n
+            ? cam_n->world_matrix()
+            : m4f::identity();
+        const std::pair<m4f,bool> cam_w_inv = math::inversed(cam_w);
+        const m4f& m_v = cam_w_inv.second
+            ? cam_w_inv.first
+            : m4f::identity();
+        matrix_vp_ = m_v * cam.projection();
+        viewport_ = viewport;
+
+        u64 sig = signature_basis;
+        sig = add_value(sig, matrix_vp_);
+        sig = add_value(sig, viewport_);
+        sig = add_value(sig, cam.background());
+        sig = add_value(sig, cam.target().get());
+        if ( sig != camera_signature_ ) {
+            camera_signature_ = sig;
+            full_ = true;
+        }
+
+        ++stamp_;
+        order_ = 0u;
+        drawn_.clear();
+        dirty_.clear();
+        regions_.clear();
+    }
+
+    void dirty_tracker::track(const const_node_iptr& node) {
+        if ( !node || !node->owner() ) {
+            return;
+        }
+
+        ecs::const_entity node_e = node->owner()->entity();
+        const renderer* node_r = node_e.find_component<renderer>();
+        if ( !node_r || !node_r->enabled() ) {
+            return;
+        }
+
+        const m4f& node_w = node->world_matrix();
+
+        // addresses may be reused by new objects, generations are not
+        u64 sig = signature_basis;
+        for ( const material_asset::ptr& mat : node_r->materials() ) {
+            sig = add_value(sig, mat ? mat->generation() : 0u);
+        }
+        sig = add_value(sig, node_r->properties().id());
+
+        entry e;
+        bool drawn = false;
+
+        const model_renderer* mdl_r = node_e.find_component<model_renderer>();
+        if ( mdl_r && mdl_r->model() ) {
+            sig = add_value(sig, mdl_r->model()->generation());
+            sig = add_value(sig, node_w);
+            e.whole = true;
+            drawn = true;
+        }
+
+        const sprite_renderer* spr_r = node_e.find_component<sprite_renderer>();
+        if ( spr_r && spr_r->sprite() && !node_r->materials().empty() ) {
+            const sprite& spr = spr_r->sprite()->content();
+            const texture_asset::ptr& tex_a = spr.texture();
+            if ( tex_a && tex_a->content() ) {
+                std::array<v2f, 16> local;
+                std::size_t count = 0u;
+                if ( spr_r->mode() == sprite_renderer::modes::sliced ) {
+                    local = spr_r->sliced().vertices;
+                    count = local.size();
+                } else {
+                    const b2f& tex_r = spr.texrect();
+                    const f32 px = tex_r.position.x - spr.pivot().x;
+                    const f32 py = tex_r.position.y - spr.pivot().y;
+                    local[0] = v2f(px, py);
+                    local[1] = v2f(px + tex_r.size.x, py);
+                    local[2] = v2f(px + tex_r.size.x, py + tex_r.size.y);
+                    local[3] = v2f(px, py + tex_r.size.y);
+                    count = 4u;
+                    sig = add_value(sig, tex_r);
+                }
+
+                const m4f m_wvp = node_w * matrix_vp_;
+                const v2f vp_pos = viewport_.position.cast_to<f32>();
+                const v2f vp_size = viewport_.size.cast_to<f32>();
+                for ( std::size_t i = 0; i < count; ++i ) {
+                    const v4f clip = v4f(local[i], 0.f, 1.f) * m_wvp;
+                    if ( clip.w <= 0.f ) {
+                        e.whole = true;
+                        break;
+                    }
+                    const v2f ndc = v2f(clip.x, clip.y) / clip.w;
+                    const v2f p = vp_pos + (ndc * 0.5f + 0.5f) * vp_size;
+                    e.bounds = i > 0u
+                        ? math::merged(e.bounds, b2f(p, v2f::zero()))
+                        : b2f(p, v2f::zero());
+                }
+
+                sig = add_value(sig, node_w);
+                sig = add_bytes(sig, local.data(), count * sizeof(v2f));
+                sig = add_value(sig, tex_a->generation());
+                sig = add_value(sig, spr_r->tint());
+                sig = add_value(sig, spr_r->filtering());
+                drawn = true;
+            }
+        }
+
+        const shape_renderer* shp_r = node_e.find_component<shape_renderer>();
+        if ( shp_r && shp_r->shape() && !node_r->materials().empty() ) {
+            const vector<v2f>& vertices = shp_r->shape()->content().vertices();
+            if ( !vertices.empty() ) {
+                v2f local_min = vertices.front();
+                v2f local_max = vertices.front();
+                for ( const v2f& v : vertices ) {
+                    local_min = math::minimized(local_min, v);
+                    local_max = math::maximized(local_max, v);
+                }
+
+                const std::array<v2f, 4> local = {{
+                    local_min,
+                    v2f(local_max.x, local_min.y),
+                    local_max,
+                    v2f(local_min.x, local_max.y)}};
+
+                const m4f m_wvp = node_w * matrix_vp_;
+                const v2f vp_pos = viewport_.position.cast_to<f32>();
+                const v2f vp_size = viewport_.size.cast_to<f32>();
+                for ( std::size_t i = 0; i < local.size(); ++i ) {
+                    const v4f clip = v4f(local[i], 0.f, 1.f) * m_wvp;
+                    if ( clip.w <= 0.f ) {
+                        e.whole = true;
+                        break;
+                    }
+                    const v2f ndc = v2f(clip.x, clip.y) / clip.w;
+                    const v2f p = vp_pos + (ndc * 0.5f + 0.5f) * vp_size;
+                    e.bounds = drawn || i > 0u
+                        ? math::merged(e.bounds, b2f(p, v2f::zero()))
+                        : b2f(p, v2f::zero());
+                }
+
+                const texture_asset::ptr& tex_a = shp_r->texture();
+                sig = add_value(sig, node_w);
+                sig = add_value(sig, shp_r->shape()->generation());
+                sig = add_value(sig, tex_a ? tex_a->generation() : 0u);
+                sig = add_value(sig, shp_r->tint());
+                sig = add_value(sig, shp_r->filtering());
+                drawn = true;
+            }
+        }
+
+        if ( !drawn ) {
+            return;
+        }
+
+        e.signature = sig;
+        e.stamp = stamp_;
+        e.order = order_++;
+
+        const auto iter = entries_.find(node.get());
+        if ( iter == entries_.end() ) {
+            mark_dirty_(e);
+            drawn_.push_back(&entries_.emplace(node.get(), e).first->second);
+        } else if ( iter->second.stamp == stamp_ ) {
+            // drawn twice in one frame
+            mark_dirty_(iter->second);
+            mark_dirty_(e);
+            iter->second = e;
+        } else {
+            if ( iter->second.signature != e.signature ) {
+                mark_dirty_(iter->second);
+                mark_dirty_(e);
+            }
+            e.prev_order = iter->second.order;
+            iter->second = e;
+            drawn_.push_back(&iter->second);
+        }
+    }
+
+    const vector<b2u>& dirty_tracker::end() {
+        if ( !full_ ) {
+            mark_reordered_();
+        }
+
+        for ( auto iter = entries_.begin(); iter != entries_.end(); ) {
+            if ( iter->second.stamp != stamp_ ) {
+                mark_dirty_(iter->second);
+                iter = entries_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+
+        if ( full_ ) {
+            full_ = false;
+            if ( viewport_.size.x > 0u && viewport_.size.y > 0u ) {
+                regions_.push_back(viewport_);
+            }
+        } else {
+            merge_regions_();
+        }
+
+        return regions_;
+    }
+
+    void dirty_tracker::invalidate() noexcept {
+        full_ = true;
+    }
+
+    void dirty_tracker::mark_dirty_(const entry& e) {
+        if ( e.whole ) {
+            full_ = true;
+        } else if ( !full_ ) {
+            dirty_.push_back(e.bounds);
+        }
+    }
+
+    void dirty_tracker::mark_reordered_() {
+        // added and removed drawables don't change the relative order of others
+        ranks_.clear();
+        bool ordered = true;
+        for ( const entry* e : drawn_ ) {
+            if ( e->prev_order == no_order ) {
+                continue;
+            }
+            if ( !ranks_.empty() && ranks_.back() > e->prev_order ) {
+                ordered = false;
+            }
+            ranks_.push_back(e->prev_order);
+        }
+        if ( ordered ) {
+            return;
+        }
+
+        vector<const entry*>& moved = drawn_;
+        moved.erase(std::remove_if(moved.begin(), moved.end(),
+            [](const entry* e) noexcept {
+                return e->prev_order == no_order;
+            }), moved.end());
+
+        // drawables out of the longest ordered subsequence have moved
+        mark_longest_increasing(ranks_, lis_tails_, lis_links_, in_lis_);
+        std::size_t moved_count = 0u;
+        for ( u8 v : in_lis_ ) {
+            moved_count += v ? 0u : 1u;
+        }
+
+        if ( moved_count * ranks_.size() > max_order_checks ) {
+            for ( std::size_t i = 0; i < moved.size(); ++i ) {
+                if ( !in_lis_[i] ) {
+                    mark_dirty_(*moved[i]);
+                }
+            }
+            return;
+        }
+
+        for ( std::size_t i = 0; i < moved.size() && !full_; ++i ) {
+            if ( in_lis_[i] ) {
+                continue;
+            }
+            const entry& m = *moved[i];
+            for ( std::size_t j = 0; j < moved.size(); ++j ) {
+                const entry& o = *moved[j];
+                const bool swapped = (o.prev_order < m.prev_order) != (j < i);
+                if ( j == i || !swapped ) {
+                    continue;
+                }
+                if ( m.whole || o.whole ) {
+                    full_ = true;
+                    break;
+                }
+                if ( math::overlaps(m.bounds, o.bounds) ) {
+                    dirty_.push_back(intersection(m.bounds, o.bounds));
+                }
+            }
+        }
+    }
+
+    void dirty_tracker::merge_regions_() {
+        const region vp{
+            viewport_.position.x,
+            viewport_.position.y,
+            i64(viewport_.position.x) + viewport_.size.x,
+            i64(viewport_.position.y) + viewport_.size.y};
+
+        // one pixel border for filtering and antialiasing
+        vector<region>& regions = merging_;
+        regions.clear();
+        for ( const b2f& d : dirty_ ) {
+            if ( math::contains_nan(d) ) {
+                regions.assign(1u, vp);
+                break;
+            }
+            const region r{
+                math::max(vp.x1, i64(math::floor(d.position.x)) - 1),
+                math::max(vp.y1, i64(math::floor(d.position.y)) - 1),
+                math::min(vp.x2, i64(math::ceil(d.position.x + d.size.x)) + 1),
+                math::min(vp.y2, i64(math::ceil(d.position.y + d.size.y)) + 1)};
+            if ( r.x1 < r.x2 && r.y1 < r.y2 ) {
+                regions.push_back(r);
+            }
+        }
+
+        for ( bool changed = true; changed; ) {
+            changed = false;
+            for ( std::size_t i = 0; i < regions.size(); ++i ) {
+                for ( std::size_t j = i + 1; j < regions.size(); ) {
+                    if ( touches(regions[i], regions[j]) || merge_cost(regions[i], regions[j]) <= 0 ) {
+                        regions[i] = merged(regions[i], regions[j]);
+                        regions.erase(regions.begin() + math::numeric_cast<std::ptrdiff_t>(j));
+                        changed = true;
+                    } else {
+                        ++j;
+                    }
+                }
+            }
+        }
+
+        while ( regions.size() > max_regions ) {
+            std::size_t best_i = 0u, best_j = 1u;
+            i64 best_cost = merge_cost(regions[0], regions[1]);
+            for ( std::size_t i = 0; i < regions.size(); ++i ) {
+                for ( std::size_t j = i + 1; j < regions.size(); ++j ) {
+                    const i64 cost = merge_cost(regions[i], regions[j]);
+                    if ( cost < best_cost ) {
+                        best_cost = cost;
+                        best_i = i;
+                        best_j = j;
+                    }
+                }
+            }
+            regions[best_i] = merged(regions[best_i], regions[best_j]);
+            regions.erase(regions.begin() + math::numeric_cast<std::ptrdiff_t>(best_j));
+        }
+
+        // the scissor test costs more than it saves for large regions
+        i64 total = 0;
+        for ( const region& r : regions ) {
+            total += area(r);
+        }
+        if ( total * 2 >= area(vp) ) {
+            regions.assign(1u, vp);
+        }
+
+        for ( const region& r : regions ) {
+            regions_.emplace_back(
+                math::numeric_cast<u32>(r.x1),
+                math::numeric_cast<u32>(r.y1),
+                math::numeric_cast<u32>(r.x2 - r.x1),
+                math::numeric_cast<u32>(r.y2 - r.y1));
+        }
+    }
+}}
@@ -0,0 +1,77 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "render_system_base.hpp"
+
+#include <enduro2d/high/node.hpp>
+#include <enduro2d/high/components/camera.hpp>
+
+namespace e2d { namespace render_system_impl
+{
+    // integer screen region in [min, max) form
+    struct dirty_region final {
+        i64 x1, y1, x2, y2;
+    };
+
+    //
+    // dirty_tracker
+    //
+    // Compares drawables of the camera with the previous frame and
+    // collects screen regions which need to be redrawn. A drawable is
+    // changed when its world vertices, sprite, tint, filtering, materials
+    // or property block differ, assets and blocks are compared by their
+    // generations. Changed models invalidate the whole viewport. Draw order
+    // is tracked apart, only overlaps of drawables which changed their
+    // relative order are redrawn.
+    //
+
+    class dirty_tracker final : private noncopyable {
+    public:
+        static constexpr std::size_t max_regions = 4u;
+        static constexpr std::size_t max_order_checks = 65536u;
+    public:
+        dirty_tracker() = default;
+
+        void begin(const camera& cam, const const_node_iptr& cam_n, const b2u& viewport);
+        void track(const const_node_iptr& node);
+        const vector<b2u>& end();
+
+        // the next frame will be redrawn entirely
+        void invalidate() noexcept;
+    private:
+        static constexpr u32 no_order = ~u32(0);
+
+        struct entry final {
+            b2f bounds;
+            bool whole{false};
+            u64 signature{0u};
+            u32 stamp{0u};
+            u32 order{0u};
+            u32 prev_order{no_order};
+        };
+        void mark_dirty_(const entry& e);
+        void mark_reordered_();
+        void merge_regions_();
+    private:
+        hash_map<const node*, entry> entries_;
+        vector<const entry*> drawn_;
+        vector<u32> ranks_;
+        vector<u32> lis_tails_;
+        vector<u32> lis_links_;
+        vector<u8> in_lis_;
+        vector<b2f> dirty_;
+        vector<b2u> regions_;
+        vector<dirty_region> merging_;
+        m4f matrix_vp_;
+        b2u viewport_;
+        u64 camera_signature_{0u};
+        u32 stamp_{0u};
+        u32 order_{0u};
+        bool full_{true};
+    };
+}}
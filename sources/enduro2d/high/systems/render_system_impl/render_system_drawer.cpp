@@ -8,6 +8,7 @@
 
 #include <enduro2d/high/components/renderer.hpp>
 #include <enduro2d/high/components/model_renderer.hpp>
+#include <enduro2d/high/components/shape_renderer.hpp>
 #include <enduro2d/high/components/sprite_renderer.hpp>
 
 namespace
@@ -19,26 +20,88 @@ namespace
     const str_hash matrix_vp_property_hash = "u_matrix_vp";
     const str_hash game_time_property_hash = "u_game_time";
     const str_hash sprite_texture_sampler_hash = "u_texture";
+
+    u8 modulate_channel(u8 l, u8 r) noexcept {
+        return math::numeric_cast<u8>((u32(l) * u32(r) + 127u) / 255u);
+    }
+
+    color32 modulate_color(const color32& l, const color32& r) noexcept {
+        return color32(
+            modulate_channel(l.r, r.r),
+            modulate_channel(l.g, r.g),
+            modulate_channel(l.b, r.b),
+            modulate_channel(l.a, r.a));
+    }
 }
 
 namespace e2d { namespace render_system_impl
 {
+    //
+    // model_screen_size
+    //
+
+    f32 model_screen_size(
+        const model& mdl,
+        const m4f& world,
+        const m4f& matrix_vp,
+        f32 projection_scale) noexcept
+    {
+        const v4f center = v4f(mdl.bounds_center(), 1.f) * world * matrix_vp;
+        const f32 scale = math::max(
+            math::length(v3f(world[0])),
+            math::max(
+                math::length(v3f(world[1])),
+                math::length(v3f(world[2]))));
+        return center.w > 0.f
+            ? mdl.bounds_radius() * scale * projection_scale / center.w
+            : 0.f;
+    }
+
+    //
+    // lod_selector
+    //
+
+    std::size_t lod_selector::select(const void* key, const model& mdl, f32 screen_size) {
+        if ( !key ) {
+            return mdl.select_lod(screen_size, 0u, 0.f);
+        }
+        entry& e = entries_[key];
+        e.level = mdl.select_lod(screen_size, e.level, hysteresis);
+        e.frame = frame_;
+        return e.level;
+    }
+
+    void lod_selector::end_frame() noexcept {
+        ++frame_;
+        if ( frame_ % max_unused_frames != 0u ) {
+            return;
+        }
+        for ( auto iter = entries_.begin(); iter != entries_.end(); ) {
+            if ( frame_ - iter->second.frame > max_unused_frames ) {
+                iter = entries_.erase(iter);
+            } else {
+                ++iter;
+            }
+        }
+    }
+
     //
     // drawer::context
     //
 
     drawer::context::context(
         const camera& cam,
-        const const_node_iptr& cam_n,
-        engine& engine,
+        const m4f& cam_w,
+        f32 time,
         render& render,
-        batcher_type& batcher)
+        batcher_type& batcher,
+        recording* rec,
+        lod_selector* lods)
     : render_(render)
     , batcher_(batcher)
+    , recording_(rec)
+    , lods_(lods)
     {
-        const m4f& cam_w = cam_n
-            ? cam_n->world_matrix()
-            : m4f::identity();
         const std::pair<m4f,bool> cam_w_inv = math::inversed(cam_w);
 
         const m4f& m_v = cam_w_inv.second
@@ -46,17 +109,14 @@ namespace e2d { namespace render_system_impl
             : m4f::identity();
         const m4f& m_p = cam.projection();
 
+        matrix_vp_ = m_v * m_p;
+        projection_scale_ = math::abs(m_p[1][1]);
+
         batcher_.flush()
             .property(matrix_v_property_hash, m_v)
             .property(matrix_p_property_hash, m_p)
             .property(matrix_vp_property_hash, m_v * m_p)
-            .property(game_time_property_hash, engine.time());
-
-        render.execute(render::command_block<3>()
-            .add_command(render::target_command(cam.target()))
-            .add_command(render::viewport_command(cam.viewport()))
-            .add_command(render::clear_command()
-                .color_value(cam.background())));
+            .property(game_time_property_hash, time);
     }
 
     drawer::context::~context() noexcept {
@@ -77,21 +137,26 @@ namespace e2d { namespace render_system_impl
         if ( node_r && node_r->enabled() ) {
             const model_renderer* mdl_r = node_e.find_component<model_renderer>();
             if ( mdl_r ) {
-                draw(node, *node_r, *mdl_r);
+                draw(node->world_matrix(), *node_r, *mdl_r, node.get());
             }
             const sprite_renderer* spr_r = node_e.find_component<sprite_renderer>();
             if ( spr_r ) {
-                draw(node, *node_r, *spr_r);
+                draw(node->world_matrix(), *node_r, *spr_r);
+            }
+            const shape_renderer* shp_r = node_e.find_component<shape_renderer>();
+            if ( shp_r ) {
+                draw(node->world_matrix(), *node_r, *shp_r);
             }
         }
     }
 
     void drawer::context::draw(
-        const const_node_iptr& node,
+        const m4f& world,
         const renderer& node_r,
-        const model_renderer& mdl_r)
+        const model_renderer& mdl_r,
+        const void* key)
     {
-        if ( !node || !node_r.enabled() ) {
+        if ( !node_r.enabled() ) {
             return;
         }
 
@@ -100,13 +165,14 @@ namespace e2d { namespace render_system_impl
         }
 
         const model& mdl = mdl_r.model()->content();
-        const mesh& msh = mdl.mesh()->content();
+        const std::size_t lod = select_lod_(world, mdl, key);
+        const mesh& msh = mdl.lod_mesh(lod)->content();
 
         try {
             property_cache_
                 .merge(batcher_.flush())
-                .property("u_matrix_m", node->world_matrix())
-                .merge(node_r.properties());
+                .property("u_matrix_m", world)
+                .merge(*node_r.properties());
 
             const std::size_t submesh_count = math::min(
                 msh.indices_submesh_count(),
@@ -115,13 +181,26 @@ namespace e2d { namespace render_system_impl
             for ( std::size_t i = 0, first_index = 0; i < submesh_count; ++i ) {
                 const std::size_t index_count = msh.indices(i).size();
                 const material_asset::ptr& mat = node_r.materials()[i];
-                if ( mat ) {
+                if ( mat && recording_ ) {
+                    recording::model_draw md;
+                    md.flush_index = recording_->flushes.size();
+                    md.material = mat;
+                    md.model = mdl_r.model();
+                    md.lod = lod;
+                    md.properties = property_cache_;
+                    md.first_index = first_index;
+                    md.index_count = index_count;
+                    recording_->models.push_back(std::move(md));
+                } else if ( mat ) {
                     render_.execute(render::draw_command(
                         mat->content(),
-                        mdl.geometry(),
+                        mdl.lod_geometry(lod),
                         property_cache_
                     ).index_range(first_index, index_count));
                 }
+                if ( mat ) {
+                    triangles_ += index_count / 3u;
+                }
                 first_index += index_count;
             }
         } catch (...) {
@@ -132,11 +211,11 @@ namespace e2d { namespace render_system_impl
     }
 
     void drawer::context::draw(
-        const const_node_iptr& node,
+        const m4f& world,
         const renderer& node_r,
         const sprite_renderer& spr_r)
     {
-        if ( !node || !node_r.enabled() ) {
+        if ( !node_r.enabled() ) {
             return;
         }
 
@@ -152,37 +231,9 @@ namespace e2d { namespace render_system_impl
             return;
         }
 
-        const b2f& tex_r = spr.texrect();
-        const v2f& tex_s = tex_a->content()->size().cast_to<f32>();
-
-        const f32 sw = tex_r.size.x;
-        const f32 sh = tex_r.size.y;
-
-        const f32 px = tex_r.position.x - spr.pivot().x;
-        const f32 py = tex_r.position.y - spr.pivot().y;
-
-        const v4f p1{px + 0.f, py + 0.f, 0.f, 1.f};
-        const v4f p2{px + sw,  py + 0.f, 0.f, 1.f};
-        const v4f p3{px + sw,  py + sh,  0.f, 1.f};
-        const v4f p4{px + 0.f, py + sh,  0.f, 1.f};
-
-        const f32 tx = tex_r.position.x / tex_s.x;
-        const f32 ty = tex_r.position.y / tex_s.y;
-        const f32 tw = tex_r.size.x / tex_s.x;
-        const f32 th = tex_r.size.y / tex_s.y;
-
-        const m4f& sm = node->world_matrix();
+        const m4f& sm = world;
         const color32& tc = spr_r.tint();
 
-        const batcher_type::index_type indices[] = {
-            0u, 1u, 2u, 2u, 3u, 0u};
-
-        const batcher_type::vertex_type vertices[] = {
-            { v3f(p1 * sm), {tx + 0.f, ty + 0.f}, tc },
-            { v3f(p2 * sm), {tx + tw,  ty + 0.f}, tc },
-            { v3f(p3 * sm), {tx + tw,  ty + th }, tc },
-            { v3f(p4 * sm), {tx + 0.f, ty + th }, tc }};
-
         const render::sampler_min_filter min_filter = spr_r.filtering()
             ? render::sampler_min_filter::linear
             : render::sampler_min_filter::nearest;
@@ -191,30 +242,203 @@ namespace e2d { namespace render_system_impl
             ? render::sampler_mag_filter::linear
             : render::sampler_mag_filter::nearest;
 
-        try {
-            property_cache_
-                .sampler(sprite_texture_sampler_hash, render::sampler_state()
-                    .texture(tex_a->content())
-                    .min_filter(min_filter)
-                    .mag_filter(mag_filter))
-                .merge(node_r.properties());
+        const auto sampler = render::sampler_state()
+            .texture(tex_a->content())
+            .min_filter(min_filter)
+            .mag_filter(mag_filter);
+
+        if ( spr_r.mode() == sprite_renderer::modes::sliced ) {
+            static const batcher_type::index_type indices[] = {
+                 0u,  1u,  5u,  5u,  4u,  0u,
+                 1u,  2u,  6u,  6u,  5u,  1u,
+                 2u,  3u,  7u,  7u,  6u,  2u,
+                 4u,  5u,  9u,  9u,  8u,  4u,
+                 5u,  6u, 10u, 10u,  9u,  5u,
+                 6u,  7u, 11u, 11u, 10u,  6u,
+                 8u,  9u, 13u, 13u, 12u,  8u,
+                 9u, 10u, 14u, 14u, 13u,  9u,
+                10u, 11u, 15u, 15u, 14u, 10u};
+
+            const sprite_renderer::sliced_geometry& sg = spr_r.sliced();
+
+            batcher_type::vertex_type vertices[16];
+            for ( std::size_t i = 0; i < E2D_COUNTOF(vertices); ++i ) {
+                vertices[i] = {
+                    v3f(v4f(sg.vertices[i], 0.f, 1.f) * sm),
+                    sg.texcoords[i],
+                    tc};
+            }
 
             batcher_.batch(
                 mat_a,
-                property_cache_,
+                sprite_texture_sampler_hash,
+                sampler,
+                node_r.properties(),
                 indices, E2D_COUNTOF(indices),
                 vertices, E2D_COUNTOF(vertices));
-        } catch (...) {
-            property_cache_.clear();
-            throw;
+            triangles_ += E2D_COUNTOF(indices) / 3u;
+        } else {
+            const b2f& tex_r = spr.texrect();
+            const v2f& tex_s = tex_a->content()->size().cast_to<f32>();
+
+            const f32 sw = tex_r.size.x;
+            const f32 sh = tex_r.size.y;
+
+            const f32 px = tex_r.position.x - spr.pivot().x;
+            const f32 py = tex_r.position.y - spr.pivot().y;
+
+            const v4f p1{px + 0.f, py + 0.f, 0.f, 1.f};
+            const v4f p2{px + sw,  py + 0.f, 0.f, 1.f};
+            const v4f p3{px + sw,  py + sh,  0.f, 1.f};
+            const v4f p4{px + 0.f, py + sh,  0.f, 1.f};
+
+            const f32 tx = tex_r.position.x / tex_s.x;
+            const f32 ty = tex_r.position.y / tex_s.y;
+            const f32 tw = tex_r.size.x / tex_s.x;
+            const f32 th = tex_r.size.y / tex_s.y;
+
+            const batcher_type::index_type indices[] = {
+                0u, 1u, 2u, 2u, 3u, 0u};
+
+            const batcher_type::vertex_type vertices[] = {
+                { v3f(p1 * sm), {tx + 0.f, ty + 0.f}, tc },
+                { v3f(p2 * sm), {tx + tw,  ty + 0.f}, tc },
+                { v3f(p3 * sm), {tx + tw,  ty + th }, tc },
+                { v3f(p4 * sm), {tx + 0.f, ty + th }, tc }};
+
+            batcher_.batch(
+                mat_a,
+                sprite_texture_sampler_hash,
+                sampler,
+                node_r.properties(),
+                indices, E2D_COUNTOF(indices),
+                vertices, E2D_COUNTOF(vertices));
+            triangles_ += E2D_COUNTOF(indices) / 3u;
         }
-        property_cache_.clear();
+    }
+
+    void drawer::context::draw(
+        const m4f& world,
+        const renderer& node_r,
+        const shape_renderer& shp_r)
+    {
+        if ( !node_r.enabled() ) {
+            return;
+        }
+
+        if ( !shp_r.shape() || node_r.materials().empty() ) {
+            return;
+        }
+
+        const shape& shp = shp_r.shape()->content();
+        const material_asset::ptr& mat_a = node_r.materials().front();
+        const vector<v2f>& vertices = shp.vertices();
+
+        const std::size_t max_vertex_count =
+            std::numeric_limits<batcher_type::index_type>::max();
+
+        if ( !mat_a || vertices.empty() || vertices.size() > max_vertex_count ) {
+            return;
+        }
+
+        shape_indices_.clear();
+        for ( std::size_t i = 0; i < shp.indices_subshape_count(); ++i ) {
+            for ( u32 index : shp.indices(i) ) {
+                if ( index >= vertices.size() ) {
+                    shape_indices_.clear();
+                    return;
+                }
+                shape_indices_.push_back(
+                    static_cast<batcher_type::index_type>(index));
+            }
+        }
+
+        if ( shape_indices_.empty() ) {
+            return;
+        }
+
+        const vector<v2f>* uvs = shp.uvs_channel_count() && shp.uvs(0).size() == vertices.size()
+            ? &shp.uvs(0)
+            : nullptr;
+
+        const vector<color32>* colors = shp.colors_channel_count() && shp.colors(0).size() == vertices.size()
+            ? &shp.colors(0)
+            : nullptr;
+
+        const color32& tc = shp_r.tint();
+
+        shape_vertices_.resize(vertices.size());
+        for ( std::size_t i = 0; i < vertices.size(); ++i ) {
+            shape_vertices_[i] = {
+                v3f(v4f(vertices[i], 0.f, 1.f) * world),
+                uvs ? (*uvs)[i] : v2f::zero(),
+                colors ? modulate_color((*colors)[i], tc) : tc};
+        }
+
+        const texture_asset::ptr& tex_a = shp_r.texture();
+        const bool textured = tex_a && tex_a->content();
+
+        const render::sampler_min_filter min_filter = shp_r.filtering()
+            ? render::sampler_min_filter::linear
+            : render::sampler_min_filter::nearest;
+
+        const render::sampler_mag_filter mag_filter = shp_r.filtering()
+            ? render::sampler_mag_filter::linear
+            : render::sampler_mag_filter::nearest;
+
+        const auto sampler = textured
+            ? render::sampler_state()
+                .texture(tex_a->content())
+                .min_filter(min_filter)
+                .mag_filter(mag_filter)
+            : render::sampler_state();
+
+        batcher_.batch(
+            mat_a,
+            textured ? sprite_texture_sampler_hash : str_hash(),
+            sampler,
+            node_r.properties(),
+            shape_indices_.data(), shape_indices_.size(),
+            shape_vertices_.data(), shape_vertices_.size());
+        triangles_ += shape_indices_.size() / 3u;
     }
 
     void drawer::context::flush() {
         batcher_.flush();
     }
 
+    u64 drawer::context::triangles() const noexcept {
+        return triangles_;
+    }
+
+    std::size_t drawer::context::select_lod_(
+        const m4f& world,
+        const model& mdl,
+        const void* key)
+    {
+        if ( mdl.lod_count() < 2u ) {
+            return 0u;
+        }
+
+        const f32 screen_size = model_screen_size(
+            mdl, world, matrix_vp_, projection_scale_);
+
+        const std::size_t lod = lods_
+            ? lods_->select(key, mdl, screen_size)
+            : mdl.select_lod(screen_size, 0u, 0.f);
+        return mdl.lod_mesh(lod) ? lod : 0u;
+    }
+
+    //
+    // drawer::recording
+    //
+
+    void drawer::recording::reset() noexcept {
+        flushes.reset();
+        models.clear();
+        triangles = 0u;
+    }
+
     //
     // drawer
     //
@@ -223,4 +447,30 @@ namespace e2d { namespace render_system_impl
     : engine_(e)
     , render_(r)
     , batcher_(d, r) {}
+
+    void drawer::replay(recording& rec) {
+        std::size_t flush_index = 0u;
+        for ( const recording::model_draw& md : rec.models ) {
+            for ( ; flush_index < md.flush_index; ++flush_index ) {
+                batcher_.replay(rec.flushes[flush_index]);
+            }
+            render_.execute(render::draw_command(
+                md.material->content(),
+                md.model->content().lod_geometry(md.lod),
+                md.properties
+            ).index_range(md.first_index, md.index_count));
+        }
+        for ( ; flush_index < rec.flushes.size(); ++flush_index ) {
+            batcher_.replay(rec.flushes[flush_index]);
+        }
+        triangles_ += rec.triangles;
+    }
+
+    u64 drawer::triangles() const noexcept {
+        return triangles_;
+    }
+
+    void drawer::reset_triangles() noexcept {
+        triangles_ = 0u;
+    }
 }}
@@ -9,6 +9,7 @@
 #include <enduro2d/high/_high.hpp>
 
 #include <enduro2d/high/node.hpp>
+#include <enduro2d/high/assets/model_asset.hpp>
 #include <enduro2d/high/components/camera.hpp>
 
 #include "render_system_base.hpp"
@@ -23,59 +24,192 @@ namespace e2d { namespace render_system_impl
         }
     };
 
+    //
+    // model_screen_size
+    //
+    // Projected bounding sphere diameter of the model as a fraction
+    // of the viewport height, 'projection_scale' is the [1][1] element
+    // of the camera projection.
+    //
+
+    f32 model_screen_size(
+        const model& mdl,
+        const m4f& world,
+        const m4f& matrix_vp,
+        f32 projection_scale) noexcept;
+
+    //
+    // lod_selector
+    //
+    // Remembers levels of detail selected by the camera for every model,
+    // so levels switch with hysteresis.
+    //
+
+    class lod_selector final : private noncopyable {
+    public:
+        static constexpr f32 hysteresis = 0.1f;
+        static constexpr u32 max_unused_frames = 60u;
+    public:
+        std::size_t select(const void* key, const model& mdl, f32 screen_size);
+
+        // forgets models which were not drawn for a while
+        void end_frame() noexcept;
+    private:
+        struct entry final {
+            std::size_t level{0u};
+            u32 frame{0u};
+        };
+        hash_map<const void*, entry> entries_;
+        u32 frame_{0u};
+    };
+
     class drawer : private noncopyable {
     public:
         using batcher_type = batcher<
             index_u16,
             vertex_v3f_t2f_c32b>;
 
+        class recording;
+
         class context : noncopyable {
         public:
             context(
                 const camera& cam,
-                const const_node_iptr& cam_n,
-                engine& engine,
+                const m4f& cam_w,
+                f32 time,
                 render& render,
-                batcher_type& batcher);
+                batcher_type& batcher,
+                recording* rec,
+                lod_selector* lods);
             ~context() noexcept;
 
             void draw(
                 const const_node_iptr& node);
 
+            // 'key' identifies the model for the level of detail selection
             void draw(
-                const const_node_iptr& node,
+                const m4f& world,
                 const renderer& node_r,
-                const model_renderer& mdl_r);
+                const model_renderer& mdl_r,
+                const void* key = nullptr);
 
             void draw(
-                const const_node_iptr& node,
+                const m4f& world,
                 const renderer& node_r,
                 const sprite_renderer& spr_r);
 
+            void draw(
+                const m4f& world,
+                const renderer& node_r,
+                const shape_renderer& shp_r);
+
             void flush();
+
+            u64 triangles() const noexcept;
+        private:
+            std::size_t select_lod_(
+                const m4f& world,
+                const model& mdl,
+                const void* key);
         private:
             render& render_;
             batcher_type& batcher_;
+            recording* recording_ = nullptr;
+            lod_selector* lods_ = nullptr;
             render::property_block property_cache_;
+            vector<batcher_type::index_type> shape_indices_;
+            vector<batcher_type::vertex_type> shape_vertices_;
+            m4f matrix_vp_;
+            f32 projection_scale_{0.f};
+            u64 triangles_{0u};
         };
     public:
         drawer(engine& e, debug& d, render& r);
 
         template < typename F >
-        void with(const camera& cam, const const_node_iptr& cam_n, F&& f);
+        void with(const camera& cam, const m4f& cam_w, lod_selector* lods, F&& f);
+
+        // records draws of 'f' without rendering, can be called from any
+        // thread, but only one thread at a time uses the drawer
+        template < typename F >
+        void record(
+            recording& rec,
+            const camera& cam,
+            const m4f& cam_w,
+            f32 time,
+            lod_selector* lods,
+            F&& f);
+
+        // renders the recording, it can be replayed several times
+        void replay(recording& rec);
+
+        // triangles rendered since the last reset
+        u64 triangles() const noexcept;
+        void reset_triangles() noexcept;
     private:
         engine& engine_;
         render& render_;
         batcher_type batcher_;
+        u64 triangles_{0u};
+    };
+
+    //
+    // drawer::recording
+    //
+    // Holds references to materials, models and textures of recorded
+    // draws, 'reset' releases them and must be called from the main thread.
+    //
+
+    class drawer::recording final {
+    public:
+        class model_draw final {
+        public:
+            std::size_t flush_index{0u};
+            material_asset::ptr material;
+            model_asset::ptr model;
+            std::size_t lod{0u};
+            render::property_block properties;
+            std::size_t first_index{0u};
+            std::size_t index_count{0u};
+        };
+    public:
+        void reset() noexcept;
+    public:
+        batcher_type::recording flushes;
+        vector<model_draw> models;
+        u64 triangles{0u};
     };
 }}
 
 namespace e2d { namespace render_system_impl
 {
     template < typename F >
-    void drawer::with(const camera& cam, const const_node_iptr& cam_n, F&& f) {
-        context ctx{cam, cam_n, engine_, render_, batcher_};
+    void drawer::with(const camera& cam, const m4f& cam_w, lod_selector* lods, F&& f) {
+        context ctx{cam, cam_w, engine_.time(), render_, batcher_, nullptr, lods};
         std::forward<F>(f)(ctx);
         ctx.flush();
+        triangles_ += ctx.triangles();
+    }
+
+    template < typename F >
+    void drawer::record(
+        recording& rec,
+        const camera& cam,
+        const m4f& cam_w,
+        f32 time,
+        lod_selector* lods,
+        F&& f)
+    {
+        batcher_.record_to(&rec.flushes);
+        try {
+            context ctx{cam, cam_w, time, render_, batcher_, &rec, lods};
+            std::forward<F>(f)(ctx);
+            ctx.flush();
+            rec.triangles += ctx.triangles();
+        } catch (...) {
+            batcher_.record_to(nullptr);
+            throw;
+        }
+        batcher_.record_to(nullptr);
     }
 }}
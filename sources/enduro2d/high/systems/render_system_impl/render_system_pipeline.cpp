@@ -0,0 +1,186 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "render_system_pipeline.hpp"
+
+namespace
+{
+    using namespace e2d;
+
+    template < typename T >
+    u32 add_component(vector<T>& components, std::size_t& count, const T& component) {
+        if ( count == components.size() ) {
+            components.push_back(component);
+        } else {
+            components[count] = component;
+        }
+        return math::numeric_cast<u32>(count++);
+    }
+
+    template < typename T >
+    void trim_components(vector<T>& components, std::size_t count) noexcept {
+        components.erase(
+            components.begin() + math::numeric_cast<std::ptrdiff_t>(count),
+            components.end());
+    }
+}
+
+namespace e2d { namespace render_system_impl
+{
+    constexpr u32 pipeline::no_index;
+
+    //
+    // pipeline::frame
+    //
+
+    pipeline::draw_item& pipeline::frame::add_item() {
+        if ( item_count_ == items.size() ) {
+            items.emplace_back();
+        }
+        return items[item_count_++];
+    }
+
+    u32 pipeline::frame::add_model(const model_renderer& mdl_r) {
+        return add_component(models, model_count_, mdl_r);
+    }
+
+    u32 pipeline::frame::add_sprite(const sprite_renderer& spr_r) {
+        return add_component(sprites, sprite_count_, spr_r);
+    }
+
+    u32 pipeline::frame::add_shape(const shape_renderer& shp_r) {
+        return add_component(shapes, shape_count_, shp_r);
+    }
+
+    camera_job& pipeline::frame::add_camera() {
+        if ( camera_count_ == cameras.size() ) {
+            cameras.emplace_back();
+        }
+        return cameras[camera_count_++];
+    }
+
+    void pipeline::frame::trim() noexcept {
+        items.erase(items.begin() + item_count_, items.end());
+        trim_components(models, model_count_);
+        trim_components(sprites, sprite_count_);
+        trim_components(shapes, shape_count_);
+        cameras.erase(cameras.begin() + camera_count_, cameras.end());
+    }
+
+    void pipeline::frame::reset() noexcept {
+        for ( camera_job& job : cameras ) {
+            job.rec.reset();
+        }
+        item_count_ = 0u;
+        model_count_ = 0u;
+        sprite_count_ = 0u;
+        shape_count_ = 0u;
+        camera_count_ = 0u;
+    }
+
+    //
+    // pipeline
+    //
+
+    pipeline::pipeline(engine& e, debug& d, render& r)
+    : drawer_(e, d, r) {
+        thread_ = std::thread([this](){
+            thread_loop_();
+        });
+    }
+
+    pipeline::~pipeline() noexcept {
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            exit_ = true;
+        }
+        cond_var_.notify_all();
+        thread_.join();
+    }
+
+    pipeline::frame& pipeline::snapshot() noexcept {
+        frame& f = frames_[snapshot_index_];
+        f.reset();
+        return f;
+    }
+
+    pipeline::frame* pipeline::submit() {
+        frame& next = frames_[snapshot_index_];
+        next.trim();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_var_.wait(lock, [this](){
+            return !recording_;
+        });
+
+        frame* const prev = submitted_;
+        std::exception_ptr error = std::move(error_);
+        error_ = nullptr;
+
+        submitted_ = &next;
+        recording_ = true;
+        snapshot_index_ = (snapshot_index_ + 1u) % E2D_COUNTOF(frames_);
+
+        lock.unlock();
+        cond_var_.notify_all();
+
+        if ( error ) {
+            std::rethrow_exception(error);
+        }
+        return prev;
+    }
+
+    void pipeline::record(drawer& drawer, frame& f) {
+        for ( camera_job& job : f.cameras ) {
+            if ( job.partial && job.regions.empty() ) {
+                continue;
+            }
+            drawer.record(job.rec, job.cam, job.cam_w, f.time, job.lods.get(), [&f](drawer::context& ctx){
+                for ( const draw_item& item : f.items ) {
+                    if ( item.model != no_index ) {
+                        ctx.draw(item.world, item.node_r, f.models[item.model], item.key);
+                    }
+                    if ( item.sprite != no_index ) {
+                        ctx.draw(item.world, item.node_r, f.sprites[item.sprite]);
+                    }
+                    if ( item.shape != no_index ) {
+                        ctx.draw(item.world, item.node_r, f.shapes[item.shape]);
+                    }
+                }
+            });
+            if ( job.lods ) {
+                job.lods->end_frame();
+            }
+        }
+    }
+
+    void pipeline::thread_loop_() noexcept {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            cond_var_.wait(lock, [this](){
+                return exit_ || recording_;
+            });
+            if ( exit_ ) {
+                return;
+            }
+
+            frame& f = *submitted_;
+            lock.unlock();
+
+            std::exception_ptr error;
+            try {
+                record(drawer_, f);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+            error_ = error;
+            recording_ = false;
+            cond_var_.notify_all();
+        }
+    }
+}}
@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "render_system_base.hpp"
+#include "render_system_drawer.hpp"
+
+#include <enduro2d/high/components/renderer.hpp>
+#include <enduro2d/high/components/model_renderer.hpp>
+#include <enduro2d/high/components/shape_renderer.hpp>
+#include <enduro2d/high/components/sprite_renderer.hpp>
+
+#include <condition_variable>
+
+namespace e2d { namespace render_system_impl
+{
+    //
+    // camera_job
+    //
+    // Everything the camera needs to be rendered, decided on the main
+    // thread: the target, redrawn regions and the scaled size.
+    //
+
+    class camera_job final {
+    public:
+        camera cam;
+        m4f cam_w;
+        render_target_ptr target;
+        b2u viewport;
+        // redrawn regions of partial cameras, other cameras are redrawn entirely
+        bool partial{false};
+        vector<b2u> regions;
+        // cached contents of the partial camera, copied to the main framebuffer
+        render_target_ptr cache;
+        // size of the scaled target, zero for cameras without scaling
+        v2u scaled_size;
+        // levels of detail selected by the camera, used by one thread at a time
+        std::shared_ptr<lod_selector> lods;
+        drawer::recording rec;
+    };
+
+    //
+    // pipeline
+    //
+    // Records frames on a render thread while the main thread simulates
+    // the next frame. Frames are presented one frame late.
+    //
+    // Ownership rules:
+    // - the main thread fills the snapshot with copies of drawable
+    //   components, the render thread never touches the world;
+    // - the render thread reads the submitted frame and writes only
+    //   its recordings until the main thread takes the frame back;
+    // - recordings are replayed on the main thread, which owns the
+    //   graphics context;
+    // - snapshots and recordings are reset on the main thread, so the
+    //   last references to render resources are never released by
+    //   the render thread.
+    //
+
+    class pipeline final : private noncopyable {
+    public:
+        static constexpr u32 no_index = ~u32(0);
+
+        // drawable components are stored in the per-type arrays of
+        // the frame, items keep indices of the present ones only
+        class draw_item final {
+        public:
+            m4f world;
+            // identifies the node, never dereferenced
+            const void* key{nullptr};
+            renderer node_r;
+            u32 model{no_index};
+            u32 sprite{no_index};
+            u32 shape{no_index};
+        };
+
+        class frame final {
+        public:
+            f32 time{0.f};
+            vector<draw_item> items;
+            vector<model_renderer> models;
+            vector<sprite_renderer> sprites;
+            vector<shape_renderer> shapes;
+            vector<camera_job> cameras;
+        public:
+            draw_item& add_item();
+            u32 add_model(const model_renderer& mdl_r);
+            u32 add_sprite(const sprite_renderer& spr_r);
+            u32 add_shape(const shape_renderer& shp_r);
+            camera_job& add_camera();
+
+            // releases references of the stale entries
+            void trim() noexcept;
+            void reset() noexcept;
+        private:
+            std::size_t item_count_{0u};
+            std::size_t model_count_{0u};
+            std::size_t sprite_count_{0u};
+            std::size_t shape_count_{0u};
+            std::size_t camera_count_{0u};
+        };
+    public:
+        pipeline(engine& e, debug& d, render& r);
+        ~pipeline() noexcept;
+
+        // the frame for the next snapshot
+        frame& snapshot() noexcept;
+
+        // hands the snapshot to the render thread and returns the recorded
+        // previous frame, nullptr for the first frame
+        frame* submit();
+
+        // records the frame in the calling thread
+        static void record(drawer& drawer, frame& f);
+    private:
+        void thread_loop_() noexcept;
+    private:
+        drawer drawer_;
+        frame frames_[2];
+        std::size_t snapshot_index_{0u};
+        frame* submitted_{nullptr};
+        bool recording_{false};
+        bool exit_{false};
+        std::exception_ptr error_;
+        std::mutex mutex_;
+        std::condition_variable cond_var_;
+        std::thread thread_;
+    };
+}}
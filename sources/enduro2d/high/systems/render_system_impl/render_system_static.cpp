@@ -0,0 +1,390 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "render_system_static.hpp"
+
+namespace
+{
+    using namespace e2d;
+
+    struct vertex_layout final {
+        std::size_t uvs{0u};
+        std::size_t colors{0u};
+        bool normals{false};
+        bool tangents{false};
+        bool bitangents{false};
+    };
+
+    bool operator==(const vertex_layout& l, const vertex_layout& r) noexcept {
+        return l.uvs == r.uvs
+            && l.colors == r.colors
+            && l.normals == r.normals
+            && l.tangents == r.tangents
+            && l.bitangents == r.bitangents;
+    }
+
+    struct candidate final {
+        const node* n{nullptr};
+        const renderer* node_r{nullptr};
+        const model_renderer* mdl_r{nullptr};
+    };
+
+    struct group final {
+        vertex_layout layout;
+        shared_property_block properties;
+        vector<candidate> nodes;
+    };
+
+    // all present channels must have one element per vertex
+    bool try_get_vertex_layout(const mesh& msh, vertex_layout& layout) noexcept {
+        const std::size_t count = msh.vertices().size();
+        if ( !count ) {
+            return false;
+        }
+        for ( std::size_t i = 0; i < msh.uvs_channel_count(); ++i ) {
+            if ( msh.uvs(i).size() != count ) {
+                return false;
+            }
+        }
+        for ( std::size_t i = 0; i < msh.colors_channel_count(); ++i ) {
+            if ( msh.colors(i).size() != count ) {
+                return false;
+            }
+        }
+        if ( !msh.normals().empty() && msh.normals().size() != count ) {
+            return false;
+        }
+        if ( !msh.tangents().empty() && msh.tangents().size() != count ) {
+            return false;
+        }
+        if ( !msh.bitangents().empty() && msh.bitangents().size() != count ) {
+            return false;
+        }
+        layout.uvs = msh.uvs_channel_count();
+        layout.colors = msh.colors_channel_count();
+        layout.normals = !msh.normals().empty();
+        layout.tangents = !msh.tangents().empty();
+        layout.bitangents = !msh.bitangents().empty();
+        return true;
+    }
+
+    bool try_get_candidate(const const_node_iptr& n, candidate& c) noexcept {
+        if ( !n || !n->owner() ) {
+            return false;
+        }
+        ecs::const_entity e = n->owner()->entity();
+        const renderer* node_r = e.find_component<renderer>();
+        const model_renderer* mdl_r = e.find_component<model_renderer>();
+        if ( !node_r || !node_r->enabled() || node_r->materials().empty() ) {
+            return false;
+        }
+        if ( !mdl_r || !mdl_r->model() || !mdl_r->model()->content().mesh() ) {
+            return false;
+        }
+        // levels of detail are selected per node by the drawer
+        if ( mdl_r->model()->content().lod_count() > 1u ) {
+            return false;
+        }
+        c.n = n.get();
+        c.node_r = node_r;
+        c.mdl_r = mdl_r;
+        return true;
+    }
+
+    // batches are drawn before other nodes of the scene,
+    // so materials must not depend on the draw order
+    bool is_order_independent(const vector<material_asset::ptr>& materials) noexcept {
+        for ( const material_asset::ptr& mat : materials ) {
+            if ( !mat ) {
+                continue;
+            }
+            const render::material& m = mat->content();
+            for ( std::size_t i = 0; i < m.pass_count(); ++i ) {
+                const render::state_block& states = m.pass(i).states();
+                if ( states.capabilities().blending()
+                    || !states.capabilities().depth_test()
+                    || !states.depth().write() )
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void append_transformed(vector<v3f>& dst, const vector<v3f>& src, const m4f& m, f32 w) {
+        for ( const v3f& v : src ) {
+            const v3f r = v3f(v4f(v, w) * m);
+            dst.push_back(w > 0.f ? r : math::normalized(r));
+        }
+    }
+}
+
+namespace e2d { namespace render_system_impl
+{
+    static_batcher::static_batcher(debug& debug, render& render)
+    : debug_(debug)
+    , render_(render) {}
+
+    void static_batcher::update(ecs::entity_id scene, const const_node_iptr& root) {
+        scene_state& state = scenes_[scene];
+        state.frame = frame_;
+
+        // only batched nodes are checked, other nodes are dynamic anyway
+        bool rebuild = !state.built;
+        for ( entry& e : state.entries ) {
+            if ( !is_unchanged_(e, root) ) {
+                state.batched.erase(e.node.get());
+                rebuild = true;
+            }
+        }
+
+        if ( !rebuild ) {
+            return;
+        }
+
+        try {
+            if ( root ) {
+                root->extract_all_nodes(std::back_inserter(nodes_));
+            }
+            build_(state);
+            changed_ = true;
+        } catch (...) {
+            nodes_.clear();
+            throw;
+        }
+        nodes_.clear();
+    }
+
+    bool static_batcher::end_frame() {
+        stats_ = statistics();
+        for ( auto iter = scenes_.begin(); iter != scenes_.end(); ) {
+            if ( iter->second.frame != frame_ ) {
+                iter = scenes_.erase(iter);
+                changed_ = true;
+            } else {
+                const statistics& s = iter->second.stats;
+                stats_.batches += s.batches;
+                stats_.batched_nodes += s.batched_nodes;
+                stats_.draws_saved += s.draws_saved;
+                stats_.memory += s.memory;
+                ++iter;
+            }
+        }
+        ++frame_;
+        const bool changed = changed_;
+        changed_ = false;
+        return changed;
+    }
+
+    const vector<static_batcher::batch>& static_batcher::batches(ecs::entity_id scene) const noexcept {
+        static const vector<batch> empty;
+        const auto iter = scenes_.find(scene);
+        return iter != scenes_.end()
+            ? iter->second.batches
+            : empty;
+    }
+
+    bool static_batcher::is_batched(ecs::entity_id scene, const node* n) const noexcept {
+        const auto scene_iter = scenes_.find(scene);
+        if ( scene_iter == scenes_.end() ) {
+            return false;
+        }
+        return scene_iter->second.batched.count(n) > 0u;
+    }
+
+    const static_batcher::statistics& static_batcher::stats() const noexcept {
+        return stats_;
+    }
+
+    bool static_batcher::is_unchanged_(entry& e, const const_node_iptr& root) {
+        // the matrix is compared only when it was recomputed
+        const u32 world_version = e.node->world_matrix_version();
+        if ( world_version != e.world_version ) {
+            if ( e.node->world_matrix() != e.world ) {
+                return false;
+            }
+            if ( e.node != root && !e.node->has_parent_recursive(root) ) {
+                return false;
+            }
+            e.world_version = world_version;
+        }
+        candidate c;
+        return try_get_candidate(e.node, c)
+            && c.mdl_r->model() == e.model
+            && c.node_r->properties() == e.properties
+            && c.node_r->materials() == e.materials;
+    }
+
+    void static_batcher::build_(scene_state& state) {
+        vector<group> groups;
+        vector<entry> entries;
+        hash_set<const node*> batched;
+
+        for ( const const_node_iptr& n : nodes_ ) {
+            candidate c;
+            if ( !try_get_candidate(n, c) ) {
+                continue;
+            }
+
+            // nodes which became dynamic or were added after the first
+            // build are never batched again
+            const bool dynamic = state.built
+                && !state.batched.count(n.get());
+            if ( dynamic || !is_order_independent(c.node_r->materials()) ) {
+                continue;
+            }
+
+            vertex_layout layout;
+            const mesh& msh = c.mdl_r->model()->content().mesh()->content();
+            if ( !try_get_vertex_layout(msh, layout) ) {
+                continue;
+            }
+
+            const auto group_iter = std::find_if(groups.begin(), groups.end(),
+                [&c, &layout](const group& g){
+                    return g.layout == layout
+                        && g.properties == c.node_r->properties();
+                });
+
+            if ( group_iter != groups.end() ) {
+                group_iter->nodes.push_back(c);
+            } else {
+                groups.emplace_back();
+                groups.back().layout = layout;
+                groups.back().properties = c.node_r->properties();
+                groups.back().nodes.push_back(c);
+            }
+        }
+
+        state.batches.clear();
+        state.stats = statistics();
+
+        for ( const group& g : groups ) {
+            // single models are drawn as usual
+            if ( g.nodes.size() < 2u ) {
+                continue;
+            }
+
+            vector<v3f> vertices;
+            vector<v3f> normals;
+            vector<v3f> tangents;
+            vector<v3f> bitangents;
+            vector<vector<v2f>> uvs(g.layout.uvs);
+            vector<vector<color32>> colors(g.layout.colors);
+            vector<material_asset::ptr> materials;
+            vector<vector<u32>> indices;
+            u32 draws = 0u;
+
+            for ( const candidate& c : g.nodes ) {
+                const mesh& msh = c.mdl_r->model()->content().mesh()->content();
+                const m4f& m = c.n->world_matrix();
+                const std::pair<m4f,bool> m_inv = math::inversed(m);
+                const m4f& m_n = m_inv.second
+                    ? math::transposed(m_inv.first)
+                    : m;
+
+                const u32 base = math::numeric_cast<u32>(vertices.size());
+                append_transformed(vertices, msh.vertices(), m, 1.f);
+                append_transformed(normals, msh.normals(), m_n, 0.f);
+                append_transformed(tangents, msh.tangents(), m, 0.f);
+                append_transformed(bitangents, msh.bitangents(), m, 0.f);
+                for ( std::size_t i = 0; i < uvs.size(); ++i ) {
+                    uvs[i].insert(uvs[i].end(), msh.uvs(i).begin(), msh.uvs(i).end());
+                }
+                for ( std::size_t i = 0; i < colors.size(); ++i ) {
+                    colors[i].insert(colors[i].end(), msh.colors(i).begin(), msh.colors(i).end());
+                }
+
+                const std::size_t submesh_count = math::min(
+                    msh.indices_submesh_count(),
+                    c.node_r->materials().size());
+
+                for ( std::size_t i = 0; i < submesh_count; ++i ) {
+                    const material_asset::ptr& mat = c.node_r->materials()[i];
+                    if ( !mat ) {
+                        continue;
+                    }
+                    ++draws;
+                    const std::size_t index = math::numeric_cast<std::size_t>(
+                        std::distance(materials.begin(),
+                            std::find(materials.begin(), materials.end(), mat)));
+                    if ( index == materials.size() ) {
+                        materials.push_back(mat);
+                        indices.emplace_back();
+                    }
+                    for ( u32 v : msh.indices(i) ) {
+                        indices[index].push_back(base + v);
+                    }
+                }
+
+                entries.emplace_back();
+                entry& e = entries.back();
+                e.node = const_node_iptr(c.n);
+                e.world_version = c.n->world_matrix_version();
+                e.world = m;
+                e.model = c.mdl_r->model();
+                e.materials = c.node_r->materials();
+                e.properties = c.node_r->properties();
+                batched.insert(c.n);
+            }
+
+            u64 memory =
+                vertices.size() * sizeof(v3f) +
+                normals.size() * sizeof(v3f) +
+                tangents.size() * sizeof(v3f) +
+                bitangents.size() * sizeof(v3f) +
+                g.layout.uvs * vertices.size() * sizeof(v2f) +
+                g.layout.colors * vertices.size() * sizeof(color32);
+
+            mesh batch_mesh;
+            batch_mesh.set_vertices(std::move(vertices));
+            batch_mesh.set_normals(std::move(normals));
+            batch_mesh.set_tangents(std::move(tangents));
+            batch_mesh.set_bitangents(std::move(bitangents));
+            for ( std::size_t i = 0; i < uvs.size(); ++i ) {
+                batch_mesh.set_uvs(i, std::move(uvs[i]));
+            }
+            for ( std::size_t i = 0; i < colors.size(); ++i ) {
+                batch_mesh.set_colors(i, std::move(colors[i]));
+            }
+            for ( std::size_t i = 0; i < indices.size(); ++i ) {
+                memory += indices[i].size() * sizeof(u32);
+                batch_mesh.set_indices(i, std::move(indices[i]));
+            }
+
+            model batch_model;
+            batch_model.set_mesh(mesh_asset::create(std::move(batch_mesh)));
+            batch_model.regenerate_geometry(render_);
+
+            batch b;
+            b.node_r
+                .materials(materials)
+                .properties(g.properties);
+            b.mdl_r.model(model_asset::create(std::move(batch_model)));
+            state.batches.push_back(std::move(b));
+
+            state.stats.batches += 1u;
+            state.stats.batched_nodes += math::numeric_cast<u32>(g.nodes.size());
+            state.stats.draws_saved += draws - math::numeric_cast<u32>(materials.size());
+            state.stats.memory += memory;
+        }
+
+        state.entries = std::move(entries);
+        state.batched = std::move(batched);
+        state.built = true;
+
+        debug_.trace("RENDER: Static batches built:\n"
+            "--> Batches: %0\n"
+            "--> Nodes: %1\n"
+            "--> Draw calls saved: %2\n"
+            "--> Memory: %3 bytes",
+            state.stats.batches,
+            state.stats.batched_nodes,
+            state.stats.draws_saved,
+            state.stats.memory);
+    }
+}}
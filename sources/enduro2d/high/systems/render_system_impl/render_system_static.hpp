@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include "render_system_base.hpp"
+
+#include <enduro2d/high/node.hpp>
+#include <enduro2d/high/components/renderer.hpp>
+#include <enduro2d/high/components/model_renderer.hpp>
+
+namespace e2d { namespace render_system_impl
+{
+    //
+    // static_batcher
+    //
+    // Merges models of a scene with equal properties and vertex layouts
+    // into models pre-transformed to world space, with one submesh per
+    // material. Batches are drawn before other nodes of the scene, so only
+    // opaque depth tested materials are batched. Models with levels of
+    // detail are not batched, the drawer selects their levels per node.
+    // Batches are built when the scene is updated for the first time.
+    // A batched node that moves or changes its model, materials or
+    // properties becomes dynamic and the batches of its scene are rebuilt
+    // without it. Nodes added later are dynamic. Moves are found by world
+    // matrix versions of batched nodes.
+    //
+
+    class static_batcher final : private noncopyable {
+    public:
+        class batch final {
+        public:
+            renderer node_r;
+            model_renderer mdl_r;
+        };
+
+        class statistics final {
+        public:
+            u32 batches{0u};
+            u32 batched_nodes{0u};
+            u32 draws_saved{0u};
+            u64 memory{0u};
+        };
+    public:
+        static_batcher(debug& debug, render& render);
+
+        // call for every scene with static batching once per frame
+        void update(ecs::entity_id scene, const const_node_iptr& root);
+
+        // drops scenes which were not updated since the previous call,
+        // returns true if batches were changed
+        bool end_frame();
+
+        const vector<batch>& batches(ecs::entity_id scene) const noexcept;
+        bool is_batched(ecs::entity_id scene, const node* n) const noexcept;
+
+        const statistics& stats() const noexcept;
+    private:
+        struct entry final {
+            const_node_iptr node;
+            u32 world_version{0u};
+            m4f world;
+            model_asset::ptr model;
+            vector<material_asset::ptr> materials;
+            shared_property_block properties;
+        };
+
+        struct scene_state final {
+            hash_set<const node*> batched;
+            vector<entry> entries;
+            vector<batch> batches;
+            statistics stats;
+            u32 frame{0u};
+            bool built{false};
+        };
+
+        static bool is_unchanged_(entry& e, const const_node_iptr& root);
+        void build_(scene_state& state);
+    private:
+        debug& debug_;
+        render& render_;
+        hash_map<ecs::entity_id, scene_state> scenes_;
+        vector<const_node_iptr> nodes_;
+        statistics stats_;
+        u32 frame_{0u};
+        bool changed_{false};
+    };
+}}
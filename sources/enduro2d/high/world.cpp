@@ -8,10 +8,119 @@
 
 #include <enduro2d/high/node.hpp>
 #include <enduro2d/high/components/actor.hpp>
+#include <enduro2d/high/components/pending_instance.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    struct flat_prefab final {
+        const prefab* source{nullptr};
+        // index of the parent entry, the root has no parent
+        std::size_t parent{0u};
+    };
+
+    const std::size_t no_parent = std::size_t(-1);
+
+    // parents always precede their children
+    vector<flat_prefab> flatten_prefab(const prefab& root) {
+        vector<flat_prefab> result;
+        result.push_back({&root, no_parent});
+        for ( std::size_t i = 0; i < result.size(); ++i ) {
+            for ( const prefab& child : result[i].source->children() ) {
+                result.push_back({&child, i});
+            }
+        }
+        return result;
+    }
+}
 
 namespace e2d
 {
+    //
+    // world::instantiation::internal_state
+    //
+
+    class world::instantiation::internal_state final : private e2d::noncopyable {
+    public:
+        std::shared_ptr<const prefab> source;
+        node_iptr parent;
+        stdex::promise<vector<flat_prefab>> flattening;
+        vector<flat_prefab> entries;
+        vector<gobject_iptr> instances;
+        stdex::promise<gobject_iptr> result;
+        std::size_t created{0u};
+        std::size_t total{0u};
+        bool flattened{false};
+        bool cancelled{false};
+        bool finished{false};
+    };
+
+    //
+    // world::instantiation
+    //
+
+    world::instantiation::instantiation(prefab&& prefab, const node_iptr& parent)
+    : state_(std::make_unique<internal_state>()) {
+        state_->source = std::make_shared<const e2d::prefab>(std::move(prefab));
+        state_->parent = parent;
+        state_->flattening = the<deferrer>().do_in_worker_thread(
+            [source = state_->source](){
+                return flatten_prefab(*source);
+            });
+    }
+
+    world::instantiation::~instantiation() noexcept = default;
+
+    std::size_t world::instantiation::created() const noexcept {
+        return state_->created;
+    }
+
+    std::size_t world::instantiation::total() const noexcept {
+        return state_->total;
+    }
+
+    f32 world::instantiation::progress() const noexcept {
+        if ( state_->finished && !state_->cancelled ) {
+            return 1.f;
+        }
+        return state_->total
+            ? math::numeric_cast<f32>(state_->created) / math::numeric_cast<f32>(state_->total)
+            : 0.f;
+    }
+
+    bool world::instantiation::done() const noexcept {
+        return state_->finished || state_->cancelled;
+    }
+
+    const stdex::promise<gobject_iptr>& world::instantiation::result() const noexcept {
+        return state_->result;
+    }
+
+    void world::instantiation::cancel() {
+        if ( !done() ) {
+            state_->cancelled = true;
+            state_->result.reject(bad_world_operation());
+        }
+    }
+
+    //
+    // world
+    //
+
+    world::world()
+    : instantiation_budget_(make_microseconds<u64>(2000u)) {}
+
     world::~world() noexcept {
+        for ( const instantiation_ptr& inst : instantiations_ ) {
+            if ( !inst->done() ) {
+                inst->state_->cancelled = true;
+                inst->state_->result.reject(
+                    std::make_exception_ptr(bad_world_operation()));
+            }
+            inst->state_->instances.clear();
+        }
+        instantiations_.clear();
         while ( !gobjects_.empty() ) {
             destroy_instance(gobjects_.begin()->second);
         }
@@ -45,20 +154,7 @@ namespace e2d
     }
 
     gobject_iptr world::instantiate(const prefab& prefab) {
-        auto inst = make_intrusive<gobject>(registry_, prefab.prototype());
-        gobjects_.emplace(inst->entity().id(), inst);
-
-        try {
-            auto inst_n = node::create(inst);
-            auto inst_a = inst->get_component<actor>();
-            if ( inst_a && inst_a->node() ) {
-                inst_n->transform(inst_a->node()->transform());
-            }
-            inst_a.assign(inst_n);
-        } catch (...) {
-            destroy_instance(inst);
-            throw;
-        }
+        auto inst = instantiate_single_(prefab);
 
         try {
             for ( const auto& child_prefab : prefab.children() ) {
@@ -95,6 +191,47 @@ namespace e2d
         }
     }
 
+    world::instantiation_ptr world::instantiate_async(prefab prefab, const node_iptr& parent) {
+        auto inst = std::make_shared<instantiation>(std::move(prefab), parent);
+        instantiations_.push_back(inst);
+        return inst;
+    }
+
+    void world::process_instantiations() {
+        if ( instantiations_.empty() ) {
+            return;
+        }
+
+        const u64 deadline_us = time::now_us<u64>().value + instantiation_budget_.value;
+
+        // callbacks of the results can start new instantiations
+        for ( std::size_t i = 0; i < instantiations_.size(); ++i ) {
+            if ( i > 0 && time::now_us<u64>().value >= deadline_us ) {
+                break;
+            }
+            const instantiation_ptr inst = instantiations_[i];
+            if ( process_instantiation_(*inst, deadline_us) ) {
+                inst->state_->finished = true;
+            }
+        }
+
+        instantiations_.erase(
+            std::remove_if(instantiations_.begin(), instantiations_.end(),
+                [](const instantiation_ptr& inst){
+                    return inst->state_->finished;
+                }),
+            instantiations_.end());
+    }
+
+    world& world::instantiation_budget(microseconds<u64> value) noexcept {
+        instantiation_budget_ = value;
+        return *this;
+    }
+
+    microseconds<u64> world::instantiation_budget() const noexcept {
+        return instantiation_budget_;
+    }
+
     gobject_iptr world::resolve(ecs::entity_id ent) const noexcept {
         E2D_ASSERT(registry_.valid_entity(ent));
         const auto iter = gobjects_.find(ent);
@@ -110,4 +247,104 @@ namespace e2d
             ? iter->second
             : nullptr;
     }
+
+    gobject_iptr world::instantiate_single_(const prefab& prefab) {
+        auto inst = make_intrusive<gobject>(registry_, prefab.prototype());
+        gobjects_.emplace(inst->entity().id(), inst);
+
+        try {
+            auto inst_n = node::create(inst);
+            auto inst_a = inst->get_component<actor>();
+            if ( inst_a && inst_a->node() ) {
+                inst_n->transform(inst_a->node()->transform());
+            }
+            inst_a.assign(inst_n);
+        } catch (...) {
+            destroy_instance(inst);
+            throw;
+        }
+
+        return inst;
+    }
+
+    bool world::process_instantiation_(instantiation& inst, u64 deadline_us) {
+        instantiation::internal_state& state = *inst.state_;
+
+        if ( state.cancelled ) {
+            if ( !state.instances.empty() ) {
+                destroy_instance(state.instances.front());
+                state.instances.clear();
+            }
+            return true;
+        }
+
+        if ( !state.flattened ) {
+            const auto zero_us = time::to_chrono(make_microseconds(0));
+            if ( state.flattening.wait_for(zero_us) == stdex::promise_wait_status::timeout ) {
+                return false;
+            }
+            try {
+                state.entries = state.flattening.get();
+            } catch (...) {
+                state.result.reject(std::current_exception());
+                return true;
+            }
+            state.total = state.entries.size();
+            state.flattened = true;
+        }
+
+        try {
+            while ( state.instances.size() < state.entries.size() ) {
+                const flat_prefab& entry = state.entries[state.instances.size()];
+                auto child = instantiate_single_(*entry.source);
+                try {
+                    child->entity_filler().component<pending_instance>();
+                } catch (...) {
+                    destroy_instance(child);
+                    throw;
+                }
+                if ( entry.parent != no_parent ) {
+                    try {
+                        auto parent_a = state.instances[entry.parent]->get_component<actor>();
+                        auto child_a = child->get_component<actor>();
+                        parent_a->node()->add_child(child_a->node());
+                    } catch (...) {
+                        destroy_instance(child);
+                        throw;
+                    }
+                }
+                state.instances.push_back(child);
+                ++state.created;
+                if ( time::now_us<u64>().value >= deadline_us ) {
+                    break;
+                }
+            }
+
+            if ( state.instances.size() < state.entries.size() ) {
+                return false;
+            }
+
+            for ( const gobject_iptr& instance : state.instances ) {
+                instance->entity().remove_component<pending_instance>();
+            }
+
+            const gobject_iptr root = state.instances.front();
+            if ( state.parent ) {
+                state.parent->add_child(root->get_component<actor>()->node());
+            }
+
+            state.instances.clear();
+            state.entries.clear();
+            state.source.reset();
+            state.result.resolve(root);
+        } catch (...) {
+            if ( !state.instances.empty() ) {
+                destroy_instance(state.instances.front());
+                state.instances.clear();
+            }
+            state.result.reject(std::current_exception());
+        }
+
+        return true;
+    }
 }
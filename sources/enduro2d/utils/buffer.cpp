@@ -8,6 +8,14 @@
 
 namespace e2d
 {
+    void buffer::data_deleter::operator()(u8* data) const noexcept {
+        if ( deleter ) {
+            deleter(data);
+        } else {
+            delete[] data;
+        }
+    }
+
     buffer::buffer(buffer&& other) noexcept {
         assign(std::move(other));
     }
@@ -43,7 +51,7 @@ namespace e2d
         data_t ndata = size_ == nsize
             ? std::move(data_)
             : (nsize
-                ? std::make_unique<u8[]>(nsize)
+                ? data_t(new u8[nsize]())
                 : data_t());
         if ( ndata && data_ && size_ ) {
             std::memcpy(ndata.get(), data_.get(), math::min(size_, nsize));
@@ -71,7 +79,7 @@ namespace e2d
         data_t ndata = size_ == nsize
             ? std::move(data_)
             : (nsize
-                ? std::make_unique<u8[]>(nsize)
+                ? data_t(new u8[nsize]())
                 : data_t());
         if ( ndata && src && nsize ) {
             std::memcpy(ndata.get(), src, nsize);
@@ -81,6 +89,18 @@ namespace e2d
         return *this;
     }
 
+    buffer& buffer::adopt(void* src, std::size_t nsize, deleter_type deleter) noexcept {
+        E2D_ASSERT(!nsize || src);
+        E2D_ASSERT(!src || deleter);
+        data_t ndata(nsize ? static_cast<u8*>(src) : nullptr, data_deleter{deleter});
+        if ( !nsize && src && deleter ) {
+            deleter(src);
+        }
+        data_.swap(ndata);
+        size_ = nsize;
+        return *this;
+    }
+
     void buffer::swap(buffer& other) noexcept {
         using std::swap;
         swap(data_, other.data_);
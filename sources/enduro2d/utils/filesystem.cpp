@@ -7,6 +7,223 @@
 #include "filesystem_impl/files.hpp"
 #include "filesystem_impl/filesystem.hpp"
 
+#include <condition_variable>
+#include <deque>
+
+namespace
+{
+    using namespace e2d;
+
+    //
+    // directory_scanner
+    //
+    // directories to scan are shared by the calling thread and the
+    // executor helpers, every thread collects results to its own batch
+    // and merges it at the end, so the scanning never locks per entry.
+    // When traced, listings of directories are queued instead and passed
+    // to the function by the calling thread. A listing is queued before
+    // its subdirectories become pending, so parents precede children.
+    //
+
+    class directory_scanner final
+        : private noncopyable
+        , public std::enable_shared_from_this<directory_scanner> {
+    public:
+        directory_scanner(str_view root, const filesystem::scan_executor& executor)
+        : root_(root)
+        , executor_(executor)
+        , max_helpers_(executor ? math::max(1u, std::thread::hardware_concurrency()) - 1u : 0u) {}
+
+        bool run(filesystem::directory_scan& dst) {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                pending_.emplace_back();
+            }
+            process_();
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_var_.wait(lock, [this](){
+                return !workers_;
+            });
+            if ( error_ ) {
+                std::rethrow_exception(error_);
+            }
+            dst.append(result_);
+            return !failed_;
+        }
+
+        bool run(const filesystem::trace_func& func) {
+            func_ = &func;
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                pending_.emplace_back();
+            }
+            process_();
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_var_.wait(lock, [this](){
+                return !workers_;
+            });
+            if ( error_ ) {
+                std::rethrow_exception(error_);
+            }
+            return !failed_ && !stopped_;
+        }
+    private:
+        // counts the directory as being scanned until the scope
+        // is left, the lock is taken back for the decrement
+        class active_scope final : private noncopyable {
+        public:
+            active_scope(std::unique_lock<std::mutex>& lock, std::size_t& active) noexcept
+            : lock_(lock)
+            , active_(active) {
+                ++active_;
+            }
+
+            ~active_scope() noexcept {
+                if ( !lock_.owns_lock() ) {
+                    lock_.lock();
+                }
+                --active_;
+            }
+        private:
+            std::unique_lock<std::mutex>& lock_;
+            std::size_t& active_;
+        };
+
+        void process_(bool helper = false) noexcept {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ++workers_;
+            try {
+                process_pending_(lock, func_ && !helper);
+            } catch (...) {
+                if ( !lock.owns_lock() ) {
+                    lock.lock();
+                }
+                if ( !error_ ) {
+                    error_ = std::current_exception();
+                }
+                pending_.clear();
+            }
+            --workers_;
+            cond_var_.notify_all();
+        }
+
+        void process_pending_(std::unique_lock<std::mutex>& lock, bool tracing) {
+            filesystem::directory_scan batch;
+            filesystem::directory_scan listing;
+            vector<str> subdirectories;
+            for (;;) {
+                cond_var_.wait(lock, [this, tracing](){
+                    return error_ || stopped_ || !pending_.empty() || !active_
+                        || (tracing && !listings_.empty());
+                });
+                if ( tracing && !error_ && !listings_.empty() ) {
+                    trace_listing_(lock);
+                    continue;
+                }
+                if ( error_ || stopped_ || pending_.empty() ) {
+                    break;
+                }
+
+                const str parent = std::move(pending_.back());
+                pending_.pop_back();
+
+                filesystem::directory_scan& dst = func_ ? listing : batch;
+                bool success = false;
+                {
+                    active_scope scope(lock, active_);
+                    lock.unlock();
+
+                    const std::size_t first = dst.size();
+                    success = filesystem::impl::scan_directory(
+                        parent.empty() ? str(root_) : path::combine(root_, parent),
+                        parent,
+                        dst);
+                    for ( std::size_t i = first; i < dst.size(); ++i ) {
+                        if ( dst.directory(i) ) {
+                            subdirectories.emplace_back(dst.path(i));
+                        }
+                    }
+                }
+
+                failed_ = failed_ || !success;
+                if ( func_ && !stopped_ && !listing.empty() ) {
+                    listings_.push_back(std::move(listing));
+                }
+                listing.clear();
+                for ( str& subdirectory : subdirectories ) {
+                    if ( !stopped_ ) {
+                        pending_.push_back(std::move(subdirectory));
+                    }
+                }
+                subdirectories.clear();
+
+                std::size_t new_helpers = 0u;
+                if ( pending_.size() > 1u && spawned_ < max_helpers_ ) {
+                    new_helpers = math::min(pending_.size() - 1u, max_helpers_ - spawned_);
+                    spawned_ += new_helpers;
+                }
+                cond_var_.notify_all();
+
+                if ( new_helpers ) {
+                    lock.unlock();
+                    spawn_helpers_(new_helpers);
+                    lock.lock();
+                }
+            }
+            result_.append(batch);
+        }
+
+        // passes the oldest listing to the function without the lock
+        void trace_listing_(std::unique_lock<std::mutex>& lock) {
+            const filesystem::directory_scan listing = std::move(listings_.front());
+            listings_.pop_front();
+            lock.unlock();
+
+            bool stop = false;
+            for ( std::size_t i = 0; i < listing.size() && !stop; ++i ) {
+                stop = !(*func_)(listing.path(i), listing.directory(i));
+            }
+
+            lock.lock();
+            if ( stop ) {
+                stopped_ = true;
+                pending_.clear();
+                listings_.clear();
+                cond_var_.notify_all();
+            }
+        }
+
+        void spawn_helpers_(std::size_t count) noexcept {
+            for ( std::size_t i = 0; i < count; ++i ) {
+                try {
+                    auto self = shared_from_this();
+                    executor_([self](){
+                        self->process_(true);
+                    });
+                } catch (...) {
+                    // the calling thread will do this work
+                }
+            }
+        }
+    private:
+        str root_;
+        filesystem::scan_executor executor_;
+        std::size_t max_helpers_{0u};
+        std::mutex mutex_;
+        std::condition_variable cond_var_;
+        vector<str> pending_;
+        std::size_t active_{0u};
+        std::size_t workers_{0u};
+        std::size_t spawned_{0u};
+        bool failed_{false};
+        bool stopped_{false};
+        std::exception_ptr error_;
+        filesystem::directory_scan result_;
+        const filesystem::trace_func* func_{nullptr};
+        std::deque<filesystem::directory_scan> listings_;
+    };
+}
+
 namespace e2d
 {
     read_file_uptr make_read_file(str_view path) noexcept {
@@ -95,6 +312,84 @@ namespace e2d { namespace filesystem
             std::bind(rfunc, "", std::placeholders::_1, std::placeholders::_2));
     }
 
+    //
+    // directory_scan
+    //
+
+    std::size_t directory_scan::size() const noexcept {
+        return entries_.size();
+    }
+
+    bool directory_scan::empty() const noexcept {
+        return entries_.empty();
+    }
+
+    str_view directory_scan::path(std::size_t index) const noexcept {
+        E2D_ASSERT(index < entries_.size());
+        const entry& e = entries_[index];
+        return str_view(names_.data() + e.offset, e.size);
+    }
+
+    bool directory_scan::directory(std::size_t index) const noexcept {
+        E2D_ASSERT(index < entries_.size());
+        return entries_[index].directory;
+    }
+
+    void directory_scan::clear() noexcept {
+        names_.clear();
+        entries_.clear();
+    }
+
+    void directory_scan::reserve(std::size_t entries, std::size_t names) {
+        entries_.reserve(entries);
+        names_.reserve(names);
+    }
+
+    void directory_scan::add(str_view parent, str_view name, bool directory) {
+        entry e;
+        e.offset = names_.size();
+        e.directory = directory;
+        if ( !parent.empty() ) {
+            names_.append(parent.data(), parent.size());
+            if ( parent.back() != '/' ) {
+                names_.push_back('/');
+            }
+        }
+        names_.append(name.data(), name.size());
+        e.size = names_.size() - e.offset;
+        entries_.push_back(e);
+    }
+
+    void directory_scan::append(const directory_scan& other) {
+        const std::size_t offset = names_.size();
+        names_.append(other.names_);
+        entries_.reserve(entries_.size() + other.entries_.size());
+        for ( entry e : other.entries_ ) {
+            e.offset += offset;
+            entries_.push_back(e);
+        }
+    }
+
+    bool scan_directory_recursive(
+        str_view path,
+        directory_scan& dst,
+        const scan_executor& executor)
+    {
+        dst.clear();
+        return std::make_shared<directory_scanner>(path, executor)->run(dst);
+    }
+
+    bool trace_directory_recursive(
+        str_view path,
+        const trace_func& func,
+        const scan_executor& executor)
+    {
+        if ( !func ) {
+            return false;
+        }
+        return std::make_shared<directory_scanner>(path, executor)->run(func);
+    }
+
     bool try_read_all(str& dst, str_view path) noexcept {
         return streams::try_read_tail(
             dst, make_read_file(path));
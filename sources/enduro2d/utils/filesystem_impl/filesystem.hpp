@@ -22,5 +22,8 @@ namespace e2d { namespace filesystem { namespace impl
 
     bool trace_directory(str_view path, const trace_func& func);
 
+    // appends entries of the directory with the 'parent' prefix
+    bool scan_directory(str_view path, str_view parent, directory_scan& dst);
+
     bool extract_predef_path(str& dst, predef_path path_type);
 }}}
@@ -91,35 +91,35 @@ namespace
 namespace e2d { namespace filesystem { namespace impl
 {
     bool remove_file(str_view path) {
-        return 0 == ::unlink(make_utf8(path).c_str())
+        return 0 == ::unlink(path_buffer(path).c_str())
             || errno == ENOENT;
     }
 
     bool remove_directory(str_view path) {
-        return 0 == ::rmdir(make_utf8(path).c_str())
+        return 0 == ::rmdir(path_buffer(path).c_str())
             || errno == ENOENT;
     }
 
     bool file_exists(str_view path) {
         struct stat st{};
-        return 0 == ::stat(make_utf8(path).c_str(), &st)
+        return 0 == ::stat(path_buffer(path).c_str(), &st)
             && S_ISREG(st.st_mode);
     }
 
     bool directory_exists(str_view path) {
         struct stat st{};
-        return 0 == ::stat(make_utf8(path).c_str(), &st)
+        return 0 == ::stat(path_buffer(path).c_str(), &st)
             && S_ISDIR(st.st_mode);
     }
 
     bool create_directory(str_view path) {
-        return 0 == ::mkdir(make_utf8(path).c_str(), default_directory_mode)
+        return 0 == ::mkdir(path_buffer(path).c_str(), default_directory_mode)
             || errno == EEXIST;
     }
 
     bool trace_directory(str_view path, const trace_func& func) {
         std::unique_ptr<DIR, decltype(&::closedir)> dir{
-            ::opendir(make_utf8(path).c_str()),
+            ::opendir(path_buffer(path).c_str()),
             ::closedir};
         if ( !dir ) {
             return false;
@@ -134,6 +134,13 @@ namespace e2d { namespace filesystem { namespace impl
         return true;
     }
 
+    bool scan_directory(str_view path, str_view parent, directory_scan& dst) {
+        return trace_directory(path, [parent, &dst](str_view relative, bool directory){
+            dst.add(parent, relative, directory);
+            return true;
+        });
+    }
+
     bool extract_predef_path(str& dst, predef_path path_type) {
         switch ( path_type ) {
             case predef_path::home:
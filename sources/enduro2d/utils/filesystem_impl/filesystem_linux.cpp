@@ -8,10 +8,12 @@
 
 #if defined(E2D_PLATFORM) && E2D_PLATFORM == E2D_PLATFORM_LINUX
 
+#include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/syscall.h>
 
 namespace
 {
@@ -19,6 +21,45 @@ namespace
 
     const mode_t default_directory_mode = S_IRWXU|S_IRGRP|S_IXGRP|S_IROTH|S_IXOTH;
 
+    // the kernel record of getdents64, glibc has no declaration before 2.30
+    struct linux_dirent64 {
+        ino64_t d_ino;
+        off64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[1];
+    };
+
+    const std::size_t getdents_buffer_size = 32u * 1024u;
+
+    bool scan_directory_fd(int fd, str_view parent, filesystem::directory_scan& dst) {
+        alignas(linux_dirent64) char buf[getdents_buffer_size];
+        for (;;) {
+            const long read_bytes = ::syscall(SYS_getdents64, fd, buf, sizeof(buf));
+            if ( read_bytes < 0 && errno == EINTR ) {
+                continue;
+            }
+            if ( read_bytes <= 0 ) {
+                return read_bytes == 0;
+            }
+            for ( long offset = 0; offset < read_bytes; ) {
+                const linux_dirent64* ent = reinterpret_cast<const linux_dirent64*>(buf + offset);
+                offset += ent->d_reclen;
+                if ( 0 == std::strcmp(ent->d_name, ".") || 0 == std::strcmp(ent->d_name, "..") ) {
+                    continue;
+                }
+                bool directory = DT_DIR == ent->d_type;
+                if ( DT_UNKNOWN == ent->d_type ) {
+                    // some filesystems don't fill the type
+                    struct stat st{};
+                    directory = 0 == ::fstatat(fd, ent->d_name, &st, AT_SYMLINK_NOFOLLOW)
+                        && S_ISDIR(st.st_mode);
+                }
+                dst.add(parent, ent->d_name, directory);
+            }
+        }
+    }
+
     bool extract_home_directory(str& dst) {
         const char* const home_path = std::getenv("HOME");
         if ( home_path ) {
@@ -81,35 +122,35 @@ namespace
 namespace e2d { namespace filesystem { namespace impl
 {
     bool remove_file(str_view path) {
-        return 0 == ::unlink(make_utf8(path).c_str())
+        return 0 == ::unlink(path_buffer(path).c_str())
             || errno == ENOENT;
     }
 
     bool remove_directory(str_view path) {
-        return 0 == ::rmdir(make_utf8(path).c_str())
+        return 0 == ::rmdir(path_buffer(path).c_str())
             || errno == ENOENT;
     }
 
     bool file_exists(str_view path) {
         struct stat st{};
-        return 0 == ::stat(make_utf8(path).c_str(), &st)
+        return 0 == ::stat(path_buffer(path).c_str(), &st)
             && S_ISREG(st.st_mode);
     }
 
     bool directory_exists(str_view path) {
         struct stat st{};
-        return 0 == ::stat(make_utf8(path).c_str(), &st)
+        return 0 == ::stat(path_buffer(path).c_str(), &st)
             && S_ISDIR(st.st_mode);
     }
 
     bool create_directory(str_view path) {
-        return 0 == ::mkdir(make_utf8(path).c_str(), default_directory_mode)
+        return 0 == ::mkdir(path_buffer(path).c_str(), default_directory_mode)
             || errno == EEXIST;
     }
 
     bool trace_directory(str_view path, const trace_func& func) {
         std::unique_ptr<DIR, decltype(&::closedir)> dir{
-            ::opendir(make_utf8(path).c_str()),
+            ::opendir(path_buffer(path).c_str()),
             ::closedir};
         if ( !dir ) {
             return false;
@@ -124,6 +165,21 @@ namespace e2d { namespace filesystem { namespace impl
         return true;
     }
 
+    bool scan_directory(str_view path, str_view parent, directory_scan& dst) {
+        const int fd = ::open(path_buffer(path).c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if ( fd < 0 ) {
+            return false;
+        }
+        try {
+            const bool success = scan_directory_fd(fd, parent, dst);
+            ::close(fd);
+            return success;
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+    }
+
     bool extract_predef_path(str& dst, predef_path path_type) {
         switch ( path_type ) {
             case predef_path::home:
@@ -148,6 +148,13 @@ namespace e2d { namespace filesystem { namespace impl
         return true;
     }
 
+    bool scan_directory(str_view path, str_view parent, directory_scan& dst) {
+        return trace_directory(path, [parent, &dst](str_view relative, bool directory){
+            dst.add(parent, relative, directory);
+            return true;
+        });
+    }
+
     bool extract_predef_path(str& dst, predef_path path_type) {
         switch ( path_type ) {
             case predef_path::home:
@@ -43,6 +43,91 @@ namespace
         E2D_ASSERT(fdesc.format == format);
         return fdesc;
     }
+
+    //
+    // decoder_registry
+    //
+
+    struct decoder_info {
+        str name;
+        i32 priority;
+        images::image_decoder decoder;
+    };
+
+    using decoder_infos = vector<decoder_info>;
+    using decoder_infos_cptr = std::shared_ptr<const decoder_infos>;
+
+    // readers get an immutable snapshot, so decoding threads
+    // never wait for each other or for registrations
+    class decoder_registry final : private noncopyable {
+    public:
+        decoder_registry() {
+            insert("dds", 200, &images::impl::try_load_image_dds);
+            insert("pvr", 200, &images::impl::try_load_image_pvr);
+        #if defined(E2D_IMAGE_WITH_LIBPNG)
+            insert("libpng", 100, &images::impl::try_load_image_libpng);
+        #endif
+        #if defined(E2D_IMAGE_WITH_LIBJPEG)
+            insert("libjpeg", 100, &images::impl::try_load_image_libjpeg);
+        #endif
+            insert("stb", 0, &images::impl::try_load_image_stb);
+        }
+
+        decoder_infos_cptr snapshot() const noexcept {
+            return std::atomic_load(&decoders_);
+        }
+
+        bool insert(str_view name, i32 priority, images::image_decoder decoder) {
+            E2D_ASSERT(decoder);
+            std::lock_guard<std::mutex> guard(mutex_);
+            const decoder_infos_cptr decoders = snapshot();
+            if ( decoders && find_decoder(*decoders, name) != decoders->end() ) {
+                return false;
+            }
+            auto ndecoders = decoders
+                ? std::make_shared<decoder_infos>(*decoders)
+                : std::make_shared<decoder_infos>();
+            const auto iter = std::upper_bound(
+                ndecoders->begin(), ndecoders->end(), priority,
+                [](i32 p, const decoder_info& info) noexcept {
+                    return p > info.priority;
+                });
+            ndecoders->insert(iter, decoder_info{str(name), priority, decoder});
+            std::atomic_store(&decoders_, decoder_infos_cptr(std::move(ndecoders)));
+            return true;
+        }
+
+        bool remove(str_view name) {
+            std::lock_guard<std::mutex> guard(mutex_);
+            const decoder_infos_cptr decoders = snapshot();
+            if ( !decoders || find_decoder(*decoders, name) == decoders->end() ) {
+                return false;
+            }
+            auto ndecoders = std::make_shared<decoder_infos>(*decoders);
+            ndecoders->erase(find_decoder(*ndecoders, name));
+            std::atomic_store(&decoders_, decoder_infos_cptr(std::move(ndecoders)));
+            return true;
+        }
+
+        static decoder_infos::const_iterator find_decoder(
+            const decoder_infos& decoders,
+            str_view name) noexcept
+        {
+            return std::find_if(
+                decoders.begin(), decoders.end(),
+                [name](const decoder_info& info) noexcept {
+                    return info.name == name;
+                });
+        }
+    private:
+        std::mutex mutex_;
+        decoder_infos_cptr decoders_;
+    };
+
+    decoder_registry& get_decoder_registry() {
+        static decoder_registry registry;
+        return registry;
+    }
 }
 
 namespace e2d
@@ -213,9 +298,16 @@ namespace e2d { namespace images
         image& dst,
         const buffer& src) noexcept
     {
-        return impl::try_load_image_dds(dst, src)
-            || impl::try_load_image_pvr(dst, src)
-            || impl::try_load_image_stb(dst, src);
+        try {
+            const decoder_infos_cptr decoders = get_decoder_registry().snapshot();
+            return decoders && std::any_of(
+                decoders->begin(), decoders->end(),
+                [&dst, &src](const decoder_info& info){
+                    return info.decoder(dst, src);
+                });
+        } catch (...) {
+            return false;
+        }
     }
 
     bool try_load_image(
@@ -227,6 +319,24 @@ namespace e2d { namespace images
             && try_load_image(dst, file_data);
     }
 
+    bool try_load_image(
+        image& dst,
+        const buffer& src,
+        str_view decoder) noexcept
+    {
+        try {
+            const decoder_infos_cptr decoders = get_decoder_registry().snapshot();
+            if ( !decoders ) {
+                return false;
+            }
+            const auto iter = decoder_registry::find_decoder(*decoders, decoder);
+            return iter != decoders->end()
+                && iter->decoder(dst, src);
+        } catch (...) {
+            return false;
+        }
+    }
+
     bool try_save_image(
         const image& src,
         image_file_format format,
@@ -259,3 +369,33 @@ namespace e2d { namespace images
             && streams::try_write_tail(file_data, dst);
     }
 }}
+
+namespace e2d { namespace images
+{
+    bool register_decoder(
+        str_view name,
+        i32 priority,
+        image_decoder decoder)
+    {
+        return get_decoder_registry().insert(name, priority, decoder);
+    }
+
+    bool unregister_decoder(str_view name) noexcept {
+        try {
+            return get_decoder_registry().remove(name);
+        } catch (...) {
+            return false;
+        }
+    }
+
+    vector<str> decoder_names() {
+        vector<str> result;
+        if ( const decoder_infos_cptr decoders = get_decoder_registry().snapshot() ) {
+            result.reserve(decoders->size());
+            for ( const decoder_info& info : *decoders ) {
+                result.push_back(info.name);
+            }
+        }
+        return result;
+    }
+}}
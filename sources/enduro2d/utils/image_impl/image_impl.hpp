@@ -15,6 +15,14 @@ namespace e2d { namespace images { namespace impl
     bool try_load_image_pvr(image& dst, const buffer& src) noexcept;
     bool try_load_image_stb(image& dst, const buffer& src) noexcept;
 
+#if defined(E2D_IMAGE_WITH_LIBPNG)
+    bool try_load_image_libpng(image& dst, const buffer& src) noexcept;
+#endif
+
+#if defined(E2D_IMAGE_WITH_LIBJPEG)
+    bool try_load_image_libjpeg(image& dst, const buffer& src) noexcept;
+#endif
+
     bool try_save_image_dds(const image& src, buffer& dst) noexcept;
     bool try_save_image_jpg(const image& src, buffer& dst) noexcept;
     bool try_save_image_png(const image& src, buffer& dst) noexcept;
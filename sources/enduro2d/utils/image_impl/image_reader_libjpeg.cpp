@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "image_impl.hpp"
+
+#if defined(E2D_IMAGE_WITH_LIBJPEG)
+
+#include <csetjmp>
+#include <jpeglib.h>
+
+namespace
+{
+    using namespace e2d;
+
+    struct jpeg_error_context {
+        jpeg_error_mgr mgr;
+        std::jmp_buf jump;
+    };
+
+    void jpeg_error_exit(j_common_ptr cinfo) {
+        jpeg_error_context* ctx = reinterpret_cast<jpeg_error_context*>(cinfo->err);
+        std::longjmp(ctx->jump, 1);
+    }
+
+    void jpeg_output_message(j_common_ptr cinfo) {
+        E2D_UNUSED(cinfo);
+    }
+
+    // libjpeg reports errors by longjmp, so nothing with a destructor
+    // is allowed here, decoded pixels are returned as a malloc'ed block
+    u8* decompress_jpeg(
+        const buffer& src,
+        v2u& out_size,
+        image_data_format& out_format,
+        std::size_t& out_data_size) noexcept
+    {
+        jpeg_decompress_struct cinfo;
+        jpeg_error_context err;
+        u8* volatile pixels = nullptr;
+
+        cinfo.err = jpeg_std_error(&err.mgr);
+        err.mgr.error_exit = &jpeg_error_exit;
+        err.mgr.output_message = &jpeg_output_message;
+
+        if ( setjmp(err.jump) ) {
+            jpeg_destroy_decompress(&cinfo);
+            std::free(pixels);
+            return nullptr;
+        }
+
+        jpeg_create_decompress(&cinfo);
+        jpeg_mem_src(
+            &cinfo,
+            const_cast<unsigned char*>(src.data()),
+            math::numeric_cast<unsigned long>(src.size()));
+
+        if ( jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK ) {
+            jpeg_destroy_decompress(&cinfo);
+            return nullptr;
+        }
+
+        u32 channels = 0;
+        switch ( cinfo.jpeg_color_space ) {
+            case JCS_GRAYSCALE:
+                cinfo.out_color_space = JCS_GRAYSCALE;
+                out_format = image_data_format::g8;
+                channels = 1;
+                break;
+            case JCS_RGB:
+            case JCS_YCbCr:
+                cinfo.out_color_space = JCS_RGB;
+                out_format = image_data_format::rgb8;
+                channels = 3;
+                break;
+            default:
+                // cmyk and friends are left to the next decoder
+                jpeg_destroy_decompress(&cinfo);
+                return nullptr;
+        }
+
+        jpeg_start_decompress(&cinfo);
+        if ( !cinfo.output_width || !cinfo.output_height ) {
+            jpeg_destroy_decompress(&cinfo);
+            return nullptr;
+        }
+
+        const std::size_t row_stride =
+            std::size_t(cinfo.output_width) * channels;
+        const std::size_t data_size =
+            row_stride * std::size_t(cinfo.output_height);
+
+        pixels = static_cast<u8*>(std::malloc(data_size));
+        if ( !pixels ) {
+            jpeg_destroy_decompress(&cinfo);
+            return nullptr;
+        }
+
+        // several scanlines per call let the SIMD upsampler work on row groups
+        JSAMPROW rows[16];
+        while ( cinfo.output_scanline < cinfo.output_height ) {
+            const JDIMENSION row_count = math::min(
+                cinfo.output_height - cinfo.output_scanline,
+                JDIMENSION(E2D_COUNTOF(rows)));
+            for ( JDIMENSION i = 0; i < row_count; ++i ) {
+                rows[i] = pixels + row_stride * (cinfo.output_scanline + i);
+            }
+            jpeg_read_scanlines(&cinfo, rows, row_count);
+        }
+
+        jpeg_finish_decompress(&cinfo);
+        out_size = v2u(cinfo.output_width, cinfo.output_height);
+        out_data_size = data_size;
+        jpeg_destroy_decompress(&cinfo);
+        return pixels;
+    }
+}
+
+namespace e2d { namespace images { namespace impl
+{
+    bool try_load_image_libjpeg(image& dst, const buffer& src) noexcept {
+        const u8* jpeg_signature = src.data();
+        if ( src.size() < 3
+            || jpeg_signature[0] != 0xFF
+            || jpeg_signature[1] != 0xD8
+            || jpeg_signature[2] != 0xFF )
+        {
+            return false;
+        }
+
+        v2u img_size;
+        image_data_format img_format = image_data_format::rgb8;
+        std::size_t img_data_size = 0;
+        u8* img_data = decompress_jpeg(src, img_size, img_format, img_data_size);
+        if ( !img_data ) {
+            return false;
+        }
+
+        buffer img_buffer;
+        img_buffer.adopt(img_data, img_data_size, std::free);
+        dst.assign(img_size, img_format, std::move(img_buffer));
+        return true;
+    }
+}}}
+
+#endif
@@ -0,0 +1,95 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "image_impl.hpp"
+
+#if defined(E2D_IMAGE_WITH_LIBPNG)
+
+#include <png.h>
+
+namespace
+{
+    using namespace e2d;
+
+    class png_image_guard final : private noncopyable {
+    public:
+        png_image_guard() noexcept {
+            std::memset(&image_, 0, sizeof(image_));
+            image_.version = PNG_IMAGE_VERSION;
+        }
+
+        ~png_image_guard() noexcept {
+            png_image_free(&image_);
+        }
+
+        png_image& get() noexcept {
+            return image_;
+        }
+    private:
+        png_image image_;
+    };
+
+    void png_format_to_image_data_format(
+        png_uint_32 png_format,
+        png_uint_32& out_png_format,
+        image_data_format& out_format) noexcept
+    {
+        const bool has_alpha = !!(png_format & PNG_FORMAT_FLAG_ALPHA);
+        const bool has_color = !!(png_format & PNG_FORMAT_FLAG_COLOR);
+        if ( has_color ) {
+            out_png_format = has_alpha ? PNG_FORMAT_RGBA : PNG_FORMAT_RGB;
+            out_format = has_alpha ? image_data_format::rgba8 : image_data_format::rgb8;
+        } else {
+            out_png_format = has_alpha ? PNG_FORMAT_GA : PNG_FORMAT_GRAY;
+            out_format = has_alpha ? image_data_format::ga8 : image_data_format::g8;
+        }
+    }
+}
+
+namespace e2d { namespace images { namespace impl
+{
+    bool try_load_image_libpng(image& dst, const buffer& src) noexcept {
+        if ( src.size() < 8 || png_sig_cmp(src.data(), 0, 8) != 0 ) {
+            return false;
+        }
+
+        png_image_guard img;
+        if ( !png_image_begin_read_from_memory(&img.get(), src.data(), src.size()) ) {
+            return false;
+        }
+
+        png_uint_32 png_format = 0;
+        image_data_format img_format = image_data_format::rgba8;
+        png_format_to_image_data_format(img.get().format, png_format, img_format);
+
+        img.get().format = png_format;
+        const std::size_t img_data_size = PNG_IMAGE_SIZE(img.get());
+        if ( !img.get().width || !img.get().height || !img_data_size ) {
+            return false;
+        }
+
+        // decoded rows go straight to the memory adopted by the image
+        void* img_data = std::malloc(img_data_size);
+        if ( !img_data ) {
+            return false;
+        }
+
+        buffer img_buffer;
+        img_buffer.adopt(img_data, img_data_size, std::free);
+
+        if ( !png_image_finish_read(&img.get(), nullptr, img_buffer.data(), 0, nullptr) ) {
+            return false;
+        }
+
+        dst.assign(
+            v2u(img.get().width, img.get().height),
+            img_format,
+            std::move(img_buffer));
+        return true;
+    }
+}}}
+
+#endif
@@ -59,14 +59,18 @@ namespace
     }
 
     bool image_from_stb_description(
-        image& dst, const stbi_img_uptr& img, const v2u& img_size, u32 img_channels) noexcept
+        image& dst, stbi_img_uptr img, const v2u& img_size, u32 img_channels) noexcept
     {
         try {
             const image_data_format img_format = image_format_from_stb_channels(img_channels);
             if ( img && img_size.x > 0 && img_size.y > 0 ) {
-                buffer img_buffer(
+                // stb pixels are adopted by the image without copying
+                buffer img_buffer;
+                img_buffer.adopt(
                     img.get(),
-                    math::numeric_cast<std::size_t>(img_size.x * img_size.y * img_channels));
+                    math::numeric_cast<std::size_t>(img_size.x * img_size.y * img_channels),
+                    stbi_image_free);
+                img.release();
                 dst.assign(img_size, img_format, std::move(img_buffer));
                 return true;
             }
@@ -82,8 +86,8 @@ namespace e2d { namespace images { namespace impl
     bool try_load_image_stb(image& dst, const buffer& src) noexcept {
         v2u img_size;
         u32 img_channels = 0;
-        const stbi_img_uptr img_ptr = load_stb_image(src, img_size, img_channels);
+        stbi_img_uptr img_ptr = load_stb_image(src, img_size, img_channels);
         return img_ptr
-            && image_from_stb_description(dst, img_ptr, img_size, img_channels);
+            && image_from_stb_description(dst, std::move(img_ptr), img_size, img_channels);
     }
 }}}
@@ -638,6 +638,76 @@ namespace
     }
 }
 
+namespace e2d { namespace impl
+{
+    json_document_storage::json_document_storage(buffer text)
+    : text_(std::move(text))
+    , pool_(math::max<std::size_t>(
+        RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY,
+        text_.size())) {}
+}}
+
+namespace e2d
+{
+    json_document::json_document(buffer text)
+    : json_document_storage(std::move(text))
+    , rapidjson::Document(&pool_) {}
+
+    bool json_document::parse() noexcept {
+        try {
+            if ( text_.empty() || text_.data()[text_.size() - 1u] != 0u ) {
+                const std::size_t text_size = text_.size();
+                text_.resize(text_size + 1u);
+                text_.data()[text_size] = 0u;
+            }
+            return !ParseInsitu(reinterpret_cast<char*>(text_.data())).HasParseError();
+        } catch (...) {
+            // nothing
+        }
+        return false;
+    }
+}
+
+namespace e2d { namespace json_utils
+{
+    input_stream_wrapper::input_stream_wrapper(input_stream& stream, std::size_t buffer_size)
+    : stream_(stream)
+    , buffer_(math::max<std::size_t>(buffer_size, 1u)) {
+        cur_ = end_ = buffer_.data();
+        fill_if_empty_();
+    }
+
+    input_stream_wrapper::Ch* input_stream_wrapper::PutBegin() {
+        E2D_ASSERT_MSG(false, "unsupported operation");
+        return nullptr;
+    }
+
+    void input_stream_wrapper::Put(Ch c) {
+        E2D_UNUSED(c);
+        E2D_ASSERT_MSG(false, "unsupported operation");
+    }
+
+    void input_stream_wrapper::Flush() {
+        E2D_ASSERT_MSG(false, "unsupported operation");
+    }
+
+    std::size_t input_stream_wrapper::PutEnd(Ch* begin) {
+        E2D_UNUSED(begin);
+        E2D_ASSERT_MSG(false, "unsupported operation");
+        return 0u;
+    }
+
+    void input_stream_wrapper::fill_if_empty_() {
+        if ( cur_ != end_ ) {
+            return;
+        }
+        consumed_ += math::numeric_cast<std::size_t>(end_ - buffer_.data());
+        const std::size_t read_bytes = stream_.read(buffer_.data(), buffer_.size());
+        cur_ = buffer_.data();
+        end_ = buffer_.data() + read_bytes;
+    }
+}}
+
 namespace e2d { namespace json_utils
 {
     void add_common_schema_definitions(rapidjson::Document& schema) {
@@ -0,0 +1,589 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/utils/pack.hpp>
+
+namespace
+{
+    using namespace e2d;
+
+    const u32 pack_file_version = 1u;
+    const str_view pack_file_signature = "e2d_pack";
+
+    const std::size_t pack_header_size =
+        8u + sizeof(u32) + sizeof(u32) + sizeof(u64);
+
+    struct pack_index_record {
+        u64 hash;
+        u64 offset;
+        u64 packed_size;
+        u64 size;
+        u32 name_offset;
+        u32 name_size;
+        u8 codec;
+        u8 padding[7];
+    };
+
+    static_assert(
+        sizeof(pack_index_record) == 48u,
+        "unexpected pack index record size");
+
+    std::size_t align_pack_offset(std::size_t offset) noexcept {
+        return (offset + pack_alignment - 1u) / pack_alignment * pack_alignment;
+    }
+
+    //
+    // lz4 block format
+    //
+    // https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+    // greedy single-probe compressor, safe decompressor
+    //
+
+    const std::size_t lz4_min_match = 4u;
+    const std::size_t lz4_last_literals = 5u;
+    const std::size_t lz4_match_find_limit = 12u;
+    const std::size_t lz4_max_distance = 65535u;
+    const std::size_t lz4_hash_log = 12u;
+
+    u32 lz4_read32(const u8* p) noexcept {
+        u32 v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    u32 lz4_hash(u32 sequence) noexcept {
+        return (sequence * 2654435761u) >> (32u - lz4_hash_log);
+    }
+
+    u8* lz4_write_length(u8* op, std::size_t length) noexcept {
+        for ( ; length >= 255u; length -= 255u ) {
+            *op++ = 255u;
+        }
+        *op++ = static_cast<u8>(length);
+        return op;
+    }
+
+    std::size_t lz4_compress_bound(std::size_t size) noexcept {
+        return size + size / 255u + 16u;
+    }
+
+    u8* lz4_write_sequence(
+        u8* op,
+        const u8* literals,
+        std::size_t literal_count,
+        std::size_t offset,
+        std::size_t match_length) noexcept
+    {
+        u8* token = op++;
+        *token = static_cast<u8>(math::min(literal_count, std::size_t(15u)) << 4u);
+        if ( literal_count >= 15u ) {
+            op = lz4_write_length(op, literal_count - 15u);
+        }
+        std::memcpy(op, literals, literal_count);
+        op += literal_count;
+
+        if ( match_length ) {
+            *op++ = static_cast<u8>(offset & 0xFFu);
+            *op++ = static_cast<u8>(offset >> 8u);
+            const std::size_t ml = match_length - lz4_min_match;
+            *token |= static_cast<u8>(math::min(ml, std::size_t(15u)));
+            if ( ml >= 15u ) {
+                op = lz4_write_length(op, ml - 15u);
+            }
+        }
+        return op;
+    }
+
+    std::size_t lz4_compress(const u8* src, std::size_t src_size, u8* dst) noexcept {
+        u8* op = dst;
+        const u8* ip = src;
+        const u8* anchor = src;
+        const u8* const end = src + src_size;
+
+        if ( src_size > lz4_match_find_limit ) {
+            const u8* const match_find_end = end - lz4_match_find_limit;
+            const u8* const match_end = end - lz4_last_literals;
+
+            std::array<u32, 1u << lz4_hash_log> table;
+            table.fill(0u);
+
+            while ( ip < match_find_end ) {
+                const u32 sequence = lz4_read32(ip);
+                const u32 h = lz4_hash(sequence);
+                const u8* ref = src + table[h];
+                table[h] = static_cast<u32>(ip - src);
+
+                if ( ref < ip
+                    && static_cast<std::size_t>(ip - ref) <= lz4_max_distance
+                    && lz4_read32(ref) == sequence )
+                {
+                    std::size_t match_length = lz4_min_match;
+                    while ( ip + match_length < match_end && ref[match_length] == ip[match_length] ) {
+                        ++match_length;
+                    }
+                    op = lz4_write_sequence(
+                        op,
+                        anchor,
+                        static_cast<std::size_t>(ip - anchor),
+                        static_cast<std::size_t>(ip - ref),
+                        match_length);
+                    ip += match_length;
+                    anchor = ip;
+                } else {
+                    ++ip;
+                }
+            }
+        }
+
+        op = lz4_write_sequence(
+            op,
+            anchor,
+            static_cast<std::size_t>(end - anchor),
+            0u,
+            0u);
+        return static_cast<std::size_t>(op - dst);
+    }
+
+    bool lz4_read_length(const u8*& ip, const u8* iend, std::size_t& length) noexcept {
+        u8 b = 255u;
+        while ( b == 255u ) {
+            if ( ip >= iend ) {
+                return false;
+            }
+            b = *ip++;
+            length += b;
+        }
+        return true;
+    }
+
+    bool lz4_decompress(const u8* src, std::size_t src_size, u8* dst, std::size_t dst_size) noexcept {
+        const u8* ip = src;
+        const u8* const iend = src + src_size;
+        u8* op = dst;
+        u8* const oend = dst + dst_size;
+
+        while ( ip < iend ) {
+            const u8 token = *ip++;
+
+            std::size_t literal_count = token >> 4u;
+            if ( literal_count == 15u && !lz4_read_length(ip, iend, literal_count) ) {
+                return false;
+            }
+            if ( literal_count > static_cast<std::size_t>(iend - ip)
+                || literal_count > static_cast<std::size_t>(oend - op) )
+            {
+                return false;
+            }
+            std::memcpy(op, ip, literal_count);
+            ip += literal_count;
+            op += literal_count;
+
+            if ( ip == iend ) {
+                break;
+            }
+
+            if ( iend - ip < 2 ) {
+                return false;
+            }
+            const std::size_t offset = std::size_t(ip[0]) | (std::size_t(ip[1]) << 8u);
+            ip += 2;
+            if ( !offset || offset > static_cast<std::size_t>(op - dst) ) {
+                return false;
+            }
+
+            std::size_t match_length = token & 0x0Fu;
+            if ( match_length == 15u && !lz4_read_length(ip, iend, match_length) ) {
+                return false;
+            }
+            match_length += lz4_min_match;
+            if ( match_length > static_cast<std::size_t>(oend - op) ) {
+                return false;
+            }
+
+            const u8* match = op - offset;
+            if ( offset >= match_length ) {
+                std::memcpy(op, match, match_length);
+                op += match_length;
+            } else {
+                for ( std::size_t i = 0; i < match_length; ++i ) {
+                    *op++ = *match++;
+                }
+            }
+        }
+
+        return op == oend;
+    }
+}
+
+namespace e2d
+{
+    //
+    // pack_writer::internal_state
+    //
+
+    class pack_writer::internal_state final : private noncopyable {
+    public:
+        output_stream_uptr stream;
+        vector<pack_index_record> records;
+        hash_set<u64> hashes;
+        str names;
+        std::size_t offset{0u};
+        buffer packed;
+    public:
+        internal_state(output_stream_uptr nstream)
+        : stream(std::move(nstream)) {
+            if ( stream ) {
+                const u32 entry_count = 0u;
+                const u64 index_offset = 0u;
+                const bool success = output_sequence(*stream)
+                    .write(pack_file_signature.data(), pack_file_signature.size())
+                    .write(pack_file_version)
+                    .write(entry_count)
+                    .write(index_offset)
+                    .success();
+                if ( success ) {
+                    offset = pack_header_size;
+                } else {
+                    stream.reset();
+                }
+            }
+        }
+
+        bool write_padding(std::size_t size) {
+            static const std::array<u8, 256u> zeros{{0u}};
+            output_sequence oseq(*stream);
+            while ( size > 0u && oseq.success() ) {
+                const std::size_t chunk = math::min(size, zeros.size());
+                oseq.write(zeros.data(), chunk);
+                size -= chunk;
+                offset += chunk;
+            }
+            return oseq.success();
+        }
+    };
+
+    pack_writer::pack_writer(output_stream_uptr stream)
+    : state_(new internal_state(std::move(stream))) {}
+    pack_writer::~pack_writer() noexcept = default;
+
+    bool pack_writer::valid() const noexcept {
+        return !!state_->stream;
+    }
+
+    bool pack_writer::add(str_view path, buffer_view content, pack_codec codec) {
+        if ( !valid() || path.empty() ) {
+            return false;
+        }
+
+        // names are compared only on a hash collision
+        const u64 hash = packs::path_hash(path);
+        if ( state_->hashes.count(hash) ) {
+            const auto same_path = std::find_if(
+                state_->records.begin(), state_->records.end(),
+                [this, hash, &path](const pack_index_record& r) noexcept {
+                    return r.hash == hash
+                        && path == str_view(state_->names.data() + r.name_offset, r.name_size);
+                });
+            if ( same_path != state_->records.end() ) {
+                return false;
+            }
+        }
+
+        buffer_view data = content;
+        if ( codec != pack_codec::store ) {
+            if ( packs::try_compress(codec, content, state_->packed)
+                && state_->packed.size() < content.size() )
+            {
+                data = state_->packed;
+            } else {
+                codec = pack_codec::store;
+            }
+        }
+
+        if ( !state_->write_padding(align_pack_offset(state_->offset) - state_->offset) ) {
+            state_->stream.reset();
+            return false;
+        }
+
+        pack_index_record record;
+        std::memset(&record, 0, sizeof(record));
+        record.hash = hash;
+        record.offset = state_->offset;
+        record.packed_size = data.size();
+        record.size = content.size();
+        record.name_offset = math::numeric_cast<u32>(state_->names.size());
+        record.name_size = math::numeric_cast<u32>(path.size());
+        record.codec = static_cast<u8>(codec);
+
+        if ( !output_sequence(*state_->stream).write(data.data(), data.size()).success() ) {
+            state_->stream.reset();
+            return false;
+        }
+
+        state_->offset += data.size();
+        state_->names.append(path.data(), path.size());
+        state_->records.push_back(record);
+        state_->hashes.insert(hash);
+        return true;
+    }
+
+    bool pack_writer::finish() {
+        if ( !valid() ) {
+            return false;
+        }
+
+        std::sort(
+            state_->records.begin(), state_->records.end(),
+            [this](const pack_index_record& l, const pack_index_record& r) noexcept {
+                return l.hash != r.hash
+                    ? l.hash < r.hash
+                    : str_view(state_->names.data() + l.name_offset, l.name_size)
+                    < str_view(state_->names.data() + r.name_offset, r.name_size);
+            });
+
+        if ( !state_->write_padding(align_pack_offset(state_->offset) - state_->offset) ) {
+            state_->stream.reset();
+            return false;
+        }
+
+        const u32 entry_count = math::numeric_cast<u32>(state_->records.size());
+        const u64 index_offset = state_->offset;
+
+        const bool success = output_sequence(*state_->stream)
+            .write(state_->records.data(), state_->records.size() * sizeof(pack_index_record))
+            .write(state_->names.data(), state_->names.size())
+            .seek(math::numeric_cast<std::ptrdiff_t>(pack_file_signature.size() + sizeof(u32)), false)
+            .write(entry_count)
+            .write(index_offset)
+            .flush()
+            .success();
+
+        state_->stream.reset();
+        return success;
+    }
+
+    //
+    // pack_reader::internal_state
+    //
+
+    class pack_reader::internal_state final : private noncopyable {
+    public:
+        input_stream_uptr stream;
+        vector<entry> entries;
+        mutable std::mutex mutex;
+    public:
+        internal_state(input_stream_uptr nstream)
+        : stream(std::move(nstream)) {
+            if ( !stream || !load_index_() ) {
+                stream.reset();
+                entries.clear();
+            }
+        }
+    private:
+        bool load_index_() {
+            input_sequence iseq(*stream);
+
+            u32 file_version = 0u;
+            u32 entry_count = 0u;
+            u64 index_offset = 0u;
+            char* file_signature = static_cast<char*>(E2D_CLEAR_ALLOCA(
+                pack_file_signature.length() + 1));
+
+            iseq.read(file_signature, pack_file_signature.length())
+                .read(file_version)
+                .read(entry_count)
+                .read(index_offset);
+
+            if ( !iseq.success()
+                || pack_file_signature != file_signature
+                || pack_file_version != file_version )
+            {
+                return false;
+            }
+
+            const std::size_t length = stream->length();
+            const std::size_t records_size = entry_count * sizeof(pack_index_record);
+            if ( index_offset > length || records_size > length - index_offset ) {
+                return false;
+            }
+
+            vector<pack_index_record> records(entry_count);
+            str names(length - index_offset - records_size, '\0');
+            iseq.seek(math::numeric_cast<std::ptrdiff_t>(index_offset), false)
+                .read(records.data(), records_size)
+                .read(&names[0], names.size());
+            if ( !iseq.success() ) {
+                return false;
+            }
+
+            entries.reserve(records.size());
+            for ( const pack_index_record& r : records ) {
+                if ( r.codec > static_cast<u8>(pack_codec::lz4)
+                    || r.name_offset > names.size()
+                    || r.name_size > names.size() - r.name_offset
+                    || r.offset > index_offset
+                    || r.packed_size > index_offset - r.offset )
+                {
+                    return false;
+                }
+                entry e;
+                e.path.assign(names.data() + r.name_offset, r.name_size);
+                e.hash = r.hash;
+                e.offset = r.offset;
+                e.packed_size = r.packed_size;
+                e.size = r.size;
+                e.codec = static_cast<pack_codec>(r.codec);
+                entries.push_back(std::move(e));
+            }
+
+            return std::is_sorted(entries.begin(), entries.end(),
+                [](const entry& l, const entry& r) noexcept {
+                    return l.hash < r.hash;
+                });
+        }
+    };
+
+    pack_reader::pack_reader(input_stream_uptr stream)
+    : state_(new internal_state(std::move(stream))) {}
+    pack_reader::~pack_reader() noexcept = default;
+
+    bool pack_reader::valid() const noexcept {
+        return !!state_->stream;
+    }
+
+    const vector<pack_reader::entry>& pack_reader::entries() const noexcept {
+        return state_->entries;
+    }
+
+    const pack_reader::entry* pack_reader::find(str_view path) const noexcept {
+        const u64 hash = packs::path_hash(path);
+        auto iter = std::lower_bound(
+            state_->entries.begin(), state_->entries.end(), hash,
+            [](const entry& e, u64 h) noexcept {
+                return e.hash < h;
+            });
+        for ( ; iter != state_->entries.end() && iter->hash == hash; ++iter ) {
+            if ( iter->path == path ) {
+                return &*iter;
+            }
+        }
+        return nullptr;
+    }
+
+    bool pack_reader::read(const entry& e, buffer& dst) const noexcept {
+        try {
+            if ( !valid() ) {
+                return false;
+            }
+
+            buffer packed(math::numeric_cast<std::size_t>(e.packed_size));
+            {
+                std::lock_guard<std::mutex> guard(state_->mutex);
+                const bool success = input_sequence(*state_->stream)
+                    .seek(math::numeric_cast<std::ptrdiff_t>(e.offset), false)
+                    .read(packed.data(), packed.size())
+                    .success();
+                if ( !success ) {
+                    return false;
+                }
+            }
+
+            if ( e.codec == pack_codec::store ) {
+                if ( packed.size() != e.size ) {
+                    return false;
+                }
+                dst = std::move(packed);
+                return true;
+            }
+
+            return packs::try_decompress(
+                e.codec,
+                packed,
+                math::numeric_cast<std::size_t>(e.size),
+                dst);
+        } catch (...) {
+            return false;
+        }
+    }
+}
+
+namespace e2d { namespace packs
+{
+    u64 path_hash(str_view path) noexcept {
+        // fnv-1a, it's a part of the file format
+        u64 hash = 14695981039346656037ull;
+        for ( const char c : path ) {
+            hash ^= static_cast<u8>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool try_compress(
+        pack_codec codec,
+        buffer_view src,
+        buffer& dst) noexcept
+    {
+        try {
+            switch ( codec ) {
+                case pack_codec::store:
+                    dst.assign(src.data(), src.size());
+                    return true;
+                case pack_codec::lz4: {
+                    buffer packed(lz4_compress_bound(src.size()));
+                    const std::size_t packed_size = lz4_compress(
+                        static_cast<const u8*>(src.data()),
+                        src.size(),
+                        packed.data());
+                    E2D_ASSERT(packed_size <= packed.size());
+                    dst.assign(packed.data(), packed_size);
+                    return true;
+                }
+                default:
+                    E2D_ASSERT_MSG(false, "unexpected pack codec");
+                    return false;
+            }
+        } catch (...) {
+            return false;
+        }
+    }
+
+    bool try_decompress(
+        pack_codec codec,
+        buffer_view src,
+        std::size_t dst_size,
+        buffer& dst) noexcept
+    {
+        try {
+            switch ( codec ) {
+                case pack_codec::store:
+                    if ( src.size() != dst_size ) {
+                        return false;
+                    }
+                    dst.assign(src.data(), src.size());
+                    return true;
+                case pack_codec::lz4: {
+                    buffer unpacked(dst_size);
+                    if ( !lz4_decompress(
+                        static_cast<const u8*>(src.data()),
+                        src.size(),
+                        unpacked.data(),
+                        unpacked.size()) )
+                    {
+                        return false;
+                    }
+                    dst = std::move(unpacked);
+                    return true;
+                }
+                default:
+                    E2D_ASSERT_MSG(false, "unexpected pack codec");
+                    return false;
+            }
+        } catch (...) {
+            return false;
+        }
+    }
+}}
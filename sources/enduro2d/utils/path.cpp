@@ -12,11 +12,19 @@ namespace
 
     const str_view dot = ".";
     const str_view dot_dot = "..";
-    const str_view path_separators = "/\\";
 
     bool is_directory_separator(char ch) noexcept {
-        return path_separators.cend() != std::find(
-            path_separators.cbegin(), path_separators.cend(), ch);
+        return ch == '/' || ch == '\\';
+    }
+
+    bool is_str_view_of(str_view v, const char* data, std::size_t size) noexcept {
+        return !v.empty()
+            && std::less_equal<const char*>()(data, v.data())
+            && std::less<const char*>()(v.data(), data + size + 1u);
+    }
+
+    bool is_str_view_of(str_view v, const str& s) noexcept {
+        return is_str_view_of(v, s.data(), s.size());
     }
 
     str str_view_concat(str_view v1, str_view v2) {
@@ -52,84 +60,315 @@ namespace e2d { namespace path
     }
 
     str remove_filename(str_view path) {
-        const str name = filename(path);
-        return name.empty()
-            ? path
-            : path.substr(0, path.length() - name.length());
+        return remove_filename_view(path);
     }
 
     str remove_extension(str_view path) {
-        const str ext = extension(path);
-        return ext.empty()
-            ? path
-            : path.substr(0, path.length() - ext.length());
+        return remove_extension_view(path);
     }
 
     str replace_filename(str_view path, str_view filename) {
-        const str without_name = remove_filename(path);
-        return str_view_concat(without_name, filename);
+        return str_view_concat(remove_filename_view(path), filename);
     }
 
     str replace_extension(str_view path, str_view extension) {
-        const str without_ext = remove_extension(path);
+        const str_view without_ext = remove_extension_view(path);
         return extension.empty()
-            ? without_ext
+            ? str(without_ext)
             : (extension.front() == '.'
                 ? str_view_concat(without_ext, extension)
                 : str_view_concat(without_ext, dot, extension));
     }
 
     str stem(str_view path) {
-        const str name = filename(path);
+        return stem_view(path);
+    }
+
+    str filename(str_view path) {
+        return filename_view(path);
+    }
+
+    str extension(str_view path) {
+        return extension_view(path);
+    }
+
+    str parent_path(str_view path) {
+        return parent_path_view(path);
+    }
+
+    bool is_absolute(str_view path) noexcept {
+        return
+            (path.size() >= 1 && (path[0] == '/' || path[0] == '\\')) ||
+            (path.size() >= 2 && path[1] == ':');
+    }
+
+    bool is_relative(str_view path) noexcept {
+        return !is_absolute(path);
+    }
+}}
+
+namespace e2d { namespace path
+{
+    str_view remove_filename_view(str_view path) noexcept {
+        const str_view name = filename_view(path);
+        return str_view(path.data(), path.size() - name.size());
+    }
+
+    str_view remove_extension_view(str_view path) noexcept {
+        const str_view ext = extension_view(path);
+        return str_view(path.data(), path.size() - ext.size());
+    }
+
+    str_view stem_view(str_view path) noexcept {
+        const str_view name = filename_view(path);
         if ( name.empty() || name == dot || name == dot_dot ) {
             return name;
         }
-        const str::size_type ext_pos = name.rfind('.');
-        return ext_pos != str::npos
-            ? name.substr(0, ext_pos)
-            : name;
+        const str_view ext = extension_view(name);
+        return str_view(name.data(), name.size() - ext.size());
     }
 
-    str filename(str_view path) {
+    str_view filename_view(str_view path) noexcept {
         const auto sep_e = std::find_if(
             path.crbegin(), path.crend(), &is_directory_separator);
         const auto sep_d = std::distance(sep_e, path.crend());
-        return path.substr(static_cast<std::size_t>(sep_d));
+        return str_view(
+            path.data() + sep_d,
+            path.size() - static_cast<std::size_t>(sep_d));
     }
 
-    str extension(str_view path) {
-        const str name = filename(path);
+    str_view extension_view(str_view path) noexcept {
+        const str_view name = filename_view(path);
         if ( name.empty() || name == dot || name == dot_dot ) {
-            return str();
+            return str_view();
         }
-        const str::size_type ext_pos = name.rfind('.');
-        return ext_pos != str::npos
-            ? name.substr(ext_pos)
-            : str();
+        const auto ext_e = std::find(name.crbegin(), name.crend(), '.');
+        if ( ext_e == name.crend() ) {
+            return str_view();
+        }
+        const auto ext_d = std::distance(ext_e, name.crend()) - 1;
+        return str_view(
+            name.data() + ext_d,
+            name.size() - static_cast<std::size_t>(ext_d));
     }
 
-    str parent_path(str_view path) {
+    str_view parent_path_view(str_view path) noexcept {
         const auto sep_e = std::find_if(
             path.crbegin(), path.crend(), &is_directory_separator);
         if ( sep_e == path.crend() ) {
-            return str();
+            return str_view();
         }
         const auto sep_b = std::find_if_not(
             sep_e, path.crend(), &is_directory_separator);
         if ( sep_b == path.crend() ) {
-            return str();
+            return str_view();
         }
         const auto sep_d = std::distance(sep_b, path.crend());
-        return path.substr(0, static_cast<std::size_t>(sep_d));
+        return str_view(path.data(), static_cast<std::size_t>(sep_d));
     }
 
-    bool is_absolute(str_view path) noexcept {
-        return
-            (path.size() >= 1 && (path[0] == '/' || path[0] == '\\')) ||
-            (path.size() >= 2 && path[1] == ':');
+    str& combine_to(str& dst, str_view lhs, str_view rhs) {
+        if ( lhs.empty() || is_absolute(rhs) ) {
+            return dst.assign(rhs.data(), rhs.size());
+        }
+        if ( rhs.empty() ) {
+            return dst.assign(lhs.data(), lhs.size());
+        }
+        if ( is_str_view_of(rhs, dst) ) {
+            return combine_to(dst, lhs, str(rhs));
+        }
+        if ( lhs.data() == dst.data() ) {
+            dst.resize(lhs.size());
+        } else {
+            dst.assign(lhs.data(), lhs.size());
+        }
+        if ( !is_directory_separator(lhs.back()) ) {
+            dst.push_back('/');
+        }
+        return dst.append(rhs.data(), rhs.size());
     }
+}}
 
-    bool is_relative(str_view path) noexcept {
-        return !is_absolute(path);
+namespace e2d
+{
+    path_buffer::path_buffer() noexcept {
+        inline_[0] = '\0';
     }
-}}
+
+    path_buffer::path_buffer(path_buffer&& other) noexcept
+    : path_buffer() {
+        assign(std::move(other));
+    }
+
+    path_buffer& path_buffer::operator=(path_buffer&& other) noexcept {
+        return assign(std::move(other));
+    }
+
+    path_buffer::path_buffer(const path_buffer& other)
+    : path_buffer() {
+        assign(other);
+    }
+
+    path_buffer& path_buffer::operator=(const path_buffer& other) {
+        return assign(other);
+    }
+
+    path_buffer::path_buffer(str_view path)
+    : path_buffer() {
+        assign(path);
+    }
+
+    path_buffer::path_buffer(str_view lhs, str_view rhs)
+    : path_buffer() {
+        assign(lhs);
+        append(rhs);
+    }
+
+    path_buffer& path_buffer::assign(path_buffer&& other) noexcept {
+        if ( this != &other ) {
+            if ( other.on_heap_ ) {
+                heap_ = std::move(other.heap_);
+                on_heap_ = true;
+                size_ = other.size_;
+            } else {
+                clear();
+                std::memcpy(inline_.data(), other.inline_.data(), other.size_ + 1u);
+                size_ = other.size_;
+            }
+            other.clear();
+        }
+        return *this;
+    }
+
+    path_buffer& path_buffer::assign(const path_buffer& other) {
+        return this != &other
+            ? assign(other.view())
+            : *this;
+    }
+
+    path_buffer& path_buffer::assign(str_view path) {
+        if ( overlaps_(path) ) {
+            return assign(str(path));
+        }
+        clear();
+        return concat(path);
+    }
+
+    path_buffer& path_buffer::append(str_view path) {
+        if ( empty() || path::is_absolute(path) ) {
+            return assign(path);
+        }
+        if ( path.empty() ) {
+            return *this;
+        }
+        if ( overlaps_(path) ) {
+            return append(str(path));
+        }
+        if ( !is_directory_separator(view().back()) ) {
+            concat("/");
+        }
+        return concat(path);
+    }
+
+    path_buffer& path_buffer::concat(str_view path) {
+        if ( path.empty() ) {
+            return *this;
+        }
+        if ( overlaps_(path) ) {
+            return concat(str(path));
+        }
+        char* dst = reserve_(size_ + path.size());
+        std::memcpy(dst + size_, path.data(), path.size());
+        commit_(size_ + path.size());
+        return *this;
+    }
+
+    path_buffer& path_buffer::replace_filename(str_view filename) {
+        if ( overlaps_(filename) ) {
+            return replace_filename(str(filename));
+        }
+        commit_(path::remove_filename_view(view()).size());
+        return concat(filename);
+    }
+
+    path_buffer& path_buffer::replace_extension(str_view extension) {
+        if ( overlaps_(extension) ) {
+            return replace_extension(str(extension));
+        }
+        commit_(path::remove_extension_view(view()).size());
+        if ( extension.empty() ) {
+            return *this;
+        }
+        if ( extension.front() != '.' ) {
+            concat(dot);
+        }
+        return concat(extension);
+    }
+
+    void path_buffer::clear() noexcept {
+        heap_.clear();
+        on_heap_ = false;
+        size_ = 0u;
+        inline_[0] = '\0';
+    }
+
+    bool path_buffer::empty() const noexcept {
+        return size_ == 0u;
+    }
+
+    std::size_t path_buffer::size() const noexcept {
+        return size_;
+    }
+
+    bool path_buffer::on_heap() const noexcept {
+        return on_heap_;
+    }
+
+    const char* path_buffer::c_str() const noexcept {
+        return on_heap_
+            ? heap_.c_str()
+            : inline_.data();
+    }
+
+    str_view path_buffer::view() const noexcept {
+        return str_view(c_str(), size_);
+    }
+
+    path_buffer::operator str_view() const noexcept {
+        return view();
+    }
+
+    char* path_buffer::reserve_(std::size_t nsize) {
+        if ( !on_heap_ ) {
+            if ( nsize < inline_capacity ) {
+                return inline_.data();
+            }
+            heap_.assign(inline_.data(), size_);
+            on_heap_ = true;
+        }
+        heap_.resize(math::max(nsize, heap_.size()));
+        return &heap_[0];
+    }
+
+    void path_buffer::commit_(std::size_t nsize) noexcept {
+        E2D_ASSERT(nsize < inline_capacity || on_heap_);
+        size_ = nsize;
+        if ( on_heap_ ) {
+            heap_.resize(nsize);
+        } else {
+            inline_[nsize] = '\0';
+        }
+    }
+
+    bool path_buffer::overlaps_(str_view path) const noexcept {
+        return is_str_view_of(path, c_str(), size_);
+    }
+
+    bool operator==(const path_buffer& l, str_view r) noexcept {
+        return l.view() == r;
+    }
+
+    bool operator!=(const path_buffer& l, str_view r) noexcept {
+        return !(l == r);
+    }
+}
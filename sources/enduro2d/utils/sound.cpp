@@ -0,0 +1,172 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "sound_impl/sound_impl.hpp"
+
+namespace e2d
+{
+    sound::sound(sound&& other) noexcept {
+        assign(std::move(other));
+    }
+
+    sound& sound::operator=(sound&& other) noexcept {
+        return assign(std::move(other));
+    }
+
+    sound::sound(const sound& other) {
+        assign(other);
+    }
+
+    sound& sound::operator=(const sound& other) {
+        return assign(other);
+    }
+
+    sound::sound(u32 channels, u32 sample_rate, vector<f32>&& samples) noexcept {
+        assign(channels, sample_rate, std::move(samples));
+    }
+
+    sound::sound(u32 channels, u32 sample_rate, const vector<f32>& samples) {
+        assign(channels, sample_rate, samples);
+    }
+
+    sound& sound::assign(sound&& other) noexcept {
+        if ( this != &other ) {
+            swap(other);
+            other.clear();
+        }
+        return *this;
+    }
+
+    sound& sound::assign(const sound& other) {
+        if ( this != &other ) {
+            samples_ = other.samples_;
+            channels_ = other.channels_;
+            sample_rate_ = other.sample_rate_;
+        }
+        return *this;
+    }
+
+    sound& sound::assign(u32 channels, u32 sample_rate, vector<f32>&& samples) noexcept {
+        E2D_ASSERT(channels > 0 || samples.empty());
+        E2D_ASSERT(!channels || samples.size() % channels == 0);
+        samples_ = std::move(samples);
+        channels_ = channels;
+        sample_rate_ = sample_rate;
+        return *this;
+    }
+
+    sound& sound::assign(u32 channels, u32 sample_rate, const vector<f32>& samples) {
+        E2D_ASSERT(channels > 0 || samples.empty());
+        E2D_ASSERT(!channels || samples.size() % channels == 0);
+        samples_ = samples;
+        channels_ = channels;
+        sample_rate_ = sample_rate;
+        return *this;
+    }
+
+    void sound::swap(sound& other) noexcept {
+        using std::swap;
+        swap(samples_, other.samples_);
+        swap(channels_, other.channels_);
+        swap(sample_rate_, other.sample_rate_);
+    }
+
+    void sound::clear() noexcept {
+        samples_.clear();
+        channels_ = 0;
+        sample_rate_ = 0;
+    }
+
+    bool sound::empty() const noexcept {
+        return samples_.empty();
+    }
+
+    u32 sound::channels() const noexcept {
+        return channels_;
+    }
+
+    u32 sound::sample_rate() const noexcept {
+        return sample_rate_;
+    }
+
+    std::size_t sound::frame_count() const noexcept {
+        return channels_
+            ? samples_.size() / channels_
+            : 0u;
+    }
+
+    const vector<f32>& sound::samples() const noexcept {
+        return samples_;
+    }
+}
+
+namespace e2d
+{
+    void swap(sound& l, sound& r) noexcept {
+        l.swap(r);
+    }
+
+    bool operator==(const sound& l, const sound& r) noexcept {
+        return l.channels() == r.channels()
+            && l.sample_rate() == r.sample_rate()
+            && l.samples() == r.samples();
+    }
+
+    bool operator!=(const sound& l, const sound& r) noexcept {
+        return !(l == r);
+    }
+}
+
+namespace e2d { namespace sounds
+{
+    bool try_load_sound(
+        sound& dst,
+        const buffer& src) noexcept
+    {
+        return impl::try_load_sound_wav(dst, src);
+    }
+
+    bool try_load_sound(
+        sound& dst,
+        const input_stream_uptr& src) noexcept
+    {
+        buffer file_data;
+        return streams::try_read_tail(file_data, src)
+            && try_load_sound(dst, file_data);
+    }
+
+    bool try_save_sound(
+        const sound& src,
+        sound_file_format format,
+        buffer& dst) noexcept
+    {
+        switch ( format ) {
+            case sound_file_format::wav:
+                return impl::try_save_sound_wav(src, dst);
+            default:
+                E2D_ASSERT_MSG(false, "unexpected sound file format");
+                return false;
+        }
+    }
+
+    bool try_save_sound(
+        const sound& src,
+        sound_file_format format,
+        const output_stream_uptr& dst) noexcept
+    {
+        buffer file_data;
+        return try_save_sound(src, format, file_data)
+            && streams::try_write_tail(file_data, dst);
+    }
+
+    sound_stream_uptr try_open_sound_stream(
+        input_stream_uptr src) noexcept
+    {
+        return src
+            ? impl::try_open_sound_stream_wav(std::move(src))
+            : nullptr;
+    }
+}}
@@ -0,0 +1,17 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#pragma once
+
+#include <enduro2d/utils/sound.hpp>
+#include <enduro2d/utils/buffer.hpp>
+
+namespace e2d { namespace sounds { namespace impl
+{
+    bool try_load_sound_wav(sound& dst, const buffer& src) noexcept;
+    bool try_save_sound_wav(const sound& src, buffer& dst) noexcept;
+    sound_stream_uptr try_open_sound_stream_wav(input_stream_uptr src) noexcept;
+}}}
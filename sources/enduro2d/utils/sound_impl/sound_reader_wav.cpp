@@ -0,0 +1,261 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "sound_impl.hpp"
+
+namespace
+{
+    using namespace e2d;
+
+    const u16 wav_format_pcm = 0x0001;
+    const u16 wav_format_float = 0x0003;
+    const u16 wav_format_extensible = 0xFFFE;
+
+    struct wav_format {
+        u16 format_tag = 0;
+        u16 channels = 0;
+        u32 sample_rate = 0;
+        u16 block_align = 0;
+        u16 bits_per_sample = 0;
+        std::size_t data_offset = 0;
+        std::size_t data_size = 0;
+    };
+
+    bool check_fourcc(const char (&fourcc)[4], const char* expected) noexcept {
+        return 0 == std::memcmp(fourcc, expected, sizeof(fourcc));
+    }
+
+    bool is_supported_format(const wav_format& fmt) noexcept {
+        if ( !fmt.channels || !fmt.sample_rate ) {
+            return false;
+        }
+        if ( fmt.block_align != fmt.channels * (fmt.bits_per_sample / 8u) ) {
+            return false;
+        }
+        switch ( fmt.format_tag ) {
+            case wav_format_pcm:
+                return fmt.bits_per_sample == 8
+                    || fmt.bits_per_sample == 16
+                    || fmt.bits_per_sample == 24
+                    || fmt.bits_per_sample == 32;
+            case wav_format_float:
+                return fmt.bits_per_sample == 32;
+            default:
+                return false;
+        }
+    }
+
+    bool read_wav_format(input_stream& stream, wav_format& dst) {
+        input_sequence iseq{stream};
+
+        char riff_id[4] = {0};
+        u32 riff_size = 0;
+        char wave_id[4] = {0};
+
+        iseq.read(riff_id, sizeof(riff_id))
+            .read(riff_size)
+            .read(wave_id, sizeof(wave_id));
+
+        if ( !iseq.success()
+            || !check_fourcc(riff_id, "RIFF")
+            || !check_fourcc(wave_id, "WAVE") )
+        {
+            return false;
+        }
+
+        wav_format fmt;
+        bool has_fmt_chunk = false;
+
+        while ( true ) {
+            char chunk_id[4] = {0};
+            u32 chunk_size = 0;
+
+            if ( !iseq.read(chunk_id, sizeof(chunk_id)).read(chunk_size).success() ) {
+                return false;
+            }
+
+            const std::size_t chunk_start = stream.tell();
+
+            if ( check_fourcc(chunk_id, "fmt ") ) {
+                u32 byte_rate = 0;
+                iseq.read(fmt.format_tag)
+                    .read(fmt.channels)
+                    .read(fmt.sample_rate)
+                    .read(byte_rate)
+                    .read(fmt.block_align)
+                    .read(fmt.bits_per_sample);
+
+                if ( fmt.format_tag == wav_format_extensible && chunk_size >= 26u ) {
+                    u16 extension_size = 0;
+                    u16 valid_bits = 0;
+                    u32 channel_mask = 0;
+                    iseq.read(extension_size)
+                        .read(valid_bits)
+                        .read(channel_mask)
+                        .read(fmt.format_tag);
+                }
+
+                has_fmt_chunk = iseq.success();
+            } else if ( check_fourcc(chunk_id, "data") ) {
+                if ( !has_fmt_chunk || !is_supported_format(fmt) ) {
+                    return false;
+                }
+                fmt.data_offset = chunk_start;
+                fmt.data_size = math::min(
+                    std::size_t(chunk_size),
+                    stream.length() - chunk_start);
+                fmt.data_size -= fmt.data_size % fmt.block_align;
+                dst = fmt;
+                return true;
+            }
+
+            const std::size_t next_chunk = chunk_start + chunk_size + (chunk_size & 1u);
+            if ( next_chunk >= stream.length() ) {
+                return false;
+            }
+
+            if ( !iseq.seek(math::numeric_cast<std::ptrdiff_t>(next_chunk), false).success() ) {
+                return false;
+            }
+        }
+    }
+
+    void convert_samples(const wav_format& fmt, const u8* src, f32* dst, std::size_t count) noexcept {
+        if ( fmt.format_tag == wav_format_float ) {
+            std::memcpy(dst, src, count * sizeof(f32));
+            return;
+        }
+        switch ( fmt.bits_per_sample ) {
+            case 8:
+                for ( std::size_t i = 0; i < count; ++i ) {
+                    dst[i] = (static_cast<f32>(src[i]) - 128.f) * (1.f / 128.f);
+                }
+                break;
+            case 16:
+                for ( std::size_t i = 0; i < count; ++i, src += 2 ) {
+                    i16 v = 0;
+                    std::memcpy(&v, src, sizeof(v));
+                    dst[i] = static_cast<f32>(v) * (1.f / 32768.f);
+                }
+                break;
+            case 24:
+                for ( std::size_t i = 0; i < count; ++i, src += 3 ) {
+                    const i32 v = static_cast<i32>(
+                        (u32(src[0]) << 8u) |
+                        (u32(src[1]) << 16u) |
+                        (u32(src[2]) << 24u)) >> 8;
+                    dst[i] = static_cast<f32>(v) * (1.f / 8388608.f);
+                }
+                break;
+            case 32:
+                for ( std::size_t i = 0; i < count; ++i, src += 4 ) {
+                    i32 v = 0;
+                    std::memcpy(&v, src, sizeof(v));
+                    dst[i] = static_cast<f32>(v) * (1.f / 2147483648.f);
+                }
+                break;
+            default:
+                E2D_ASSERT_MSG(false, "unexpected wav bits per sample");
+                std::fill(dst, dst + count, 0.f);
+                break;
+        }
+    }
+
+    class wav_sound_stream final : public sound_stream {
+    public:
+        wav_sound_stream(input_stream_uptr stream, const wav_format& fmt)
+        : stream_(std::move(stream))
+        , format_(fmt) {}
+
+        u32 channels() const noexcept final {
+            return format_.channels;
+        }
+
+        u32 sample_rate() const noexcept final {
+            return format_.sample_rate;
+        }
+
+        std::size_t read(f32* dst, std::size_t frames) final {
+            E2D_ASSERT(dst || !frames);
+            const std::size_t frames_left =
+                (format_.data_size - position_) / format_.block_align;
+            const std::size_t frames_to_read = math::min(frames, frames_left);
+            if ( !frames_to_read ) {
+                return 0u;
+            }
+
+            const std::size_t bytes_to_read = frames_to_read * format_.block_align;
+            if ( scratch_.size() < bytes_to_read ) {
+                scratch_.resize(bytes_to_read);
+            }
+
+            if ( bytes_to_read != stream_->read(scratch_.data(), bytes_to_read) ) {
+                throw bad_stream_operation();
+            }
+            position_ += bytes_to_read;
+
+            convert_samples(
+                format_,
+                scratch_.data(),
+                dst,
+                frames_to_read * format_.channels);
+            return frames_to_read;
+        }
+
+        bool rewind() final {
+            const std::ptrdiff_t data_offset =
+                math::numeric_cast<std::ptrdiff_t>(format_.data_offset);
+            if ( format_.data_offset != stream_->seek(data_offset, false) ) {
+                return false;
+            }
+            position_ = 0u;
+            return true;
+        }
+    private:
+        input_stream_uptr stream_;
+        wav_format format_;
+        std::size_t position_ = 0u;
+        buffer scratch_;
+    };
+}
+
+namespace e2d { namespace sounds { namespace impl
+{
+    bool try_load_sound_wav(sound& dst, const buffer& src) noexcept {
+        try {
+            wav_format fmt;
+            input_stream_uptr stream = make_memory_stream(src);
+            if ( !stream || !read_wav_format(*stream, fmt) ) {
+                return false;
+            }
+
+            wav_sound_stream wav_stream(std::move(stream), fmt);
+            const std::size_t frames = fmt.data_size / fmt.block_align;
+            vector<f32> samples(frames * fmt.channels);
+            if ( frames != wav_stream.read(samples.data(), frames) ) {
+                return false;
+            }
+
+            dst.assign(fmt.channels, fmt.sample_rate, std::move(samples));
+            return true;
+        } catch (...) {
+            // nothing
+        }
+        return false;
+    }
+
+    sound_stream_uptr try_open_sound_stream_wav(input_stream_uptr src) noexcept {
+        try {
+            wav_format fmt;
+            if ( src && read_wav_format(*src, fmt) ) {
+                return std::make_unique<wav_sound_stream>(std::move(src), fmt);
+            }
+        } catch (...) {
+            // nothing
+        }
+        return nullptr;
+    }
+}}}
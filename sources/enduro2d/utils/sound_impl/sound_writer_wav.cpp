@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "sound_impl.hpp"
+
+namespace
+{
+    using namespace e2d;
+
+    const u16 wav_format_float = 0x0003;
+    const std::size_t wav_header_size = 44u;
+
+    template < typename T >
+    u8* write_pod(u8* dst, const T& v) noexcept {
+        std::memcpy(dst, &v, sizeof(v));
+        return dst + sizeof(v);
+    }
+
+    u8* write_fourcc(u8* dst, const char* fourcc) noexcept {
+        std::memcpy(dst, fourcc, 4u);
+        return dst + 4u;
+    }
+}
+
+namespace e2d { namespace sounds { namespace impl
+{
+    bool try_save_sound_wav(const sound& src, buffer& dst) noexcept {
+        try {
+            const std::size_t data_size = src.samples().size() * sizeof(f32);
+            if ( !src.channels()
+                || src.channels() > std::numeric_limits<u16>::max() / sizeof(f32)
+                || data_size > std::numeric_limits<u32>::max() - wav_header_size )
+            {
+                return false;
+            }
+
+            const u16 channels = math::numeric_cast<u16>(src.channels());
+            const u16 block_align = math::numeric_cast<u16>(channels * sizeof(f32));
+
+            buffer file_data(wav_header_size + data_size);
+            u8* iter = file_data.data();
+
+            iter = write_fourcc(iter, "RIFF");
+            iter = write_pod(iter, math::numeric_cast<u32>(wav_header_size - 8u + data_size));
+            iter = write_fourcc(iter, "WAVE");
+            iter = write_fourcc(iter, "fmt ");
+            iter = write_pod(iter, u32(16u));
+            iter = write_pod(iter, wav_format_float);
+            iter = write_pod(iter, channels);
+            iter = write_pod(iter, src.sample_rate());
+            iter = write_pod(iter, src.sample_rate() * block_align);
+            iter = write_pod(iter, block_align);
+            iter = write_pod(iter, u16(32u));
+            iter = write_fourcc(iter, "data");
+            iter = write_pod(iter, math::numeric_cast<u32>(data_size));
+
+            E2D_ASSERT(iter == file_data.data() + wav_header_size);
+            if ( data_size ) {
+                std::memcpy(iter, src.samples().data(), data_size);
+            }
+
+            dst.swap(file_data);
+            return true;
+        } catch (...) {
+            // nothing
+        }
+        return false;
+    }
+}}}
@@ -59,6 +59,158 @@ namespace
         buffer data_;
         std::size_t pos_ = 0;
     };
+
+    struct io_counters {
+        std::atomic<u64> read_calls{0u};
+        std::atomic<u64> seek_calls{0u};
+        std::atomic<u64> read_bytes{0u};
+        std::atomic<u64> buffered_reads{0u};
+    };
+
+    io_counters& get_io_counters() noexcept {
+        static io_counters counters;
+        return counters;
+    }
+
+    class buffered_stream final : public input_stream {
+    public:
+        // 'stream' is moved only when the construction can't fail
+        buffered_stream(
+            input_stream_uptr&& stream,
+            std::unique_ptr<u8[]> buffer,
+            std::size_t buffer_capacity,
+            std::size_t stream_pos) noexcept
+        : stream_(std::move(stream))
+        , buffer_(std::move(buffer))
+        , buffer_capacity_(buffer_capacity)
+        , stream_pos_(stream_pos)
+        , pos_(stream_pos)
+        , buffer_pos_(stream_pos) {
+            E2D_ASSERT(buffer_ && buffer_capacity_ > 0u);
+        }
+
+        ~buffered_stream() noexcept final {
+            flush_buffered_reads_();
+        }
+
+        std::size_t read(void* dst, std::size_t size) final {
+            if ( !dst || !size ) {
+                return 0;
+            }
+            u8* dst_bytes = static_cast<u8*>(dst);
+            std::size_t read_bytes = 0;
+
+            if ( pos_ >= buffer_pos_ && pos_ < buffer_pos_ + buffer_size_ ) {
+                const std::size_t chunk = math::min(size, buffer_pos_ + buffer_size_ - pos_);
+                std::memcpy(dst_bytes, buffer_.get() + (pos_ - buffer_pos_), chunk);
+                pos_ += chunk;
+                read_bytes += chunk;
+                ++buffered_reads_;
+            }
+
+            if ( read_bytes < size ) {
+                const std::size_t tail = size - read_bytes;
+                if ( tail >= buffer_capacity_ ) {
+                    read_bytes += read_underlying_(dst_bytes + read_bytes, tail);
+                } else if ( fill_buffer_() ) {
+                    const std::size_t chunk = math::min(tail, buffer_size_);
+                    std::memcpy(dst_bytes + read_bytes, buffer_.get(), chunk);
+                    pos_ += chunk;
+                    read_bytes += chunk;
+                }
+            }
+
+            return read_bytes;
+        }
+
+        std::size_t seek(std::ptrdiff_t offset, bool relative) final {
+            std::size_t npos = 0;
+            if ( offset < 0 ) {
+                const std::size_t uoffset = math::abs_to_unsigned(offset);
+                if ( !relative || uoffset > pos_ ) {
+                    throw bad_stream_operation();
+                }
+                npos = pos_ - uoffset;
+            } else {
+                npos = math::abs_to_unsigned(offset) + (relative ? pos_ : 0u);
+                if ( npos > stream_->length() ) {
+                    throw bad_stream_operation();
+                }
+            }
+            // the underlying stream is repositioned lazily by the next read
+            pos_ = npos;
+            return pos_;
+        }
+
+        std::size_t tell() const final {
+            return pos_;
+        }
+
+        std::size_t length() const noexcept final {
+            return stream_->length();
+        }
+    private:
+        // small reads are counted by the stream and added to the process-wide
+        // counter with the underlying reads or on the destruction
+        void flush_buffered_reads_() noexcept {
+            if ( buffered_reads_ ) {
+                get_io_counters().buffered_reads.fetch_add(buffered_reads_, std::memory_order_relaxed);
+                buffered_reads_ = 0u;
+            }
+        }
+
+        void sync_underlying_() {
+            if ( stream_pos_ != pos_ ) {
+                get_io_counters().seek_calls.fetch_add(1u, std::memory_order_relaxed);
+                stream_pos_ = stream_->seek(math::numeric_cast<std::ptrdiff_t>(pos_), false);
+                if ( stream_pos_ != pos_ ) {
+                    throw bad_stream_operation();
+                }
+            }
+        }
+
+        std::size_t read_underlying_(u8* dst, std::size_t size) {
+            // the length is known, so the end is never probed by a call
+            const std::size_t length = stream_->length();
+            size = pos_ < length ? math::min(size, length - pos_) : 0u;
+            if ( !size ) {
+                return 0;
+            }
+            sync_underlying_();
+            std::size_t read_bytes = 0;
+            while ( read_bytes < size ) {
+                get_io_counters().read_calls.fetch_add(1u, std::memory_order_relaxed);
+                const std::size_t chunk = stream_->read(dst + read_bytes, size - read_bytes);
+                if ( !chunk ) {
+                    break;
+                }
+                read_bytes += chunk;
+            }
+            get_io_counters().read_bytes.fetch_add(read_bytes, std::memory_order_relaxed);
+            flush_buffered_reads_();
+            stream_pos_ += read_bytes;
+            pos_ += read_bytes;
+            return read_bytes;
+        }
+
+        bool fill_buffer_() {
+            const std::size_t fill_pos = pos_;
+            buffer_size_ = 0;
+            buffer_pos_ = fill_pos;
+            buffer_size_ = read_underlying_(buffer_.get(), buffer_capacity_);
+            pos_ = fill_pos;
+            return buffer_size_ > 0u;
+        }
+    private:
+        input_stream_uptr stream_;
+        std::unique_ptr<u8[]> buffer_;
+        std::size_t buffer_capacity_{0u};
+        std::size_t stream_pos_{0u};
+        std::size_t pos_{0u};
+        std::size_t buffer_pos_{0u};
+        std::size_t buffer_size_{0u};
+        u64 buffered_reads_{0u};
+    };
 }
 
 namespace e2d
@@ -209,6 +361,32 @@ namespace e2d
             return nullptr;
         }
     }
+
+    input_stream_uptr make_buffered_stream(
+        input_stream_uptr stream,
+        std::size_t buffer_size) noexcept
+    {
+        if ( !stream || !buffer_size ) {
+            return stream;
+        }
+        try {
+            // streams smaller than the read-ahead get a buffer of their size
+            const std::size_t pos = stream->tell();
+            const std::size_t length = stream->length();
+            const std::size_t capacity = math::min(
+                buffer_size,
+                length > pos ? length - pos : 0u);
+            if ( !capacity ) {
+                return stream;
+            }
+            std::unique_ptr<u8[]> data(new u8[capacity]);
+            return std::make_unique<buffered_stream>(
+                std::move(stream), std::move(data), capacity, pos);
+        } catch (...) {
+            // the original stream is still usable without buffering
+            return stream;
+        }
+    }
 }
 
 namespace e2d { namespace streams
@@ -245,3 +423,24 @@ namespace e2d { namespace streams
             : false;
     }
 }}
+
+namespace e2d { namespace streams
+{
+    io_statistics statistics() noexcept {
+        const io_counters& counters = get_io_counters();
+        io_statistics result;
+        result.read_calls = counters.read_calls.load(std::memory_order_relaxed);
+        result.seek_calls = counters.seek_calls.load(std::memory_order_relaxed);
+        result.read_bytes = counters.read_bytes.load(std::memory_order_relaxed);
+        result.buffered_reads = counters.buffered_reads.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void reset_statistics() noexcept {
+        io_counters& counters = get_io_counters();
+        counters.read_calls.store(0u, std::memory_order_relaxed);
+        counters.seek_calls.store(0u, std::memory_order_relaxed);
+        counters.read_bytes.store(0u, std::memory_order_relaxed);
+        counters.buffered_reads.store(0u, std::memory_order_relaxed);
+    }
+}}
@@ -8,144 +8,596 @@
 
 #include <3rdparty/utfcpp/utf8.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define E2D_STRINGS_SSE2
+#  include <emmintrin.h>
+#endif
+
 namespace
 {
     using namespace e2d;
 
     //
-    // utf8_to_X
+    // simd blocks
+    //
+    // every block function converts 16 code units when all of them
+    // are in the fast range (ascii or bmp without surrogates)
+    // and returns false without writing otherwise
     //
 
-    str16 utf8_to_16(str_view src) {
-        str16 dst;
-        dst.reserve(src.size());
-        utf8::utf8to16(src.cbegin(), src.cend(), std::back_inserter(dst));
-        dst.shrink_to_fit();
-        return dst;
-    }
+    const std::size_t block_size = 16u;
 
-    str32 utf8_to_32(str_view src) {
-        str32 dst;
-        dst.reserve(src.size());
-        utf8::utf8to32(src.cbegin(), src.cend(), std::back_inserter(dst));
-        dst.shrink_to_fit();
-        return dst;
+    bool is_surrogate(u32 cp) noexcept {
+        return cp >= 0xD800u && cp <= 0xDFFFu;
     }
 
-    template < typename WChar = wchar_t >
-    std::enable_if_t<sizeof(WChar) == 2, wstr>
-    utf8_to_wide(str_view src) {
-        wstr dst;
-        dst.reserve(src.size());
-        utf8::utf8to16(src.cbegin(), src.cend(), std::back_inserter(dst));
-        dst.shrink_to_fit();
-        return dst;
+    bool is_ascii_block(const char* src) noexcept {
+    #if defined(E2D_STRINGS_SSE2)
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        return 0 == _mm_movemask_epi8(v);
+    #else
+        u64 v[2];
+        std::memcpy(v, src, sizeof(v));
+        return 0u == ((v[0] | v[1]) & 0x8080808080808080ull);
+    #endif
     }
 
-    template < typename WChar = wchar_t >
-    std::enable_if_t<sizeof(WChar) == 4, wstr>
-    utf8_to_wide(str_view src) {
-        wstr dst;
-        dst.reserve(src.size());
-        utf8::utf8to32(src.cbegin(), src.cend(), std::back_inserter(dst));
-        dst.shrink_to_fit();
-        return dst;
+    template < typename Char >
+    std::enable_if_t<sizeof(Char) == 2, bool>
+    widen_ascii_block(const char* src, Char* dst) noexcept {
+        if ( !is_ascii_block(src) ) {
+            return false;
+        }
+    #if defined(E2D_STRINGS_SSE2)
+        const __m128i z = _mm_setzero_si128();
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_unpacklo_epi8(v, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpackhi_epi8(v, z));
+    #else
+        for ( std::size_t i = 0; i < block_size; ++i ) {
+            dst[i] = static_cast<Char>(src[i]);
+        }
+    #endif
+        return true;
     }
 
-    //
-    // utf16_to_X
-    //
-
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 2, str>
-    utf16_to_8(basic_string_view<Char> src) {
-        str dst;
-        dst.reserve(src.size() * 2);
-        utf8::utf16to8(src.cbegin(), src.cend(), std::back_inserter(dst));
-        dst.shrink_to_fit();
-        return dst;
+    std::enable_if_t<sizeof(Char) == 4, bool>
+    widen_ascii_block(const char* src, Char* dst) noexcept {
+        if ( !is_ascii_block(src) ) {
+            return false;
+        }
+    #if defined(E2D_STRINGS_SSE2)
+        const __m128i z = _mm_setzero_si128();
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        const __m128i lo = _mm_unpacklo_epi8(v, z);
+        const __m128i hi = _mm_unpackhi_epi8(v, z);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_unpacklo_epi16(lo, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(lo, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpacklo_epi16(hi, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 12), _mm_unpackhi_epi16(hi, z));
+    #else
+        for ( std::size_t i = 0; i < block_size; ++i ) {
+            dst[i] = static_cast<Char>(src[i]);
+        }
+    #endif
+        return true;
     }
 
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 2, str32>
-    utf16_to_32(basic_string_view<Char> src) {
-        return utf8_to_32(utf16_to_8(src));
+    std::enable_if_t<sizeof(Char) == 2, bool>
+    narrow_ascii_block(const Char* src, char* dst) noexcept {
+    #if defined(E2D_STRINGS_SSE2)
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 0));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+        const __m128i m = _mm_and_si128(_mm_or_si128(a, b), _mm_set1_epi16(-0x80));
+        if ( 0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi16(m, _mm_setzero_si128())) ) {
+            return false;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_packus_epi16(a, b));
+    #else
+        u32 m = 0u;
+        for ( std::size_t i = 0; i < block_size; ++i ) {
+            m |= static_cast<u32>(src[i]);
+        }
+        if ( m >= 0x80u ) {
+            return false;
+        }
+        for ( std::size_t i = 0; i < block_size; ++i ) {
+            dst[i] = static_cast<char>(src[i]);
+        }
+    #endif
+        return true;
     }
 
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 2, wstr>
-    utf16_to_wide(basic_string_view<Char> src) {
-        return utf8_to_wide(utf16_to_8(src));
+    std::enable_if_t<sizeof(Char) == 4, bool>
+    narrow_ascii_block(const Char* src, char* dst) noexcept {
+    #if defined(E2D_STRINGS_SSE2)
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 0));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+        const __m128i m = _mm_and_si128(
+            _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)),
+            _mm_set1_epi32(-0x80));
+        if ( 0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(m, _mm_setzero_si128())) ) {
+            return false;
+        }
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst),
+            _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    #else
+        u32 m = 0u;
+        for ( std::size_t i = 0; i < block_size; ++i ) {
+            m |= static_cast<u32>(src[i]);
+        }
+        if ( m >= 0x80u ) {
+            return false;
+        }
+        for ( std::size_t i = 0; i < block_size; ++i ) {
+            dst[i] = static_cast<char>(src[i]);
+        }
+    #endif
+        return true;
+    }
+
+    template < typename SrcChar, typename DstChar >
+    std::enable_if_t<sizeof(SrcChar) == 2 && sizeof(DstChar) == 4, bool>
+    convert_bmp_block(const SrcChar* src, DstChar* dst) noexcept {
+    #if defined(E2D_STRINGS_SSE2)
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 0));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+        const __m128i sm = _mm_set1_epi16(static_cast<short>(0xF800));
+        const __m128i sv = _mm_set1_epi16(static_cast<short>(0xD800));
+        const __m128i s = _mm_or_si128(
+            _mm_cmpeq_epi16(_mm_and_si128(a, sm), sv),
+            _mm_cmpeq_epi16(_mm_and_si128(b, sm), sv));
+        if ( 0 != _mm_movemask_epi8(s) ) {
+            return false;
+        }
+        const __m128i z = _mm_setzero_si128();
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_unpacklo_epi16(a, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(a, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 8), _mm_unpacklo_epi16(b, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 12), _mm_unpackhi_epi16(b, z));
+    #else
+        for ( std::size_t i = 0; i < block_size; ++i ) {
+            if ( is_surrogate(static_cast<u32>(src[i])) ) {
+                return false;
+            }
+        }
+        for ( std::size_t i = 0; i < block_size; ++i ) {
+            dst[i] = static_cast<DstChar>(src[i]);
+        }
+    #endif
+        return true;
+    }
+
+    template < typename SrcChar, typename DstChar >
+    std::enable_if_t<sizeof(SrcChar) == 4 && sizeof(DstChar) == 2, bool>
+    convert_bmp_block(const SrcChar* src, DstChar* dst) noexcept {
+    #if defined(E2D_STRINGS_SSE2)
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 0));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12));
+        const __m128i hm = _mm_set1_epi32(static_cast<int>(0xFFFF0000u));
+        const __m128i h = _mm_and_si128(
+            _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), hm);
+        const __m128i sm = _mm_set1_epi32(0xF800);
+        const __m128i sv = _mm_set1_epi32(0xD800);
+        const __m128i s = _mm_or_si128(
+            _mm_or_si128(
+                _mm_cmpeq_epi32(_mm_and_si128(a, sm), sv),
+                _mm_cmpeq_epi32(_mm_and_si128(b, sm), sv)),
+            _mm_or_si128(
+                _mm_cmpeq_epi32(_mm_and_si128(c, sm), sv),
+                _mm_cmpeq_epi32(_mm_and_si128(d, sm), sv)));
+        if ( 0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi32(h, _mm_setzero_si128()))
+            || 0 != _mm_movemask_epi8(s) )
+        {
+            return false;
+        }
+        // sse2 has only the signed 32->16 pack, so bias the values
+        // to the signed range before packing and restore them after
+        const __m128i bias32 = _mm_set1_epi32(0x8000);
+        const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst + 0),
+            _mm_xor_si128(bias16, _mm_packs_epi32(
+                _mm_sub_epi32(a, bias32),
+                _mm_sub_epi32(b, bias32))));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(dst + 8),
+            _mm_xor_si128(bias16, _mm_packs_epi32(
+                _mm_sub_epi32(c, bias32),
+                _mm_sub_epi32(d, bias32))));
+    #else
+        for ( std::size_t i = 0; i < block_size; ++i ) {
+            const u32 cp = static_cast<u32>(src[i]);
+            if ( cp > 0xFFFFu || is_surrogate(cp) ) {
+                return false;
+            }
+        }
+        for ( std::size_t i = 0; i < block_size; ++i ) {
+            dst[i] = static_cast<DstChar>(src[i]);
+        }
+    #endif
+        return true;
     }
 
     //
-    // utf32_to_X
+    // code point decoders and encoders
     //
 
+    bool decode_utf8(const char* src, std::size_t size, std::size_t& i, u32& cp) noexcept {
+        const auto byte = [src](std::size_t index) noexcept {
+            return static_cast<u32>(static_cast<u8>(src[index]));
+        };
+        const auto is_trail = [&byte](std::size_t index) noexcept {
+            return (byte(index) & 0xC0u) == 0x80u;
+        };
+        const u32 lead = byte(i);
+        if ( lead < 0x80u ) {
+            cp = lead;
+            i += 1u;
+            return true;
+        }
+        if ( lead < 0xC2u ) {
+            return false;
+        }
+        if ( lead < 0xE0u ) {
+            if ( size - i < 2u || !is_trail(i + 1u) ) {
+                return false;
+            }
+            cp = ((lead & 0x1Fu) << 6u) | (byte(i + 1u) & 0x3Fu);
+            i += 2u;
+            return true;
+        }
+        if ( lead < 0xF0u ) {
+            if ( size - i < 3u || !is_trail(i + 1u) || !is_trail(i + 2u) ) {
+                return false;
+            }
+            cp = ((lead & 0x0Fu) << 12u)
+                | ((byte(i + 1u) & 0x3Fu) << 6u)
+                | (byte(i + 2u) & 0x3Fu);
+            if ( cp < 0x800u || is_surrogate(cp) ) {
+                return false;
+            }
+            i += 3u;
+            return true;
+        }
+        if ( lead < 0xF5u ) {
+            if ( size - i < 4u || !is_trail(i + 1u) || !is_trail(i + 2u) || !is_trail(i + 3u) ) {
+                return false;
+            }
+            cp = ((lead & 0x07u) << 18u)
+                | ((byte(i + 1u) & 0x3Fu) << 12u)
+                | ((byte(i + 2u) & 0x3Fu) << 6u)
+                | (byte(i + 3u) & 0x3Fu);
+            if ( cp < 0x10000u || cp > 0x10FFFFu ) {
+                return false;
+            }
+            i += 4u;
+            return true;
+        }
+        return false;
+    }
+
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 4, str>
-    utf32_to_8(basic_string_view<Char> src) {
-        str dst;
-        dst.reserve(src.size() * 4);
-        utf8::utf32to8(src.cbegin(), src.cend(), std::back_inserter(dst));
-        dst.shrink_to_fit();
-        return dst;
+    bool decode_utf16(const Char* src, std::size_t size, std::size_t& i, u32& cp) noexcept {
+        const u32 lead = static_cast<u32>(src[i]) & 0xFFFFu;
+        if ( !is_surrogate(lead) ) {
+            cp = lead;
+            i += 1u;
+            return true;
+        }
+        if ( lead > 0xDBFFu || size - i < 2u ) {
+            return false;
+        }
+        const u32 trail = static_cast<u32>(src[i + 1u]) & 0xFFFFu;
+        if ( trail < 0xDC00u || trail > 0xDFFFu ) {
+            return false;
+        }
+        cp = 0x10000u + ((lead - 0xD800u) << 10u) + (trail - 0xDC00u);
+        i += 2u;
+        return true;
+    }
+
+    template < typename Char >
+    bool decode_utf32(const Char* src, std::size_t i, u32& cp) noexcept {
+        cp = static_cast<u32>(src[i]);
+        return cp <= 0x10FFFFu && !is_surrogate(cp);
+    }
+
+    void encode_utf8(u32 cp, char* dst, std::size_t& o) noexcept {
+        if ( cp < 0x80u ) {
+            dst[o++] = static_cast<char>(cp);
+        } else if ( cp < 0x800u ) {
+            dst[o++] = static_cast<char>(0xC0u | (cp >> 6u));
+            dst[o++] = static_cast<char>(0x80u | (cp & 0x3Fu));
+        } else if ( cp < 0x10000u ) {
+            dst[o++] = static_cast<char>(0xE0u | (cp >> 12u));
+            dst[o++] = static_cast<char>(0x80u | ((cp >> 6u) & 0x3Fu));
+            dst[o++] = static_cast<char>(0x80u | (cp & 0x3Fu));
+        } else {
+            dst[o++] = static_cast<char>(0xF0u | (cp >> 18u));
+            dst[o++] = static_cast<char>(0x80u | ((cp >> 12u) & 0x3Fu));
+            dst[o++] = static_cast<char>(0x80u | ((cp >> 6u) & 0x3Fu));
+            dst[o++] = static_cast<char>(0x80u | (cp & 0x3Fu));
+        }
+    }
+
+    template < typename Char >
+    std::enable_if_t<sizeof(Char) == 2>
+    encode_unit(u32 cp, Char* dst, std::size_t& o) noexcept {
+        if ( cp < 0x10000u ) {
+            dst[o++] = static_cast<Char>(cp);
+        } else {
+            cp -= 0x10000u;
+            dst[o++] = static_cast<Char>(0xD800u + (cp >> 10u));
+            dst[o++] = static_cast<Char>(0xDC00u + (cp & 0x3FFu));
+        }
     }
 
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 4, str16>
-    utf32_to_16(basic_string_view<Char> src) {
-        return utf8_to_16(utf32_to_8(src));
+    std::enable_if_t<sizeof(Char) == 4>
+    encode_unit(u32 cp, Char* dst, std::size_t& o) noexcept {
+        dst[o++] = static_cast<Char>(cp);
+    }
+
+    //
+    // transcoders
+    //
+    // after a failed block check the rest of that block is converted
+    // by code points, so mixed text pays one check per block
+    //
+    // return false on invalid input, callers fall back to utfcpp
+    // to report the error the same way as before
+    //
+
+    template < typename DstChar >
+    bool transcode_utf8(const char* src, std::size_t size, DstChar* dst, std::size_t& o) noexcept {
+        std::size_t i = 0;
+        while ( i < size ) {
+            if ( size - i >= block_size && widen_ascii_block(src + i, dst + o) ) {
+                i += block_size;
+                o += block_size;
+                continue;
+            }
+            const std::size_t block_end = math::min(size, i + block_size);
+            while ( i < block_end ) {
+                u32 cp = 0;
+                if ( !decode_utf8(src, size, i, cp) ) {
+                    return false;
+                }
+                encode_unit(cp, dst, o);
+            }
+        }
+        return true;
+    }
+
+    template < typename SrcChar >
+    std::enable_if_t<sizeof(SrcChar) == 2, bool>
+    transcode_to_utf8(const SrcChar* src, std::size_t size, char* dst, std::size_t& o) noexcept {
+        std::size_t i = 0;
+        while ( i < size ) {
+            if ( size - i >= block_size && narrow_ascii_block(src + i, dst + o) ) {
+                i += block_size;
+                o += block_size;
+                continue;
+            }
+            const std::size_t block_end = math::min(size, i + block_size);
+            while ( i < block_end ) {
+                u32 cp = 0;
+                if ( !decode_utf16(src, size, i, cp) ) {
+                    return false;
+                }
+                encode_utf8(cp, dst, o);
+            }
+        }
+        return true;
+    }
+
+    template < typename SrcChar >
+    std::enable_if_t<sizeof(SrcChar) == 4, bool>
+    transcode_to_utf8(const SrcChar* src, std::size_t size, char* dst, std::size_t& o) noexcept {
+        std::size_t i = 0;
+        while ( i < size ) {
+            if ( size - i >= block_size && narrow_ascii_block(src + i, dst + o) ) {
+                i += block_size;
+                o += block_size;
+                continue;
+            }
+            const std::size_t block_end = math::min(size, i + block_size);
+            while ( i < block_end ) {
+                u32 cp = 0;
+                if ( !decode_utf32(src, i, cp) ) {
+                    return false;
+                }
+                encode_utf8(cp, dst, o);
+                i += 1u;
+            }
+        }
+        return true;
+    }
+
+    template < typename SrcChar, typename DstChar >
+    std::enable_if_t<sizeof(SrcChar) == 2 && sizeof(DstChar) == 4, bool>
+    transcode_units(const SrcChar* src, std::size_t size, DstChar* dst, std::size_t& o) noexcept {
+        std::size_t i = 0;
+        while ( i < size ) {
+            if ( size - i >= block_size && convert_bmp_block(src + i, dst + o) ) {
+                i += block_size;
+                o += block_size;
+                continue;
+            }
+            const std::size_t block_end = math::min(size, i + block_size);
+            while ( i < block_end ) {
+                u32 cp = 0;
+                if ( !decode_utf16(src, size, i, cp) ) {
+                    return false;
+                }
+                encode_unit(cp, dst, o);
+            }
+        }
+        return true;
+    }
+
+    template < typename SrcChar, typename DstChar >
+    std::enable_if_t<sizeof(SrcChar) == 4 && sizeof(DstChar) == 2, bool>
+    transcode_units(const SrcChar* src, std::size_t size, DstChar* dst, std::size_t& o) noexcept {
+        std::size_t i = 0;
+        while ( i < size ) {
+            if ( size - i >= block_size && convert_bmp_block(src + i, dst + o) ) {
+                i += block_size;
+                o += block_size;
+                continue;
+            }
+            const std::size_t block_end = math::min(size, i + block_size);
+            while ( i < block_end ) {
+                u32 cp = 0;
+                if ( !decode_utf32(src, i, cp) ) {
+                    return false;
+                }
+                encode_unit(cp, dst, o);
+                i += 1u;
+            }
+        }
+        return true;
     }
 
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 4, wstr>
-    utf32_to_wide(basic_string_view<Char> src) {
-        return utf8_to_wide(utf32_to_8(src));
+    std::size_t ascii_prefix_length(const Char* src, std::size_t size) noexcept {
+        std::size_t i = 0;
+        char tmp[block_size];
+        while ( size - i >= block_size && narrow_ascii_block(src + i, tmp) ) {
+            i += block_size;
+        }
+        while ( i < size && static_cast<u32>(src[i]) < 0x80u ) {
+            ++i;
+        }
+        return i;
     }
 
     //
-    // wide_to_X
+    // utfcpp fallbacks
     //
 
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 2, str>
-    wide_to_utf8(basic_string_view<Char> src) {
-        return utf16_to_8(src);
+    std::enable_if_t<sizeof(Char) == 2>
+    utfcpp_from_utf8(str_view src, std::basic_string<Char>& dst) {
+        utf8::utf8to16(src.cbegin(), src.cend(), std::back_inserter(dst));
     }
 
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 4, str>
-    wide_to_utf8(basic_string_view<Char> src) {
-        return utf32_to_8(src);
+    std::enable_if_t<sizeof(Char) == 4>
+    utfcpp_from_utf8(str_view src, std::basic_string<Char>& dst) {
+        utf8::utf8to32(src.cbegin(), src.cend(), std::back_inserter(dst));
     }
 
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 2, str16>
-    wide_to_utf16(basic_string_view<Char> src) {
-        return src.empty()
-            ? str16()
-            : str16(src.cbegin(), src.cend());
+    std::enable_if_t<sizeof(Char) == 2>
+    utfcpp_to_utf8(basic_string_view<Char> src, str& dst) {
+        utf8::utf16to8(src.cbegin(), src.cend(), std::back_inserter(dst));
     }
 
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 4, str16>
-    wide_to_utf16(basic_string_view<Char> src) {
-        return utf32_to_16(src);
+    std::enable_if_t<sizeof(Char) == 4>
+    utfcpp_to_utf8(basic_string_view<Char> src, str& dst) {
+        utf8::utf32to8(src.cbegin(), src.cend(), std::back_inserter(dst));
     }
 
+    //
+    // result helpers
+    //
+
+    template < typename String >
+    void shrink_result(String& dst, std::size_t size) {
+        dst.resize(size);
+        if ( dst.capacity() - size > size / 4u ) {
+            dst.shrink_to_fit();
+        }
+    }
+
+    template < typename DstChar, typename SrcChar >
+    std::enable_if_t<sizeof(SrcChar) == sizeof(DstChar), std::basic_string<DstChar>>
+    copy_units(basic_string_view<SrcChar> src) {
+        std::basic_string<DstChar> dst;
+        if ( !src.empty() ) {
+            dst.resize(src.size());
+            std::memcpy(&dst[0], src.data(), src.size() * sizeof(SrcChar));
+        }
+        return dst;
+    }
+
+    //
+    // utf8 to utf16/utf32
+    //
+
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 2, str32>
-    wide_to_utf32(basic_string_view<Char> src) {
-        return utf16_to_32(src);
+    std::basic_string<Char> utf8_to_units(str_view src) {
+        std::basic_string<Char> dst;
+        if ( src.empty() ) {
+            return dst;
+        }
+        dst.resize(src.size());
+        std::size_t size = 0;
+        if ( transcode_utf8(src.data(), src.size(), &dst[0], size) ) {
+            shrink_result(dst, size);
+            return dst;
+        }
+        dst.clear();
+        utfcpp_from_utf8(src, dst);
+        return dst;
     }
 
+    //
+    // utf16/utf32 to utf8 and to each other
+    //
+
     template < typename Char >
-    std::enable_if_t<sizeof(Char) == 4, str32>
-    wide_to_utf32(basic_string_view<Char> src) {
-        return src.empty()
-            ? str32()
-            : str32(src.cbegin(), src.cend());
+    str units_to_utf8(basic_string_view<Char> src) {
+        str dst;
+        if ( src.empty() ) {
+            return dst;
+        }
+        const std::size_t ascii = ascii_prefix_length(src.data(), src.size());
+        dst.resize(ascii == src.size()
+            ? src.size()
+            : ascii + (src.size() - ascii) * (sizeof(Char) == 2 ? 3u : 4u));
+        std::size_t size = 0;
+        if ( transcode_to_utf8(src.data(), src.size(), &dst[0], size) ) {
+            shrink_result(dst, size);
+            return dst;
+        }
+        dst.clear();
+        utfcpp_to_utf8(src, dst);
+        return dst;
+    }
+
+    template < typename DstChar, typename SrcChar >
+    std::enable_if_t<sizeof(SrcChar) != sizeof(DstChar), std::basic_string<DstChar>>
+    units_to_units(basic_string_view<SrcChar> src) {
+        std::basic_string<DstChar> dst;
+        if ( src.empty() ) {
+            return dst;
+        }
+        dst.resize(sizeof(DstChar) == 2 ? src.size() * 2u : src.size());
+        std::size_t size = 0;
+        if ( transcode_units(src.data(), src.size(), &dst[0], size) ) {
+            shrink_result(dst, size);
+            return dst;
+        }
+        // reports the error through utfcpp
+        return utf8_to_units<DstChar>(units_to_utf8(src));
+    }
+
+    template < typename DstChar, typename SrcChar >
+    std::enable_if_t<sizeof(SrcChar) == sizeof(DstChar), std::basic_string<DstChar>>
+    units_to_units(basic_string_view<SrcChar> src) {
+        return copy_units<DstChar>(src);
     }
 }
 
@@ -156,21 +608,19 @@ namespace e2d
     //
 
     str make_utf8(str_view src) {
-        return src.empty()
-            ? str()
-            : str(src.cbegin(), src.cend());
+        return copy_units<char>(src);
     }
 
     str make_utf8(wstr_view src) {
-        return wide_to_utf8(src);
+        return units_to_utf8(src);
     }
 
     str make_utf8(str16_view src) {
-        return utf16_to_8(src);
+        return units_to_utf8(src);
     }
 
     str make_utf8(str32_view src) {
-        return utf32_to_8(src);
+        return units_to_utf8(src);
     }
 
     //
@@ -178,21 +628,19 @@ namespace e2d
     //
 
     wstr make_wide(str_view src) {
-        return utf8_to_wide(src);
+        return utf8_to_units<wchar_t>(src);
     }
 
     wstr make_wide(wstr_view src) {
-        return src.empty()
-            ? wstr()
-            : wstr(src.cbegin(), src.cend());
+        return copy_units<wchar_t>(src);
     }
 
     wstr make_wide(str16_view src) {
-        return utf16_to_wide(src);
+        return units_to_units<wchar_t>(src);
     }
 
     wstr make_wide(str32_view src) {
-        return utf32_to_wide(src);
+        return units_to_units<wchar_t>(src);
     }
 
     //
@@ -200,21 +648,19 @@ namespace e2d
     //
 
     str16 make_utf16(str_view src) {
-        return utf8_to_16(src);
+        return utf8_to_units<char16_t>(src);
     }
 
     str16 make_utf16(wstr_view src) {
-        return wide_to_utf16(src);
+        return units_to_units<char16_t>(src);
     }
 
     str16 make_utf16(str16_view src) {
-        return src.empty()
-            ? str16()
-            : str16(src.cbegin(), src.cend());
+        return copy_units<char16_t>(src);
     }
 
     str16 make_utf16(str32_view src) {
-        return utf32_to_16(src);
+        return units_to_units<char16_t>(src);
     }
 
     //
@@ -222,21 +668,19 @@ namespace e2d
     //
 
     str32 make_utf32(str_view src) {
-        return utf8_to_32(src);
+        return utf8_to_units<char32_t>(src);
     }
 
     str32 make_utf32(wstr_view src) {
-        return wide_to_utf32(src);
+        return units_to_units<char32_t>(src);
     }
 
     str32 make_utf32(str16_view src) {
-        return utf16_to_32(src);
+        return units_to_units<char32_t>(src);
     }
 
     str32 make_utf32(str32_view src) {
-        return src.empty()
-            ? str32()
-            : str32(src.cbegin(), src.cend());
+        return copy_units<char32_t>(src);
     }
 
     //
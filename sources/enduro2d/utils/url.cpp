@@ -38,15 +38,23 @@ namespace
             : str_view::npos;
     }
 
-    std::pair<str, str> separate_schemepath(str_view schemepath) {
+    std::pair<str_view, str_view> separate_schemepath(str_view schemepath) noexcept {
         const str_view::size_type sep_pos =
             str_view_search(schemepath, scheme_separator, 0);
         if ( str_view::npos == sep_pos ) {
-            return std::make_pair(str(), schemepath);
+            return std::make_pair(str_view(), schemepath);
         }
         return std::make_pair(
-            schemepath.substr(0, sep_pos),
-            schemepath.substr(sep_pos + scheme_separator.length()));
+            str_view(schemepath.data(), sep_pos),
+            str_view(
+                schemepath.data() + sep_pos + scheme_separator.length(),
+                schemepath.length() - sep_pos - scheme_separator.length()));
+    }
+
+    bool is_str_view_of(str_view v, const str& s) noexcept {
+        return !v.empty()
+            && std::less_equal<const char*>()(s.data(), v.data())
+            && std::less<const char*>()(v.data(), s.data() + s.size() + 1u);
     }
 }
 
@@ -91,14 +99,24 @@ namespace e2d
     }
 
     url& url::assign(str_view schemepath) {
-        str nscheme, npath;
+        str_view nscheme, npath;
         std::tie(nscheme, npath) = separate_schemepath(schemepath);
-        return assign(std::move(nscheme), std::move(npath));
+        return assign(nscheme, npath);
     }
 
     url& url::assign(str_view scheme, str_view path) noexcept {
-        scheme_ = scheme;
-        path_ = path;
+        if ( is_str_view_of(scheme, scheme_) || is_str_view_of(scheme, path_)
+            || is_str_view_of(path, scheme_) || is_str_view_of(path, path_) )
+        {
+            // the views can point into either member
+            str nscheme(scheme.data(), scheme.size());
+            str npath(path.data(), path.size());
+            scheme_.swap(nscheme);
+            path_.swap(npath);
+            return *this;
+        }
+        scheme_.assign(scheme.data(), scheme.size());
+        path_.assign(path.data(), path.size());
         return *this;
     }
 
@@ -108,7 +126,11 @@ namespace e2d
     }
 
     url& url::append(str_view path) {
-        path_ = path::combine(path_, path);
+        if ( is_str_view_of(path, path_) ) {
+            path_ = path::combine(path_, path);
+        } else {
+            path::combine_to(path_, path_, path);
+        }
         return *this;
     }
 
@@ -165,6 +187,19 @@ namespace e2d
     }
 
     url operator/(const url& l, str_view r) {
-        return url(l.scheme(), path::combine(l.path(), r));
+        url result;
+        return combine_to(result, l, r);
+    }
+
+    url& combine_to(url& dst, const url& lhs, str_view rhs) {
+        if ( &dst == &lhs ) {
+            return dst.append(rhs);
+        }
+        if ( is_str_view_of(rhs, dst.scheme()) || is_str_view_of(rhs, dst.path()) ) {
+            return combine_to(dst, lhs, str(rhs));
+        }
+        return dst
+            .assign(lhs.scheme(), lhs.path())
+            .append(rhs);
     }
 }
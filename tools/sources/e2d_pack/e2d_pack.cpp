@@ -0,0 +1,152 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include <enduro2d/enduro2d.hpp>
+using namespace e2d;
+
+//
+// usage: e2d_pack <input_dir> <output_file> [--manifest <file>] [--store]
+//
+// manifest is a text file with one relative path per line (the load order
+// recorded by the game), listed files are packed first and in the same
+// order to make cold loads sequential, other files follow sorted by path
+//
+
+namespace
+{
+    struct options {
+        str input_dir;
+        str output_file;
+        str manifest_file;
+        pack_codec codec{pack_codec::lz4};
+    };
+
+    void print_usage() {
+        std::printf(
+            "usage: e2d_pack <input_dir> <output_file> [--manifest <file>] [--store]\n");
+    }
+
+    bool parse_options(int argc, char *argv[], options& dst) {
+        vector<str> positional;
+        for ( int i = 1; i < argc; ++i ) {
+            const str_view arg{argv[i]};
+            if ( arg == "--store" ) {
+                dst.codec = pack_codec::store;
+            } else if ( arg == "--manifest" && i + 1 < argc ) {
+                dst.manifest_file = argv[++i];
+            } else if ( arg.starts_with("--") ) {
+                return false;
+            } else {
+                positional.emplace_back(arg);
+            }
+        }
+        if ( positional.size() != 2u ) {
+            return false;
+        }
+        dst.input_dir = positional[0];
+        dst.output_file = positional[1];
+        return true;
+    }
+
+    bool collect_files(const options& opts, vector<str>& dst) {
+        filesystem::directory_scan scan;
+        if ( !filesystem::scan_directory_recursive(opts.input_dir, scan) ) {
+            std::printf("can't read input directory: %s\n", opts.input_dir.c_str());
+            return false;
+        }
+        vector<str> files;
+        files.reserve(scan.size());
+        for ( std::size_t i = 0; i < scan.size(); ++i ) {
+            if ( !scan.directory(i) ) {
+                files.emplace_back(scan.path(i));
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        vector<str> ordered;
+        hash_set<str> ordered_set;
+        if ( !opts.manifest_file.empty() ) {
+            str manifest;
+            if ( !filesystem::try_read_all(manifest, opts.manifest_file) ) {
+                std::printf("can't read manifest file: %s\n", opts.manifest_file.c_str());
+                return false;
+            }
+            for ( auto line_begin = manifest.begin(); line_begin != manifest.end(); ) {
+                const auto line_end = std::find(line_begin, manifest.end(), '\n');
+                str line(line_begin, line_end);
+                line_begin = line_end != manifest.end() ? line_end + 1 : line_end;
+                while ( !line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t') ) {
+                    line.pop_back();
+                }
+                if ( line.empty() || line.front() == '#' ) {
+                    continue;
+                }
+                const auto iter = std::lower_bound(files.begin(), files.end(), line);
+                if ( iter == files.end() || *iter != line ) {
+                    std::printf("skip manifest entry not found in input: %s\n", line.c_str());
+                    continue;
+                }
+                if ( ordered_set.insert(line).second ) {
+                    ordered.push_back(line);
+                }
+            }
+        }
+
+        for ( const str& file : files ) {
+            if ( ordered_set.insert(file).second ) {
+                ordered.push_back(file);
+            }
+        }
+
+        dst = std::move(ordered);
+        return true;
+    }
+}
+
+int e2d_main(int argc, char *argv[]) {
+    options opts;
+    if ( !parse_options(argc, argv, opts) ) {
+        print_usage();
+        return 1;
+    }
+
+    vector<str> files;
+    if ( !collect_files(opts, files) ) {
+        return 1;
+    }
+
+    pack_writer writer(make_write_file(opts.output_file, false));
+    if ( !writer.valid() ) {
+        std::printf("can't create output file: %s\n", opts.output_file.c_str());
+        return 1;
+    }
+
+    std::size_t total_size = 0u;
+    buffer content;
+    for ( const str& file : files ) {
+        if ( !filesystem::try_read_all(content, path::combine(opts.input_dir, file)) ) {
+            std::printf("can't read input file: %s\n", file.c_str());
+            return 1;
+        }
+        if ( !writer.add(file, content, opts.codec) ) {
+            std::printf("can't pack input file: %s\n", file.c_str());
+            return 1;
+        }
+        total_size += content.size();
+    }
+
+    if ( !writer.finish() ) {
+        std::printf("can't write output file: %s\n", opts.output_file.c_str());
+        return 1;
+    }
+
+    std::printf(
+        "packed %zu files (%zu bytes) to %s\n",
+        files.size(),
+        total_size,
+        opts.output_file.c_str());
+    return 0;
+}
@@ -0,0 +1,225 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_core.hpp"
+using namespace e2d;
+
+namespace
+{
+    class capture_sink final : public audio::sink {
+    public:
+        capture_sink(vector<f32>& samples)
+        : samples_(samples) {}
+
+        bool on_mix(const f32* samples, std::size_t frames, u32 sample_rate) noexcept final {
+            E2D_UNUSED(sample_rate);
+            samples_.insert(samples_.end(), samples, samples + frames * 2u);
+            return true;
+        }
+    private:
+        vector<f32>& samples_;
+    };
+
+    class counting_sink final : public audio::sink {
+    public:
+        counting_sink(std::atomic<u64>& blocks)
+        : blocks_(blocks) {}
+
+        bool on_mix(const f32* samples, std::size_t frames, u32 sample_rate) noexcept final {
+            E2D_UNUSED(samples, frames, sample_rate);
+            blocks_.fetch_add(1u);
+            return true;
+        }
+    private:
+        std::atomic<u64>& blocks_;
+    };
+
+    audio::parameters manual_parameters() {
+        return audio::parameters()
+            .sample_rate(100u)
+            .block_frames(4u)
+            .mixer_thread(false);
+    }
+}
+
+TEST_CASE("audio") {
+    debug d;
+    {
+        vector<f32> samples;
+        audio a(d, std::make_unique<capture_sink>(samples), manual_parameters());
+        REQUIRE(a.sample_rate() == 100u);
+
+        const auto s = std::make_shared<sound>(1u, 100u, vector<f32>{0.1f, 0.2f, 0.3f});
+        const audio::voice_id id = a.play(s, 0.5f);
+        REQUIRE(id != audio::invalid_voice);
+
+        a.mix(6u);
+        REQUIRE(samples.size() == 12u);
+        REQUIRE(samples[0] == Approx(0.05f));
+        REQUIRE(samples[1] == Approx(0.05f));
+        REQUIRE(samples[2] == Approx(0.1f));
+        REQUIRE(samples[5] == Approx(0.15f));
+        REQUIRE(samples[6] == Approx(0.f));
+        REQUIRE(samples[11] == Approx(0.f));
+
+        REQUIRE(a.stats().mixed_frames == 6u);
+        REQUIRE(a.stats().active_voices == 0u);
+    }
+    {
+        vector<f32> samples;
+        audio a(d, std::make_unique<capture_sink>(samples), manual_parameters());
+
+        const auto s = std::make_shared<sound>(2u, 50u, vector<f32>{1.f, -1.f, 0.f, 0.f});
+        const audio::voice_id id = a.play(s, 1.f, 1.f, true);
+        a.master_volume(0.5f);
+
+        a.mix(4u);
+        REQUIRE(samples.size() == 8u);
+        REQUIRE(samples[0] == Approx(0.5f));
+        REQUIRE(samples[1] == Approx(-0.5f));
+        REQUIRE(samples[2] == Approx(0.25f));
+        REQUIRE(samples[3] == Approx(-0.25f));
+        REQUIRE(samples[4] == Approx(0.f));
+        REQUIRE(samples[6] == Approx(0.25f));
+        REQUIRE(a.stats().active_voices == 1u);
+
+        a.pause(id, true);
+        a.mix(4u);
+        REQUIRE(samples[8] == Approx(0.f));
+        REQUIRE(a.stats().active_voices == 1u);
+
+        a.stop(id);
+        a.mix(4u);
+        REQUIRE(a.stats().active_voices == 0u);
+    }
+    {
+        vector<f32> samples;
+        audio a(d, std::make_unique<capture_sink>(samples), manual_parameters());
+
+        buffer file_data;
+        const sound src(1u, 100u, vector<f32>{0.1f, 0.2f, 0.3f, 0.4f});
+        REQUIRE(sounds::try_save_sound(src, sound_file_format::wav, file_data));
+
+        a.play(sounds::try_open_sound_stream(make_memory_stream(file_data)));
+        a.mix(8u);
+        REQUIRE(samples.size() == 16u);
+        REQUIRE(samples[0] == Approx(0.1f));
+        REQUIRE(samples[2] == Approx(0.2f));
+        REQUIRE(samples[4] == Approx(0.3f));
+        REQUIRE(samples[6] == Approx(0.4f));
+        REQUIRE(samples[8] == Approx(0.f));
+        REQUIRE(a.stats().active_voices == 0u);
+    }
+    {
+        vector<f32> samples;
+        audio a(d, std::make_unique<capture_sink>(samples), manual_parameters());
+        REQUIRE(a.play(sound_ptr()) == audio::invalid_voice);
+        REQUIRE(a.play(std::make_shared<sound>()) == audio::invalid_voice);
+        REQUIRE(a.play(sound_stream_uptr()) == audio::invalid_voice);
+    }
+    {
+        vector<f32> samples;
+        audio a(d, std::make_unique<capture_sink>(samples), manual_parameters());
+
+        vector<f32> src_samples(100u);
+        for ( std::size_t i = 0; i < src_samples.size(); ++i ) {
+            src_samples[i] = static_cast<f32>(i) * 0.01f;
+        }
+        buffer file_data;
+        const sound src(1u, 100u, src_samples);
+        REQUIRE(sounds::try_save_sound(src, sound_file_format::wav, file_data));
+
+        // the stream window is much smaller than the stream
+        a.play(sounds::try_open_sound_stream(make_memory_stream(file_data)));
+        a.mix(100u);
+        REQUIRE(samples.size() == 200u);
+        for ( std::size_t i = 0; i < 100u; ++i ) {
+            REQUIRE(samples[i * 2u] == Approx(src_samples[i]).margin(0.0001f));
+        }
+        REQUIRE(a.stats().stream_underruns == 0u);
+    }
+    {
+        audio a(d, std::make_unique<audio_null_sink>(), manual_parameters());
+        const auto s = std::make_shared<sound>(1u, 100u, vector<f32>{0.1f});
+        std::size_t rejected = 0u;
+        for ( std::size_t i = 0; i < 1100u; ++i ) {
+            if ( a.play(s) == audio::invalid_voice ) {
+                ++rejected;
+            }
+        }
+        REQUIRE(rejected == 76u);
+        REQUIRE_FALSE(a.stop_all());
+        REQUIRE(a.stats().dropped_commands == 77u);
+        REQUIRE(a.stats().dropped_voices == 76u);
+        a.mix(1u);
+        REQUIRE(a.stats().dropped_voices == 76u + 1024u - 256u);
+        REQUIRE(a.stop_all());
+    }
+    {
+        // more commands than the queue capacity are processed
+        // while the queue is drained by 'mix'
+        audio a(d, std::make_unique<audio_null_sink>(), manual_parameters()
+            .max_voices(3000u));
+        const auto s = std::make_shared<sound>(1u, 100u, vector<f32>(1000u, 0.1f));
+        for ( std::size_t i = 0; i < 3u; ++i ) {
+            for ( std::size_t j = 0; j < 1000u; ++j ) {
+                REQUIRE(a.play(s) != audio::invalid_voice);
+            }
+            a.mix(1u);
+        }
+        REQUIRE(a.stats().active_voices == 3000u);
+        REQUIRE(a.stats().dropped_commands == 0u);
+    }
+    {
+        // the mixer thread drains the queue while producers push
+        audio a(d, std::make_unique<audio_null_sink>(), audio::parameters()
+            .sample_rate(100u)
+            .block_frames(4u)
+            .max_voices(3000u)
+            .realtime(false));
+        const auto s = std::make_shared<sound>(1u, 100u, vector<f32>(100000u, 0.1f));
+        std::size_t played = 0u;
+        for ( std::size_t i = 0; i < 100000u && played < 3000u; ++i ) {
+            if ( a.play(s, 1.f, 1.f, true) != audio::invalid_voice ) {
+                ++played;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        REQUIRE(played == 3000u);
+        for ( std::size_t i = 0; i < 1000u && a.stats().active_voices < 3000u; ++i ) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(a.stats().active_voices == 3000u);
+    }
+    {
+        std::atomic<u64> blocks{0u};
+        audio a(d, std::make_unique<counting_sink>(blocks), audio::parameters()
+            .sample_rate(100u)
+            .block_frames(4u)
+            .realtime(false));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE(blocks == 0u);
+
+        a.play(std::make_shared<sound>(1u, 100u, vector<f32>(10u, 0.5f)));
+        for ( std::size_t i = 0; i < 1000u && a.stats().mixed_frames < 12u; ++i ) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE(a.stats().mixed_frames == 12u);
+        REQUIRE(a.stats().active_voices == 0u);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        REQUIRE(blocks == 3u);
+    }
+    {
+        audio a(d, std::make_unique<audio_null_sink>(), audio::parameters()
+            .mixer_thread(false));
+        REQUIRE_THROWS_AS(
+            audio(d, nullptr, audio::parameters()),
+            bad_audio_operation);
+    }
+}
@@ -7,6 +7,41 @@
 #include "_core.hpp"
 using namespace e2d;
 
+#if defined(E2D_PLATFORM) && E2D_PLATFORM == E2D_PLATFORM_LINUX
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace
+{
+    void drop_file_cache(str_view path) noexcept {
+    #if defined(E2D_PLATFORM) && E2D_PLATFORM == E2D_PLATFORM_LINUX
+        const int fd = ::open(make_utf8(path).c_str(), O_RDONLY);
+        if ( fd >= 0 ) {
+            ::fdatasync(fd);
+            ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            ::close(fd);
+        }
+    #else
+        E2D_UNUSED(path);
+    #endif
+    }
+
+    vector<buffer> load_all_async(const vfs& v, const vector<url>& urls) {
+        vector<stdex::promise<buffer>> promises;
+        promises.reserve(urls.size());
+        for ( const url& u : urls ) {
+            promises.push_back(v.load_async(u));
+        }
+        vector<buffer> result;
+        result.reserve(promises.size());
+        for ( stdex::promise<buffer>& p : promises ) {
+            result.push_back(p.get());
+        }
+        return result;
+    }
+}
+
 TEST_CASE("vfs"){
     const str_view file_path = "vfs_file_name";
     const str_view nofile_path = "vfs_file_name2";
@@ -46,6 +81,28 @@ TEST_CASE("vfs"){
 
             auto b3 = v.load_as_string_async({"file", file_path}).get();
             REQUIRE(b3 == "hello");
+
+            buffer b4;
+            REQUIRE(v.load({"file", file_path}, b4, true));
+            REQUIRE(b4 == buffer{"hello", 6});
+
+            auto b5 = v.load_async({"file", file_path}, true).get();
+            REQUIRE(b5 == buffer{"hello", 6});
+        }
+        {
+            streams::reset_statistics();
+            auto r = v.read({"file", file_path});
+            REQUIRE(r);
+            char c = '\0';
+            for ( const char e : str("hello") ) {
+                REQUIRE(r->read(&c, 1) == 1);
+                REQUIRE(c == e);
+            }
+            REQUIRE(r->read(&c, 1) == 0);
+            r.reset();
+            REQUIRE(streams::statistics().read_calls == 1);
+            REQUIRE(streams::statistics().seek_calls == 0);
+            REQUIRE(streams::statistics().buffered_reads == 4);
         }
     }
     {
@@ -55,6 +112,66 @@ TEST_CASE("vfs"){
         REQUIRE(v.resolve_scheme_aliases({"home", "file.txt"}) == url("file://~/file.txt"));
         REQUIRE(v.resolve_scheme_aliases({"save", "save.txt"}) == url("file://~/game/saves/save.txt"));
     }
+    {
+        vfs v;
+        REQUIRE(v.register_scheme_alias("data", url("file://.")));
+        REQUIRE_FALSE(v.exists({"data", file_path}));
+        REQUIRE(v.register_scheme<filesystem_file_source>("file"));
+        REQUIRE(v.exists({"data", file_path}));
+        REQUIRE(v.unregister_scheme("file"));
+        REQUIRE_FALSE(v.exists({"data", file_path}));
+        REQUIRE(v.resolve_scheme_aliases({"data", "file.txt"}) == url("file://./file.txt"));
+
+        REQUIRE(v.register_scheme_alias("loop1", url("loop2://a")));
+        REQUIRE(v.register_scheme_alias("loop2", url("loop1://b")));
+        REQUIRE_THROWS_AS(v.exists({"loop1", file_path}), bad_vfs_operation);
+        REQUIRE_THROWS_AS(v.resolve_scheme_aliases({"loop2", file_path}), bad_vfs_operation);
+        REQUIRE(v.unregister_scheme_alias("loop2"));
+        REQUIRE_FALSE(v.exists({"loop1", file_path}));
+        REQUIRE(v.resolve_scheme_aliases({"loop1", "c"}) == url("loop2://a/c"));
+    }
+    {
+        const str dir_path = "vfs_listing_cache";
+        if ( filesystem::directory_exists(dir_path) ) {
+            REQUIRE(filesystem::remove_directory(dir_path));
+        }
+        REQUIRE(filesystem::create_directory(dir_path));
+
+        vfs v;
+        REQUIRE(v.register_scheme<filesystem_file_source>(
+            "file",
+            filesystem_file_source::default_read_ahead,
+            filesystem_file_source::default_async_queue_depth,
+            true));
+        REQUIRE(v.register_scheme_alias("cached", url("file", dir_path)));
+
+        REQUIRE_FALSE(v.exists({"cached", "a.txt"}));
+        REQUIRE_FALSE(v.exists({"cached", "sub/b.txt"}));
+
+        // external changes are invisible until the invalidation
+        REQUIRE(filesystem::try_write_all(buffer{"a", 1}, path::combine(dir_path, "a.txt"), false));
+        REQUIRE(filesystem::create_directory(path::combine(dir_path, "sub")));
+        REQUIRE(filesystem::try_write_all(buffer{"b", 1}, path::combine(dir_path, "sub/b.txt"), false));
+        REQUIRE_FALSE(v.exists({"cached", "a.txt"}));
+        REQUIRE_FALSE(v.exists({"cached", "sub/b.txt"}));
+        v.invalidate({"cached", "a.txt"});
+        REQUIRE(v.exists({"cached", "a.txt"}));
+        REQUIRE(v.exists({"cached", "sub/b.txt"}));
+        REQUIRE_FALSE(v.exists({"cached", "sub"}));
+
+        // writes through the source invalidate the listing
+        REQUIRE_FALSE(v.exists({"cached", "sub/c.txt"}));
+        REQUIRE(streams::try_write_tail(buffer{"c", 1}, v.write({"cached", "sub/c.txt"}, false)));
+        REQUIRE(v.exists({"cached", "sub/c.txt"}));
+
+        REQUIRE(filesystem::remove_file(path::combine(dir_path, "a.txt")));
+        REQUIRE(v.exists({"cached", "a.txt"}));
+        v.invalidate({"file", ""});
+        REQUIRE_FALSE(v.exists({"cached", "a.txt"}));
+        REQUIRE(v.exists({"cached", "sub/c.txt"}));
+
+        REQUIRE(filesystem::remove_directory(dir_path));
+    }
     SECTION("archive"){
         vfs v;
         {
@@ -200,4 +317,173 @@ TEST_CASE("vfs"){
             }
         }
     }
+    SECTION("pack"){
+        const str_view pack_path = "vfs_pack_file_name.e2d";
+        {
+            pack_writer w(make_write_file(pack_path, false));
+            REQUIRE(w.add("test.txt", buffer("hello", 5), pack_codec::store));
+            REQUIRE(w.add("folder/file.txt", buffer("world", 5), pack_codec::lz4));
+            REQUIRE(w.add("folder/subfolder/file.txt", buffer("!", 1), pack_codec::lz4));
+            REQUIRE(w.finish());
+        }
+        vfs v;
+        REQUIRE_FALSE(v.register_scheme<pack_file_source>(
+            "pack",
+            make_read_file("vfs_nopack_file_name.e2d")));
+        REQUIRE(v.register_scheme<pack_file_source>(
+            "pack",
+            make_read_file(pack_path)));
+
+        REQUIRE(v.exists({"pack", "test.txt"}));
+        REQUIRE(v.exists({"pack", "folder/file.txt"}));
+        REQUIRE_FALSE(v.exists({"pack", "TEst.txt"}));
+        REQUIRE_FALSE(v.exists({"pack", "folder"}));
+        {
+            vector<std::pair<str,bool>> result;
+            REQUIRE(v.extract(url("pack://folder"), std::back_inserter(result)));
+            std::sort(result.begin(), result.end());
+            REQUIRE(result == vector<std::pair<str, bool>>{
+                {"folder/file.txt", false},
+                {"folder/subfolder/", true},
+                {"folder/subfolder/file.txt", false}
+            });
+            REQUIRE_FALSE(v.extract(url("pack://fold"), std::back_inserter(result)));
+            REQUIRE_FALSE(v.extract(url("pack://test.txt"), std::back_inserter(result)));
+        }
+        {
+            buffer b;
+            REQUIRE(v.load(url("pack://test.txt"), b));
+            REQUIRE(b == buffer("hello", 5));
+            REQUIRE(v.load(url("pack://folder/file.txt"), b));
+            REQUIRE(b == buffer("world", 5));
+            REQUIRE(v.load_async(url("pack://folder/subfolder/file.txt")).get() == buffer("!", 1));
+            REQUIRE_FALSE(v.load(url("pack://TEst.txt"), b));
+            REQUIRE(v.write(url("pack://test.txt"), false) == output_stream_uptr());
+        }
+        REQUIRE(v.unregister_scheme("pack"));
+        REQUIRE(filesystem::remove_file(pack_path));
+    }
+}
+
+TEST_CASE("vfs_load_async"){
+    const str dir_path = "vfs_load_async_files";
+#if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+    const std::size_t file_count = 500;
+#else
+    const std::size_t file_count = 4000;
+#endif
+    vector<url> urls;
+    vector<buffer> contents;
+    {
+        REQUIRE(filesystem::create_directory(dir_path));
+        for ( std::size_t i = 0; i < file_count; ++i ) {
+            const str file_path = path::combine(dir_path, strings::rformat("%0.bin", i));
+            buffer content(i % 7 ? 256u + (i * 37u) % 3840u : 0u);
+            for ( std::size_t j = 0; j < content.size(); ++j ) {
+                content.data()[j] = static_cast<u8>(i + j);
+            }
+            REQUIRE(filesystem::try_write_all(content, file_path, false));
+            urls.push_back(url("file", file_path));
+            contents.push_back(std::move(content));
+        }
+    }
+    {
+        for ( const std::size_t queue_depth : {std::size_t(0u), std::size_t(1u), std::size_t(64u)} ) {
+            vfs v;
+            REQUIRE(v.register_scheme<filesystem_file_source>(
+                "file",
+                filesystem_file_source::default_read_ahead,
+                queue_depth));
+
+            const vector<buffer> result = load_all_async(v, urls);
+            REQUIRE(result == contents);
+
+            REQUIRE_THROWS_AS(
+                v.load_async(url("file", path::combine(dir_path, "missing.bin"))).get(),
+                vfs_load_async_exception);
+
+            buffer b;
+            REQUIRE(v.load(urls[1], b));
+            REQUIRE(b == contents[1]);
+            REQUIRE_FALSE(v.load(url("file", path::combine(dir_path, "missing.bin")), b));
+
+            // nested loading from a continuation goes to the fallback
+            const buffer nested = v.load_async(urls[1])
+                .then([&v, &urls](auto&&){
+                    return v.load_async(urls[2]);
+                }).get();
+            REQUIRE(nested == contents[2]);
+        }
+    }
+    {
+        std::printf("-= vfs::load_async performance tests =-\n");
+        for ( const std::size_t queue_depth : {std::size_t(0u), std::size_t(64u)} ) {
+            vfs v;
+            REQUIRE(v.register_scheme<filesystem_file_source>(
+                "file",
+                filesystem_file_source::default_read_ahead,
+                queue_depth));
+
+            filesystem_file_source probe(0u, queue_depth);
+            const str suffix = strings::rformat(
+                " [%0 files, %1]",
+                file_count,
+                probe.native_async() ? "native" : "fallback");
+
+            for ( const url& u : urls ) {
+                drop_file_cache(u.path());
+            }
+            {
+                e2d_untests::verbose_profiler_ms p("vfs::load_async(cold)" + suffix);
+                p.done(load_all_async(v, urls).size());
+            }
+            {
+                e2d_untests::verbose_profiler_ms p("vfs::load_async(warm)" + suffix);
+                p.done(load_all_async(v, urls).size());
+            }
+        }
+    }
+    {
+        for ( const url& u : urls ) {
+            REQUIRE(filesystem::remove_file(u.path()));
+        }
+        REQUIRE(filesystem::remove_directory(dir_path));
+    }
+}
+
+TEST_CASE("vfs_exists_performance"){
+#if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+    const std::size_t probe_count = 10000u;
+#else
+    const std::size_t probe_count = 100000u;
+#endif
+    const str_view file_path = "vfs_exists_file_name";
+    REQUIRE(filesystem::try_write_all(buffer{"hello", 5}, file_path, false));
+    {
+        std::printf("-= vfs::performance tests =-\n");
+        for ( const bool listing_cache : {false, true} ) {
+            vfs v;
+            REQUIRE(v.register_scheme<filesystem_file_source>(
+                "file",
+                filesystem_file_source::default_read_ahead,
+                filesystem_file_source::default_async_queue_depth,
+                listing_cache));
+            REQUIRE(v.register_scheme_alias("home", url("file://.")));
+            REQUIRE(v.register_scheme_alias("data", url("home://")));
+
+            const url hit{"data", file_path};
+            const url miss{"data", "vfs_exists_file_name2"};
+            e2d_untests::verbose_profiler_ms p(listing_cache
+                ? "vfs::exists(listing cache)"
+                : "vfs::exists");
+            std::size_t found = 0;
+            for ( std::size_t i = 0; i < probe_count; ++i ) {
+                found += v.exists(hit) ? 1u : 0u;
+                found += v.exists(miss) ? 1u : 0u;
+            }
+            p.done(found);
+            REQUIRE(found == probe_count);
+        }
+    }
+    REQUIRE(filesystem::remove_file(file_path));
 }
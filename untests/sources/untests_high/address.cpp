@@ -28,4 +28,13 @@ TEST_CASE("address") {
         REQUIRE(address::nested("at/las.json:/spr/ite.png:/") == "spr/ite.png:/");
         REQUIRE(address::nested("at/las.json:/spr/ite.png:/chi/ld") == "spr/ite.png:/chi/ld");
     }
+    SECTION("views") {
+        const str address = "at/las.json:/spr/ite.png";
+        REQUIRE(address::parent_view(address) == "at/las.json");
+        REQUIRE(address::parent_view(address).data() == address.data());
+        REQUIRE(address::nested_view(address) == "spr/ite.png");
+        REQUIRE(address::nested_view(address).data() == address.data() + 13);
+        REQUIRE(address::parent_view(":/") == "");
+        REQUIRE(address::nested_view("at/las.json") == "");
+    }
 }
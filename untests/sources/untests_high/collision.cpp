@@ -0,0 +1,244 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+#include <random>
+using namespace e2d;
+
+namespace
+{
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("collision_untests", "enduro2d")
+                        .without_graphics(true)
+                        .without_audio(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+
+    ecs::entity make_collider(ecs::registry& owner, const v2f& pos, const collider& c) {
+        node_iptr n = node::create();
+        n->translation(v3f(pos, 0.f));
+        ecs::entity e = owner.create_entity();
+        e.assign_component<actor>(n);
+        e.assign_component<collider>(c);
+        return e;
+    }
+
+    bool has_contact(
+        const vector<collision::contact>& contacts,
+        ecs::entity_id a,
+        ecs::entity_id b)
+    {
+        return std::find_if(contacts.begin(), contacts.end(), [a,b](const collision::contact& c){
+            return (c.first == a && c.second == b)
+                || (c.first == b && c.second == a);
+        }) != contacts.end();
+    }
+}
+
+TEST_CASE("collision") {
+    safe_starter_initializer initializer;
+    {
+        collider c;
+        c.polygon(vector<v2f>{
+            {0.f, 0.f}, {2.f, 0.f}, {1.f, 1.f}, {2.f, 2.f}, {0.f, 2.f}});
+        REQUIRE(c.type() == collider::types::polygon);
+        REQUIRE(c.vertices().size() == 4u);
+        REQUIRE(c.layer() == 1u);
+        REQUIRE(c.mask() == ~0u);
+        REQUIRE(c.enabled());
+    }
+    {
+        ecs::registry owner;
+        collision col;
+
+        ecs::entity e1 = make_collider(owner, v2f(0.f, 0.f), collider().circle(v2f::zero(), 1.f));
+        ecs::entity e2 = make_collider(owner, v2f(1.5f, 0.f), collider().circle(v2f::zero(), 1.f));
+        ecs::entity e3 = make_collider(owner, v2f(10.f, 0.f), collider().rect(b2f(-1.f, -1.f, 2.f, 2.f)));
+        ecs::entity e4 = make_collider(owner, v2f(10.5f, 0.5f), collider().polygon(vector<v2f>{
+            {0.f, 0.f}, {2.f, 0.f}, {0.f, 2.f}}));
+
+        col.update(owner);
+        REQUIRE(col.proxy_count() == 4u);
+
+        vector<collision::contact> contacts;
+        col.find_contacts(contacts);
+        REQUIRE(contacts.size() == 2u);
+        REQUIRE(has_contact(contacts, e1.id(), e2.id()));
+        REQUIRE(has_contact(contacts, e3.id(), e4.id()));
+
+        vector<ecs::entity_id> result;
+        col.overlap(b2f(-0.5f, -0.5f, 0.8f, 0.8f), ~0u, result);
+        REQUIRE(result.size() == 1u);
+        REQUIRE(result[0] == e1.id());
+
+        col.overlap(b2f(8.5f, 2.5f, 0.1f, 0.1f), ~0u, result);
+        REQUIRE(result.empty());
+
+        collision::raycast_hit hit;
+        REQUIRE(col.raycast(collision::ray{v2f(-5.f, 0.f), v2f(1.f, 0.f), 100.f}, hit));
+        REQUIRE(hit.entity == e1.id());
+        REQUIRE(hit.distance == Approx(4.f));
+        REQUIRE(hit.point.x == Approx(-1.f));
+        REQUIRE(hit.normal.x == Approx(-1.f));
+
+        REQUIRE(col.raycast(collision::ray{v2f(20.f, 0.75f), v2f(-1.f, 0.f), 100.f}, hit));
+        REQUIRE(hit.entity == e4.id());
+        REQUIRE(hit.point.x == Approx(12.25f));
+        REQUIRE(hit.normal.x == Approx(0.7071f).epsilon(0.001f));
+
+        REQUIRE_FALSE(col.raycast(collision::ray{v2f(-5.f, 0.f), v2f(1.f, 0.f), 3.f}, hit));
+        REQUIRE_FALSE(col.raycast(collision::ray{v2f(-5.f, 5.f), v2f(1.f, 0.f), 100.f}, hit));
+
+        e2.get_component<actor>().node()->translation(v3f(50.f, 0.f, 0.f));
+        e4.get_component<collider>().layer(2u);
+        e3.get_component<collider>().mask(1u);
+        col.update(owner);
+        col.find_contacts(contacts);
+        REQUIRE(contacts.empty());
+
+        e1.remove_component<collider>();
+        e3.destroy();
+        col.update(owner);
+        REQUIRE(col.proxy_count() == 2u);
+        col.overlap(b2f(-0.5f, -0.5f, 1.f, 1.f), ~0u, result);
+        REQUIRE(result.empty());
+        col.overlap(b2f(49.f, -1.f, 2.f, 2.f), ~0u, result);
+        REQUIRE(result.size() == 1u);
+        REQUIRE(result[0] == e2.id());
+        col.overlap(b2f(10.5f, 0.5f, 1.f, 1.f), 1u, result);
+        REQUIRE(result.empty());
+    }
+    {
+        ecs::registry owner;
+        collision col(collision::parameters().parallel_threshold(8u));
+
+        vector<ecs::entity> entities;
+        for ( std::size_t i = 0; i < 100u; ++i ) {
+            entities.push_back(make_collider(
+                owner,
+                v2f(static_cast<f32>(i) * 1.5f, 0.f),
+                collider().rect(b2f(0.f, 0.f, 1.f, 1.f))));
+        }
+        col.update(owner);
+        REQUIRE(col.proxy_count() == 100u);
+        REQUIRE(col.tree_height() < 16u);
+
+        vector<collision::contact> contacts;
+        col.find_contacts(contacts);
+        REQUIRE(contacts.empty());
+
+        for ( ecs::entity& e : entities ) {
+            e.get_component<collider>().rect(b2f(0.f, 0.f, 2.f, 1.f));
+        }
+        col.update(owner);
+        col.find_contacts(contacts);
+        REQUIRE(contacts.size() == 99u);
+
+        vector<b2f> areas;
+        vector<collision::ray> rays;
+        for ( std::size_t i = 0; i < 100u; ++i ) {
+            areas.push_back(b2f(static_cast<f32>(i) * 1.5f + 0.6f, 0.1f, 0.1f, 0.1f));
+            rays.push_back(collision::ray{
+                v2f(static_cast<f32>(i) * 1.5f + 0.75f, -1.f), v2f(0.f, 1.f), 10.f});
+        }
+
+        vector<vector<ecs::entity_id>> overlaps;
+        col.overlap(areas, ~0u, overlaps);
+        REQUIRE(overlaps.size() == 100u);
+        for ( std::size_t i = 0; i < 100u; ++i ) {
+            REQUIRE(overlaps[i].size() == 1u);
+            REQUIRE(overlaps[i][0] == entities[i].id());
+        }
+
+        vector<collision::raycast_hit> hits;
+        col.raycast(rays, hits);
+        REQUIRE(hits.size() == 100u);
+        for ( std::size_t i = 0; i < 100u; ++i ) {
+            REQUIRE(hits[i].hit);
+            REQUIRE(hits[i].entity == entities[i].id());
+            REQUIRE(hits[i].distance == Approx(1.f));
+        }
+    }
+    {
+        std::printf("-= collision::performance tests =-\n");
+    #if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+        const std::size_t task_ns[] = {10'000};
+    #else
+        const std::size_t task_ns[] = {10'000, 50'000, 100'000};
+    #endif
+        for ( const std::size_t task_n : task_ns ) {
+            std::mt19937 rng(42u);
+            const f32 side = math::sqrt(static_cast<f32>(task_n)) * 8.f;
+            std::uniform_real_distribution<f32> pos_dist(0.f, side);
+            std::uniform_real_distribution<f32> size_dist(1.f, 4.f);
+
+            ecs::registry owner;
+            collision col;
+
+            vector<node_iptr> nodes;
+            for ( std::size_t i = 0; i < task_n; ++i ) {
+                const v2f pos(pos_dist(rng), pos_dist(rng));
+                const f32 size = size_dist(rng);
+                ecs::entity e = i % 2u
+                    ? make_collider(owner, pos, collider().circle(v2f::zero(), size * 0.5f))
+                    : make_collider(owner, pos, collider().rect(b2f(size, size)));
+                nodes.push_back(e.get_component<actor>().node());
+            }
+
+            vector<b2f> areas;
+            vector<collision::ray> rays;
+            for ( std::size_t i = 0; i < 1000u; ++i ) {
+                areas.push_back(b2f(pos_dist(rng), pos_dist(rng), 16.f, 16.f));
+                rays.push_back(collision::ray{
+                    v2f(pos_dist(rng), pos_dist(rng)),
+                    v2f(pos_dist(rng) - side * 0.5f, pos_dist(rng) - side * 0.5f),
+                    64.f});
+            }
+
+            vector<collision::contact> contacts;
+            vector<vector<ecs::entity_id>> overlaps;
+            vector<collision::raycast_hit> hits;
+
+            const str suffix = strings::rformat(" [%0 colliders]", task_n);
+            {
+                e2d_untests::verbose_profiler_ms p("collision::update(insert)" + suffix);
+                col.update(owner);
+                p.done(col.proxy_count());
+            }
+            {
+                for ( std::size_t i = 0; i < task_n; i += 10u ) {
+                    nodes[i]->translation(nodes[i]->translation() + v3f(1.f, 1.f, 0.f));
+                }
+                e2d_untests::verbose_profiler_ms p("collision::update(move 10%)" + suffix);
+                col.update(owner);
+                p.done(col.tree_height());
+            }
+            {
+                e2d_untests::verbose_profiler_ms p("collision::find_contacts" + suffix);
+                col.find_contacts(contacts);
+                p.done(contacts.size());
+            }
+            {
+                e2d_untests::verbose_profiler_ms p("collision::overlap(x1000)" + suffix);
+                col.overlap(areas, ~0u, overlaps);
+                p.done(overlaps.size());
+            }
+            {
+                e2d_untests::verbose_profiler_ms p("collision::raycast(x1000)" + suffix);
+                col.raycast(rays, hits);
+                p.done(hits.size());
+            }
+        }
+    }
+}
@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+#include "../../../sources/enduro2d/high/systems/render_system_impl/render_system_dirty.hpp"
+using namespace e2d;
+using namespace e2d::render_system_impl;
+
+namespace
+{
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("dirty_tracker_untests", "enduro2d")
+                        .without_graphics(true)
+                        .without_audio(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+
+    gobject_iptr make_shape(world& w, const shape_asset::ptr& shp, const material_asset::ptr& mat) {
+        gobject_iptr go = w.instantiate();
+        go->entity_filler()
+            .component<renderer>(renderer().materials({mat}))
+            .component<shape_renderer>(shape_renderer(shp));
+        return go;
+    }
+
+    const vector<b2u>& track_frame(
+        dirty_tracker& tracker,
+        const camera& cam,
+        std::initializer_list<gobject_iptr> gobjects)
+    {
+        tracker.begin(cam, nullptr, cam.viewport());
+        for ( const gobject_iptr& go : gobjects ) {
+            tracker.track(go->get_component<actor>()->node());
+        }
+        return tracker.end();
+    }
+}
+
+TEST_CASE("dirty_tracker") {
+    safe_starter_initializer initializer;
+    world& w = the<world>();
+
+    shape shp;
+    shp.set_vertices({v2f(0.f, 0.f), v2f(0.125f, 0.f), v2f(0.f, 0.125f)});
+    shp.set_indices(0u, {0u, 1u, 2u});
+    const shape_asset::ptr shp_a = shape_asset::create(shp);
+    const material_asset::ptr mat_a = material_asset::create(render::material());
+
+    // identity projection maps [-1, 1] to the viewport,
+    // the shape covers pixels [50, 56.25] with the one pixel border
+    const camera cam = camera().viewport(b2u(100u, 100u));
+    const b2u shape_region(49u, 49u, 9u, 9u);
+
+    gobject_iptr go1 = make_shape(w, shp_a, mat_a);
+    gobject_iptr go2 = make_shape(w, shp_a, mat_a);
+    go2->get_component<actor>()->node()->translation(v3f(-0.5f, -0.5f, 0.f));
+
+    dirty_tracker tracker;
+    SECTION("first_frame") {
+        const vector<b2u>& regions = track_frame(tracker, cam, {go1});
+        REQUIRE(regions.size() == 1u);
+        REQUIRE(regions[0] == cam.viewport());
+        REQUIRE(track_frame(tracker, cam, {go1}).empty());
+    }
+    SECTION("move") {
+        track_frame(tracker, cam, {go1});
+        go1->get_component<actor>()->node()->translation(v3f(0.5f, 0.f, 0.f));
+        const vector<b2u>& regions = track_frame(tracker, cam, {go1});
+        REQUIRE(regions.size() == 2u);
+        REQUIRE(std::find(regions.begin(), regions.end(), shape_region) != regions.end());
+        REQUIRE(std::find(regions.begin(), regions.end(), b2u(74u, 49u, 9u, 9u)) != regions.end());
+        REQUIRE(track_frame(tracker, cam, {go1}).empty());
+    }
+    SECTION("tint") {
+        track_frame(tracker, cam, {go1});
+        go1->get_component<shape_renderer>()->tint(color32::red());
+        const vector<b2u>& regions = track_frame(tracker, cam, {go1});
+        REQUIRE(regions.size() == 1u);
+        REQUIRE(regions[0] == shape_region);
+        REQUIRE(track_frame(tracker, cam, {go1}).empty());
+    }
+    SECTION("properties") {
+        track_frame(tracker, cam, {go1});
+        go1->get_component<renderer>()->properties(render::property_block()
+            .property("u_color", v4f(1.f, 0.f, 0.f, 1.f)));
+        const vector<b2u>& regions = track_frame(tracker, cam, {go1});
+        REQUIRE(regions.size() == 1u);
+        REQUIRE(regions[0] == shape_region);
+        REQUIRE(track_frame(tracker, cam, {go1}).empty());
+
+        go1->get_component<renderer>()->properties(render::property_block()
+            .property("u_color", v4f(1.f, 0.f, 0.f, 1.f)));
+        REQUIRE(track_frame(tracker, cam, {go1}).empty());
+    }
+    SECTION("add") {
+        track_frame(tracker, cam, {go1});
+        const vector<b2u>& regions = track_frame(tracker, cam, {go1, go2});
+        REQUIRE(regions.size() == 1u);
+        REQUIRE(regions[0] == b2u(24u, 24u, 9u, 9u));
+        REQUIRE(track_frame(tracker, cam, {go1, go2}).empty());
+    }
+    SECTION("remove") {
+        track_frame(tracker, cam, {go2, go1});
+        const vector<b2u>& regions = track_frame(tracker, cam, {go2});
+        REQUIRE(regions.size() == 1u);
+        REQUIRE(regions[0] == shape_region);
+        REQUIRE(track_frame(tracker, cam, {go2}).empty());
+    }
+    SECTION("spawn") {
+        track_frame(tracker, cam, {go1});
+        const vector<b2u>& regions = track_frame(tracker, cam, {go2, go1});
+        REQUIRE(regions.size() == 1u);
+        REQUIRE(regions[0] == b2u(24u, 24u, 9u, 9u));
+        REQUIRE(track_frame(tracker, cam, {go2, go1}).empty());
+    }
+    SECTION("reorder") {
+        track_frame(tracker, cam, {go1, go2});
+        REQUIRE(track_frame(tracker, cam, {go2, go1}).empty());
+
+        gobject_iptr go3 = make_shape(w, shp_a, mat_a);
+        go3->get_component<actor>()->node()->translation(v3f(0.04f, 0.04f, 0.f));
+        track_frame(tracker, cam, {go1, go2, go3});
+        const vector<b2u>& regions = track_frame(tracker, cam, {go3, go2, go1});
+        REQUIRE(regions.size() == 1u);
+        REQUIRE(regions[0] == b2u(51u, 51u, 7u, 7u));
+        REQUIRE(track_frame(tracker, cam, {go3, go2, go1}).empty());
+        w.destroy_instance(go3);
+    }
+    SECTION("generation") {
+        track_frame(tracker, cam, {go1});
+        const u64 generation = shp_a->generation();
+        shp_a->fill(shape(shp));
+        REQUIRE(shp_a->generation() != generation);
+        const vector<b2u>& regions = track_frame(tracker, cam, {go1});
+        REQUIRE(regions.size() == 1u);
+        REQUIRE(regions[0] == shape_region);
+    }
+    SECTION("invalidate") {
+        track_frame(tracker, cam, {go1});
+        tracker.invalidate();
+        const vector<b2u>& regions = track_frame(tracker, cam, {go1});
+        REQUIRE(regions.size() == 1u);
+        REQUIRE(regions[0] == cam.viewport());
+    }
+
+    w.destroy_instance(go1);
+    w.destroy_instance(go2);
+}
@@ -0,0 +1,188 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+#include "../../../sources/enduro2d/high/systems/render_system_impl/render_system_drawer.hpp"
+using namespace e2d;
+using namespace e2d::render_system_impl;
+
+namespace
+{
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("drawer_untests", "enduro2d")
+                        .without_graphics(true)
+                        .without_audio(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+
+    shape_asset::ptr make_quad_shape() {
+        shape shp;
+        shp.set_vertices({v2f(0.f, 0.f), v2f(1.f, 0.f), v2f(1.f, 1.f), v2f(0.f, 1.f)});
+        shp.set_uvs(0u, {v2f(0.f, 0.f), v2f(1.f, 0.f), v2f(1.f, 1.f), v2f(0.f, 1.f)});
+        shp.set_indices(0u, {0u, 1u, 2u, 2u, 3u, 0u});
+        return shape_asset::create(shp);
+    }
+
+    mesh_asset::ptr make_triangle_mesh(f32 size) {
+        mesh msh;
+        msh.set_vertices({v3f(-size, -size, 0.f), v3f(size, -size, 0.f), v3f(0.f, size, 0.f)});
+        msh.set_indices(0u, {0u, 1u, 2u});
+        return mesh_asset::create(std::move(msh));
+    }
+
+    model make_lod_model() {
+        model mdl;
+        mdl.set_mesh(make_triangle_mesh(1.f))
+            .add_lod(make_triangle_mesh(0.5f), 0.5f)
+            .add_lod(make_triangle_mesh(0.25f), 0.1f);
+        return mdl;
+    }
+
+    // 90 degrees vertical field of view, so the [1][1] element is 1
+    m4f make_perspective() {
+        return math::make_perspective_lh_matrix4(make_deg(90.f), 1.f, 0.1f, 1000.f);
+    }
+
+    std::size_t recorded_batches(drawer::recording& rec) {
+        std::size_t count = 0u;
+        for ( std::size_t i = 0; i < rec.flushes.size(); ++i ) {
+            count += rec.flushes[i].batches.size();
+        }
+        return count;
+    }
+}
+
+TEST_CASE("drawer_lods") {
+    safe_starter_initializer initializer;
+    const model mdl = make_lod_model();
+    const m4f proj = make_perspective();
+    const f32 r = mdl.bounds_radius();
+    const f32 cz = mdl.bounds_center().z;
+
+    SECTION("model_screen_size") {
+        REQUIRE(math::approximately(
+            model_screen_size(mdl, math::make_translation_matrix4(0.f, 0.f, 10.f), proj, 1.f),
+            r / (cz + 10.f)));
+        REQUIRE(math::approximately(
+            model_screen_size(mdl, math::make_translation_matrix4(0.f, 0.f, 10.f), proj, 2.f),
+            2.f * r / (cz + 10.f)));
+        REQUIRE(math::approximately(
+            model_screen_size(mdl,
+                math::make_scale_matrix4(2.f, 2.f, 2.f) *
+                math::make_translation_matrix4(0.f, 0.f, 10.f), proj, 1.f),
+            2.f * r / (2.f * cz + 10.f)));
+        REQUIRE(math::approximately(
+            model_screen_size(mdl, math::make_translation_matrix4(0.f, 0.f, -10.f), proj, 1.f),
+            0.f));
+    }
+    SECTION("lod_selector") {
+        lod_selector lods;
+        int key = 0;
+
+        // without a key levels switch exactly at their sizes
+        REQUIRE(lods.select(nullptr, mdl, 1.f) == 0u);
+        REQUIRE(lods.select(nullptr, mdl, 0.46f) == 1u);
+        REQUIRE(lods.select(nullptr, mdl, 0.05f) == 2u);
+
+        // with a key levels are kept within the hysteresis
+        REQUIRE(lods.select(&key, mdl, 1.f) == 0u);
+        REQUIRE(lods.select(&key, mdl, 0.46f) == 0u);
+        REQUIRE(lods.select(&key, mdl, 0.4f) == 1u);
+        REQUIRE(lods.select(&key, mdl, 0.54f) == 1u);
+        REQUIRE(lods.select(&key, mdl, 0.05f) == 2u);
+        REQUIRE(lods.select(&key, mdl, 0.6f) == 0u);
+
+        // unused models are forgotten and start from the level 0 again
+        REQUIRE(lods.select(&key, mdl, 0.4f) == 1u);
+        REQUIRE(lods.select(&key, mdl, 0.46f) == 1u);
+        for ( u32 i = 0; i <= lod_selector::max_unused_frames * 2u; ++i ) {
+            lods.end_frame();
+        }
+        REQUIRE(lods.select(&key, mdl, 0.46f) == 0u);
+    }
+    SECTION("record") {
+        if ( !modules::is_initialized<render>() ) {
+            return;
+        }
+
+        const renderer node_r = renderer().materials({
+            material_asset::create(render::material())});
+        const model_renderer mdl_r(model_asset::create(make_lod_model()));
+        drawer d(the<engine>(), the<debug>(), the<render>());
+        drawer::recording rec;
+        lod_selector lods;
+        d.record(rec, camera().projection(make_perspective()), m4f::identity(), 0.f, &lods,
+        [&](drawer::context& ctx){
+            // projected sizes are 1, 0.25 and 0.05 of the viewport height
+            ctx.draw(math::make_translation_matrix4(0.f, 0.f, r - cz), node_r, mdl_r);
+            ctx.draw(math::make_translation_matrix4(0.f, 0.f, 4.f * r - cz), node_r, mdl_r);
+            ctx.draw(math::make_translation_matrix4(0.f, 0.f, 20.f * r - cz), node_r, mdl_r);
+        });
+        REQUIRE(rec.models.size() == 3u);
+        REQUIRE(rec.models[0].lod == 0u);
+        REQUIRE(rec.models[1].lod == 1u);
+        REQUIRE(rec.models[2].lod == 2u);
+        rec.reset();
+    }
+}
+
+TEST_CASE("drawer") {
+    safe_starter_initializer initializer;
+    if ( !modules::is_initialized<render>() ) {
+        return;
+    }
+
+    const texture_ptr tex = the<render>().create_texture(image(
+        v2u(2u, 2u),
+        image_data_format::rgba8,
+        buffer(2u * 2u * 4u)));
+    if ( !tex ) {
+        return;
+    }
+
+    const texture_asset::ptr tex_a = texture_asset::create(tex);
+    const material_asset::ptr mat_a = material_asset::create(render::material());
+    const shape_asset::ptr shp_a = make_quad_shape();
+    const sprite_asset::ptr spr_a = sprite_asset::create(sprite()
+        .set_texrect(b2f(2.f, 2.f))
+        .set_texture(tex_a));
+
+    const renderer node_r = renderer().materials({mat_a});
+    const sprite_renderer spr_r(spr_a);
+    const shape_renderer textured_shp_r = shape_renderer(shp_a).texture(tex_a);
+    const shape_renderer untextured_shp_r(shp_a);
+
+    drawer d(the<engine>(), the<debug>(), the<render>());
+    drawer::recording rec;
+
+    SECTION("textured_shapes_and_sprites") {
+        d.record(rec, camera(), m4f::identity(), 0.f, nullptr, [&](drawer::context& ctx){
+            ctx.draw(m4f::identity(), node_r, spr_r);
+            ctx.draw(math::make_translation_matrix4(1.f, 0.f, 0.f), node_r, textured_shp_r);
+            ctx.draw(math::make_translation_matrix4(2.f, 0.f, 0.f), node_r, spr_r);
+        });
+        REQUIRE(recorded_batches(rec) == 1u);
+        REQUIRE(rec.triangles == 6u);
+    }
+    SECTION("untextured_shapes") {
+        d.record(rec, camera(), m4f::identity(), 0.f, nullptr, [&](drawer::context& ctx){
+            ctx.draw(m4f::identity(), node_r, spr_r);
+            ctx.draw(math::make_translation_matrix4(1.f, 0.f, 0.f), node_r, untextured_shp_r);
+            ctx.draw(math::make_translation_matrix4(2.f, 0.f, 0.f), node_r, untextured_shp_r);
+        });
+        REQUIRE(recorded_batches(rec) == 2u);
+    }
+
+    rec.reset();
+}
@@ -0,0 +1,93 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+namespace
+{
+    const f32 target = 1.f / 60.f;
+
+    dynamic_resolution::parameters make_params() {
+        return dynamic_resolution::parameters()
+            .enabled(true)
+            .min_scale(0.5f)
+            .max_scale(1.f)
+            .scale_step(0.1f)
+            .target_frame_time(target)
+            .downscale_threshold(1.15f)
+            .upscale_threshold(1.05f)
+            .history_size(10u);
+    }
+
+    std::size_t feed(dynamic_resolution& dr, f32 frame_time, std::size_t frames) {
+        std::size_t changes = 0u;
+        for ( std::size_t i = 0; i < frames; ++i ) {
+            if ( dr.update(frame_time) ) {
+                ++changes;
+            }
+        }
+        return changes;
+    }
+}
+
+TEST_CASE("dynamic_resolution") {
+    SECTION("disabled") {
+        dynamic_resolution dr;
+        REQUIRE_FALSE(dr.enabled());
+        REQUIRE(feed(dr, target * 4.f, 100u) == 0u);
+        REQUIRE(math::approximately(dr.scale(), 1.f));
+        REQUIRE(dr.scaled_size(v2u(640u, 480u)) == v2u(640u, 480u));
+    }
+    SECTION("downscale") {
+        dynamic_resolution dr(make_params());
+        REQUIRE_FALSE(feed(dr, target * 2.f, 9u));
+        REQUIRE(math::approximately(dr.scale(), 1.f));
+        REQUIRE(dr.update(target * 2.f));
+        REQUIRE(math::approximately(dr.scale(), 0.9f));
+        REQUIRE(math::approximately(dr.smoothed_frame_time(), 0.f));
+
+        REQUIRE(feed(dr, target * 2.f, 1000u) == 4u);
+        REQUIRE(math::approximately(dr.scale(), 0.5f));
+        REQUIRE(dr.scaled_size(v2u(640u, 480u)) == v2u(320u, 240u));
+        REQUIRE(dr.scaled_size(v2u(1u, 0u)) == v2u(1u, 1u));
+    }
+    SECTION("hysteresis") {
+        dynamic_resolution dr(make_params());
+        REQUIRE(feed(dr, target * 2.f, 10u) == 1u);
+        REQUIRE(feed(dr, target * 1.1f, 1000u) == 0u);
+        REQUIRE(math::approximately(dr.scale(), 0.9f));
+        REQUIRE(math::approximately(dr.smoothed_frame_time(), target * 1.1f));
+    }
+    SECTION("upscale") {
+        dynamic_resolution dr(make_params());
+        REQUIRE(feed(dr, target * 2.f, 30u) == 3u);
+        REQUIRE(math::approximately(dr.scale(), 0.7f));
+        // 0.8 was the last slow scale, it waits for the retry period
+        REQUIRE(feed(dr, target * 0.5f, 39u) == 0u);
+        REQUIRE(feed(dr, target * 0.5f, 1u) == 1u);
+        REQUIRE(math::approximately(dr.scale(), 0.8f));
+        REQUIRE(feed(dr, target * 0.5f, 1000u) == 2u);
+        REQUIRE(math::approximately(dr.scale(), 1.f));
+        dr.reset();
+        REQUIRE(math::approximately(dr.scale(), 1.f));
+    }
+    SECTION("retry_backoff") {
+        dynamic_resolution dr(make_params());
+        // 1.0 is too slow, 0.9 is fine
+        std::size_t slow_frames = 0u;
+        for ( std::size_t i = 0; i < 2000u; ++i ) {
+            const bool slow = dr.scale() > 0.95f;
+            dr.update(slow ? target * 2.f : target);
+            if ( slow && i >= 200u ) {
+                ++slow_frames;
+            }
+        }
+        // retries after 10, 20, 40, 80, 160, 160... frames
+        REQUIRE(slow_frames < 180u);
+        REQUIRE(slow_frames > 0u);
+    }
+}
@@ -7,6 +7,24 @@
 #include "_high.hpp"
 using namespace e2d;
 
+namespace
+{
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("flipbook_untests", "enduro2d")
+                        .without_graphics(true)
+                        .without_audio(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+}
+
 TEST_CASE("flipbook_player") {
     {
         flipbook_player fp;
@@ -72,3 +90,104 @@ TEST_CASE("flipbook_player") {
         REQUIRE(fp.sequence() == make_hash(""));
     }
 }
+
+TEST_CASE("flipbook_player_playback") {
+    safe_starter_initializer initializer;
+    {
+        auto s1 = sprite_asset::create(sprite());
+        auto s2 = sprite_asset::create(sprite());
+        auto s3 = sprite_asset::create(sprite());
+
+        flipbook fb;
+        fb.set_frames({{s1}, {s2}, {s3}});
+        fb.set_sequences({
+            {2.f, make_hash("walk"), {0u, 1u, 2u}},
+            {0.f, make_hash("idle"), {2u}}});
+        auto fb_res = flipbook_asset::create(fb);
+
+        ecs::registry owner;
+        ecs::entity e = owner.create_entity();
+        e.assign_component<flipbook_source>(flipbook_source(fb_res));
+        e.assign_component<flipbook_player>(flipbook_player().sequence("walk"));
+        e.assign_component<sprite_renderer>();
+
+        flipbook_system fs;
+        const auto& ps = e.get_component<flipbook_player>().playback();
+
+        fs.process(owner);
+        REQUIRE(ps.sequence == fb_res->content().find_sequence("walk"));
+        REQUIRE(ps.frame_index == 0u);
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s1);
+
+        e.get_component<flipbook_player>().time(0.4f);
+        e.get_component<sprite_renderer>().sprite(nullptr);
+        fs.process(owner);
+        REQUIRE(ps.frame_index == 0u);
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s1);
+
+        e.get_component<flipbook_player>().time(0.6f);
+        fs.process(owner);
+        REQUIRE(ps.frame_index == 1u);
+        REQUIRE(math::approximately(ps.frame_begin, 0.5f));
+        REQUIRE(math::approximately(ps.frame_end, 1.f));
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s2);
+
+        e.get_component<flipbook_player>().time(100.f);
+        fs.process(owner);
+        REQUIRE(ps.frame_index == 2u);
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s3);
+
+        e.get_component<flipbook_player>().sequence("idle");
+        fs.process(owner);
+        REQUIRE(ps.sequence == fb_res->content().find_sequence("idle"));
+        REQUIRE(ps.frame_index == 0u);
+        REQUIRE(e.get_component<sprite_renderer>().sprite() == s3);
+
+        e.get_component<flipbook_player>().sequence("unknown");
+        fs.process(owner);
+        REQUIRE_FALSE(ps.sequence);
+        REQUIRE_FALSE(e.get_component<sprite_renderer>().sprite());
+    }
+    {
+        auto s1 = sprite_asset::create(sprite());
+        auto s2 = sprite_asset::create(sprite());
+
+        flipbook fb;
+        fb.set_frames({{s1}, {s2}});
+        fb.set_sequences({
+            {2.f, make_hash("walk"), {0u, 1u}},
+            {0.f, make_hash("idle"), {1u}}});
+        auto fb_res = flipbook_asset::create(fb);
+
+        ecs::registry owner;
+        flipbook_system fs;
+
+        // renderers added after the sequence is resolved
+        ecs::entity e1 = owner.create_entity();
+        e1.assign_component<flipbook_source>(flipbook_source(fb_res));
+        e1.assign_component<flipbook_player>(flipbook_player().sequence("idle"));
+        fs.process(owner);
+        REQUIRE(e1.get_component<flipbook_player>().playback().resolved);
+        e1.assign_component<sprite_renderer>();
+        fs.process(owner);
+        REQUIRE(e1.get_component<sprite_renderer>().sprite() == s2);
+
+        // copies of resolved players are resolved again
+        flipbook_player fp_copy = e1.get_component<flipbook_player>();
+        REQUIRE_FALSE(fp_copy.playback().resolved);
+        REQUIRE_FALSE(fp_copy.playback().sequence);
+        REQUIRE_FALSE(fp_copy.playback().frame);
+
+        ecs::entity e2 = owner.create_entity();
+        e2.assign_component<flipbook_source>(flipbook_source(fb_res));
+        e2.assign_component<flipbook_player>(fp_copy.sequence("walk"));
+        e2.assign_component<sprite_renderer>();
+        fs.process(owner);
+        REQUIRE(e2.get_component<flipbook_player>().playback().sequence
+            == fb_res->content().find_sequence("walk"));
+        REQUIRE(e2.get_component<sprite_renderer>().sprite() == s1);
+
+        fp_copy = e1.get_component<flipbook_player>();
+        REQUIRE_FALSE(fp_copy.playback().resolved);
+    }
+}
@@ -159,7 +159,7 @@ TEST_CASE("library"){
         if ( modules::is_initialized<render>() ) {
             auto shader_res = l.load_asset<shader_asset>("shader.json");
             REQUIRE(shader_res);
-            REQUIRE(shader_res->content());
+            REQUIRE(shader_res->content().variant(the<render>(), 0u));
 
             auto texture_res = l.load_asset<texture_asset>("image.png");
             REQUIRE(texture_res);
@@ -180,6 +180,7 @@ TEST_CASE("library"){
                 REQUIRE(spr);
                 REQUIRE(spr->content().pivot() == v2f(1.f,2.f));
                 REQUIRE(spr->content().texrect() == b2f(5.f,6.f,7.f,8.f));
+                REQUIRE(spr->content().borders() == v4f::zero());
                 REQUIRE(spr->content().texture()== texture_res);
             }
 
@@ -188,6 +189,7 @@ TEST_CASE("library"){
                 REQUIRE(sprite_res);
                 REQUIRE(sprite_res->content().pivot() == v2f(1.f, 2.f));
                 REQUIRE(sprite_res->content().texrect() == b2f(5.f, 6.f, 7.f, 8.f));
+                REQUIRE(sprite_res->content().borders() == v4f(1.f, 2.f, 3.f, 4.f));
                 REQUIRE(sprite_res->content().texture() == texture_res);
             }
 
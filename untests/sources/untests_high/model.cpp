@@ -0,0 +1,71 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+namespace
+{
+    mesh_asset::ptr make_mesh(f32 size) {
+        mesh m;
+        m.set_vertices({
+            v3f(-size, -size, 0.f),
+            v3f( size, -size, 0.f),
+            v3f( size,  size, 2.f)});
+        m.set_indices(0u, {0u, 1u, 2u});
+        return mesh_asset::create(std::move(m));
+    }
+}
+
+TEST_CASE("model") {
+    SECTION("bounds") {
+        model m;
+        REQUIRE(m.lod_count() == 1u);
+        REQUIRE(math::approximately(m.bounds_radius(), 0.f));
+        m.set_mesh(make_mesh(1.f));
+        REQUIRE(m.bounds_center() == v3f(0.f, 0.f, 1.f));
+        REQUIRE(math::approximately(m.bounds_radius(), math::sqrt(3.f)));
+    }
+    SECTION("lods") {
+        const mesh_asset::ptr lod0 = make_mesh(1.f);
+        const mesh_asset::ptr lod1 = make_mesh(2.f);
+        const mesh_asset::ptr lod2 = make_mesh(3.f);
+
+        model m;
+        m.set_mesh(lod0)
+            .add_lod(lod2, 0.1f)
+            .add_lod(lod1, 0.5f);
+
+        REQUIRE(m.lod_count() == 3u);
+        REQUIRE(m.lod_mesh(0u) == lod0);
+        REQUIRE(m.lod_mesh(1u) == lod1);
+        REQUIRE(m.lod_mesh(2u) == lod2);
+        REQUIRE(math::approximately(m.lod_screen_size(1u), 0.5f));
+        REQUIRE(math::approximately(m.lod_screen_size(2u), 0.1f));
+
+        REQUIRE(m.select_lod(1.f, 0u, 0.f) == 0u);
+        REQUIRE(m.select_lod(0.4f, 0u, 0.f) == 1u);
+        REQUIRE(m.select_lod(0.05f, 0u, 0.f) == 2u);
+        REQUIRE(m.select_lod(1.f, 2u, 0.f) == 0u);
+        REQUIRE(m.select_lod(0.4f, 42u, 0.f) == 1u);
+
+        model m2(m);
+        REQUIRE(m2 == m);
+        m2.clear_lods();
+        REQUIRE(m2 != m);
+        REQUIRE(m2.lod_count() == 1u);
+    }
+    SECTION("hysteresis") {
+        model m;
+        m.set_mesh(make_mesh(1.f))
+            .add_lod(make_mesh(2.f), 0.5f);
+
+        REQUIRE(m.select_lod(0.48f, 0u, 0.1f) == 0u);
+        REQUIRE(m.select_lod(0.44f, 0u, 0.1f) == 1u);
+        REQUIRE(m.select_lod(0.52f, 1u, 0.1f) == 1u);
+        REQUIRE(m.select_lod(0.56f, 1u, 0.1f) == 0u);
+    }
+}
@@ -735,6 +735,25 @@ TEST_CASE("node") {
                 math::make_translation_matrix4(60.f,0.f,0.f));
         }
     }
+    SECTION("world_matrix_version") {
+        auto p = node::create();
+        auto n = node::create(p);
+
+        const u32 v1 = n->world_matrix_version();
+        REQUIRE(n->world_matrix_version() == v1);
+
+        n->translation({10.f,0.f,0.f});
+        const u32 v2 = n->world_matrix_version();
+        REQUIRE(v2 != v1);
+        REQUIRE(n->world_matrix_version() == v2);
+
+        p->translation({10.f,0.f,0.f});
+        const u32 v3 = n->world_matrix_version();
+        REQUIRE(v3 != v2);
+
+        n->remove_from_parent();
+        REQUIRE(n->world_matrix_version() != v3);
+    }
     SECTION("lifetime") {
         {
             fake_node::reset_counters();
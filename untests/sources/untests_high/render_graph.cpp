@@ -0,0 +1,120 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+TEST_CASE("render_graph") {
+    using rg = render_graph;
+    SECTION("culling") {
+        rg g;
+        const rg::resource main = g.import_target("main", nullptr);
+        const rg::resource scene = g.create_target("scene", rg::target_desc(v2u(256u)));
+        const rg::resource debug = g.create_target("debug", rg::target_desc(v2u(256u)));
+
+        g.add_pass("scene").target(scene).clear(render::clear_command());
+        g.add_pass("debug_background").target(debug).clear(render::clear_command());
+        g.add_pass("debug").target(debug).side_effect();
+        g.add_pass("overwritten").target(scene).clear(render::clear_command());
+        g.add_pass("final_scene").target(scene).clear(render::clear_command());
+        g.add_pass("compose").target(main).read(scene);
+        g.add_pass("overlay").target(main);
+        g.compile();
+
+        REQUIRE(g.pass_count() == 7u);
+        REQUIRE(g.is_culled(0u));
+        REQUIRE_FALSE(g.is_culled(1u));
+        REQUIRE_FALSE(g.is_culled(2u));
+        REQUIRE(g.is_culled(3u));
+        REQUIRE_FALSE(g.is_culled(4u));
+        REQUIRE_FALSE(g.is_culled(5u));
+        REQUIRE_FALSE(g.is_culled(6u));
+        REQUIRE(g.stats().passes == 7u);
+        REQUIRE(g.stats().culled_passes == 2u);
+    }
+    SECTION("imported") {
+        rg g;
+        const render_target_ptr rt;
+        REQUIRE(g.import_target("a", rt) == g.import_target("b", nullptr));
+        g.add_pass("a").target(g.import_target("a", rt)).clear(render::clear_command());
+        g.add_pass("b").target(g.import_target("a", rt)).clear(render::clear_command());
+        g.compile();
+        REQUIRE_FALSE(g.is_culled(0u));
+        REQUIRE_FALSE(g.is_culled(1u));
+    }
+    SECTION("aliasing") {
+        rg g;
+        const rg::resource main = g.import_target("main", nullptr);
+        const rg::resource a = g.create_target("a", rg::target_desc(v2u(128u)));
+        const rg::resource b = g.create_target("b", rg::target_desc(v2u(128u)));
+        const rg::resource c = g.create_target("c", rg::target_desc(v2u(128u)));
+        const rg::resource d = g.create_target("d", rg::target_desc(v2u(64u)));
+
+        g.add_pass("a").target(a).discard();
+        g.add_pass("b").target(b).read(a).discard();
+        g.add_pass("c").target(c).read(b).discard();
+        g.add_pass("d").target(d).read(c).discard();
+        g.add_pass("main").target(main).read(d);
+        g.compile();
+
+        REQUIRE(g.stats().culled_passes == 0u);
+        REQUIRE(g.stats().transient_targets == 4u);
+        REQUIRE(g.stats().physical_targets == 3u);
+        REQUIRE(g.physical_target(a) == g.physical_target(c));
+        REQUIRE(g.physical_target(a) != g.physical_target(b));
+        REQUIRE(g.physical_target(c) != g.physical_target(d));
+        REQUIRE(g.physical_target(main) != rg::resource::invalid_index);
+    }
+    SECTION("desc") {
+        rg g;
+        const rg::resource main = g.import_target("main", nullptr);
+        const rg::resource a = g.create_target("a", rg::target_desc(v2u(128u)));
+        const rg::resource b = g.create_target("b", rg::target_desc(v2u(128u))
+            .color_decl(pixel_declaration::pixel_type::rgb8));
+        g.add_pass("a").target(a).discard();
+        g.add_pass("a_to_main").target(main).read(a);
+        g.add_pass("b").target(b).discard();
+        g.add_pass("b_to_main").target(main).read(b);
+        g.compile();
+        REQUIRE(g.physical_target(a) != g.physical_target(b));
+        REQUIRE(g.stats().physical_targets == 2u);
+
+        REQUIRE(rg::target_desc(v2u(1u)) == rg::target_desc(v2u(1u)));
+        REQUIRE(rg::target_desc(v2u(1u)) != rg::target_desc(v2u(2u)));
+        REQUIRE(rg::target_desc(v2u(1u)) != rg::target_desc(v2u(1u))
+            .external_texture(render_target::external_texture::color_and_depth));
+    }
+    SECTION("clear") {
+        rg g;
+        const rg::resource a = g.create_target("a", rg::target_desc(v2u(128u)));
+        g.add_pass("a").target(a).discard();
+        g.compile();
+        REQUIRE(g.is_culled(0u));
+        REQUIRE(g.physical_target(a) == rg::resource::invalid_index);
+        g.clear();
+        REQUIRE(g.pass_count() == 0u);
+        g.compile();
+        REQUIRE(g.stats().passes == 0u);
+    }
+    SECTION("misuse") {
+        rg g;
+        REQUIRE_THROWS_AS(g.create_target("b", rg::target_desc()), bad_render_graph_operation);
+        REQUIRE_THROWS_AS(g.add_pass("p").target(rg::resource()), bad_render_graph_operation);
+        REQUIRE_THROWS_AS(g.add_pass("p").read(rg::resource(42u)), bad_render_graph_operation);
+        {
+            rg g2;
+            g2.add_pass("no_target");
+            REQUIRE_THROWS_AS(g2.compile(), bad_render_graph_operation);
+        }
+        {
+            rg g2;
+            const rg::resource m2 = g2.import_target("main", nullptr);
+            const rg::resource a2 = g2.create_target("a", rg::target_desc(v2u(128u)));
+            g2.add_pass("read_unwritten").target(m2).read(a2);
+            REQUIRE_THROWS_AS(g2.compile(), bad_render_graph_operation);
+        }
+    }
+}
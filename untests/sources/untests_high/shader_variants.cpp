@@ -0,0 +1,114 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+namespace
+{
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("shader_variants_untests", "enduro2d")
+                        .without_graphics(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+}
+
+TEST_CASE("shader_variants") {
+    SECTION("keywords") {
+        const shader_variants s("vs", "fs", {"TINT", "ALPHA_TEST", "VERTEX_COLOR"});
+        REQUIRE(s.keywords().size() == 3u);
+
+        shader_variants::keyword_mask mask = 42u;
+        REQUIRE(s.try_make_mask({}, mask));
+        REQUIRE(mask == 0u);
+        REQUIRE(s.try_make_mask({"VERTEX_COLOR", "TINT"}, mask));
+        REQUIRE(mask == 5u);
+        REQUIRE_FALSE(s.try_make_mask({"TINT", "FOG"}, mask));
+        REQUIRE(mask == 5u);
+
+        REQUIRE(s.mask_keywords(0u).empty());
+        REQUIRE(s.mask_keywords(6u) == vector<str>{"ALPHA_TEST", "VERTEX_COLOR"});
+        REQUIRE(s.mask_keywords(8u).empty());
+        REQUIRE(s.usage().empty());
+    }
+    SECTION("declaration") {
+        REQUIRE_THROWS_AS(
+            shader_variants("vs", "fs", {"TINT", "TINT"}),
+            bad_shader_variants_operation);
+        REQUIRE_THROWS_AS(
+            shader_variants("vs", "fs", {""}),
+            bad_shader_variants_operation);
+        REQUIRE_THROWS_AS(
+            shader_variants("vs", "fs", vector<str>(33u, "K")),
+            bad_shader_variants_operation);
+    }
+    SECTION("copies") {
+        const shader_variants s1("vs", "fs", {"TINT"});
+        shader_variants s2 = s1;
+        REQUIRE(s1 == s2);
+        REQUIRE(s2 != shader_variants("vs", "fs"));
+
+        shader_variants s3 = std::move(s2);
+        REQUIRE(s3 == s1);
+        REQUIRE(s2.keywords().empty());
+        REQUIRE(s2.vertex_source().empty());
+    }
+    SECTION("defines") {
+        const shader_variants s(
+            "// comment\n/* #version 100 */\n#version 120\nvoid main() {}\n",
+            "void main() {}\n",
+            {"TINT", "ALPHA_TEST"});
+
+        REQUIRE(s.variant_vertex_source(0u) == s.vertex_source());
+        REQUIRE(s.variant_vertex_source(3u) ==
+            "// comment\n/* #version 100 */\n#version 120\n"
+            "#define TINT 1\n#define ALPHA_TEST 1\n"
+            "void main() {}\n");
+        REQUIRE(s.variant_fragment_source(2u) ==
+            "#define ALPHA_TEST 1\nvoid main() {}\n");
+    }
+    SECTION("compile") {
+        safe_starter_initializer initializer;
+        if ( modules::is_initialized<render>() ) {
+            const shader_variants s(
+                "#version 120\n"
+                "attribute vec3 a_position;\n"
+                "void main() {\n"
+                "#ifdef TINT\n"
+                "    gl_Position = vec4(a_position, 1.0);\n"
+                "#else\n"
+                "    gl_Position = vec4(0.0);\n"
+                "#endif\n"
+                "}\n",
+                "#version 120\n"
+                "void main() {\n"
+                "    gl_FragColor = vec4(1.0);\n"
+                "}\n",
+                {"TINT"});
+
+            const shader_ptr v0 = s.variant(the<render>(), 0u);
+            const shader_ptr v1 = s.variant(the<render>(), 1u);
+            REQUIRE(v0);
+            REQUIRE(v1);
+            REQUIRE(v0 != v1);
+            REQUIRE(s.variant(the<render>(), 1u) == v1);
+
+            const vector<shader_variants::variant_usage> usage = s.usage();
+            REQUIRE(usage.size() == 2u);
+            REQUIRE(usage[1].mask == 1u);
+            REQUIRE(usage[1].requests == 2u);
+            REQUIRE(usage[1].compiled);
+        }
+    }
+}
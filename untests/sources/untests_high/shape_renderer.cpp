@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+namespace
+{
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("shape_renderer_untests", "enduro2d")
+                        .without_graphics(true)
+                        .without_audio(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+}
+
+TEST_CASE("shape_renderer") {
+    {
+        shape_renderer sr;
+        REQUIRE(sr.tint() == color32::white());
+        REQUIRE(sr.filtering());
+        REQUIRE_FALSE(sr.shape());
+        REQUIRE_FALSE(sr.texture());
+    }
+    {
+        shape shp;
+        shp.set_vertices({v2f(0.f, 0.f), v2f(1.f, 0.f), v2f(0.f, 1.f)});
+        shp.set_indices(0u, {0u, 1u, 2u});
+        const shape_asset::ptr shp_a = shape_asset::create(shp);
+
+        shape_renderer sr(shp_a);
+        REQUIRE(sr.shape() == shp_a);
+
+        sr.tint(color32::red())
+            .filtering(false)
+            .shape(nullptr);
+        REQUIRE(sr.tint() == color32::red());
+        REQUIRE_FALSE(sr.filtering());
+        REQUIRE_FALSE(sr.shape());
+    }
+}
+
+TEST_CASE("shape_renderer_factory") {
+    safe_starter_initializer initializer;
+    factory& f = the<factory>();
+
+    shape shp;
+    shp.set_vertices({v2f(0.f, 0.f), v2f(1.f, 0.f), v2f(0.f, 1.f)});
+    shp.set_indices(0u, {0u, 1u, 2u});
+    const shape_asset::ptr shp_a = shape_asset::create(shp);
+
+    asset_group dependencies;
+    dependencies.add_asset("shapes/ship.e2d_shape", shp_a);
+
+    SECTION("loader") {
+        rapidjson::Document root;
+        root.Parse(R"json({
+            "tint" : [255, 0, 0, 255],
+            "filtering" : false,
+            "shape" : "ship.e2d_shape"
+        })json");
+        REQUIRE_FALSE(root.HasParseError());
+        REQUIRE(f.validate_json("shape_renderer", root));
+
+        asset_dependencies collected;
+        REQUIRE(f.collect_dependencies(
+            "shape_renderer",
+            collected,
+            factory_loader<>::collect_context("shapes", root)));
+
+        ecs::prototype proto;
+        REQUIRE(f.fill_prototype(
+            "shape_renderer",
+            proto,
+            factory_loader<>::fill_context("shapes", root, dependencies)));
+
+        shape_renderer sr;
+        REQUIRE(proto.apply_to_component(sr));
+        REQUIRE(sr.tint() == color32::red());
+        REQUIRE_FALSE(sr.filtering());
+        REQUIRE(sr.shape() == shp_a);
+        REQUIRE_FALSE(sr.texture());
+
+        REQUIRE_FALSE(f.fill_prototype(
+            "shape_renderer",
+            proto,
+            factory_loader<>::fill_context("sprites", root, dependencies)));
+    }
+    SECTION("loader_schema") {
+        rapidjson::Document root;
+        root.Parse(R"json({ "shape" : 42 })json");
+        REQUIRE_FALSE(root.HasParseError());
+        REQUIRE_FALSE(f.validate_json("shape_renderer", root));
+    }
+    SECTION("serializer") {
+        world& w = the<world>();
+        factory_serializer<>::asset_addresses addresses{
+            {shp_a.get(), "shapes/ship.e2d_shape"}};
+
+        gobject_iptr root = w.instantiate();
+        root->entity_filler().component<shape_renderer>(shape_renderer(shp_a)
+            .tint(color32::blue())
+            .filtering(false));
+
+        buffer data;
+        REQUIRE(snapshots::try_save_snapshot(root, addresses, data));
+
+        asset_dependencies collected;
+        REQUIRE(snapshots::try_collect_dependencies(collected, data));
+
+        prefab content;
+        REQUIRE(snapshots::try_load_snapshot(content, data, dependencies));
+
+        gobject_iptr inst = w.instantiate(content);
+        REQUIRE(inst->get_component<shape_renderer>()->shape() == shp_a);
+        REQUIRE(inst->get_component<shape_renderer>()->tint() == color32::blue());
+        REQUIRE_FALSE(inst->get_component<shape_renderer>()->filtering());
+        REQUIRE_FALSE(inst->get_component<shape_renderer>()->texture());
+
+        prefab broken;
+        REQUIRE_FALSE(snapshots::try_load_snapshot(broken, data, asset_group()));
+
+        w.destroy_instance(inst);
+        w.destroy_instance(root);
+    }
+}
@@ -0,0 +1,86 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+TEST_CASE("shared_property_block") {
+    SECTION("empty") {
+        const shared_property_block b1;
+        const shared_property_block b2{render::property_block()};
+        REQUIRE(b1.empty());
+        REQUIRE(b2.empty());
+        REQUIRE(b1 == b2);
+        REQUIRE(b1->property_count() == 0u);
+        REQUIRE(b1->sampler_count() == 0u);
+    }
+    SECTION("interning") {
+        const std::size_t count = shared_property_block::instance_count();
+        {
+            const shared_property_block b1{render::property_block()
+                .property("u_tint", v4f(1.f, 0.f, 0.f, 1.f))};
+            const shared_property_block b2{render::property_block()
+                .property("u_tint", v4f(1.f, 0.f, 0.f, 1.f))};
+            const shared_property_block b3{render::property_block()
+                .property("u_tint", v4f(0.f, 1.f, 0.f, 1.f))};
+            const shared_property_block b4{render::property_block()
+                .property("u_tint", 1)};
+
+            REQUIRE(b1 == b2);
+            REQUIRE(&*b1 == &*b2);
+            REQUIRE(b1.id() == b2.id());
+            REQUIRE(b1.id() != b3.id());
+            REQUIRE(b1 != b3);
+            REQUIRE(b1 != b4);
+            REQUIRE(shared_property_block::instance_count() == count + 3u);
+        }
+        REQUIRE(shared_property_block::instance_count() == count);
+    }
+    SECTION("ids") {
+        REQUIRE(shared_property_block().id() == 0u);
+        u64 id = 0u;
+        {
+            const shared_property_block b1{render::property_block()
+                .property("u_id", 1)};
+            id = b1.id();
+            REQUIRE(id != 0u);
+        }
+        const shared_property_block b2{render::property_block()
+            .property("u_id", 1)};
+        REQUIRE(b2.id() != id);
+    }
+    SECTION("update") {
+        const shared_property_block b1{render::property_block()
+            .property("i", 42)};
+        shared_property_block b2 = b1;
+        REQUIRE(b1 == b2);
+
+        b2.update([](render::property_block& pb){
+            pb.property("i", 21);
+        });
+        REQUIRE(b1 != b2);
+        REQUIRE(*b1->property<i32>("i") == 42);
+        REQUIRE(*b2->property<i32>("i") == 21);
+
+        b2.update([](render::property_block& pb){
+            pb.property("i", 42);
+        });
+        REQUIRE(b1 == b2);
+    }
+    SECTION("renderer") {
+        renderer r1;
+        renderer r2;
+        r1.properties(render::property_block().property("f", 1.f));
+        r2.properties(render::property_block().property("f", 1.f));
+        REQUIRE(r1.properties() == r2.properties());
+
+        r2.update_properties([](render::property_block& pb){
+            pb.property("f", 2.f);
+        });
+        REQUIRE(r1.properties() != r2.properties());
+        REQUIRE(math::approximately(*r1.properties()->property<f32>("f"), 1.f));
+    }
+}
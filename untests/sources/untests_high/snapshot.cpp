@@ -0,0 +1,215 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+namespace
+{
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("snapshot_untests", "enduro2d")
+                        .without_graphics(true)
+                        .without_audio(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+
+    gobject_iptr make_child(world& w, const gobject_iptr& parent) {
+        gobject_iptr child = w.instantiate();
+        parent->get_component<actor>()->node()->add_child(
+            child->get_component<actor>()->node());
+        return child;
+    }
+}
+
+TEST_CASE("snapshot") {
+    safe_starter_initializer initializer;
+    world& w = the<world>();
+
+    auto sprite_res = sprite_asset::create(sprite());
+    factory_serializer<>::asset_addresses addresses{
+        {sprite_res.get(), "sprites/ship.json"}};
+    asset_group dependencies;
+    dependencies.add_asset("sprites/ship.json", sprite_res);
+
+    {
+        gobject_iptr root = w.instantiate();
+        root->get_component<actor>()->node()->translation(v3f(1.f, 2.f, 3.f));
+        root->entity_filler().component<scene>(scene().depth(7).static_batching(true));
+
+        gobject_iptr child1 = make_child(w, root);
+        child1->get_component<actor>()->node()->scale(v3f(2.f, 2.f, 1.f));
+        child1->entity_filler()
+            .component<sprite_renderer>(sprite_renderer(sprite_res)
+                .tint(color32::red())
+                .mode(sprite_renderer::modes::sliced))
+            .component<flipbook_player>(flipbook_player()
+                .looped(true)
+                .play("walk"));
+
+        gobject_iptr child2 = make_child(w, root);
+        child2->entity_filler().component<collider>(collider()
+            .polygon(vector<v2f>{{0.f, 0.f}, {2.f, 0.f}, {0.f, 2.f}})
+            .layer(4u))
+            .component<renderer>(renderer()
+                .enabled(false)
+                .properties(render::property_block()
+                    .property("u_color", v4f(1.f, 0.5f, 0.25f, 1.f))
+                    .property("u_index", 3)));
+        make_child(w, child2);
+
+        buffer data;
+        REQUIRE(snapshots::try_save_snapshot(root, addresses, data));
+        REQUIRE_FALSE(data.empty());
+
+        {
+            buffer data2;
+            REQUIRE(snapshots::try_save_snapshot(root, addresses, data2));
+            REQUIRE(data == data2);
+        }
+        {
+            buffer data2;
+            REQUIRE_FALSE(snapshots::try_save_snapshot(
+                root, factory_serializer<>::asset_addresses(), data2));
+        }
+
+        asset_dependencies collected;
+        REQUIRE(snapshots::try_collect_dependencies(collected, data));
+
+        prefab content;
+        REQUIRE(snapshots::try_load_snapshot(content, data, dependencies));
+        REQUIRE(content.children().size() == 2u);
+        REQUIRE(content.children()[1].children().size() == 1u);
+
+        gobject_iptr inst = w.instantiate(content);
+        REQUIRE(inst->get_component<actor>()->node()->translation() == v3f(1.f, 2.f, 3.f));
+        REQUIRE(inst->get_component<scene>()->depth() == 7);
+        REQUIRE(inst->get_component<scene>()->static_batching());
+        REQUIRE(inst->get_component<actor>()->node()->child_count_recursive() == 3u);
+
+        gobject_iptr inst1 = inst->get_component<actor>()->node()->first_child()->owner();
+        REQUIRE(inst1->get_component<actor>()->node()->scale() == v3f(2.f, 2.f, 1.f));
+        REQUIRE(inst1->get_component<sprite_renderer>()->sprite() == sprite_res);
+        REQUIRE(inst1->get_component<sprite_renderer>()->tint() == color32::red());
+        REQUIRE(inst1->get_component<sprite_renderer>()->mode() == sprite_renderer::modes::sliced);
+        REQUIRE(inst1->get_component<flipbook_player>()->sequence() == make_hash("walk"));
+        REQUIRE(inst1->get_component<flipbook_player>()->looped());
+        REQUIRE(inst1->get_component<flipbook_player>()->playing());
+
+        gobject_iptr inst2 = inst->get_component<actor>()->node()->last_child()->owner();
+        REQUIRE(inst2->get_component<collider>()->type() == collider::types::polygon);
+        REQUIRE(inst2->get_component<collider>()->vertices().size() == 3u);
+        REQUIRE(inst2->get_component<collider>()->layer() == 4u);
+        REQUIRE_FALSE(inst2->get_component<sprite_renderer>().exists());
+        REQUIRE_FALSE(inst2->get_component<renderer>()->enabled());
+        {
+            const render::property_block& props = *inst2->get_component<renderer>()->properties();
+            REQUIRE(props.property_count() == 2u);
+            REQUIRE(props.property<v4f>("u_color"));
+            REQUIRE(*props.property<v4f>("u_color") == v4f(1.f, 0.5f, 0.25f, 1.f));
+            REQUIRE(props.property<i32>("u_index"));
+            REQUIRE(*props.property<i32>("u_index") == 3);
+        }
+
+        prefab broken;
+        REQUIRE_FALSE(snapshots::try_load_snapshot(broken, data, asset_group()));
+        REQUIRE_FALSE(snapshots::try_load_snapshot(broken, buffer(data.data(), data.size() - 1u), dependencies));
+        REQUIRE_FALSE(snapshots::try_load_snapshot(broken, buffer("hello", 5), dependencies));
+
+        w.destroy_instance(inst);
+        w.destroy_instance(root);
+    }
+    {
+        gobject_iptr root = w.instantiate();
+        root->entity_filler().component<scene>(scene().depth(0x5A5A5A5A).static_batching(true));
+
+        buffer data;
+        REQUIRE(snapshots::try_save_snapshot(root, addresses, data));
+
+        const u8 pattern[] = {0x5A, 0x5A, 0x5A, 0x5A, 0x01};
+        u8* flag = std::search(
+            data.data(), data.data() + data.size(),
+            std::begin(pattern), std::end(pattern));
+        REQUIRE(flag != data.data() + data.size());
+        flag[4] = 0x02;
+
+        prefab broken;
+        REQUIRE_FALSE(snapshots::try_load_snapshot(broken, data, asset_group()));
+
+        w.destroy_instance(root);
+    }
+    {
+        const str library_path = "snapshot_untests_library";
+        REQUIRE(filesystem::create_directory_recursive(library_path));
+
+        gobject_iptr root = w.instantiate();
+        root->entity_filler().component<scene>(scene().depth(3));
+        buffer data;
+        REQUIRE(snapshots::try_save_snapshot(
+            root, factory_serializer<>::asset_addresses(), data));
+        REQUIRE(filesystem::try_write_all(
+            data, path::combine(library_path, "scene.bin"), false));
+        w.destroy_instance(root);
+
+        {
+            library l(url("file", library_path), the<deferrer>());
+            const snapshot_asset::ptr snapshot_res = l.load_asset<snapshot_asset>("scene.bin");
+            REQUIRE(snapshot_res);
+            REQUIRE(snapshot_res->content().children().empty());
+            REQUIRE(l.cache().find<snapshot_asset>("scene.bin") == snapshot_res);
+            REQUIRE_FALSE(l.cache().find<binary_asset>("scene.bin"));
+            REQUIRE(l.cache().asset_count<binary_asset>() == 0u);
+        }
+
+        REQUIRE(filesystem::remove_directory(library_path));
+    }
+    {
+        std::printf("-= snapshot::performance tests =-\n");
+    #if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+        const std::size_t task_n = 1'000;
+    #else
+        const std::size_t task_n = 10'000;
+    #endif
+        gobject_iptr root = w.instantiate();
+        for ( std::size_t i = 0; i < task_n; ++i ) {
+            gobject_iptr child = make_child(w, root);
+            child->get_component<actor>()->node()->translation(v3f(static_cast<f32>(i), 0.f, 0.f));
+            child->entity_filler()
+                .component<sprite_renderer>(sprite_renderer(sprite_res))
+                .component<collider>(collider().rect(b2f(1.f, 1.f)));
+        }
+
+        buffer data;
+        {
+            e2d_untests::verbose_profiler_ms p("snapshot::save");
+            REQUIRE(snapshots::try_save_snapshot(root, addresses, data));
+            p.done(data.size());
+        }
+
+        prefab content;
+        {
+            e2d_untests::verbose_profiler_ms p("snapshot::load");
+            REQUIRE(snapshots::try_load_snapshot(content, data, dependencies));
+            p.done(content.children().size());
+        }
+
+        {
+            e2d_untests::verbose_profiler_ms p("snapshot::instantiate");
+            gobject_iptr inst = w.instantiate(content);
+            p.done(inst->get_component<actor>()->node()->child_count());
+            w.destroy_instance(inst);
+        }
+
+        w.destroy_instance(root);
+    }
+}
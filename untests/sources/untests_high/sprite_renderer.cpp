@@ -0,0 +1,47 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+using namespace e2d;
+
+TEST_CASE("sprite_renderer") {
+    {
+        sprite_renderer sr;
+        REQUIRE(sr.tint() == color32::white());
+        REQUIRE(sr.size() == v2f::zero());
+        REQUIRE(sr.mode() == sprite_renderer::modes::simple);
+        REQUIRE(sr.filtering());
+        REQUIRE_FALSE(sr.sprite());
+    }
+    {
+        sprite spr;
+        spr.set_pivot(v2f(10.f, 20.f));
+        spr.set_texrect(b2f(10.f, 20.f, 30.f, 40.f));
+        spr.set_borders(v4f(5.f, 6.f, 7.f, 8.f));
+
+        sprite_renderer sr(sprite_asset::create(spr));
+        sr.mode(sprite_renderer::modes::sliced);
+
+        const sprite_renderer::sliced_geometry& sg1 = sr.sliced();
+        REQUIRE(sg1.vertices[0] == v2f(0.f, 0.f));
+        REQUIRE(sg1.vertices[5] == v2f(5.f, 6.f));
+        REQUIRE(sg1.vertices[10] == v2f(23.f, 32.f));
+        REQUIRE(sg1.vertices[15] == v2f(30.f, 40.f));
+
+        sr.size(v2f(100.f, 200.f));
+        const sprite_renderer::sliced_geometry& sg2 = sr.sliced();
+        REQUIRE(sg2.vertices[0] == v2f(0.f, 0.f));
+        REQUIRE(sg2.vertices[5] == v2f(5.f, 6.f));
+        REQUIRE(sg2.vertices[10] == v2f(93.f, 192.f));
+        REQUIRE(sg2.vertices[15] == v2f(100.f, 200.f));
+
+        sr.size(v2f(6.f, 7.f));
+        const sprite_renderer::sliced_geometry& sg3 = sr.sliced();
+        REQUIRE(sg3.vertices[5].x == Approx(2.5f));
+        REQUIRE(sg3.vertices[10].x == Approx(2.5f));
+        REQUIRE(sg3.vertices[15] == v2f(6.f, 7.f));
+    }
+}
@@ -14,3 +14,21 @@ TEST_CASE("starter"){
                 .without_graphics(true)));
     modules::shutdown<starter>();
 }
+
+TEST_CASE("starter_dynamic_resolution"){
+    modules::initialize<starter>(0, nullptr,
+        starter::parameters(
+            engine::parameters("starter_untests", "enduro2d")
+                .without_graphics(true))
+        .dynamic_resolution_params(dynamic_resolution::parameters()
+            .enabled(true)
+            .min_scale(0.25f)
+            .target_frame_time(1.f / 30.f)));
+    {
+        const dynamic_resolution& dr = the<dynamic_resolution>();
+        REQUIRE(dr.enabled());
+        REQUIRE(math::approximately(dr.params().min_scale(), 0.25f));
+        REQUIRE(math::approximately(dr.params().target_frame_time(), 1.f / 30.f));
+    }
+    modules::shutdown<starter>();
+}
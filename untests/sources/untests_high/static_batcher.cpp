@@ -0,0 +1,155 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_high.hpp"
+#include "../../../sources/enduro2d/high/systems/render_system_impl/render_system_static.hpp"
+using namespace e2d;
+using namespace e2d::render_system_impl;
+
+namespace
+{
+    class safe_starter_initializer final : private noncopyable {
+    public:
+        safe_starter_initializer() {
+            modules::initialize<starter>(0, nullptr,
+                starter::parameters(
+                    engine::parameters("static_batcher_untests", "enduro2d")
+                        .without_graphics(true)
+                        .without_audio(true)));
+        }
+
+        ~safe_starter_initializer() noexcept {
+            modules::shutdown<starter>();
+        }
+    };
+
+    mesh_asset::ptr make_triangle_mesh() {
+        mesh msh;
+        msh.set_vertices({v3f(0.f, 0.f, 0.f), v3f(1.f, 0.f, 0.f), v3f(0.f, 1.f, 0.f)});
+        msh.set_indices(0u, {0u, 1u, 2u});
+        return mesh_asset::create(std::move(msh));
+    }
+
+    material_asset::ptr make_material(bool blending) {
+        return material_asset::create(render::material()
+            .add_pass(render::pass_state()
+                .states(render::state_block()
+                    .capabilities(render::capabilities_state()
+                        .blending(blending)
+                        .depth_test(true)))));
+    }
+
+    gobject_iptr make_child(
+        world& w,
+        const gobject_iptr& parent,
+        const model_asset::ptr& mdl,
+        const material_asset::ptr& mat)
+    {
+        gobject_iptr child = w.instantiate();
+        child->entity_filler()
+            .component<renderer>(renderer().materials({mat}))
+            .component<model_renderer>(model_renderer(mdl));
+        parent->get_component<actor>()->node()->add_child(
+            child->get_component<actor>()->node());
+        return child;
+    }
+
+    const node* node_of(const gobject_iptr& go) {
+        return go->get_component<actor>()->node().get();
+    }
+}
+
+TEST_CASE("static_batcher") {
+    safe_starter_initializer initializer;
+    if ( !modules::is_initialized<render>() ) {
+        return;
+    }
+
+    world& w = the<world>();
+
+    model mdl;
+    mdl.set_mesh(make_triangle_mesh());
+    const model_asset::ptr mdl_a = model_asset::create(std::move(mdl));
+
+    model lod_mdl;
+    lod_mdl.set_mesh(make_triangle_mesh())
+        .add_lod(make_triangle_mesh(), 0.5f);
+    const model_asset::ptr lod_mdl_a = model_asset::create(std::move(lod_mdl));
+    const material_asset::ptr opaque_a = make_material(false);
+    const material_asset::ptr blended_a = make_material(true);
+
+    gobject_iptr root = w.instantiate();
+    gobject_iptr c1 = make_child(w, root, mdl_a, opaque_a);
+    gobject_iptr c2 = make_child(w, root, mdl_a, opaque_a);
+    gobject_iptr c3 = make_child(w, root, mdl_a, opaque_a);
+    gobject_iptr c4 = make_child(w, root, mdl_a, blended_a);
+    gobject_iptr c5 = make_child(w, root, mdl_a, opaque_a);
+    c5->get_component<renderer>()->properties(render::property_block()
+        .property("u_color", v4f(1.f, 0.f, 0.f, 1.f)));
+    gobject_iptr c6 = make_child(w, root, lod_mdl_a, opaque_a);
+
+    c1->get_component<actor>()->node()->translation(v3f(1.f, 0.f, 0.f));
+    c2->get_component<actor>()->node()->translation(v3f(2.f, 0.f, 0.f));
+    c3->get_component<actor>()->node()->translation(v3f(3.f, 0.f, 0.f));
+
+    const ecs::entity_id scn = root->entity().id();
+    const const_node_iptr root_n = root->get_component<actor>()->node();
+
+    static_batcher sb(the<debug>(), the<render>());
+    sb.update(scn, root_n);
+    REQUIRE(sb.end_frame());
+
+    // grouping: equal properties, order independent materials
+    // and models without levels of detail
+    REQUIRE(sb.batches(scn).size() == 1u);
+    REQUIRE(sb.stats().batches == 1u);
+    REQUIRE(sb.stats().batched_nodes == 3u);
+    REQUIRE(sb.stats().draws_saved == 2u);
+    REQUIRE(sb.is_batched(scn, node_of(c1)));
+    REQUIRE(sb.is_batched(scn, node_of(c2)));
+    REQUIRE(sb.is_batched(scn, node_of(c3)));
+    REQUIRE_FALSE(sb.is_batched(scn, node_of(c4)));
+    REQUIRE_FALSE(sb.is_batched(scn, node_of(c5)));
+    REQUIRE_FALSE(sb.is_batched(scn, node_of(c6)));
+
+    const mesh& batch_mesh = sb.batches(scn).front().mdl_r.model()->content().mesh()->content();
+    REQUIRE(batch_mesh.vertices().size() == 9u);
+    REQUIRE(batch_mesh.vertices()[0] == v3f(1.f, 0.f, 0.f));
+    REQUIRE(batch_mesh.indices_submesh_count() == 1u);
+    REQUIRE(batch_mesh.indices(0).size() == 9u);
+
+    // unchanged and equally transformed nodes keep batches
+    sb.update(scn, root_n);
+    REQUIRE_FALSE(sb.end_frame());
+    c1->get_component<actor>()->node()->translation(v3f(1.f, 0.f, 0.f));
+    sb.update(scn, root_n);
+    REQUIRE_FALSE(sb.end_frame());
+    REQUIRE(sb.is_batched(scn, node_of(c1)));
+
+    // moved nodes fall back to dynamic drawing
+    c1->get_component<actor>()->node()->translation(v3f(5.f, 0.f, 0.f));
+    sb.update(scn, root_n);
+    REQUIRE(sb.end_frame());
+    REQUIRE_FALSE(sb.is_batched(scn, node_of(c1)));
+    REQUIRE(sb.is_batched(scn, node_of(c2)));
+    REQUIRE(sb.stats().batched_nodes == 2u);
+    REQUIRE(sb.stats().draws_saved == 1u);
+
+    c1->get_component<actor>()->node()->translation(v3f(1.f, 0.f, 0.f));
+    sb.update(scn, root_n);
+    REQUIRE_FALSE(sb.end_frame());
+    REQUIRE_FALSE(sb.is_batched(scn, node_of(c1)));
+
+    // removed nodes are found too, a single model is not batched
+    c2->get_component<actor>()->node()->remove_from_parent();
+    sb.update(scn, root_n);
+    REQUIRE(sb.end_frame());
+    REQUIRE(sb.batches(scn).empty());
+    REQUIRE(sb.stats().batched_nodes == 0u);
+
+    w.destroy_instance(c2);
+    w.destroy_instance(root);
+}
@@ -35,4 +35,101 @@ TEST_CASE("world") {
         w.registry().destroy_entity(e);
         REQUIRE_FALSE(cw.registry().valid_entity(e));
     }
+    SECTION("instantiate_async") {
+        prefab child;
+        child.set_children({prefab(), prefab()});
+        prefab root;
+        root.set_children({child, child});
+
+        const gobject_iptr parent = w.instantiate();
+        const node_iptr parent_n = parent->get_component<actor>()->node();
+
+        const world::instantiation_ptr inst = w.instantiate_async(root, parent_n);
+        REQUIRE_FALSE(inst->done());
+        REQUIRE(inst->created() == 0u);
+        REQUIRE(math::approximately(inst->progress(), 0.f));
+
+        w.instantiation_budget(make_microseconds<u64>(0u));
+        while ( !inst->done() ) {
+            const std::size_t created = inst->created();
+            w.process_instantiations();
+            REQUIRE(inst->created() <= created + 1u);
+            if ( !inst->done() ) {
+                REQUIRE(parent_n->child_count() == 0u);
+            }
+        }
+
+        REQUIRE(inst->total() == 7u);
+        REQUIRE(inst->created() == 7u);
+        REQUIRE(math::approximately(inst->progress(), 1.f));
+
+        const gobject_iptr result = inst->result().get();
+        REQUIRE(result);
+        REQUIRE(parent_n->child_count() == 1u);
+        REQUIRE(parent_n->child_count_recursive() == 7u);
+        REQUIRE(result->get_component<actor>()->node()->parent() == parent_n);
+
+        w.destroy_instance(parent);
+    }
+    SECTION("instantiate_async_pending") {
+        auto spr_a = sprite_asset::create(sprite());
+        flipbook fb;
+        fb.set_frames({{spr_a}});
+        fb.set_sequences({{0.f, make_hash("idle"), {0u}}});
+        auto fb_a = flipbook_asset::create(fb);
+
+        prefab child;
+        child.prototype()
+            .component<flipbook_source>(fb_a)
+            .component<flipbook_player>(flipbook_player().sequence("idle"))
+            .component<sprite_renderer>();
+        prefab root;
+        root.set_children({child, child});
+
+        const world::instantiation_ptr inst = w.instantiate_async(root);
+        flipbook_system fs;
+
+        w.instantiation_budget(make_microseconds<u64>(0u));
+        while ( !inst->done() ) {
+            w.process_instantiations();
+            fs.process(w.registry());
+            if ( !inst->done() ) {
+                REQUIRE(cw.registry().component_count<pending_instance>() == inst->created());
+                cw.registry().for_each_component<sprite_renderer>([](
+                    const ecs::const_entity&, const sprite_renderer& sr)
+                {
+                    REQUIRE_FALSE(sr.sprite());
+                });
+            }
+        }
+        REQUIRE(cw.registry().component_count<pending_instance>() == 0u);
+
+        fs.process(w.registry());
+        const gobject_iptr result = inst->result().get();
+        result->get_component<actor>()->node()->for_each_child([](const node_iptr& child_n){
+            REQUIRE(child_n->owner()->get_component<sprite_renderer>()->sprite());
+        });
+
+        w.destroy_instance(result);
+    }
+    SECTION("instantiate_async_cancel") {
+        prefab root;
+        root.set_children({prefab(), prefab(), prefab()});
+
+        const std::size_t entity_count = cw.registry().entity_count();
+        const world::instantiation_ptr inst = w.instantiate_async(root);
+
+        w.instantiation_budget(make_microseconds<u64>(0u));
+        while ( inst->created() < 2u ) {
+            w.process_instantiations();
+        }
+        REQUIRE(cw.registry().entity_count() == entity_count + 2u);
+
+        inst->cancel();
+        REQUIRE(inst->done());
+        REQUIRE_THROWS_AS(inst->result().get(), bad_world_operation);
+
+        w.process_instantiations();
+        REQUIRE(cw.registry().entity_count() == entity_count);
+    }
 }
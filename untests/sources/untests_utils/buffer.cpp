@@ -7,6 +7,16 @@
 #include "_utils.hpp"
 using namespace e2d;
 
+namespace
+{
+    std::size_t adopted_free_count = 0;
+
+    void adopted_free(void* ptr) noexcept {
+        ++adopted_free_count;
+        std::free(ptr);
+    }
+}
+
 TEST_CASE("buffer") {
     {
         REQUIRE(buffer().size() == 0);
@@ -170,6 +180,49 @@ TEST_CASE("buffer") {
         }
     #endif
     }
+    {
+        adopted_free_count = 0;
+        {
+            void* mem = std::malloc(5);
+            std::memcpy(mem, "hello", 5);
+
+            buffer b0;
+            REQUIRE(&b0.adopt(mem, 5, adopted_free) == &b0);
+            REQUIRE(b0.data() == mem);
+            REQUIRE(b0.size() == 5);
+
+            buffer b1(b0);
+            REQUIRE(b1.data() != mem);
+            REQUIRE(b1 == b0);
+
+            buffer b2(std::move(b0));
+            REQUIRE(b2.data() == mem);
+            REQUIRE(b0.empty());
+            REQUIRE(adopted_free_count == 0);
+
+            b2.resize(5);
+            REQUIRE(b2.data() == mem);
+            b2.resize(3);
+            REQUIRE(b2.data() != mem);
+            REQUIRE(adopted_free_count == 1);
+            REQUIRE(std::memcmp(b2.data(), "hel", 3) == 0);
+        }
+        REQUIRE(adopted_free_count == 1);
+        {
+            buffer b0;
+            b0.adopt(std::malloc(4), 4, adopted_free);
+            b0.adopt(std::malloc(8), 8, adopted_free);
+            REQUIRE(adopted_free_count == 2);
+            b0.assign("hello", 5);
+            REQUIRE(adopted_free_count == 3);
+            b0.adopt(std::malloc(1), 0, adopted_free);
+            REQUIRE(b0.empty());
+            REQUIRE(adopted_free_count == 4);
+            b0.adopt(std::malloc(2), 2, adopted_free);
+            b0.clear();
+            REQUIRE(adopted_free_count == 5);
+        }
+    }
 }
 
 TEST_CASE("buffer_view") {
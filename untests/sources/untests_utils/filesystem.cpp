@@ -184,9 +184,130 @@ TEST_CASE("filesystem") {
                 {"child2/subchild_b", false}
             });
 
+            for ( const bool parallel : {false, true} ) {
+                vector<std::thread> threads;
+                std::mutex threads_mutex;
+                const filesystem::scan_executor executor = [&threads, &threads_mutex](std::function<void()> task){
+                    std::lock_guard<std::mutex> guard(threads_mutex);
+                    threads.emplace_back(std::move(task));
+                };
+                filesystem::directory_scan scan;
+                REQUIRE(filesystem::scan_directory_recursive(
+                    parent_dir_path, scan, parallel ? executor : nullptr));
+                for ( std::thread& t : threads ) {
+                    t.join();
+                }
+                vector<std::pair<str,bool>> result_scan;
+                for ( std::size_t i = 0; i < scan.size(); ++i ) {
+                    result_scan.emplace_back(scan.path(i), scan.directory(i));
+                }
+                std::sort(result_scan.begin(), result_scan.end());
+                REQUIRE(result_scan == result_recursive);
+
+                vector<std::pair<str,bool>> result_trace;
+                REQUIRE(filesystem::trace_directory_recursive(
+                    parent_dir_path,
+                    [&result_trace](str_view relative, bool directory){
+                        const str parent = path::parent_path(relative);
+                        const bool parent_traced = parent.empty() || std::find(
+                            result_trace.begin(), result_trace.end(),
+                            std::make_pair(parent, true)) != result_trace.end();
+                        result_trace.emplace_back(relative, directory);
+                        return parent_traced;
+                    },
+                    parallel ? executor : nullptr));
+
+                std::size_t trace_count = 0u;
+                REQUIRE_FALSE(filesystem::trace_directory_recursive(
+                    parent_dir_path,
+                    [&trace_count](str_view, bool){
+                        ++trace_count;
+                        return false;
+                    },
+                    parallel ? executor : nullptr));
+                for ( std::thread& t : threads ) {
+                    if ( t.joinable() ) {
+                        t.join();
+                    }
+                }
+                REQUIRE(trace_count == 1u);
+
+                std::sort(result_trace.begin(), result_trace.end());
+                REQUIRE(result_trace == result_recursive);
+            }
+            REQUIRE_FALSE(filesystem::trace_directory_recursive(
+                noparent_dir_path,
+                [](str_view, bool){ return true; },
+                nullptr));
+            {
+                filesystem::directory_scan scan;
+                scan.add("", "file", false);
+                REQUIRE_FALSE(filesystem::scan_directory_recursive(noparent_dir_path, scan));
+                REQUIRE(scan.empty());
+            }
+
             REQUIRE(filesystem::remove_directory(parent_dir_path));
             REQUIRE_FALSE(filesystem::file_exists(subchild1_dir_path_a));
             REQUIRE_FALSE(filesystem::file_exists(subchild2_dir_path_b));
         }
     }
 }
+
+TEST_CASE("filesystem_scan_performance") {
+#if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+    const std::size_t dir_count = 16u;
+    const std::size_t file_count = 64u;
+#else
+    const std::size_t dir_count = 64u;
+    const std::size_t file_count = 256u;
+#endif
+    const str root_path = "test_filesystem_scan_dir";
+    if ( filesystem::directory_exists(root_path) ) {
+        REQUIRE(filesystem::remove_directory(root_path));
+    }
+    for ( std::size_t d = 0; d < dir_count; ++d ) {
+        const str dir_path = path::combine(root_path, strings::rformat("dir%0/sub", d));
+        REQUIRE(filesystem::create_directory_recursive(dir_path));
+        for ( std::size_t f = 0; f < file_count; ++f ) {
+            REQUIRE(filesystem::create_file(
+                path::combine(dir_path, strings::rformat("file%0.txt", f))));
+        }
+    }
+    const std::size_t entry_count = dir_count * (file_count + 2u);
+
+    std::printf("-= filesystem::performance tests =-\n");
+    {
+        e2d_untests::verbose_profiler_ms p("filesystem::trace_directory_recursive");
+        std::size_t count = 0u;
+        REQUIRE(filesystem::trace_directory_recursive(root_path, [&count](str_view, bool){
+            ++count;
+            return true;
+        }));
+        p.done(count);
+        REQUIRE(count == entry_count);
+    }
+    {
+        e2d_untests::verbose_profiler_ms p("filesystem::scan_directory_recursive");
+        filesystem::directory_scan scan;
+        REQUIRE(filesystem::scan_directory_recursive(root_path, scan));
+        p.done(scan.size());
+        REQUIRE(scan.size() == entry_count);
+    }
+    {
+        vector<std::thread> threads;
+        std::mutex threads_mutex;
+        const filesystem::scan_executor executor = [&threads, &threads_mutex](std::function<void()> task){
+            std::lock_guard<std::mutex> guard(threads_mutex);
+            threads.emplace_back(std::move(task));
+        };
+        e2d_untests::verbose_profiler_ms p("filesystem::scan_directory_recursive(parallel)");
+        filesystem::directory_scan scan;
+        REQUIRE(filesystem::scan_directory_recursive(root_path, scan, executor));
+        p.done(scan.size());
+        REQUIRE(scan.size() == entry_count);
+        for ( std::thread& t : threads ) {
+            t.join();
+        }
+    }
+    REQUIRE(filesystem::remove_directory(root_path));
+}
@@ -7,6 +7,86 @@
 #include "_utils.hpp"
 using namespace e2d;
 
+namespace
+{
+    // counts bytes requested through the global operator new
+    // while the counting is enabled in the current thread
+    thread_local bool new_counting_enabled = false;
+    thread_local std::size_t new_counting_bytes = 0;
+
+    class new_counting_scope final : private noncopyable {
+    public:
+        new_counting_scope() noexcept {
+            new_counting_bytes = 0;
+            new_counting_enabled = true;
+        }
+
+        ~new_counting_scope() noexcept {
+            new_counting_enabled = false;
+        }
+
+        std::size_t bytes() const noexcept {
+            return new_counting_bytes;
+        }
+    };
+}
+
+namespace
+{
+    bool try_load_test_image(image& dst, const buffer& src) noexcept {
+        const str_view signature("e2d_test_image");
+        if ( src.size() != signature.size()
+            || std::memcmp(src.data(), signature.data(), signature.size()) != 0 )
+        {
+            return false;
+        }
+        const u8 img_data[] = {1,2,3,4};
+        dst.assign(v2u(1,1), image_data_format::rgba8, buffer(img_data, sizeof(img_data)));
+        return true;
+    }
+
+    bool try_load_any_image(image& dst, const buffer& src) noexcept {
+        E2D_UNUSED(src);
+        dst.clear();
+        return true;
+    }
+
+    buffer make_image_fixture(const v2u& size, image_data_format format, image_file_format file_format) {
+        const std::size_t channels = format == image_data_format::rgba8 ? 4u : 3u;
+        buffer data(size.x * size.y * channels);
+        for ( u32 y = 0; y < size.y; ++y )
+        for ( u32 x = 0; x < size.x; ++x ) {
+            u8* pixel = data.data() + (y * size.x + x) * channels;
+            pixel[0] = static_cast<u8>(x);
+            pixel[1] = static_cast<u8>(y);
+            pixel[2] = static_cast<u8>((x * y) >> 4);
+            if ( channels == 4u ) {
+                pixel[3] = static_cast<u8>(x + y);
+            }
+        }
+        buffer result;
+        REQUIRE(images::try_save_image(
+            image(size, format, std::move(data)),
+            file_format,
+            result));
+        return result;
+    }
+}
+
+void* operator new(std::size_t size) {
+    if ( new_counting_enabled ) {
+        new_counting_bytes += size;
+    }
+    if ( void* ptr = std::malloc(size ? size : 1) ) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
 TEST_CASE("images") {
     {
         image i;
@@ -129,4 +209,128 @@ TEST_CASE("images") {
         REQUIRE(math::approximately(img.pixel32(1,0), color32::green(), 0));
         REQUIRE(math::approximately(img.pixel32(2,0), color32::blue(),  0));
     }
+    {
+        buffer src_data(256 * 256 * 4);
+        for ( std::size_t i = 0; i < src_data.size(); i += 4 ) {
+            src_data.data()[i + 0] = static_cast<u8>(i / 4 % 256);
+            src_data.data()[i + 1] = static_cast<u8>(i / 4 / 256);
+            src_data.data()[i + 2] = static_cast<u8>(i / 7);
+            src_data.data()[i + 3] = 255u;
+        }
+        const image src(v2u(256,256), image_data_format::rgba8, std::move(src_data));
+
+        buffer png_buf;
+        REQUIRE(images::try_save_image(src, image_file_format::png, png_buf));
+
+        image dst;
+        std::size_t new_bytes = 0;
+        {
+            new_counting_scope counter;
+            REQUIRE(images::try_load_image(dst, png_buf));
+            new_bytes = counter.bytes();
+        }
+
+        // decoded pixels are adopted from the decoder, not copied
+        REQUIRE(dst.size() == src.size());
+        REQUIRE(dst.format() == image_data_format::rgba8);
+        REQUIRE(dst.data() == src.data());
+        REQUIRE(new_bytes < dst.data().size());
+    }
+    {
+        const vector<str> names = images::decoder_names();
+        REQUIRE(names.size() >= 3u);
+        REQUIRE(names.back() == "stb");
+        REQUIRE(std::find(names.begin(), names.end(), "dds") != names.end());
+        REQUIRE(std::find(names.begin(), names.end(), "pvr") != names.end());
+
+        buffer test_src("e2d_test_image", 14);
+        buffer png_src = make_image_fixture(v2u(4,4), image_data_format::rgb8, image_file_format::png);
+
+        image img;
+        REQUIRE_FALSE(images::try_load_image(img, test_src));
+        REQUIRE(images::try_load_image(img, png_src, "stb"));
+        REQUIRE(img.size() == v2u(4,4));
+        REQUIRE_FALSE(images::try_load_image(img, png_src, "test"));
+
+        REQUIRE(images::register_decoder("test", 10, try_load_test_image));
+        REQUIRE_FALSE(images::register_decoder("test", 20, try_load_any_image));
+        REQUIRE(images::decoder_names().back() == "stb");
+
+        REQUIRE(images::try_load_image(img, test_src));
+        REQUIRE(img.size() == v2u(1,1));
+        REQUIRE(images::try_load_image(img, png_src));
+        REQUIRE(img.size() == v2u(4,4));
+        REQUIRE_FALSE(images::try_load_image(img, test_src, "stb"));
+        REQUIRE_FALSE(images::try_load_image(img, png_src, "test"));
+
+        REQUIRE(images::register_decoder("any", -10, try_load_any_image));
+        REQUIRE(images::decoder_names().back() == "any");
+        REQUIRE(images::try_load_image(img, buffer("garbage", 7)));
+        REQUIRE(img.empty());
+
+        REQUIRE(images::unregister_decoder("any"));
+        REQUIRE(images::unregister_decoder("test"));
+        REQUIRE_FALSE(images::unregister_decoder("test"));
+        REQUIRE(images::decoder_names() == names);
+        REQUIRE_FALSE(images::try_load_image(img, test_src));
+    }
+    {
+        std::printf("-= images::performance tests =-\n");
+    #if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+        const std::size_t iterations = 5;
+    #else
+        const std::size_t iterations = 50;
+    #endif
+        str resources;
+        REQUIRE(filesystem::extract_predef_path(
+            resources,
+            filesystem::predef_path::resources));
+
+        vector<std::pair<str, buffer>> fixtures;
+        for ( const char* fixture : {
+            "bin/gnome/gnome.png",
+            "bin/gnome/yad.png",
+            "bin/library/image.png" } )
+        {
+            // skips not fetched fixtures
+            buffer fixture_data;
+            image fixture_image;
+            if ( filesystem::try_read_all(fixture_data, path::combine(resources, fixture))
+                && images::try_load_image(fixture_image, fixture_data) )
+            {
+                fixtures.emplace_back(fixture, std::move(fixture_data));
+            }
+        }
+
+        fixtures.emplace_back("png rgb 1024x1024", make_image_fixture(
+            v2u(1024,1024), image_data_format::rgb8, image_file_format::png));
+        fixtures.emplace_back("png rgba 1024x1024", make_image_fixture(
+            v2u(1024,1024), image_data_format::rgba8, image_file_format::png));
+        fixtures.emplace_back("jpg rgb 1024x1024", make_image_fixture(
+            v2u(1024,1024), image_data_format::rgb8, image_file_format::jpg));
+        fixtures.emplace_back("tga rgba 1024x1024", make_image_fixture(
+            v2u(1024,1024), image_data_format::rgba8, image_file_format::tga));
+
+        for ( const auto& fixture : fixtures ) {
+            for ( const str& decoder : images::decoder_names() ) {
+                image img;
+                if ( !images::try_load_image(img, fixture.second, decoder) ) {
+                    continue;
+                }
+                const auto begin = time::now_us<f64>();
+                for ( std::size_t i = 0; i < iterations; ++i ) {
+                    REQUIRE(images::try_load_image(img, fixture.second, decoder));
+                }
+                const f64 seconds = math::max(
+                    (time::now_us<f64>() - begin).value * 0.000001,
+                    0.000001);
+                const f64 megabytes = static_cast<f64>(img.data().size() * iterations) / (1024.0 * 1024.0);
+                std::printf(
+                    "result: %.1f MB/s, decoder: %s, desc: %s\n",
+                    megabytes / seconds,
+                    decoder.c_str(),
+                    fixture.first.c_str());
+            }
+        }
+    }
 }
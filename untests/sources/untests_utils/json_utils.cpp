@@ -414,3 +414,123 @@ TEST_CASE("json_utils") {
         REQUIRE(v6 == v6_);
     }
 }
+
+namespace
+{
+    struct counting_handler final
+        : rapidjson::BaseReaderHandler<rapidjson::UTF8<>, counting_handler> {
+        std::size_t objects = 0;
+        std::size_t numbers = 0;
+        std::size_t strings = 0;
+
+        bool StartObject() {
+            ++objects;
+            return true;
+        }
+
+        bool Int(int) { ++numbers; return true; }
+        bool Uint(unsigned) { ++numbers; return true; }
+        bool Double(double) { ++numbers; return true; }
+
+        bool String(const char*, rapidjson::SizeType, bool) {
+            ++strings;
+            return true;
+        }
+
+        bool Default() {
+            return true;
+        }
+    };
+
+    str make_large_json(std::size_t count) {
+        str result = "[";
+        for ( std::size_t i = 0; i < count; ++i ) {
+            result += strings::rformat(
+                "%0{\"name\":\"item_%1\",\"position\":{\"x\":%1,\"y\":%2},\"tags\":[\"a\",\"b\"]}",
+                i > 0 ? "," : "",
+                i,
+                i * 2u + 1u);
+        }
+        result += "]";
+        return result;
+    }
+}
+
+TEST_CASE("json_utils_document") {
+    {
+        json_document doc(buffer(json_source, std::strlen(json_source)));
+        REQUIRE(doc.parse());
+        REQUIRE(doc.IsObject());
+        v4i v6;
+        REQUIRE(json_utils::try_parse_value(doc["v6"], v6));
+        REQUIRE(v6 == v4i(1,-2,3,-4));
+    }
+    {
+        const str src = "{\"hello\":\"world\"}";
+        json_document doc(buffer(src.c_str(), src.size() + 1u));
+        REQUIRE(doc.parse());
+        REQUIRE(str(doc["hello"].GetString()) == "world");
+    }
+    {
+        json_document doc(buffer("{\"hello\":", 9));
+        REQUIRE_FALSE(doc.parse());
+        json_document doc2{buffer()};
+        REQUIRE_FALSE(doc2.parse());
+    }
+    {
+        const str src = make_large_json(100);
+        const buffer src_buffer(src.data(), src.size());
+
+        counting_handler h1;
+        REQUIRE(json_utils::try_parse_sax(src_buffer, h1));
+        REQUIRE(h1.objects == 200u);
+        REQUIRE(h1.numbers == 200u);
+        REQUIRE(h1.strings == 800u);
+
+        counting_handler h2;
+        REQUIRE(json_utils::try_parse_sax(make_memory_stream(src_buffer), h2));
+        REQUIRE(h2.objects == h1.objects);
+        REQUIRE(h2.numbers == h1.numbers);
+        REQUIRE(h2.strings == h1.strings);
+
+        // tiny read-ahead buffer to cross chunk boundaries everywhere
+        counting_handler h3;
+        auto stream = make_memory_stream(src_buffer);
+        json_utils::input_stream_wrapper wrapper(*stream, 3u);
+        rapidjson::Reader reader;
+        REQUIRE_FALSE(reader.Parse(wrapper, h3).IsError());
+        REQUIRE(h3.strings == h1.strings);
+        REQUIRE(wrapper.Tell() == src.size());
+
+        counting_handler h4;
+        REQUIRE_FALSE(json_utils::try_parse_sax(buffer("[1,2", 4), h4));
+    }
+    {
+        std::printf("-= json_utils::performance tests =-\n");
+    #if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+        const std::size_t task_n = 10'000;
+    #else
+        const std::size_t task_n = 200'000;
+    #endif
+        const str src = make_large_json(task_n);
+        const buffer src_buffer(src.data(), src.size());
+        {
+            e2d_untests::verbose_profiler_ms p("json: rapidjson::Document::Parse");
+            rapidjson::Document doc;
+            doc.Parse(src.c_str());
+            p.done(doc.Size());
+        }
+        {
+            e2d_untests::verbose_profiler_ms p("json: json_document::parse (in situ)");
+            json_document doc(src_buffer);
+            doc.parse();
+            p.done(doc.Size());
+        }
+        {
+            e2d_untests::verbose_profiler_ms p("json: json_utils::try_parse_sax(stream)");
+            counting_handler h;
+            json_utils::try_parse_sax(make_memory_stream(src_buffer), h);
+            p.done(h.objects);
+        }
+    }
+}
@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_utils.hpp"
+#include <random>
+using namespace e2d;
+
+namespace
+{
+    buffer make_text_fixture(std::size_t size) {
+        const str_view words[] = {
+            "sprite", "atlas", "shader", "texture", "material", "prefab", "{", "}", "\n"};
+        buffer result(size);
+        std::mt19937 rnd(42u);
+        for ( std::size_t i = 0; i < size; ) {
+            const str_view word = words[rnd() % E2D_COUNTOF(words)];
+            const std::size_t n = math::min(word.size(), size - i);
+            std::memcpy(result.data() + i, word.data(), n);
+            i += n;
+        }
+        return result;
+    }
+
+    buffer make_noise_fixture(std::size_t size) {
+        buffer result(size);
+        std::mt19937 rnd(42u);
+        for ( std::size_t i = 0; i < size; ++i ) {
+            result.data()[i] = static_cast<u8>(rnd());
+        }
+        return result;
+    }
+}
+
+TEST_CASE("pack") {
+    SECTION("codecs") {
+        const buffer fixtures[] = {
+            buffer(),
+            buffer("a", 1),
+            buffer("hello world", 11),
+            buffer(1000u),
+            make_text_fixture(100000u),
+            make_noise_fixture(10000u)
+        };
+        for ( const buffer& src : fixtures ) {
+            for ( pack_codec codec : {pack_codec::store, pack_codec::lz4} ) {
+                buffer packed, unpacked;
+                REQUIRE(packs::try_compress(codec, src, packed));
+                REQUIRE(packs::try_decompress(codec, packed, src.size(), unpacked));
+                REQUIRE(unpacked == src);
+            }
+        }
+        {
+            const buffer src = make_text_fixture(100000u);
+            buffer packed, unpacked;
+            REQUIRE(packs::try_compress(pack_codec::lz4, src, packed));
+            REQUIRE(packed.size() < src.size() / 2u);
+            REQUIRE_FALSE(packs::try_decompress(pack_codec::lz4, packed, src.size() - 1u, unpacked));
+            REQUIRE_FALSE(packs::try_decompress(pack_codec::lz4, packed, src.size() + 1u, unpacked));
+            REQUIRE_FALSE(packs::try_decompress(
+                pack_codec::lz4,
+                buffer_view(packed.data(), packed.size() / 2u),
+                src.size(),
+                unpacked));
+        }
+    }
+    SECTION("writer_reader") {
+        const str pack_path = "pack_file_name.e2d";
+        const buffer text = make_text_fixture(50000u);
+        const buffer noise = make_noise_fixture(5000u);
+        {
+            pack_writer w(make_write_file(pack_path, false));
+            REQUIRE(w.valid());
+            REQUIRE(w.add("text.json", text, pack_codec::lz4));
+            REQUIRE(w.add("folder/noise.bin", noise, pack_codec::lz4));
+            REQUIRE(w.add("folder/hello.txt", buffer("hello", 5), pack_codec::store));
+            REQUIRE(w.add("empty.txt", buffer(), pack_codec::lz4));
+            REQUIRE_FALSE(w.add("text.json", text, pack_codec::store));
+            REQUIRE_FALSE(w.add("", text, pack_codec::store));
+            REQUIRE(w.finish());
+            REQUIRE_FALSE(w.valid());
+            REQUIRE_FALSE(w.add("late.txt", text, pack_codec::store));
+            REQUIRE_FALSE(w.finish());
+        }
+        {
+            pack_reader r(make_read_file(pack_path));
+            REQUIRE(r.valid());
+            REQUIRE(r.entries().size() == 4u);
+            REQUIRE(std::is_sorted(r.entries().begin(), r.entries().end(),
+                [](const pack_reader::entry& l, const pack_reader::entry& r){
+                    return l.hash < r.hash;
+                }));
+            for ( const pack_reader::entry& e : r.entries() ) {
+                REQUIRE(e.offset % pack_alignment == 0u);
+                REQUIRE(e.hash == packs::path_hash(e.path));
+            }
+
+            REQUIRE_FALSE(r.find("text2.json"));
+            REQUIRE_FALSE(r.find("folder"));
+            REQUIRE_FALSE(r.find("Text.json"));
+
+            const pack_reader::entry* e = r.find("text.json");
+            REQUIRE(e);
+            REQUIRE(e->codec == pack_codec::lz4);
+            REQUIRE(e->size == text.size());
+            REQUIRE(e->packed_size < text.size());
+            buffer b;
+            REQUIRE(r.read(*e, b));
+            REQUIRE(b == text);
+
+            e = r.find("folder/noise.bin");
+            REQUIRE(e);
+            REQUIRE(e->codec == pack_codec::store);
+            REQUIRE(r.read(*e, b));
+            REQUIRE(b == noise);
+
+            e = r.find("folder/hello.txt");
+            REQUIRE(e);
+            REQUIRE(r.read(*e, b));
+            REQUIRE(b == buffer("hello", 5));
+
+            e = r.find("empty.txt");
+            REQUIRE(e);
+            REQUIRE(r.read(*e, b));
+            REQUIRE(b.empty());
+        }
+        {
+            REQUIRE_FALSE(pack_reader(nullptr).valid());
+            REQUIRE_FALSE(pack_reader(make_memory_stream(buffer("e2d_pack", 8))).valid());
+            REQUIRE_FALSE(pack_reader(make_memory_stream(make_noise_fixture(8192u))).valid());
+        }
+        REQUIRE(filesystem::remove_file(pack_path));
+    }
+}
+
+TEST_CASE("pack_performance") {
+    std::printf("-= pack::performance tests =-\n");
+#if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+    const std::size_t fixture_size = 1024u * 1024u;
+#else
+    const std::size_t fixture_size = 16u * 1024u * 1024u;
+#endif
+    const buffer src = make_text_fixture(fixture_size);
+    buffer packed, unpacked;
+    {
+        e2d_untests::verbose_profiler_ms p("packs::try_compress(lz4)");
+        REQUIRE(packs::try_compress(pack_codec::lz4, src, packed));
+        p.done(packed.size());
+    }
+    {
+        e2d_untests::verbose_profiler_ms p("packs::try_decompress(lz4)");
+        REQUIRE(packs::try_decompress(pack_codec::lz4, packed, src.size(), unpacked));
+        p.done(unpacked.size());
+    }
+    REQUIRE(unpacked == src);
+}
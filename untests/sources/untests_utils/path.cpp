@@ -78,6 +78,10 @@ TEST_CASE("path") {
             str lhs, rhs, res;
             std::tie(lhs, rhs, res) = combination;
             REQUIRE(path::combine(lhs, rhs) == res);
+            str dst = "garbage";
+            REQUIRE(path::combine_to(dst, lhs, rhs) == res);
+            REQUIRE(path_buffer(lhs, rhs) == res);
+            REQUIRE(path_buffer(lhs).append(rhs) == res);
         }
     }
     {
@@ -137,6 +141,9 @@ TEST_CASE("path") {
             REQUIRE(path::stem(path) == std::get<1>(combination));
             REQUIRE(path::filename(path) == std::get<2>(combination));
             REQUIRE(path::extension(path) == std::get<3>(combination));
+            REQUIRE(path::stem_view(path) == std::get<1>(combination));
+            REQUIRE(path::filename_view(path) == std::get<2>(combination));
+            REQUIRE(path::extension_view(path) == std::get<3>(combination));
         }
     }
     {
@@ -189,6 +196,8 @@ TEST_CASE("path") {
             const str path = std::get<0>(combination);
             REQUIRE(path::remove_filename(path) == std::get<1>(combination));
             REQUIRE(path::remove_extension(path) == std::get<2>(combination));
+            REQUIRE(path::remove_filename_view(path) == std::get<1>(combination));
+            REQUIRE(path::remove_extension_view(path) == std::get<2>(combination));
         }
     }
     {
@@ -249,6 +258,7 @@ TEST_CASE("path") {
             str path, name, result;
             std::tie(path, name, result) = combination;
             REQUIRE(path::replace_filename(path, name) == result);
+            REQUIRE(path_buffer(path).replace_filename(name) == result);
         }
     }
     {
@@ -292,6 +302,7 @@ TEST_CASE("path") {
             str path, extension, result;
             std::tie(path, extension, result) = combination;
             REQUIRE(path::replace_extension(path, extension) == result);
+            REQUIRE(path_buffer(path).replace_extension(extension) == result);
         }
     }
     {
@@ -347,6 +358,108 @@ TEST_CASE("path") {
             str path, result;
             std::tie(path, result) = combination;
             REQUIRE(path::parent_path(path) == result);
+            REQUIRE(path::parent_path_view(path) == result);
         }
     }
+    {
+        const str folder(path_buffer::inline_capacity, 'f');
+
+        path_buffer b("folder");
+        REQUIRE_FALSE(b.on_heap());
+        REQUIRE(b.size() == 6u);
+        REQUIRE(str_view(b.c_str()) == "folder");
+
+        b.append("file.png");
+        REQUIRE(b == "folder/file.png");
+        REQUIRE(b.c_str()[b.size()] == '\0');
+
+        b.concat(".meta");
+        REQUIRE(b == "folder/file.png.meta");
+
+        b.append(folder);
+        REQUIRE(b.on_heap());
+        REQUIRE(b == path::combine("folder/file.png.meta", folder));
+        REQUIRE(str_view(b.c_str()) == b.view());
+
+        path_buffer c(b);
+        REQUIRE(c == b.view());
+        path_buffer d(std::move(c));
+        REQUIRE(d == b.view());
+        REQUIRE(c.empty());
+
+        b.assign("short");
+        REQUIRE_FALSE(b.on_heap());
+        REQUIRE(b == "short");
+
+        b.append(b.view());
+        REQUIRE(b == "short/short");
+        b.assign(path::filename_view(b));
+        REQUIRE(b == "short");
+
+        b.clear();
+        REQUIRE(b.empty());
+        REQUIRE(b == "");
+    }
+    {
+        url u("file://folder");
+        REQUIRE(combine_to(u, u, "file.png") == url("file://folder/file.png"));
+
+        url dst("other://garbage");
+        REQUIRE(combine_to(dst, url("res://folder"), "file.png") == url("res://folder/file.png"));
+        REQUIRE(combine_to(dst, url("res://folder"), "/file.png") == url("res:///file.png"));
+        REQUIRE(combine_to(dst, url("res://folder"), "file.png") == url("res://folder/file.png"));
+        REQUIRE(combine_to(dst, dst, dst.path()) == url("res://folder/file.png/folder/file.png"));
+    }
+}
+
+TEST_CASE("path_performance") {
+    std::printf("-= path::performance tests =-\n");
+#if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+    const std::size_t iterations = 100000u;
+#else
+    const std::size_t iterations = 1000000u;
+#endif
+    const str_view parent = "assets/levels/level_01/prefabs";
+    const str_view child = "../sprites/characters/hero_idle_animation.json";
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("path::combine");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += path::combine(parent, child).size();
+        }
+        p.done(result);
+    }
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("path_buffer");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += path_buffer(parent, child).size();
+        }
+        p.done(result);
+    }
+    {
+        str dst;
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("path::combine_to");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += path::combine_to(dst, parent, child).size();
+        }
+        p.done(result);
+    }
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("path::extension");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += path::extension(child).size();
+        }
+        p.done(result);
+    }
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("path::extension_view");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += path::extension_view(child).size();
+        }
+        p.done(result);
+    }
 }
@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * This file is part of the "Enduro2D"
+ * For conditions of distribution and use, see copyright notice in LICENSE.md
+ * Copyright (C) 2018-2019, by Matvey Cherevko (blackmatov@gmail.com)
+ ******************************************************************************/
+
+#include "_utils.hpp"
+using namespace e2d;
+
+TEST_CASE("sounds") {
+    {
+        sound s;
+        REQUIRE(s.empty());
+        REQUIRE(s.channels() == 0u);
+        REQUIRE(s.sample_rate() == 0u);
+        REQUIRE(s.frame_count() == 0u);
+    }
+    {
+        sound s(2u, 22050u, vector<f32>{0.f, 0.5f, -0.5f, 1.f, 0.25f, -1.f});
+        REQUIRE_FALSE(s.empty());
+        REQUIRE(s.channels() == 2u);
+        REQUIRE(s.sample_rate() == 22050u);
+        REQUIRE(s.frame_count() == 3u);
+
+        sound s2 = s;
+        REQUIRE(s2 == s);
+        s2.clear();
+        REQUIRE(s2 != s);
+        REQUIRE(s2.empty());
+    }
+    {
+        const sound src(2u, 22050u, vector<f32>{0.f, 0.5f, -0.5f, 1.f, 0.25f, -1.f});
+
+        buffer file_data;
+        REQUIRE(sounds::try_save_sound(src, sound_file_format::wav, file_data));
+
+        sound dst;
+        REQUIRE(sounds::try_load_sound(dst, file_data));
+        REQUIRE(dst == src);
+
+        sound_stream_uptr stream = sounds::try_open_sound_stream(
+            make_memory_stream(file_data));
+        REQUIRE(stream);
+        REQUIRE(stream->channels() == 2u);
+        REQUIRE(stream->sample_rate() == 22050u);
+
+        f32 frames[4] = {0.f};
+        REQUIRE(stream->read(frames, 2u) == 2u);
+        REQUIRE(frames[0] == 0.f);
+        REQUIRE(frames[1] == 0.5f);
+        REQUIRE(frames[2] == -0.5f);
+        REQUIRE(frames[3] == 1.f);
+        REQUIRE(stream->read(frames, 2u) == 1u);
+        REQUIRE(frames[0] == 0.25f);
+        REQUIRE(frames[1] == -1.f);
+        REQUIRE(stream->read(frames, 2u) == 0u);
+
+        REQUIRE(stream->rewind());
+        REQUIRE(stream->read(frames, 1u) == 1u);
+        REQUIRE(frames[0] == 0.f);
+        REQUIRE(frames[1] == 0.5f);
+    }
+    {
+        sound dst;
+        REQUIRE_FALSE(sounds::try_load_sound(dst, buffer("RIFF", 4)));
+        REQUIRE_FALSE(sounds::try_open_sound_stream(make_memory_stream(buffer("RIFF", 4))));
+    }
+}
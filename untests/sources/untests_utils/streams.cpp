@@ -103,4 +103,85 @@ TEST_CASE("streams") {
             REQUIRE(s->length() == 5);
         }
     }
+    {
+        buffer data(1000);
+        for ( std::size_t i = 0; i < data.size(); ++i ) {
+            data.data()[i] = static_cast<u8>(i % 251);
+        }
+        streams::reset_statistics();
+        input_stream_uptr s = make_buffered_stream(make_memory_stream(data), 64);
+        REQUIRE(s);
+        REQUIRE(s->length() == 1000);
+        REQUIRE(s->tell() == 0);
+        {
+            u32 v = 0;
+            for ( std::size_t i = 0; i < 16; ++i ) {
+                REQUIRE(input_sequence(*s).read(v).success());
+                REQUIRE(std::memcmp(&v, data.data() + i * 4, 4) == 0);
+            }
+            REQUIRE(s->tell() == 64);
+            REQUIRE(streams::statistics().read_calls == 1);
+            REQUIRE(streams::statistics().read_bytes == 64);
+            // counted by the stream until the next underlying read
+            REQUIRE(streams::statistics().buffered_reads == 0);
+        }
+        {
+            u8 b[8] = {0};
+            REQUIRE(s->seek(-10, true) == 54);
+            REQUIRE(s->read(b, 8) == 8);
+            REQUIRE(std::memcmp(b, data.data() + 54, 8) == 0);
+            REQUIRE(s->read(b, 8) == 8);
+            REQUIRE(std::memcmp(b, data.data() + 62, 8) == 0);
+            REQUIRE(s->tell() == 70);
+            REQUIRE(streams::statistics().read_calls == 2);
+            REQUIRE(streams::statistics().seek_calls == 0);
+            REQUIRE(streams::statistics().buffered_reads == 17);
+        }
+        {
+            buffer b(200);
+            REQUIRE(s->seek(500, false) == 500);
+            REQUIRE(s->read(b.data(), b.size()) == 200);
+            REQUIRE(std::memcmp(b.data(), data.data() + 500, 200) == 0);
+            REQUIRE(streams::statistics().read_calls == 3);
+            REQUIRE(streams::statistics().seek_calls == 1);
+            REQUIRE(s->tell() == 700);
+        }
+        {
+            REQUIRE_THROWS_AS(s->seek(-1, false), bad_stream_operation);
+            REQUIRE_THROWS_AS(s->seek(301, true), bad_stream_operation);
+            REQUIRE(s->tell() == 700);
+
+            buffer b;
+            REQUIRE(streams::try_read_tail(b, s));
+            REQUIRE(b.size() == 300);
+            REQUIRE(std::memcmp(b.data(), data.data() + 700, 300) == 0);
+            REQUIRE(s->read(b.data(), 1) == 0);
+        }
+        REQUIRE(make_buffered_stream(nullptr, 64) == nullptr);
+    }
+    {
+        buffer data(40);
+        for ( std::size_t i = 0; i < data.size(); ++i ) {
+            data.data()[i] = static_cast<u8>(i);
+        }
+        streams::reset_statistics();
+        input_stream_uptr s = make_buffered_stream(make_memory_stream(data), 64);
+        REQUIRE(s);
+        u32 v = 0;
+        for ( std::size_t i = 0; i < 10; ++i ) {
+            REQUIRE(input_sequence(*s).read(v).success());
+            REQUIRE(std::memcmp(&v, data.data() + i * 4, 4) == 0);
+        }
+        REQUIRE(s->read(&v, 1) == 0);
+        REQUIRE(streams::statistics().read_calls == 1);
+        REQUIRE(streams::statistics().read_bytes == 40);
+        REQUIRE(streams::statistics().buffered_reads == 0);
+        s.reset();
+        REQUIRE(streams::statistics().buffered_reads == 9);
+
+        input_stream_uptr e = make_buffered_stream(make_memory_stream(buffer()), 64);
+        REQUIRE(e);
+        REQUIRE(e->length() == 0);
+        REQUIRE(streams::statistics().read_calls == 1);
+    }
 }
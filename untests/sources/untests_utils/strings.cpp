@@ -99,6 +99,86 @@ TEST_CASE("strings") {
         REQUIRE(make_utf32(str16_view(null_utf16, 0)) == make_utf32(u""));
         REQUIRE(make_utf32(str32_view(null_utf32, 0)) == make_utf32(U""));
     }
+    {
+        // [utf8, utf16, utf32]
+        using t = std::tuple<str, str16, str32>;
+        const vector<t> segments = {
+            t{"", u"", U""},
+            t{u8"\u00E9", u"\u00E9", U"\u00E9"},
+            t{u8"\u4F60\u597D", u"\u4F60\u597D", U"\u4F60\u597D"},
+            t{u8"\U0001F600", u"\U0001F600", U"\U0001F600"},
+            t{u8"\uD7FF\uE000\uFFFF", u"\uD7FF\uE000\uFFFF", U"\uD7FF\uE000\uFFFF"},
+        };
+        const str ascii = "0123456789abcdefghijklmnopqrstuvwxyz/._-";
+
+        // ascii runs of all lengths around the simd block size
+        str s8;
+        str16 s16;
+        str32 s32;
+        for ( std::size_t pad = 0; pad <= ascii.size(); ++pad ) {
+            for ( const t& seg : segments ) {
+                for ( std::size_t i = 0; i < pad; ++i ) {
+                    s8.push_back(ascii[i]);
+                    s16.push_back(static_cast<char16_t>(ascii[i]));
+                    s32.push_back(static_cast<char32_t>(ascii[i]));
+                }
+                s8 += std::get<0>(seg);
+                s16 += std::get<1>(seg);
+                s32 += std::get<2>(seg);
+            }
+            REQUIRE(make_utf8(s16) == s8);
+            REQUIRE(make_utf8(s32) == s8);
+            REQUIRE(make_utf16(s8) == s16);
+            REQUIRE(make_utf16(s32) == s16);
+            REQUIRE(make_utf32(s8) == s32);
+            REQUIRE(make_utf32(s16) == s32);
+            REQUIRE(make_utf8(make_wide(s8)) == s8);
+            REQUIRE(make_utf16(make_wide(s16)) == s16);
+            REQUIRE(make_utf32(make_wide(s32)) == s32);
+        }
+        {
+            const str a(1000u, 'a');
+            REQUIRE(make_utf8(make_utf16(a)) == a);
+            REQUIRE(make_utf8(make_utf32(a)) == a);
+            REQUIRE(make_utf8(make_wide(a)) == a);
+        }
+    }
+    {
+        const str prefix = "0123456789abcdefghijklmnopqrstuvwxyz";
+        const str invalid_utf8[] = {
+            prefix + "\xfa",
+            prefix + "\xc0\xaf",
+            prefix + "\xe0\x80\xaf",
+            prefix + "\xed\xa0\x80",
+            prefix + "\xf4\x90\x80\x80",
+            prefix + "\xf0\x9f\x98",
+            prefix + "\x80" + prefix,
+        };
+        for ( const str& s : invalid_utf8 ) {
+            REQUIRE_THROWS_AS(make_utf16(s), std::exception);
+            REQUIRE_THROWS_AS(make_utf32(s), std::exception);
+            REQUIRE_THROWS_AS(make_wide(s), std::exception);
+        }
+
+        str16 lone_lead = make_utf16(prefix);
+        lone_lead.push_back(static_cast<char16_t>(0xD800u));
+        str16 lone_trail = make_utf16(prefix);
+        lone_trail.push_back(static_cast<char16_t>(0xDC00u));
+        lone_trail += make_utf16(prefix);
+        for ( const str16& s : {lone_lead, lone_trail} ) {
+            REQUIRE_THROWS_AS(make_utf8(s), std::exception);
+            REQUIRE_THROWS_AS(make_utf32(s), std::exception);
+        }
+
+        str32 out_of_range = make_utf32(prefix);
+        out_of_range.push_back(static_cast<char32_t>(0x110000u));
+        str32 surrogate = make_utf32(prefix);
+        surrogate.push_back(static_cast<char32_t>(0xDFFFu));
+        for ( const str32& s : {out_of_range, surrogate} ) {
+            REQUIRE_THROWS_AS(make_utf8(s), std::exception);
+            REQUIRE_THROWS_AS(make_utf16(s), std::exception);
+        }
+    }
     {
         using strings::wildcard_match;
 
@@ -562,3 +642,77 @@ TEST_CASE("strings") {
         }
     }
 }
+
+TEST_CASE("strings_performance") {
+    std::printf("-= strings::performance tests =-\n");
+#if defined(E2D_BUILD_MODE) && E2D_BUILD_MODE == E2D_BUILD_MODE_DEBUG
+    const std::size_t iterations = 1000u;
+#else
+    const std::size_t iterations = 10000u;
+#endif
+    str ascii;
+    str mixed;
+    while ( ascii.size() < 4096u ) {
+        ascii += "assets/levels/level_01/prefabs/hero_idle_animation.json ";
+        mixed += u8"\u4F60\u597D label text \u00E9t\u00E9 \U0001F600 ";
+    }
+    const str16 ascii16 = make_utf16(ascii);
+    const str16 mixed16 = make_utf16(mixed);
+    const str32 ascii32 = make_utf32(ascii);
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("make_utf16(ascii utf8)");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += make_utf16(ascii).size();
+        }
+        p.done(result);
+    }
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("make_utf16(mixed utf8)");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += make_utf16(mixed).size();
+        }
+        p.done(result);
+    }
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("make_utf32(ascii utf8)");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += make_utf32(ascii).size();
+        }
+        p.done(result);
+    }
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("make_utf8(ascii utf16)");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += make_utf8(ascii16).size();
+        }
+        p.done(result);
+    }
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("make_utf8(mixed utf16)");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += make_utf8(mixed16).size();
+        }
+        p.done(result);
+    }
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("make_utf8(ascii utf32)");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += make_utf8(ascii32).size();
+        }
+        p.done(result);
+    }
+    {
+        std::size_t result = 0u;
+        e2d_untests::verbose_profiler_ms p("make_utf32(ascii utf16)");
+        for ( std::size_t i = 0; i < iterations; ++i ) {
+            result += make_utf32(ascii16).size();
+        }
+        p.done(result);
+    }
+}
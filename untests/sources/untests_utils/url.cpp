@@ -8,6 +8,15 @@
 using namespace e2d;
 
 TEST_CASE("url") {
+    {
+        url u("scheme_value", "path_value");
+        u.assign(str_view(u.path()), str_view(u.scheme()));
+        REQUIRE(u.scheme() == "path_value");
+        REQUIRE(u.path() == "scheme_value");
+        u.assign(str_view(u.path()).substr(0, 6), str_view(u.scheme()).substr(5));
+        REQUIRE(u.scheme() == "scheme");
+        REQUIRE(u.path() == "value");
+    }
     {
         url u;
         REQUIRE(u.empty());